@@ -0,0 +1,69 @@
+// allocator_bench.cpp
+// Lua-shaped allocation churn through the pooled allocator against plain malloc.
+#include "lua/allocator.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+    /// @brief Sizes skewed towards the small objects Lua allocates most: strings, table nodes, closures
+    std::vector<size_t> lua_sizes(size_t count) {
+        std::mt19937                          rng(42);
+        std::discrete_distribution<size_t>    pick({40, 30, 15, 10, 5});
+        constexpr size_t                      BOUNDS[] = {16, 48, 128, 256, 4096};
+        std::uniform_int_distribution<size_t> jitter(1, 16);
+
+        std::vector<size_t>                   sizes(count);
+        for (auto& size : sizes) {
+            const size_t bound = BOUNDS[pick(rng)];
+            size               = bound > 16 ? bound - jitter(rng) : jitter(rng);
+        }
+        return sizes;
+    }
+
+    void* malloc_alloc(void*, void* ptr, size_t, size_t nsize) {
+        if (nsize == 0) {
+            std::free(ptr);
+            return nullptr;
+        }
+        return std::realloc(ptr, nsize);
+    }
+
+    /// @brief Allocate a working set, then replace half of it per iteration the way a config's garbage turns over
+    void churn(benchmark::State& state, void* (*alloc)(void*, void*, size_t, size_t), void* ud) {
+        const auto         sizes = lua_sizes(4096);
+        std::vector<void*> live(sizes.size());
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            live[i] = alloc(ud, nullptr, 0, sizes[i]);
+        }
+
+        for (auto _ : state) {
+            for (size_t i = 0; i < sizes.size(); i += 2) {
+                alloc(ud, live[i], sizes[i], 0);
+                live[i] = alloc(ud, nullptr, 0, sizes[i]);
+                benchmark::DoNotOptimize(live[i]);
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(sizes.size() / 2));
+
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            alloc(ud, live[i], sizes[i], 0);
+        }
+    }
+
+}
+
+static void BM_AllocChurnMalloc(benchmark::State& state) {
+    churn(state, &malloc_alloc, nullptr);
+}
+BENCHMARK(BM_AllocChurnMalloc);
+
+static void BM_AllocChurnPooled(benchmark::State& state) {
+    hyprlua::LuaAllocator allocator;
+    churn(state, &hyprlua::LuaAllocator::lua_alloc, &allocator);
+    state.counters["pool_kib"] = static_cast<double>(allocator.stats().poolBytes) / 1024;
+}
+BENCHMARK(BM_AllocChurnPooled);
@@ -0,0 +1,119 @@
+// bytecode_cache_bench.cpp
+// Cold vs warm startup of a synthetic 5k-line config split across required modules.
+#include "lua/bytecode_cache.hpp"
+#include "lua/module_graph.hpp"
+
+#include <benchmark/benchmark.h>
+#include <sol/sol.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+    constexpr int MODULES          = 50;
+    constexpr int LINES_PER_MODULE = 100;
+
+    /// @brief Temporary config tree: entry.lua requiring MODULES files of LINES_PER_MODULE lines
+    struct SyntheticConfig {
+        fs::path root;
+        fs::path entry;
+        fs::path cacheHome;
+
+        SyntheticConfig() {
+            root      = fs::temp_directory_path() / ("hyprlua-bench-" + std::to_string(getpid()));
+            cacheHome = root / "cache";
+            fs::create_directories(root / "synthetic");
+
+            for (int m = 1; m <= MODULES; ++m) {
+                std::ofstream out(root / "synthetic" / ("mod_" + std::to_string(m) + ".lua"));
+                out << "local M = { entries = {} }\n";
+                for (int i = 1; i <= LINES_PER_MODULE - 2; ++i) {
+                    out << "M.entries[" << i << "] = { name = \"entry_" << i << "\", value = " << i << " * 3 + " << m
+                        << ", flags = { \"a\", \"b\", \"c\" }, enabled = (" << i << " % 2 == 0) }\n";
+                }
+                out << "return M\n";
+            }
+
+            entry = root / "hyprland.lua";
+            std::ofstream out(entry);
+            out << "local mods = {}\n"
+                << "for i = 1, " << MODULES << " do mods[i] = require(\"synthetic.mod_\" .. i) end\n";
+
+            setenv("XDG_CACHE_HOME", cacheHome.c_str(), 1);
+        }
+
+        ~SyntheticConfig() {
+            std::error_code ec;
+            fs::remove_all(root, ec);
+        }
+    };
+
+    SyntheticConfig& config() {
+        static SyntheticConfig cfg;
+        return cfg;
+    }
+
+    /// @brief What init does: fresh state, package.path next to the config, run the entry file
+    void startup(bool useCache) {
+        auto&      cfg = config();
+        sol::state lua;
+        lua.open_libraries(sol::lib::base, sol::lib::package, sol::lib::math, sol::lib::table, sol::lib::string);
+        lua["package"]["path"] = cfg.root.string() + "/?.lua";
+
+        // A fresh graph replays nothing, so every module goes through the cache
+        hyprlua::ModuleGraph                        graph;
+        hyprlua::ChangeSet                          changes;
+        std::unique_ptr<hyprlua::ModuleGraph::Run> run;
+        if (useCache) {
+            run = graph.attach(lua, changes, cfg.entry.string(), [] { return size_t{0}; });
+            run->begin();
+        }
+
+        sol::load_result        chunk = useCache ? hyprlua::cache::load_file(lua, cfg.entry.string()) : lua.load_file(cfg.entry.string());
+        sol::protected_function fn    = chunk;
+        auto                    result = fn();
+        if (run) {
+            run->finish();
+        }
+        if (!result.valid()) {
+            std::abort();
+        }
+    }
+
+}
+
+/// @brief Baseline: parse every file from source, as init did before the cache
+static void BM_StartupFromSource(benchmark::State& state) {
+    for (auto _ : state) {
+        startup(false);
+    }
+}
+BENCHMARK(BM_StartupFromSource)->Unit(benchmark::kMillisecond);
+
+/// @brief Empty cache: parse, dump and write every chunk
+static void BM_StartupColdCache(benchmark::State& state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::error_code ec;
+        fs::remove_all(config().cacheHome, ec);
+        state.ResumeTiming();
+
+        startup(true);
+    }
+}
+BENCHMARK(BM_StartupColdCache)->Unit(benchmark::kMillisecond);
+
+/// @brief Populated cache: hash sources and load bytecode
+static void BM_StartupWarmCache(benchmark::State& state) {
+    startup(true);
+    for (auto _ : state) {
+        startup(true);
+    }
+}
+BENCHMARK(BM_StartupWarmCache)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,126 @@
+// compile_bench.cpp
+// Writing a generated config with thousands of entries: the Lua serialize_config path
+// against the native writer hyprlua-compile uses, and hyprlua-compile end to end.
+#include "logger.hpp"
+#include "lua/changeset.hpp"
+#include "lua/config_build.hpp"
+#include "lua/conf_writer.hpp"
+
+#include <benchmark/benchmark.h>
+#include <sol/sol.hpp>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+    const std::string RUNTIME = HYPRLUA_RUNTIME_MODULES;
+
+    /// @brief Scratch directory; generated configs and outputs go here
+    struct Scratch {
+        fs::path root;
+
+        Scratch() {
+            root = fs::temp_directory_path() / ("hyprlua-compile-bench-" + std::to_string(getpid()));
+            fs::create_directories(root);
+            hyprlua::log::setLevel(hyprlua::log::Level::Off);
+        }
+
+        ~Scratch() {
+            std::error_code ec;
+            fs::remove_all(root, ec);
+        }
+    };
+
+    Scratch& scratch() {
+        static Scratch s;
+        return s;
+    }
+
+    std::string monitor_line(int i) {
+        return std::format("OUT-{},1920x1080@60,{}x0,1", i, i * 1920);
+    }
+
+    std::string bind_line(int i) {
+        return std::format("bind = SUPER, code:{}, workspace, {}", i, i + 1);
+    }
+
+}
+
+/// @brief The Lua path: N monitors and N binds as a config table through runtime/libs/utils.lua serialize_config, then written
+static void BM_ConfLua(benchmark::State& state) {
+    const int  count = static_cast<int>(state.range(0));
+    const auto out   = scratch().root / "lua.conf";
+
+    sol::state lua;
+    lua.open_libraries(sol::lib::base, sol::lib::table, sol::lib::string, sol::lib::io);
+    sol::table utils  = lua.script_file(fs::path(RUNTIME).parent_path().string() + "/libs/utils.lua");
+    sol::table config = lua.create_table();
+    for (int i = 0; i < count; ++i) {
+        config[std::format("monitor_{:05}", i)] = lua.create_table_with("name", std::format("OUT-{}", i), "resolution", "1920x1080@60", "position", std::format("{}x0", i * 1920), "scale", 1);
+        config[std::format("bind_{:05}", i)]    = bind_line(i);
+    }
+    sol::protected_function serialize = utils["serialize_config"];
+
+    for (auto _ : state) {
+        std::string   text = serialize(config, "hyprlua");
+        std::ofstream file(out, std::ios::trunc | std::ios::binary);
+        file << text;
+    }
+    state.counters["entries"] = 2.0 * count;
+}
+BENCHMARK(BM_ConfLua)->Arg(1000)->Arg(5000)->Unit(benchmark::kMillisecond);
+
+/// @brief The native path: the same entries recorded in a ChangeSet, streamed through one buffered writer
+static void BM_ConfNative(benchmark::State& state) {
+    const int          count = static_cast<int>(state.range(0));
+    const auto         out   = scratch().root / "native.conf";
+
+    hyprlua::ChangeSet changes;
+    for (int i = 0; i < count; ++i) {
+        changes.monitors.push_back(std::make_shared<hyprlua::MonitorSpec>(*hyprlua::parse_monitor_line(monitor_line(i))));
+        changes.binds.push_back(*hyprlua::parse_bind_line(bind_line(i)));
+    }
+
+    std::vector<char> buffer(1 << 16);
+    for (auto _ : state) {
+        std::ofstream file;
+        file.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        file.open(out, std::ios::trunc | std::ios::binary);
+        benchmark::DoNotOptimize(hyprlua::write_conf(changes, file));
+    }
+    state.counters["entries"] = 2.0 * count;
+}
+BENCHMARK(BM_ConfNative)->Arg(1000)->Arg(5000)->Unit(benchmark::kMillisecond);
+
+/// @brief hyprlua-compile end to end: run a generated hyprland.lua in record mode and write the result
+static void BM_CompileConfig(benchmark::State& state) {
+    const int  count  = static_cast<int>(state.range(0));
+    const auto config = scratch().root / std::format("hyprland-{}.lua", count);
+    const auto out    = scratch().root / "compiled.conf";
+    {
+        std::ofstream lua(config);
+        for (int i = 0; i < count; ++i) {
+            lua << "hypr.monitors.add(\"OUT-" << i << "\", \"1920x1080@60\", \"" << i * 1920 << "x0\", 1)\n";
+            lua << "hypr.binds.set(\"SUPER\", \"code:" << i << "\", \"workspace\", \"" << i + 1 << "\")\n";
+        }
+    }
+
+    for (auto _ : state) {
+        auto changes = hyprlua::record_config(RUNTIME, config.string());
+        if (!changes) {
+            state.SkipWithError("config failed");
+            break;
+        }
+        std::ofstream file(out, std::ios::trunc | std::ios::binary);
+        benchmark::DoNotOptimize(hyprlua::write_conf(*changes, file));
+    }
+    state.counters["entries"] = 2.0 * count;
+}
+BENCHMARK(BM_CompileConfig)->Arg(1000)->Arg(5000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,43 @@
+// legacy_logger.hpp
+// The synchronous logger hyprlua used before logger.hpp became asynchronous,
+// kept only as a baseline for logger_bench.cpp.
+#pragma once
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+
+namespace legacy::log {
+
+    inline std::ofstream& stream() {
+        static std::ofstream file("/tmp/hyprlua-bench-legacy.log", std::ios::app);
+        return file;
+    }
+
+    inline std::string timestamp() {
+        auto               now = std::chrono::system_clock::now();
+        auto               t_c = std::chrono::system_clock::to_time_t(now);
+        std::ostringstream ss;
+        ss << std::put_time(std::localtime(&t_c), "%Y-%m-%d %H:%M:%S");
+        return ss.str();
+    }
+
+    inline void write(const std::string& level, const std::string& message) {
+        static std::mutex           mtx;
+        std::lock_guard<std::mutex> lock(mtx);
+        stream() << "[" << timestamp() << "] [" << level << "] " << message << std::endl;
+    }
+
+    inline void info(const std::string& message) {
+        write("INFO", message);
+    }
+
+    inline void debug(const std::string& message) {
+        write("DEBUG", message);
+    }
+
+} // namespace legacy::log
@@ -0,0 +1,90 @@
+// logger_bench.cpp
+// Per-call cost of the asynchronous logger against the previous synchronous one.
+#include "logger.hpp"
+#include "legacy_logger.hpp"
+
+#include <benchmark/benchmark.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    const std::string        NAME       = "DP-2";
+    const std::string        RESOLUTION = "1920x1200";
+    const std::string        POSITION   = "0x0";
+    const std::vector<double> WORKSPACES = {1, 2, 3};
+
+    void setup_async(const benchmark::State& state, hyprlua::log::Level level) {
+        if (state.thread_index() == 0) {
+            hyprlua::log::setPath("/tmp/hyprlua-bench-async.log");
+            hyprlua::log::setLevel(level);
+            hyprlua::log::init();
+        }
+    }
+
+    void report_drops(benchmark::State& state, uint64_t before) {
+        if (state.thread_index() == 0) {
+            hyprlua::log::flush();
+            state.counters["dropped"] = static_cast<double>(hyprlua::log::dropped() - before);
+        }
+    }
+
+}
+
+/// @brief Old logger: mutex, localtime, ostringstream and std::endl per line
+static void BM_LegacyInfo(benchmark::State& state) {
+    for (auto _ : state) {
+        legacy::log::info("Monitor rule applied: " + NAME);
+    }
+}
+BENCHMARK(BM_LegacyInfo)->Threads(1)->Threads(4);
+
+/// @brief New logger: format into a ring slot, written by the background thread
+static void BM_AsyncInfo(benchmark::State& state) {
+    setup_async(state, hyprlua::log::Level::Info);
+    const auto before = hyprlua::log::dropped();
+    for (auto _ : state) {
+        hyprlua::log::info("Monitor rule applied: {}", NAME);
+    }
+    report_drops(state, before);
+}
+BENCHMARK(BM_AsyncInfo)->Threads(1)->Threads(4);
+
+/// @brief Old add_monitor debug dump, built and written whether or not anyone reads it
+static void BM_LegacyDebugDump(benchmark::State& state) {
+    for (auto _ : state) {
+        std::ostringstream debugLog;
+        debugLog << "Add Monitor:\n"
+                 << "  Name:       " << NAME << "\n"
+                 << "  Resolution: " << RESOLUTION << "\n"
+                 << "  Position:   " << POSITION << "\n"
+                 << "  Scale:      " << 1.0 << "\n";
+        debugLog << "  Workspaces: ";
+        for (const auto& w : WORKSPACES)
+            debugLog << w << " ";
+        debugLog << "\n";
+        legacy::log::debug(debugLog.str());
+    }
+}
+BENCHMARK(BM_LegacyDebugDump);
+
+/// @brief New debug call while the runtime level is info: must not format anything
+static void BM_AsyncDebugDisabled(benchmark::State& state) {
+    setup_async(state, hyprlua::log::Level::Info);
+    for (auto _ : state) {
+        hyprlua::log::debug("Add Monitor: name={} resolution={} position={} scale={}", NAME, RESOLUTION, POSITION, 1.0);
+    }
+}
+BENCHMARK(BM_AsyncDebugDisabled);
+
+/// @brief New debug call with debug enabled
+static void BM_AsyncDebugEnabled(benchmark::State& state) {
+    setup_async(state, hyprlua::log::Level::Debug);
+    const auto before = hyprlua::log::dropped();
+    for (auto _ : state) {
+        hyprlua::log::debug("Add Monitor: name={} resolution={} position={} scale={}", NAME, RESOLUTION, POSITION, 1.0);
+    }
+    report_drops(state, before);
+}
+BENCHMARK(BM_AsyncDebugEnabled);
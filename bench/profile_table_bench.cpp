@@ -0,0 +1,78 @@
+// profile_table_bench.cpp
+// Cost of one profiler sample: the fixed-size call tree against folding each stack into a string key.
+#include "lua/profile_table.hpp"
+
+#include <benchmark/benchmark.h>
+#include <format>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace hyprlua;
+
+namespace {
+
+    constexpr size_t DEPTH  = 12;
+    constexpr size_t STACKS = 256;
+
+    /// @brief Names outliving the frames that view them
+    struct Stacks {
+        std::vector<std::string>               names;
+        std::vector<std::vector<ProfileFrame>> stacks;
+    };
+
+    /// @brief STACKS stacks of DEPTH frames sharing their outer callers, like a config's callbacks do
+    const Stacks& stacks() {
+        static const Stacks s = [] {
+            Stacks out;
+            out.names.reserve(64);
+            for (int i = 0; i < 64; ++i) {
+                out.names.push_back(std::format("fn_{}", i));
+            }
+            std::mt19937 rng(7);
+            for (size_t i = 0; i < STACKS; ++i) {
+                auto& stack = out.stacks.emplace_back();
+                for (size_t d = 0; d < DEPTH; ++d) {
+                    // Outer frames vary little, inner frames a lot
+                    const size_t spread = 1 + (DEPTH - d) * 4;
+                    const size_t pick   = rng() % spread;
+                    stack.push_back({out.names[pick % out.names.size()], d < 4 ? "hyprland.lua" : "lib/util.lua", static_cast<int32_t>(10 + pick), static_cast<int32_t>(pick)});
+                }
+            }
+            return out;
+        }();
+        return s;
+    }
+
+}
+
+/// @brief Each sample folded into its "a;b;c" key and counted in a hash map, as a simple profiler would
+static void BM_ProfileFoldedStrings(benchmark::State& state) {
+    const auto&                               s = stacks();
+    std::unordered_map<std::string, uint64_t> counts;
+    size_t                                    i = 0;
+    for (auto _ : state) {
+        const auto& stack = s.stacks[i++ % STACKS];
+        std::string key;
+        for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+            key += std::format("{} ({}:{});", it->function, it->source, it->line);
+        }
+        ++counts[key];
+    }
+    benchmark::DoNotOptimize(counts.size());
+}
+BENCHMARK(BM_ProfileFoldedStrings);
+
+/// @brief Each sample merged into the ProfileTable's call tree
+static void BM_ProfileTable(benchmark::State& state) {
+    const auto&  s = stacks();
+    ProfileTable table;
+    size_t       i = 0;
+    for (auto _ : state) {
+        table.record(s.stacks[i++ % STACKS]);
+    }
+    benchmark::DoNotOptimize(table.samples());
+    state.counters["dropped"] = static_cast<double>(table.dropped());
+}
+BENCHMARK(BM_ProfileTable);
@@ -0,0 +1,324 @@
+// runtime_bench.cpp
+// Runtime init, reloads and monitor rule application against the compositor stand-in.
+#include "eventloop.hpp"
+#include "globals.hpp"
+#include "logger.hpp"
+#include "utils.hpp"
+#include "lua/binds.hpp"
+#include "lua/changeset.hpp"
+#include "lua/monitors.hpp"
+#include "lua/runtime.hpp"
+#include "lua/watchdog.hpp"
+#include "standin.hpp"
+
+#include <benchmark/benchmark.h>
+#include <any>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <wayland-server-core.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+    /// @brief Stand-in compositor with an event loop, and a scratch directory for configs
+    struct Environment {
+        fs::path       root;
+        wl_event_loop* loop = nullptr;
+
+        Environment() {
+            root = fs::temp_directory_path() / ("hyprlua-runtime-bench-" + std::to_string(getpid()));
+            fs::create_directories(root);
+            setenv("XDG_CACHE_HOME", (root / "cache").c_str(), 1);
+
+            hyprlua::log::setLevel(hyprlua::log::Level::Off);
+            standin::reset();
+            loop                         = wl_event_loop_create();
+            g_pCompositor->m_wlEventLoop = loop;
+            hyprlua::eventloop::init(loop);
+
+            // Count every toast instead of holding them back
+            PHANDLE = reinterpret_cast<HANDLE>(1);
+            setNotificationRateLimit(1, 0);
+        }
+
+        ~Environment() {
+            hyprlua::eventloop::shutdown();
+            shutdownNotifications();
+            wl_event_loop_destroy(loop);
+            std::error_code ec;
+            fs::remove_all(root, ec);
+        }
+
+        /// @brief Outputs OUT-0 .. OUT-(count-1), created on first use
+        void ensureMonitors(int count) {
+            for (int i = static_cast<int>(g_pCompositor->m_realMonitors.size()); i < count; ++i) {
+                standin::addMonitor("OUT-" + std::to_string(i));
+            }
+        }
+
+        /**
+         * @brief Write a config with @p monitors monitor directives and as many binds
+         * @return Path of the config file
+         */
+        std::string writeConfig(int monitors) {
+            ensureMonitors(monitors);
+            const auto    path = root / ("hyprland-" + std::to_string(monitors) + ".lua");
+            std::ofstream out(path);
+            for (int i = 0; i < monitors; ++i) {
+                out << "hypr.monitors.add(\"OUT-" << i << "\", \"1920x1080@60\", \"" << i * 1920 << "x0\", 1, { " << i + 1 << " })\n";
+            }
+            for (int i = 0; i < monitors; ++i) {
+                out << "hypr.binds.set(\"SUPER\", \"code:" << i << "\", \"workspace\", \"" << i + 1 << "\")\n";
+            }
+            return path.string();
+        }
+
+        /// @brief Dispatch the event loop until the config loaded by init_lua_runtime() is applied
+        void waitForLoad() {
+            while (!hyprlua::config_loaded()) {
+                wl_event_loop_dispatch(loop, 10);
+            }
+        }
+
+        /// @brief Dispatch the event loop until the next "Config reloaded" toast
+        void waitForReload() {
+            const auto before = reloads();
+            while (reloads() == before) {
+                wl_event_loop_dispatch(loop, 10);
+            }
+        }
+
+        size_t reloads() const {
+            size_t count = 0;
+            for (const auto& n : standin::notifications()) {
+                count += n.text == "[Hyprlua] Config reloaded";
+            }
+            return count;
+        }
+    };
+
+    Environment& environment() {
+        static Environment env;
+        return env;
+    }
+
+    const std::string MODULES = HYPRLUA_RUNTIME_MODULES;
+
+    /// @brief N monitor specs that differ from the ones built with @p variant != 0
+    hyprlua::ChangeSet monitor_changes(int count, int variant) {
+        hyprlua::ChangeSet changes;
+        for (int i = 0; i < count; ++i) {
+            const auto line = std::format("OUT-{},{},{}x0,1", i, variant ? "2560x1440@144" : "1920x1080@60", i * 2560);
+            changes.monitors.push_back(std::make_shared<hyprlua::MonitorSpec>(*hyprlua::parse_monitor_line(line)));
+        }
+        return changes;
+    }
+
+    /// @brief N binds on distinct keys; @p variant changes their argument
+    hyprlua::ChangeSet bind_changes(int count, int variant) {
+        hyprlua::ChangeSet changes;
+        for (int i = 0; i < count; ++i) {
+            changes.binds.push_back(*hyprlua::parse_bind_line(std::format("bind = SUPER, code:{}, workspace, {}", i, i + variant)));
+        }
+        return changes;
+    }
+
+}
+
+/// @brief Cold start: fresh Lua state, modules, config with N monitor and N bind directives, built on the worker and committed
+static void BM_RuntimeInit(benchmark::State& state) {
+    auto&      env    = environment();
+    const auto config = env.writeConfig(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        hyprlua::init_lua_runtime(MODULES, config);
+        env.waitForLoad();
+        state.PauseTiming();
+        hyprlua::shutdown_lua_runtime();
+        state.ResumeTiming();
+    }
+    state.counters["directives"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_RuntimeInit)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/// @brief The part of a cold start that blocks plugin init: until init_lua_runtime() returns
+static void BM_RuntimeInitBlocking(benchmark::State& state) {
+    auto&      env    = environment();
+    const auto config = env.writeConfig(static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        hyprlua::init_lua_runtime(MODULES, config);
+        state.PauseTiming();
+        env.waitForLoad();
+        hyprlua::shutdown_lua_runtime();
+        state.ResumeTiming();
+    }
+    state.counters["directives"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_RuntimeInitBlocking)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+/// @brief Watcher-to-applied latency: build on the worker, hand over, commit (rules unchanged)
+static void BM_Reload(benchmark::State& state) {
+    auto&      env    = environment();
+    const auto config = env.writeConfig(static_cast<int>(state.range(0)));
+    hyprlua::init_lua_runtime(MODULES, config);
+    env.waitForLoad();
+
+    for (auto _ : state) {
+        hyprlua::request_reload();
+        env.waitForReload();
+    }
+
+    hyprlua::shutdown_lua_runtime();
+    state.counters["directives"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_Reload)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/// @brief Every output's rule changes on every commit
+static void BM_CommitMonitorsChanged(benchmark::State& state) {
+    auto&      env   = environment();
+    const int  count = static_cast<int>(state.range(0));
+    env.ensureMonitors(count);
+    const auto a = monitor_changes(count, 0);
+    const auto b = monitor_changes(count, 1);
+
+    const auto before = standin::rulesApplied();
+    bool       flip   = false;
+    for (auto _ : state) {
+        hyprlua::modules::commit_monitors(flip ? b : a);
+        flip = !flip;
+    }
+    state.counters["applied/commit"] = static_cast<double>(standin::rulesApplied() - before) / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_CommitMonitorsChanged)->Arg(10)->Arg(100)->Arg(1000);
+
+/// @brief Re-committing the same rules: the diff skips every output
+static void BM_CommitMonitorsUnchanged(benchmark::State& state) {
+    auto&      env   = environment();
+    const int  count = static_cast<int>(state.range(0));
+    env.ensureMonitors(count);
+    const auto a = monitor_changes(count, 0);
+    hyprlua::modules::commit_monitors(a);
+
+    const auto before = standin::rulesApplied();
+    for (auto _ : state) {
+        hyprlua::modules::commit_monitors(a);
+    }
+    state.counters["applied/commit"] = static_cast<double>(standin::rulesApplied() - before) / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_CommitMonitorsUnchanged)->Arg(10)->Arg(100)->Arg(1000);
+
+/// @brief Every bind changes on every commit: one remove and one add each
+static void BM_CommitBindsChanged(benchmark::State& state) {
+    environment();
+    const int  count = static_cast<int>(state.range(0));
+    const auto a     = bind_changes(count, 0);
+    const auto b     = bind_changes(count, 1);
+
+    hyprlua::modules::BindCallbacks callbacks;
+    const auto                      before = standin::keybindCalls();
+    bool                            flip   = false;
+    for (auto _ : state) {
+        hyprlua::modules::commit_binds(flip ? b : a, callbacks);
+        flip = !flip;
+    }
+    state.counters["calls/commit"] = static_cast<double>(standin::keybindCalls() - before) / static_cast<double>(state.iterations());
+    hyprlua::modules::remove_binds();
+}
+BENCHMARK(BM_CommitBindsChanged)->Arg(10)->Arg(100)->Arg(1000);
+
+/// @brief Re-committing the same binds: nothing reaches the keybind manager
+static void BM_CommitBindsUnchanged(benchmark::State& state) {
+    environment();
+    const int  count = static_cast<int>(state.range(0));
+    const auto a     = bind_changes(count, 0);
+    hyprlua::modules::BindCallbacks callbacks;
+    hyprlua::modules::commit_binds(a, callbacks);
+
+    const auto before = standin::keybindCalls();
+    for (auto _ : state) {
+        hyprlua::modules::commit_binds(a, callbacks);
+    }
+    state.counters["calls/commit"] = static_cast<double>(standin::keybindCalls() - before) / static_cast<double>(state.iterations());
+    hyprlua::modules::remove_binds();
+}
+BENCHMARK(BM_CommitBindsUnchanged)->Arg(10)->Arg(100)->Arg(1000);
+
+/// @brief Key press on a bind to a Lua function: dispatcher lookup, id parse, protected call
+static void BM_LuaBindDispatch(benchmark::State& state) {
+    auto&      env  = environment();
+    const auto path = env.root / "lua-bind.lua";
+    std::ofstream(path) << "local presses = 0\nhypr.binds.set(\"SUPER\", \"x\", function() presses = presses + 1 end)\n";
+    hyprlua::init_lua_runtime(MODULES, path.string());
+    env.waitForLoad();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(standin::dispatch("hyprlua", "0"));
+    }
+
+    hyprlua::shutdown_lua_runtime();
+}
+BENCHMARK(BM_LuaBindDispatch);
+
+/**
+ * @brief Cost per compositor event with N hypr.on subscribers, delivery included
+ * @details Events are emitted in bursts of 64 and delivered in one batch per burst,
+ *          as happens when they arrive within one event loop iteration
+ */
+static void BM_EventOverhead(benchmark::State& state) {
+    auto&      env  = environment();
+    const auto path = env.root / "events.lua";
+    {
+        std::ofstream out(path);
+        out << "local seen = 0\n";
+        for (int i = 0; i < state.range(0); ++i) {
+            out << "hypr.on(\"activeWindow\", function(events) seen = seen + #events end)\n";
+        }
+    }
+    hyprlua::init_lua_runtime(MODULES, path.string());
+    env.waitForLoad();
+
+    auto window     = std::make_shared<CWindow>();
+    window->m_title = "foot";
+    window->m_class = "foot";
+
+    int64_t burst = 0;
+    for (auto _ : state) {
+        standin::emit("activeWindow", std::any(window));
+        if (++burst % 64 == 0) {
+            wl_event_loop_dispatch(env.loop, 0);
+        }
+    }
+    wl_event_loop_dispatch(env.loop, 0);
+
+    hyprlua::shutdown_lua_runtime();
+    state.counters["subscribers"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_EventOverhead)->Arg(0)->Arg(1)->Arg(50);
+
+/**
+ * @brief A tight arithmetic and table loop with the budget hook off (0) and on (1)
+ * @details The loop is the worst case for the hook: nothing but VM instructions,
+ *          so the difference between the two is the whole cost of the clock reads.
+ */
+static void BM_WatchdogOverhead(benchmark::State& state) {
+    sol::state lua;
+    lua.open_libraries(sol::lib::base);
+    if (state.range(0)) {
+        hyprlua::modules::install_watchdog(lua.lua_state());
+    }
+    sol::protected_function loop = lua.load("local t, s = {}, 0 for i = 1, 100000 do t[i % 64] = i; s = s + t[i % 64] end return s");
+
+    for (auto _ : state) {
+        hyprlua::modules::Budget budget(lua.lua_state(), hyprlua::modules::BudgetKind::Callback);
+        benchmark::DoNotOptimize(loop().valid());
+    }
+    state.counters["hook"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_WatchdogOverhead)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
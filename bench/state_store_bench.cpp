@@ -0,0 +1,94 @@
+// state_store_bench.cpp
+// Keeping state across a reload: the store against writing it to a text file and parsing it back, as configs do today.
+#include "lua/state_store.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <format>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+using namespace hyprlua;
+
+namespace {
+
+    constexpr size_t KEYS = 1000;
+
+    std::string      bench_path(const char* name) {
+        return std::format("/tmp/hyprlua-store-bench-{}-{}", getpid(), name);
+    }
+
+    std::string key(size_t i) {
+        return std::format("key_{}", i);
+    }
+
+}
+
+/// @brief One change: rewrite every key as "key=value" lines, then read and parse the file back on reload
+static void BM_StoreTextFile(benchmark::State& state) {
+    const auto                                   path = bench_path("text");
+    std::unordered_map<std::string, std::string> values;
+    for (size_t i = 0; i < KEYS; ++i) {
+        values[key(i)] = std::to_string(i);
+    }
+    size_t n = 0;
+    for (auto _ : state) {
+        values[key(n % KEYS)] = std::to_string(n);
+        ++n;
+        {
+            std::ofstream out(path, std::ios::trunc);
+            for (const auto& [k, v] : values) {
+                out << k << '=' << v << '\n';
+            }
+        }
+
+        std::unordered_map<std::string, std::string> loaded;
+        std::ifstream                                in(path);
+        std::string                                  line;
+        while (std::getline(in, line)) {
+            const auto eq = line.find('=');
+            loaded.emplace(line.substr(0, eq), line.substr(eq + 1));
+        }
+        benchmark::DoNotOptimize(loaded.size());
+    }
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_StoreTextFile);
+
+/// @brief One change and the read after a reload, served from the store
+static void BM_StoreSetGet(benchmark::State& state) {
+    StateStore store;
+    for (size_t i = 0; i < KEYS; ++i) {
+        store.set(key(i), static_cast<int64_t>(i));
+    }
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < KEYS; ++i) {
+        keys.push_back(key(i));
+    }
+    size_t n = 0;
+    for (auto _ : state) {
+        const auto& k = keys[n % KEYS];
+        store.set(k, static_cast<int64_t>(++n));
+        benchmark::DoNotOptimize(store.get(k));
+    }
+}
+BENCHMARK(BM_StoreSetGet);
+
+/// @brief A compositor restart with persistence on: write the snapshot, then map and decode it
+static void BM_StoreSnapshot(benchmark::State& state) {
+    const auto path = bench_path("snapshot");
+    StateStore store;
+    for (size_t i = 0; i < KEYS; ++i) {
+        store.set(key(i), static_cast<int64_t>(i));
+    }
+    for (auto _ : state) {
+        store.save(path);
+        StateStore loaded;
+        benchmark::DoNotOptimize(loaded.load(path));
+    }
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_StoreSnapshot);
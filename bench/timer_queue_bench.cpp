@@ -0,0 +1,68 @@
+// timer_queue_bench.cpp
+// Scheduling and cancelling a config's worth of Lua timers on the stand-in event loop:
+// one wl_event_loop timer each, against the TimerQueue's heap behind a single timer.
+#include "eventloop.hpp"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <vector>
+#include <wayland-server-core.h>
+
+namespace {
+
+    /// @brief Delays spread over a few seconds, as polling and deferred setup timers are
+    std::vector<int> delays(size_t count) {
+        std::mt19937                       rng(3);
+        std::uniform_int_distribution<int> pick(1, 5000);
+        std::vector<int>                   out(count);
+        for (auto& delay : out) {
+            delay = pick(rng);
+        }
+        return out;
+    }
+
+    /// @brief The event loop timers are created on; shared by the benchmarks in this file
+    void ensure_loop() {
+        static wl_event_loop* loop = [] {
+            auto* l = wl_event_loop_create();
+            hyprlua::eventloop::init(l);
+            return l;
+        }();
+        benchmark::DoNotOptimize(loop);
+    }
+
+}
+
+/// @brief A timer source per Lua timer: a timerfd, an epoll registration and a settime each
+static void BM_TimersSourceEach(benchmark::State& state) {
+    ensure_loop();
+    const auto list = delays(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::vector<std::unique_ptr<hyprlua::eventloop::Timer>> timers;
+        timers.reserve(list.size());
+        for (const int delay : list) {
+            timers.push_back(std::make_unique<hyprlua::eventloop::Timer>([] {}));
+            timers.back()->arm(delay);
+        }
+        // A reload cancels them all
+        timers.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TimersSourceEach)->Arg(10)->Arg(1000);
+
+/// @brief The TimerQueue: a heap push per timer, the one timer re-armed only for a new earliest deadline
+static void BM_TimersQueue(benchmark::State& state) {
+    ensure_loop();
+    const auto                     list = delays(static_cast<size_t>(state.range(0)));
+    hyprlua::eventloop::TimerQueue queue;
+    for (auto _ : state) {
+        for (const int delay : list) {
+            queue.schedule(delay, [] {});
+        }
+        queue.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TimersQueue)->Arg(10)->Arg(1000);
@@ -0,0 +1,53 @@
+// watcher_bench.cpp
+// Time from a write to the watched file until the change callback runs.
+#include "watcher.hpp"
+
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using Clock  = std::chrono::steady_clock;
+
+/// @brief Write-to-callback latency, including hashing the saved file
+static void BM_WatcherEventLatency(benchmark::State& state) {
+    const fs::path directory = fs::temp_directory_path() / ("hyprlua-watcher-bench-" + std::to_string(getpid()));
+    fs::create_directories(directory);
+    const std::string filepath = (directory / "hyprland.lua").string();
+    std::ofstream(filepath) << "-- initial\n";
+
+    std::mutex              mtx;
+    std::condition_variable cv;
+    uint64_t                events = 0;
+    Clock::time_point       eventTime;
+
+    FileWatcher             watcher(filepath, [&](const std::string&) {
+        std::lock_guard<std::mutex> lock(mtx);
+        eventTime = Clock::now();
+        ++events;
+        cv.notify_one();
+    });
+    watcher.start();
+
+    for (auto _ : state) {
+        std::unique_lock<std::mutex> lock(mtx);
+        const uint64_t               seen = events;
+        const auto                   start = Clock::now();
+        std::ofstream(filepath) << "-- change " << seen << "\n";
+        if (!cv.wait_for(lock, std::chrono::seconds(2), [&] { return events != seen; })) {
+            state.SkipWithError("no change event within 2s");
+            break;
+        }
+        state.SetIterationTime(std::chrono::duration<double>(eventTime - start).count());
+    }
+
+    watcher.stop();
+    std::error_code ec;
+    fs::remove_all(directory, ec);
+}
+BENCHMARK(BM_WatcherEventLatency)->UseManualTime()->Iterations(10)->Unit(benchmark::kMicrosecond);
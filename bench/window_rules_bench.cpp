@@ -0,0 +1,145 @@
+// window_rules_bench.cpp
+// Matching 10k windows opened in the stand-in against a 500-rule set: every rule's
+// regexes per window, against the RuleSet with its literal matchers and class index.
+#include "lua/window_rules.hpp"
+#include "standin.hpp"
+
+#include <benchmark/benchmark.h>
+#include <array>
+#include <format>
+#include <optional>
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace hyprlua;
+
+namespace {
+
+    constexpr int RULES   = 500;
+    constexpr int WINDOWS = 10000;
+
+    /// @brief Patterns of one rule, by RuleField
+    using Patterns = std::array<std::string, RULE_FIELD_COUNT>;
+
+    /**
+     * @brief A rule set shaped like a large real config
+     * @details Mostly exact classes, some with a title pattern as well, plus rules on
+     *          the initial class and rules that only look at the title
+     */
+    std::vector<Patterns> rule_patterns() {
+        std::vector<Patterns> out;
+        for (int i = 0; i < RULES; ++i) {
+            Patterns p;
+            if (i % 10 < 7) {
+                p[static_cast<size_t>(RuleField::Class)] = std::format("^(app-{})$", i);
+                if (i % 3 == 0) {
+                    p[static_cast<size_t>(RuleField::Title)] = std::format("^(Dialog|Settings) {}", i % 7);
+                }
+            } else if (i % 10 < 9) {
+                p[static_cast<size_t>(RuleField::InitialClass)] = std::format("^tool-{}$", i);
+            } else {
+                p[static_cast<size_t>(RuleField::Title)] = std::format(".* - Project {}$", i);
+            }
+            out.push_back(std::move(p));
+        }
+        return out;
+    }
+
+    /// @brief WINDOWS windows in the stand-in compositor; about half have a class some rule names
+    const std::vector<PHLWINDOW>& windows() {
+        static const std::vector<PHLWINDOW> list = [] {
+            standin::reset();
+            std::vector<PHLWINDOW> out;
+            for (int i = 0; i < WINDOWS; ++i) {
+                const int app = i % (2 * RULES);
+                out.push_back(standin::addWindow(i % 10 < 8 ? std::format("app-{}", app) : std::format("tool-{}", app),
+                                                 i % 5 == 0 ? std::format("Settings {}", i % 7) : std::format("notes.txt - Project {}", i % RULES)));
+            }
+            return out;
+        }();
+        return list;
+    }
+
+    WindowFields fields_of(const CWindow& window) {
+        return {{window.m_class, window.m_title, window.m_initialClass, window.m_initialTitle}};
+    }
+
+}
+
+/// @brief Every rule against every window, each pattern a std::regex compiled once
+static void BM_RulesRegexPerRule(benchmark::State& state) {
+    std::vector<std::array<std::optional<std::regex>, RULE_FIELD_COUNT>> rules;
+    for (const auto& patterns : rule_patterns()) {
+        auto& rule = rules.emplace_back();
+        for (size_t f = 0; f < RULE_FIELD_COUNT; ++f) {
+            if (!patterns[f].empty()) {
+                rule[f].emplace(patterns[f], std::regex::ECMAScript | std::regex::optimize);
+            }
+        }
+    }
+    const auto& list = windows();
+
+    uint64_t    matched = 0;
+    for (auto _ : state) {
+        for (const auto& window : list) {
+            const auto fields = fields_of(*window);
+            for (const auto& rule : rules) {
+                bool match = true;
+                for (size_t f = 0; f < RULE_FIELD_COUNT && match; ++f) {
+                    match = !rule[f] || std::regex_search(fields.values[f].begin(), fields.values[f].end(), *rule[f]);
+                }
+                matched += match;
+            }
+        }
+    }
+    benchmark::DoNotOptimize(matched);
+    state.counters["windows/s"] = benchmark::Counter(static_cast<double>(state.iterations()) * WINDOWS, benchmark::Counter::kIsRate);
+    state.counters["checked"]   = RULES;
+}
+BENCHMARK(BM_RulesRegexPerRule)->Unit(benchmark::kMillisecond);
+
+/// @brief The RuleSet: plain-text patterns compared as text, rules with an exact class only checked against that class
+static void BM_RulesIndexed(benchmark::State& state) {
+    std::vector<WindowRuleSpec> specs;
+    for (const auto& patterns : rule_patterns()) {
+        auto& spec = specs.emplace_back();
+        for (size_t f = 0; f < RULE_FIELD_COUNT; ++f) {
+            spec.fields[f] = *Matcher::compile(patterns[f]);
+        }
+        spec.actions.push_back(*parse_rule_action("float"));
+    }
+    const RuleSet rules(std::move(specs));
+    const auto&   list = windows();
+
+    std::vector<uint32_t> matched;
+    uint64_t              total = 0;
+    for (auto _ : state) {
+        for (const auto& window : list) {
+            rules.match(fields_of(*window), matched);
+            total += matched.size();
+        }
+    }
+    benchmark::DoNotOptimize(total);
+    state.counters["windows/s"] = benchmark::Counter(static_cast<double>(state.iterations()) * WINDOWS, benchmark::Counter::kIsRate);
+    state.counters["checked"]   = static_cast<double>(rules.checked()) / (static_cast<double>(state.iterations()) * WINDOWS);
+}
+BENCHMARK(BM_RulesIndexed)->Unit(benchmark::kMillisecond);
+
+/// @brief Compiling the rule set, as a config load does; repeated patterns come from the shared regex cache
+static void BM_RulesCompile(benchmark::State& state) {
+    const auto patterns = rule_patterns();
+    for (auto _ : state) {
+        std::vector<WindowRuleSpec> specs;
+        specs.reserve(patterns.size());
+        for (const auto& p : patterns) {
+            auto& spec = specs.emplace_back();
+            for (size_t f = 0; f < RULE_FIELD_COUNT; ++f) {
+                spec.fields[f] = *Matcher::compile(p[f]);
+            }
+        }
+        benchmark::DoNotOptimize(RuleSet(std::move(specs)));
+    }
+    state.counters["rules"] = RULES;
+}
+BENCHMARK(BM_RulesCompile)->Unit(benchmark::kMicrosecond);
@@ -10,9 +10,10 @@ hyprlua.general.setup({
 })
 
 hyprlua.decoration.setup({
-	shadow_offset = false,
-	shadow_ignore_window = false,
-	drop_shadow = false,
+	rounding = 8,
+	shadow = {
+		enabled = false,
+	},
 })
 
 hyprlua.binds.set("SUPER SHIFT", "h", "resizeactive", "-50 0", { flags = "e" })
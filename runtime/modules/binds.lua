@@ -0,0 +1,86 @@
+--- Binds Module
+--- @module binds
+--- Collects keybinds during a config run; they are applied as one batch afterwards.
+--- On reload only binds whose modifiers and key gained, lost or changed a bind are touched.
+
+local M = {}
+
+-- Submap that binds are added to, set by M.submap
+local _submap = nil
+
+--- Adds a keybind.
+--- The dispatcher may be a Lua function, which is then called on every press:
+---   hypr.binds.set("SUPER", "x", function() ... end, { flags = "e" })
+--- @param mods string: Modifiers separated by spaces or '+' (e.g. "SUPER SHIFT"), "" for none
+--- @param key string: Key name (e.g. "h", "Return", "mouse:272"), "code:<keycode>" or "catchall"
+--- @param dispatcher string|function: Hyprland dispatcher (e.g. "exec", "workspace", "resizeactive") or a Lua function
+--- @param arg string|number: Optional dispatcher argument; not used with a Lua function
+--- @param opts table: Optional { flags = string, description = string, submap = string }
+---   flags: Hyprland's bind flag letters, e.g. "e" for repeat or "l" for locked
+function M.set(mods, key, dispatcher, arg, opts)
+	if type(dispatcher) == "function" and type(arg) == "table" and opts == nil then
+		arg, opts = nil, arg
+	end
+	opts = opts or {}
+	assert(type(opts) == "table", "Options must be a table")
+
+	-- luacheck: push ignore 113
+	local err = __hypr_add_bind({
+		mods = mods,
+		key = key,
+		dispatcher = dispatcher,
+		arg = arg,
+		flags = opts.flags,
+		description = opts.description,
+		submap = opts.submap or _submap,
+	})
+	-- luacheck: pop
+	if err then
+		error(err, 2)
+	end
+end
+
+--- Adds many keybinds with one call into the runtime.
+--- Each entry is a table { mods, key, dispatcher, arg, flags = ..., description = ..., submap = ... }
+--- or a Hyprland bind line such as "binde = SUPER SHIFT, h, resizeactive, -50 0".
+--- Inside M.submap, entries without a submap of their own go to that submap.
+--- @param list table: List of binds
+function M.set_many(list)
+	assert(type(list) == "table", "Binds must be a list")
+
+	-- luacheck: push ignore 113
+	local err = __hypr_add_binds(list, _submap)
+	-- luacheck: pop
+	if err then
+		error(err, 2)
+	end
+end
+
+--- Adds the binds created by fn to a submap.
+--- @param name string: Submap name, entered with the "submap" dispatcher
+--- @param fn function: Calls M.set / M.set_many for the binds of the submap
+function M.submap(name, fn)
+	assert(type(name) == "string" and name ~= "", "Submap name must be a non-empty string")
+	assert(type(fn) == "function", "Submap body must be a function")
+
+	local previous = _submap
+	_submap = name
+	local ok, err = pcall(fn)
+	_submap = previous
+	if not ok then
+		error(err, 0)
+	end
+end
+
+--- Returns how many binds were added, removed and left unchanged by reloads.
+--- @return table: { added = number, removed = number, unchanged = number }
+function M.stats()
+	-- luacheck: push ignore 113
+	return __hypr_bind_stats()
+	-- luacheck: pop
+end
+
+-- luacheck: push ignore 112
+hypr.binds = M
+-- luacheck: pop
+return M
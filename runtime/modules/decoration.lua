@@ -0,0 +1,30 @@
+--- Decoration Module
+--- @module decoration
+--- Options of Hyprland's decoration section: rounding, opacity, blur and shadows.
+
+local M = {}
+
+--- Sets decoration options; keys are Hyprland's option names in that section.
+--- Nested tables are subcategories: blur = { size = 4 } sets decoration:blur:size.
+--- Booleans are written as 0 or 1. All options of one config are applied
+--- together once it ran: unchanged ones are skipped and the layout is
+--- recalculated once, not per option. Unknown options are reported when the
+--- config is applied. An option a reloaded config no longer sets goes back to
+--- the value it had before hyprlua first set it.
+--- @param opts table: option names to values, e.g.
+---   hypr.decoration.setup({ rounding = 8, active_opacity = 0.95, blur = { enabled = true, size = 4 } })
+function M.setup(opts)
+	assert(type(opts) == "table", "Options must be a table")
+
+	-- luacheck: push ignore 113
+	local err = __hypr_set_options("decoration", opts)
+	-- luacheck: pop
+	if err then
+		error(err, 2)
+	end
+end
+
+-- luacheck: push ignore 112
+hypr.decoration = M
+-- luacheck: pop
+return M
@@ -0,0 +1,40 @@
+--- Events Module
+--- @module events
+--- Runs Lua functions when the compositor reports events.
+--- Events are queued and handed over in batches: a handler gets every event
+--- that arrived since its last call, as a list, in one call.
+
+local M = {}
+
+--- Calls fn with a batch of events each time event fires.
+--- Only events with at least one handler are hooked at all.
+---   hypr.on("workspace", function(events)
+---     local last = events[#events]
+---     print(last.name, last.monitor)
+---   end)
+--- @param event string: monitorAdded, monitorRemoved, focusedMon, workspace, createWorkspace,
+---   destroyWorkspace, moveWorkspace, activeWindow, openWindow, closeWindow, submap or configReloaded
+--- @param fn function: Receives a list of event tables, oldest first, each with an `event` field and
+---   name/description (monitors), name/id/monitor (workspaces), title/class/address (windows) or name (submap)
+--- @param opts table: Optional { debounce_ms = number }
+---   debounce_ms: wait until the event has been quiet this long before calling fn (default 0: once per
+---   event loop iteration). Useful for bursts such as monitor hotplugs when docking.
+function M.on(event, fn, opts)
+	opts = opts or {}
+	assert(type(event) == "string", "Event name must be a string")
+	assert(type(fn) == "function", "Handler must be a function")
+	assert(type(opts) == "table", "Options must be a table")
+
+	-- luacheck: push ignore 113
+	local err = __hypr_on(event, fn, math.floor(opts.debounce_ms or 0))
+	-- luacheck: pop
+	if err then
+		error(err, 2)
+	end
+end
+
+-- luacheck: push ignore 112
+hypr.events = M
+hypr.on = M.on
+-- luacheck: pop
+return M
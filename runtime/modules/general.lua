@@ -0,0 +1,31 @@
+--- General Module
+--- @module general
+--- Options of Hyprland's general section: gaps, borders and layout.
+
+local M = {}
+
+--- Sets general options; keys are Hyprland's option names in that section.
+--- Nested tables are subcategories, except col, whose keys are colors:
+--- col = { active_border = ... } sets general:col.active_border.
+--- Booleans are written as 0 or 1. All options of one config are applied
+--- together once it ran: unchanged ones are skipped and the layout is
+--- recalculated once, not per option. Unknown options are reported when the
+--- config is applied. An option a reloaded config no longer sets goes back to
+--- the value it had before hyprlua first set it.
+--- @param opts table: option names to values, e.g.
+---   hypr.general.setup({ gaps_in = 5, border_size = 2, col = { active_border = "rgba(33ccffee) 45deg" } })
+function M.setup(opts)
+	assert(type(opts) == "table", "Options must be a table")
+
+	-- luacheck: push ignore 113
+	local err = __hypr_set_options("general", opts)
+	-- luacheck: pop
+	if err then
+		error(err, 2)
+	end
+end
+
+-- luacheck: push ignore 112
+hypr.general = M
+-- luacheck: pop
+return M
@@ -8,34 +8,57 @@ local M = {}
 local _queue = {}
 local _disabled = {}
 
+--- Parses a monitor description into a MonitorSpec.
+--- Specs are immutable and parsed once; passing the same description again,
+--- in this run or after a reload, returns the already parsed spec.
+--- @param value table|string|MonitorSpec: Either a table
+---   { name, resolution, position, scale, transform, mirror, bitdepth, vrr, workspaces }
+---   or a Hyprland monitor line such as "DP-1, 2560x1440@144, 0x0, 1, vrr, 1"
+--- @return MonitorSpec
+function M.spec(value)
+	-- luacheck: push ignore 113
+	local spec, err = __hypr_monitor_spec(value)
+	-- luacheck: pop
+	if not spec then
+		error(err, 2)
+	end
+	return spec
+end
+
 --- Adds a monitor configuration to the apply queue.
---- @param name string: Monitor identifier (e.g. "desc:LG Electronics 0x1234")
---- @param resolution string: Monitor resolution and refresh (e.g. "1920x1080@60.00Hz")
---- @param position string: Screen position (e.g. "0x0")
---- @param scale string: Monitor scaling factor (e.g. "1.0")
---- @param workspaces table: Optional list of workspaces assigned to this monitor
+--- Accepts a MonitorSpec, a table or monitor line (see M.spec), or the positional form below.
+--- A rule for an output that is not plugged in is kept and applied when it appears.
+--- @param name string: Monitor identifier: a name ("DP-1"), a name prefix ("DP-*", every match),
+--- a description prefix ("desc:LG Electronics 0x1234", first match) or a serial ("serial:0x1234")
+--- @param resolution string: Resolution and refresh (e.g. "1920x1080@60"), or preferred, highres, highrr, maxwidth
+--- @param position string: Screen position (e.g. "0x0") or auto, auto-right, auto-left, ...
+--- @param scale number|string: Monitor scaling factor (e.g. 1.5) or "auto"
+--- @param workspaces table: Optional list of workspaces assigned to this monitor; the first is its default
 function M.add(name, resolution, position, scale, workspaces)
-	assert(type(name) == "string", "Monitor name must be a string")
-	assert(type(resolution) == "string", "Resolution must be a string")
-	assert(type(position) == "string", "Position must be a string")
-	assert(type(scale) == "number", "Scale must be a number")
-	assert(workspaces == nil or type(workspaces) == "table", "Workspaces must be a table or nil")
-
-	table.insert(_queue, {
-		name = name,
-		resolution = resolution,
-		position = position,
-		scale = scale,
-		workspaces = workspaces or {},
-	})
+	local value = name
+	if resolution ~= nil then
+		value = {
+			name = name,
+			resolution = resolution,
+			position = position,
+			scale = scale,
+			workspaces = workspaces,
+		}
+	end
 
 	-- luacheck: push ignore 113
-	if __hypr_add_monitor then
-		__hypr_add_monitor(name, resolution, position, scale, workspaces)
-		-- luacheck: pop
-	else
-		error("__hypr_add_monitor is not defined in Lua runtime")
+	local spec, err = __hypr_monitor_spec(value)
+	if not spec then
+		error(err, 2)
+	end
+
+	err = __hypr_add_monitor(spec)
+	-- luacheck: pop
+	if err then
+		error(err, 2)
 	end
+	table.insert(_queue, spec)
+	return spec
 end
 
 --- Marks a monitor for disabling.
@@ -43,15 +66,24 @@ end
 function M.disable(name)
 	assert(type(name) == "string", "Monitor name must be a string")
 
-	table.insert(_disabled, name)
-
 	-- luacheck: push ignore 113
-	if __hypr_disable_monitor then
-		__hypr_disable_monitor(name)
-		-- luacheck: pop
-	else
+	if not __hypr_disable_monitor then
 		error("__hypr_disable_monitor is not defined in Lua runtime")
 	end
+	local err = __hypr_disable_monitor(name)
+	-- luacheck: pop
+	if err then
+		error(err, 2)
+	end
+	table.insert(_disabled, name)
+end
+
+--- Returns how many monitor rules were committed, skipped as unchanged, are waiting for their output and were applied on hotplug.
+--- @return table: { applied = number, skipped = number, pending = number, hotplug = number }
+function M.stats()
+	-- luacheck: push ignore 113
+	return __hypr_monitor_stats()
+	-- luacheck: pop
 end
 
 -- luacheck: push ignore 112
@@ -0,0 +1,32 @@
+--- Notifications Module
+--- @module notifications
+--- Controls how Hyprlua's toasts are merged and rate limited.
+
+local M = {}
+
+--- Sets the notification rate limit.
+--- Repeated messages are merged while they wait, so a burst of errors shows up
+--- as one toast with a count instead of filling the screen.
+--- @param opts table: { burst = number, interval_ms = number }
+---   burst: toasts that may be shown back to back (default 3)
+---   interval_ms: time until one more toast may be shown, 0 disables the limit (default 1000)
+function M.configure(opts)
+	assert(type(opts) == "table", "Options must be a table")
+	assert(opts.burst == nil or (type(opts.burst) == "number" and opts.burst >= 1), "burst must be a number >= 1")
+	assert(
+		opts.interval_ms == nil or (type(opts.interval_ms) == "number" and opts.interval_ms >= 0),
+		"interval_ms must be a number >= 0"
+	)
+
+	-- luacheck: push ignore 113
+	local err = __hypr_configure_notifications(opts)
+	-- luacheck: pop
+	if err then
+		error(err, 2)
+	end
+end
+
+-- luacheck: push ignore 112
+hypr.notifications = M
+-- luacheck: pop
+return M
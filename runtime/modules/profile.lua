@@ -0,0 +1,31 @@
+--- Profile Module
+--- @module profile
+--- A sampling profiler showing which lines of the config and its callbacks Lua spends its time in.
+
+--- Profiles a function while it runs, or reports on the profile started with
+--- `hyprctl hyprlua profile start`.
+--- Every 1000 VM instructions the Lua stack is sampled, on every thread running Lua,
+--- so bind and event callbacks firing meanwhile are included. Time spent inside
+--- Hyprlua's C++ functions is not seen.
+--- The report has one line per distinct stack, `outer;...;inner count`, with each frame
+--- written as `function (file:line)`: the folded format flamegraph.pl, inferno and
+--- speedscope read.
+--- @usage local report = hypr.profile(require, "heavy_module")
+--- @param fn function|nil: called with the remaining arguments; its errors are raised again
+--- @return string|nil: the report, or nil when fn is nil and no profile is running
+local function profile(fn, ...)
+	assert(fn == nil or type(fn) == "function", "Argument must be a function or nil")
+
+	-- luacheck: push ignore 113
+	local report, err = __hypr_profile(fn, ...)
+	-- luacheck: pop
+	if err then
+		error(err, 2)
+	end
+	return report
+end
+
+-- luacheck: push ignore 112
+hypr.profile = profile
+-- luacheck: pop
+return profile
@@ -0,0 +1,44 @@
+--- Rules Module
+--- @module rules
+--- Window rules: actions run on windows whose class or title match.
+--- Patterns are compiled once when the config loads and matched natively; Lua
+--- only runs for rules with a when function.
+
+local M = {}
+
+--- Adds a window rule.
+--- A rule applies when every pattern it sets is found in the window's field, as in
+--- Hyprland's windowrulev2: anchor with ^ and $ to match the whole name. Rules with an
+--- exact class ("^firefox$") are only checked against windows of that class.
+--- Actions run when a window opens, and when its title changes to one the rule matches.
+---   hypr.rules.add({ class = "^firefox$", title = "^Picture-in-Picture$", actions = { "float", "pin" } })
+--- @param rule table: {
+---   class, title, initial_class, initial_title = string: patterns, at least one unless when is set
+---   actions = string or list of strings: float, tile, pin, workspace <name> [silent],
+---     size <w> <h>, move <x> <y>, opacity <alpha>
+---   when = function: Optional; receives { class, title, initial_class, initial_title, address }
+---     and returns whether the rule applies
+--- }
+function M.add(rule)
+	assert(type(rule) == "table", "Rule must be a table")
+
+	-- luacheck: push ignore 113
+	local err = __hypr_add_rule(rule)
+	-- luacheck: pop
+	if err then
+		error(err, 2)
+	end
+end
+
+--- Returns counters of the window rules since the plugin loaded.
+--- @return table: { windows = number, checked = number, applied = number, predicates = number }
+function M.stats()
+	-- luacheck: push ignore 113
+	return __hypr_rule_stats()
+	-- luacheck: pop
+end
+
+-- luacheck: push ignore 112
+hypr.rules = M
+-- luacheck: pop
+return M
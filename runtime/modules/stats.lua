@@ -0,0 +1,35 @@
+--- Stats Module
+--- @module stats
+--- Timings of Hyprlua's startup and reload phases and of the bound C++ functions,
+--- and the memory used by the config's Lua state.
+
+--- Returns the recorded timings, keyed by phase or function name
+--- (e.g. "config.user", "reload.total", "lua.__hypr_add_monitor").
+--- Durations are in microseconds; p50 and p99 are accurate to about 12%.
+--- The full garbage collection after a config run is timed as "lua.gc". Once the
+--- config is active its collector runs in steps between and during callbacks,
+--- each timed as "lua.gc.step": count, total_us and max_us are its pauses.
+--- The same data is available as JSON through `hyprctl hyprlua stats`.
+--- @return table: { [name] = { count, last_us, p50_us, p99_us, max_us, total_us } }
+local function stats()
+	-- luacheck: push ignore 113
+	return __hypr_stats()
+	-- luacheck: pop
+end
+
+--- Returns the allocation counters of this config's Lua state.
+--- Sizes are in bytes. pool_bytes is reserved for small objects; limit is set
+--- with HYPRLUA_LUA_MEMORY_MB (default 256 MiB, 0 for none) and limit_hits counts
+--- allocations it refused.
+--- @return table: { allocations, frees, bytes, peak_bytes, pool_bytes, large_bytes, limit, limit_hits }
+local function memory()
+	-- luacheck: push ignore 113
+	return __hypr_memory_stats()
+	-- luacheck: pop
+end
+
+-- luacheck: push ignore 112
+hypr.stats = stats
+hypr.memory = memory
+-- luacheck: pop
+return stats
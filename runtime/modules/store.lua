@@ -0,0 +1,97 @@
+--- Store Module
+--- @module store
+--- Values that outlive the config: they survive reloads, and compositor restarts
+--- too once persistence is on. Values are copied into the store when written;
+--- changing a table afterwards does not change the stored one, so set it again.
+--- Writes made while the config loads take effect when it is applied: a config
+--- that fails, or that a newer reload replaces first, leaves the store as it was.
+--- Until then the config itself already reads back what it wrote.
+
+local M = {}
+
+--- Returns the value stored under key, or default if there is none.
+--- Tables come back as a fresh copy each call.
+--- @param key string
+--- @param default any: Returned when nothing is stored under key
+--- @return any
+function M.get(key, default)
+	assert(type(key) == "string", "Key must be a string")
+	-- luacheck: push ignore 113
+	local value = __hypr_store_get(key)
+	-- luacheck: pop
+	if value == nil then
+		return default
+	end
+	return value
+end
+
+--- Stores value under key; nil removes the key.
+--- @param key string
+--- @param value nil|boolean|number|string|table: Tables may nest, but hold no functions, userdata or coroutines
+function M.set(key, value)
+	assert(type(key) == "string", "Key must be a string")
+	-- luacheck: push ignore 113
+	local ok, err = __hypr_store_set(key, value)
+	-- luacheck: pop
+	if not ok then
+		error(err, 2)
+	end
+end
+
+--- Returns the value under key, calling fn to compute and store it only when
+--- there is none, so reloads reuse it instead of running fn again.
+---   local layout = hypr.store.remember("layout", build_layout)
+--- @param key string
+--- @param fn function: Called with no arguments; its result is stored and returned
+--- @return any
+function M.remember(key, fn)
+	assert(type(fn) == "function", "Argument must be a function")
+	local value = M.get(key)
+	if value == nil then
+		value = fn()
+		M.set(key, value)
+	end
+	return value
+end
+
+--- Replaces the value under key with fn(value) and returns the new value.
+---   hypr.store.update("reloads", function(n) return (n or 0) + 1 end)
+--- @param key string
+--- @param fn function: Called with the stored value, or nil
+--- @return any
+function M.update(key, fn)
+	assert(type(fn) == "function", "Argument must be a function")
+	local value = fn(M.get(key))
+	M.set(key, value)
+	return value
+end
+
+--- Returns every key in the store, sorted.
+--- @return table
+function M.keys()
+	-- luacheck: push ignore 113
+	return __hypr_store_keys()
+	-- luacheck: pop
+end
+
+--- Configures persistence. Without persist, the store lives in memory only and a
+--- snapshot left by an earlier config is removed once this config is applied.
+--- @param options table: { persist = boolean, flush_ms = number }
+---   persist keeps a snapshot in $XDG_STATE_HOME/hyprlua/store.bin (HYPRLUA_STORE_PATH overrides it);
+---   flush_ms is the longest a change waits before the snapshot is rewritten (default 1000)
+function M.configure(options)
+	assert(type(options) == "table", "Options must be a table")
+	assert(options.persist == nil or type(options.persist) == "boolean", "persist must be a boolean")
+	assert(options.flush_ms == nil or (type(options.flush_ms) == "number" and options.flush_ms >= 0), "flush_ms must be a number >= 0")
+	-- luacheck: push ignore 113
+	local err = __hypr_configure_store(options)
+	-- luacheck: pop
+	if err then
+		error(err, 2)
+	end
+end
+
+-- luacheck: push ignore 112
+hypr.store = M
+-- luacheck: pop
+return M
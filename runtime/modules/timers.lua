@@ -0,0 +1,89 @@
+--- Timers Module
+--- @module timers
+--- Delayed and periodic Lua on the compositor's event loop, and coroutines that sleep.
+--- Timers created while the config loads start once it is applied. Reloading the
+--- config cancels every timer of the old one, and coroutines it left sleeping
+--- are never resumed. Monitors, binds, rules, options and configure calls are
+--- only recorded while the config loads; from a timer they raise an error.
+
+local M = {}
+
+--- Runs a coroutine until it finishes or waits, raising its error if it fails.
+local function resume(co, ...)
+	local ok, err = coroutine.resume(co, ...)
+	if not ok then
+		error(err, 0)
+	end
+end
+
+--- Calls fn after ms milliseconds, and then every repeat_ms if given.
+---   local battery = hypr.timer(0, poll_battery, 30000)
+---   battery:stop()
+--- @param ms number: Delay before the first call, >= 0
+--- @param fn function: Called with no arguments under the callback time budget
+--- @param repeat_ms number|nil: Interval of the following calls; nil for a single call
+--- @return table: { stop = function } which cancels the timer, also from inside fn
+function M.timer(ms, fn, repeat_ms)
+	assert(type(ms) == "number", "Delay must be a number")
+	assert(type(fn) == "function", "Callback must be a function")
+	assert(repeat_ms == nil or type(repeat_ms) == "number", "Repeat interval must be a number")
+
+	-- luacheck: push ignore 113
+	local id, err = __hypr_timer(math.floor(ms), fn, math.floor(repeat_ms or 0))
+	if not id then
+		error(err, 2)
+	end
+	return {
+		stop = function()
+			return __hypr_timer_stop(id)
+		end,
+	}
+	-- luacheck: pop
+end
+
+--- Calls fn once the current config run or callback has finished, on the next
+--- event loop iteration.
+--- @param fn function: Called with no arguments
+--- @return table: { stop = function }
+function M.defer(fn)
+	assert(type(fn) == "function", "Callback must be a function")
+	return M.timer(0, fn)
+end
+
+--- Runs fn as a coroutine, so it can wait with hypr.sleep without blocking anything.
+--- It runs right away until its first hypr.sleep.
+---   hypr.async(function()
+---     while true do
+---       hypr.store.update("uptime_min", function(n) return (n or 0) + 1 end)
+---       hypr.sleep(60000)
+---     end
+---   end)
+--- @param fn function: Called with the remaining arguments
+function M.async(fn, ...)
+	assert(type(fn) == "function", "Argument must be a function")
+	resume(coroutine.create(fn), ...)
+end
+
+--- Waits ms milliseconds, letting the compositor and other Lua run meanwhile.
+--- Only inside hypr.async or another coroutine.
+--- @param ms number: >= 0
+function M.sleep(ms)
+	assert(type(ms) == "number", "Delay must be a number")
+	local co, main = coroutine.running()
+	if co == nil or main then
+		error("hypr.sleep can only wait inside hypr.async", 2)
+	end
+
+	M.timer(ms, function()
+		resume(co)
+	end)
+	coroutine.yield()
+end
+
+-- luacheck: push ignore 112
+hypr.timer = M.timer
+hypr.defer = M.defer
+hypr.async = M.async
+hypr.sleep = M.sleep
+-- luacheck: pop
+return M
@@ -0,0 +1,37 @@
+--- Watchdog Module
+--- @module watchdog
+--- Time budgets that stop a looping or slow script before it freezes the desktop.
+
+local M = {}
+
+--- Sets the time budgets, in milliseconds; 0 disables one.
+--- A script that runs past its budget is aborted with a traceback notification.
+--- A config that is aborted leaves the previous config applied.
+--- The budgets apply once this config is applied: reload_ms to the next reload,
+--- callback_ms to this config's callbacks. The first config run after the plugin
+--- loads comes before any config is applied, so its budget is set outside the
+--- config, with the HYPRLUA_LOAD_MS environment variable (default 1000).
+--- @param opts table: { reload_ms = number, callback_ms = number }
+---   reload_ms: a config reload, which runs in the background (default 3000)
+---   callback_ms: each bind, event, rule or timer callback (default 50)
+function M.configure(opts)
+	assert(type(opts) == "table", "Options must be a table")
+	if opts.load_ms ~= nil then
+		error("load_ms cannot be set from the config; set HYPRLUA_LOAD_MS in the environment instead", 2)
+	end
+	for _, key in ipairs({ "reload_ms", "callback_ms" }) do
+		assert(opts[key] == nil or (type(opts[key]) == "number" and opts[key] >= 0), key .. " must be a number >= 0")
+	end
+
+	-- luacheck: push ignore 113
+	local err = __hypr_configure_watchdog(opts)
+	-- luacheck: pop
+	if err then
+		error(err, 2)
+	end
+end
+
+-- luacheck: push ignore 112
+hypr.watchdog = M
+-- luacheck: pop
+return M
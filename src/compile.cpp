@@ -0,0 +1,128 @@
+// compile.cpp
+#include "logger.hpp"
+#include "paths.hpp"
+#include "lua/config_build.hpp"
+#include "lua/conf_writer.hpp"
+#include "lua/profiler.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @file compile.cpp
+ * @brief hyprlua-compile: turn a hyprland.lua into a static hyprland.conf
+ * @details Runs the config with the plugin's own bindings in record mode, exactly as
+ *          a reload would build it, and writes the recorded changes instead of
+ *          applying them. Nothing talks to a compositor.
+ */
+
+namespace fs = std::filesystem;
+
+namespace {
+    /// @brief Output buffer; the file is written in a few large writes however many lines it has
+    constexpr size_t WRITE_BUFFER = 1 << 16;
+
+    void             usage(std::ostream& out) {
+        out << "usage: hyprlua-compile [-c CONFIG] [-o OUTPUT] [-m MODULES]\n"
+               "  -c, --config   hyprland.lua to compile (default: " << hyprlua::paths::config_file() << ")\n"
+               "  -o, --output   hyprland.conf to write, - for stdout (default: hyprlua.conf)\n"
+               "  -m, --modules  Hyprlua runtime modules (default: " << hyprlua::paths::modules_dir() << ")\n"
+               "  -p, --profile  Profile the config run and write its folded stacks to this file\n";
+    }
+
+    /// @brief Write through a temporary file renamed into place, so readers never see half a config
+    bool write_file(const hyprlua::ChangeSet& changes, const std::string& path, const std::string& source, hyprlua::ConfStats& stats) {
+        const std::string tmp = path + ".tmp";
+        std::vector<char> buffer(WRITE_BUFFER);
+        std::ofstream     out;
+        out.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        out.open(tmp, std::ios::trunc | std::ios::binary);
+        if (!out) {
+            return false;
+        }
+
+        stats = hyprlua::write_conf(changes, out, source);
+        out.close();
+
+        std::error_code ec;
+        if (!out || (fs::rename(tmp, path, ec), ec)) {
+            fs::remove(tmp, ec);
+            return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string config  = hyprlua::paths::config_file();
+    std::string output  = "hyprlua.conf";
+    std::string modules = hyprlua::paths::modules_dir();
+    std::string profile;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg   = argv[i];
+        const bool             value = i + 1 < argc;
+        if ((arg == "-c" || arg == "--config") && value) {
+            config = argv[++i];
+        } else if ((arg == "-o" || arg == "--output") && value) {
+            output = argv[++i];
+        } else if ((arg == "-m" || arg == "--modules") && value) {
+            modules = argv[++i];
+        } else if ((arg == "-p" || arg == "--profile") && value) {
+            profile = argv[++i];
+        } else if (arg == "-h" || arg == "--help") {
+            usage(std::cout);
+            return 0;
+        } else {
+            usage(std::cerr);
+            return 2;
+        }
+    }
+
+    // Nobody reads the plugin's log here; its errors, such as the config's own, go to stderr
+    hyprlua::log::setPath("/dev/stderr");
+    hyprlua::log::setLevel(hyprlua::log::Level::Error);
+    hyprlua::log::init();
+
+    if (!profile.empty()) {
+        hyprlua::modules::start_profile();
+    }
+    const auto changes = hyprlua::record_config(modules, config);
+    hyprlua::log::shutdown();
+    if (const auto report = hyprlua::modules::stop_profile()) {
+        std::ofstream out(profile, std::ios::trunc);
+        out << report->folded;
+        if (!out.flush()) {
+            std::cerr << "hyprlua-compile: cannot write " << profile << "\n";
+            return 1;
+        }
+        std::cerr << "hyprlua-compile: folded stacks written to " << profile << "\n" << hyprlua::modules::profile_summary(*report) << "\n";
+    }
+    if (!changes) {
+        std::cerr << "hyprlua-compile: " << config << " failed, nothing written\n";
+        return 1;
+    }
+
+    hyprlua::ConfStats stats;
+    if (output == "-") {
+        stats = hyprlua::write_conf(*changes, std::cout, config);
+        std::cout.flush();
+    } else if (!write_file(*changes, output, config, stats)) {
+        std::cerr << "hyprlua-compile: cannot write " << output << "\n";
+        return 1;
+    }
+
+    if (stats.luaBinds > 0) {
+        std::cerr << "hyprlua-compile: " << stats.luaBinds << " binds to Lua functions were written as comments; they need the plugin\n";
+    }
+    if (stats.luaRules > 0) {
+        std::cerr << "hyprlua-compile: " << stats.luaRules << " window rules with a when function were written as comments; they need the plugin\n";
+    }
+    std::cerr << "hyprlua-compile: " << stats.options << " options, " << stats.monitors << " monitors, " << stats.workspaces << " workspace rules, " << stats.binds << " binds, " << stats.rules << " window rules\n";
+    return 0;
+}
@@ -0,0 +1,229 @@
+#include "eventloop.hpp"
+#include "logger.hpp"
+
+#include <wayland-server-core.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace hyprlua::eventloop {
+
+    namespace {
+        std::mutex        queueMutex;
+        std::vector<Task> queue;
+        int               wakeFd = -1;
+        wl_event_source*  source = nullptr;
+        wl_event_loop*    eventLoop = nullptr;
+
+        int64_t           now_ns() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        /// @brief Heap order for std::push_heap and friends: the earliest deadline on top, ties by scheduling order
+        template <typename T>
+        bool later(const T& a, const T& b) {
+            return a.dueNs != b.dueNs ? a.dueNs > b.dueNs : a.id > b.id;
+        }
+
+        /**
+         * @brief wl_event_loop callback draining the task queue
+         * @details Resets the eventfd counter first, then swaps the queue out so
+         *          tasks that post more work do not hold the lock or loop forever
+         */
+        int onWake(int fd, uint32_t /*mask*/, void* /*data*/) {
+            uint64_t count = 0;
+            if (read(fd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+                log::error("Failed to reset event loop wakeup");
+            }
+
+            std::vector<Task> tasks;
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                tasks.swap(queue);
+            }
+
+            for (auto& task : tasks) {
+                try {
+                    task();
+                } catch (const std::exception& e) { log::error("Event loop task failed: {}", e.what()); }
+            }
+            return 0;
+        }
+    }
+
+    bool init(wl_event_loop* loop) {
+        if (source) {
+            return true;
+        }
+        if (!loop) {
+            return false;
+        }
+
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeFd < 0) {
+            return false;
+        }
+
+        source = wl_event_loop_add_fd(loop, wakeFd, WL_EVENT_READABLE, &onWake, nullptr);
+        if (!source) {
+            close(wakeFd);
+            wakeFd = -1;
+            return false;
+        }
+        eventLoop = loop;
+        return true;
+    }
+
+    void shutdown() {
+        if (source) {
+            wl_event_source_remove(source);
+            source = nullptr;
+        }
+        eventLoop = nullptr;
+
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.clear();
+        if (wakeFd >= 0) {
+            close(wakeFd);
+            wakeFd = -1;
+        }
+    }
+
+    bool post(Task task) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (wakeFd < 0) {
+            return false;
+        }
+
+        // Only the first task of a batch needs to wake the compositor
+        const bool wake = queue.empty();
+        queue.push_back(std::move(task));
+        if (wake) {
+            const uint64_t one = 1;
+            if (write(wakeFd, &one, sizeof(one)) < 0) {
+                log::error("Failed to wake event loop");
+            }
+        }
+        return true;
+    }
+
+    Timer::Timer(Task task) : m_task(std::move(task)) {}
+
+    Timer::~Timer() {
+        if (m_source) {
+            wl_event_source_remove(m_source);
+        }
+    }
+
+    bool Timer::arm(int delayMs) {
+        if (!m_source) {
+            if (!eventLoop) {
+                return false;
+            }
+            m_source = wl_event_loop_add_timer(eventLoop, &Timer::onFire, this);
+            if (!m_source) {
+                return false;
+            }
+        }
+        // A delay of 0 would disarm the timer, so round up to the next millisecond
+        wl_event_source_timer_update(m_source, delayMs > 0 ? delayMs : 1);
+        return true;
+    }
+
+    void Timer::disarm() {
+        if (m_source) {
+            wl_event_source_timer_update(m_source, 0);
+        }
+    }
+
+    int Timer::onFire(void* data) {
+        auto* timer = static_cast<Timer*>(data);
+        try {
+            timer->m_task();
+        } catch (const std::exception& e) { log::error("Event loop timer failed: {}", e.what()); }
+        return 0;
+    }
+
+    TimerQueue::TimerQueue() : m_timer([this] { fire(); }) {}
+
+    TimerQueue::Id TimerQueue::schedule(int delayMs, Task task) {
+        const Id id = m_nextId++;
+        m_tasks.emplace(id, std::move(task));
+        m_heap.push_back({now_ns() + static_cast<int64_t>(std::max(delayMs, 0)) * 1000000, id});
+        std::ranges::push_heap(m_heap, later<Deadline>);
+        if (m_armedNs == 0 || m_heap.front().dueNs < m_armedNs) {
+            rearm();
+        }
+        return id;
+    }
+
+    bool TimerQueue::cancel(Id id) {
+        if (m_tasks.erase(id) == 0) {
+            return false;
+        }
+        // Rebuild rather than let cancelled deadlines pile up under a long-lived one
+        if (m_heap.size() > 64 && m_heap.size() > 2 * m_tasks.size()) {
+            std::erase_if(m_heap, [this](const Deadline& d) { return !m_tasks.contains(d.id); });
+            std::ranges::make_heap(m_heap, later<Deadline>);
+        }
+        return true;
+    }
+
+    void TimerQueue::clear() {
+        m_tasks.clear();
+        m_heap.clear();
+        m_timer.disarm();
+        m_armedNs = 0;
+    }
+
+    void TimerQueue::rearm() {
+        while (!m_heap.empty() && !m_tasks.contains(m_heap.front().id)) {
+            std::ranges::pop_heap(m_heap, later<Deadline>);
+            m_heap.pop_back();
+        }
+        if (m_heap.empty()) {
+            m_timer.disarm();
+            m_armedNs = 0;
+            return;
+        }
+
+        // Round up, so the timer never fires before the deadline it is armed for
+        const int64_t due   = m_heap.front().dueNs;
+        const int64_t delay = (std::max<int64_t>(due - now_ns(), 0) + 999999) / 1000000;
+        if (m_timer.arm(static_cast<int>(std::min<int64_t>(delay, INT32_MAX)))) {
+            m_armedNs = due;
+        }
+    }
+
+    void TimerQueue::fire() {
+        m_armedNs = 0;
+
+        // Collect what is due before running any of it: tasks may schedule or cancel timers
+        const int64_t   now = now_ns();
+        std::vector<Id> due;
+        while (!m_heap.empty() && m_heap.front().dueNs <= now) {
+            std::ranges::pop_heap(m_heap, later<Deadline>);
+            due.push_back(m_heap.back().id);
+            m_heap.pop_back();
+        }
+
+        for (const Id id : due) {
+            auto it = m_tasks.find(id);
+            if (it == m_tasks.end()) {
+                continue; // cancelled, possibly by a task of this batch
+            }
+            Task task = std::move(it->second);
+            m_tasks.erase(it);
+            try {
+                task();
+            } catch (const std::exception& e) { log::error("Timer task failed: {}", e.what()); }
+        }
+        rearm();
+    }
+
+} // namespace hyprlua::eventloop
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+struct wl_event_loop;
+struct wl_event_source;
+
+/**
+ * @file eventloop.hpp
+ * @brief Hand work from plugin threads to the compositor thread
+ * @details Tasks are queued under a short lock and run from Hyprland's
+ *          wl_event_loop through a single eventfd source. Any number of
+ *          posts made before the compositor gets to the queue cost one wakeup.
+ */
+
+namespace hyprlua::eventloop {
+
+    /// @brief Unit of work executed on the compositor thread
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Register the wakeup eventfd with the compositor's event loop
+     * @param loop Hyprland's wl_event_loop
+     * @return false if the eventfd or event source could not be created
+     * @note Must be called on the compositor thread
+     */
+    bool init(wl_event_loop* loop);
+
+    /**
+     * @brief Remove the event source and drop any tasks still queued
+     * @note Must be called on the compositor thread before the plugin unloads
+     */
+    void shutdown();
+
+    /**
+     * @brief Queue a task to run on the compositor thread
+     * @param task Work to run; never executed inline
+     * @return false if the queue is not initialized and the task was dropped
+     * @note Thread-safe
+     */
+    bool post(Task task);
+
+    /**
+     * @class Timer
+     * @brief One-shot timer on the compositor's event loop
+     * @note Create, arm and destroy on the compositor thread only
+     */
+    class Timer {
+      public:
+        explicit Timer(Task task);
+        ~Timer();
+
+        Timer(const Timer&)            = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        /**
+         * @brief Run the task once after @p delayMs, replacing any earlier schedule
+         * @return false if the event loop is not initialized
+         */
+        bool arm(int delayMs);
+
+        /// @brief Cancel a pending run
+        void disarm();
+
+      private:
+        static int       onFire(void* data);
+
+        Task             m_task;
+        wl_event_source* m_source = nullptr;
+    };
+
+    /**
+     * @class TimerQueue
+     * @brief Any number of one-shot timers sharing a single Timer
+     * @details Deadlines wait in a min-heap and only the earliest is armed, so a
+     *          thousand pending timers cost one timerfd rather than one each.
+     *          Cancelled timers leave the heap lazily, when they reach its top or
+     *          when they outnumber the live ones.
+     * @note Compositor thread only
+     */
+    class TimerQueue {
+      public:
+        using Id = uint64_t;
+
+        TimerQueue();
+
+        TimerQueue(const TimerQueue&)            = delete;
+        TimerQueue& operator=(const TimerQueue&) = delete;
+
+        /**
+         * @brief Run @p task once, @p delayMs from now; 0 runs it on the next event loop iteration
+         * @return An id for cancel(), never 0
+         * @note Timers due at the same time run in the order they were scheduled
+         */
+        Id     schedule(int delayMs, Task task);
+
+        /// @brief Drop a pending timer; false if it already ran or was cancelled
+        bool   cancel(Id id);
+
+        /// @brief Drop every pending timer
+        void   clear();
+
+        /// @brief Timers scheduled and not yet run or cancelled
+        size_t size() const {
+            return m_tasks.size();
+        }
+
+      private:
+        struct Deadline {
+            int64_t dueNs = 0;
+            Id      id    = 0;
+        };
+
+        void                           fire();
+        void                           rearm();
+
+        std::unordered_map<Id, Task>   m_tasks;
+        std::vector<Deadline>          m_heap;
+        Timer                          m_timer;
+        Id                             m_nextId  = 1;
+        int64_t                        m_armedNs = 0; ///< Deadline m_timer is armed for, 0 when disarmed
+    };
+
+} // namespace hyprlua::eventloop
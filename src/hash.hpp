@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @file hash.hpp
+ * @brief Small non-cryptographic hashing helpers
+ */
+
+namespace hyprlua::hash {
+
+    /// @brief FNV-1a offset basis, also the hash of an empty input
+    inline constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+
+    /**
+     * @brief 64-bit FNV-1a over a byte range
+     * @param data Bytes to hash
+     * @param seed Previous hash to continue from, for hashing several ranges as one
+     */
+    constexpr uint64_t fnv1a(std::string_view data, uint64_t seed = FNV_OFFSET) {
+        uint64_t h = seed;
+        for (const char c : data) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 0x100000001b3ULL;
+        }
+        return h;
+    }
+
+} // namespace hyprlua::hash
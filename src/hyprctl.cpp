@@ -0,0 +1,143 @@
+#include "hyprctl.hpp"
+#include "globals.hpp"
+#include "json.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+#include "lua/binds.hpp"
+#include "lua/monitors.hpp"
+#include "lua/options.hpp"
+#include "lua/profiler.hpp"
+#include "lua/rules.hpp"
+#include "lua/runtime.hpp"
+#include "lua/store.hpp"
+#include "lua/timers.hpp"
+#include "lua/watchdog.hpp"
+
+#include <hyprland/src/plugins/PluginAPI.hpp>
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace hyprlua::hyprctl {
+
+    namespace {
+        constexpr const char* DEFAULT_TRACE_PATH   = "/tmp/hyprlua-trace.json";
+        constexpr const char* DEFAULT_PROFILE_PATH = "/tmp/hyprlua-profile.folded";
+
+        SP<SHyprCtlCommand>   command;
+
+        std::string           stats() {
+            const auto monitors = modules::monitor_stats();
+            const auto binds    = modules::bind_stats();
+            const auto options  = modules::option_stats();
+            const auto rules    = modules::rule_stats();
+            const auto timers   = modules::timer_stats();
+            const auto store    = modules::store_stats();
+            const auto memory   = memory_stats().value_or(LuaAllocator::Stats{});
+            const auto required = module_stats();
+            json::Writer w;
+            w.beginObject().raw("phases", trace::statsJson());
+            w.beginObject("monitors").field("applied", monitors.applied).field("skipped", monitors.skipped).field("pending", monitors.pending).field("hotplug", monitors.hotplug).end();
+            w.beginObject("binds").field("added", binds.added).field("removed", binds.removed).field("unchanged", binds.unchanged).end();
+            w.beginObject("options").field("written", options.written).field("skipped", options.skipped).field("failed", options.failed).field("refreshes", options.refreshes).end();
+            w.beginObject("rules").field("windows", rules.windows).field("checked", rules.checked).field("applied", rules.applied).field("predicates", rules.predicates).end();
+            w.beginObject("timers")
+                .field("scheduled", timers.scheduled)
+                .field("fired", timers.fired)
+                .field("failed", timers.failed)
+                .field("cancelled", timers.cancelled)
+                .field("pending", timers.pending)
+                .end();
+            w.beginObject("store")
+                .field("keys", store.keys)
+                .field("reads", store.reads)
+                .field("writes", store.writes)
+                .field("saves", store.saves)
+                .field("failed_saves", store.failedSaves)
+                .field("persist", store.persist)
+                .end();
+            w.raw("callbacks", modules::callbacks_json());
+            w.beginObject("memory")
+                .field("allocations", memory.allocations)
+                .field("frees", memory.frees)
+                .field("bytes", memory.bytes)
+                .field("peak_bytes", memory.peakBytes)
+                .field("pool_bytes", memory.poolBytes)
+                .field("large_bytes", memory.largeBytes)
+                .field("limit", memory.limit)
+                .field("limit_hits", memory.limitHits)
+                .end();
+            w.beginObject("modules").field("executed", required.executed).field("replayed", required.replayed).field("files", required.files).end();
+            w.beginObject("watchdog").field("aborts", modules::watchdog_aborts()).end();
+            w.beginObject("log").field("dropped", log::dropped()).end();
+            return w.end().str();
+        }
+
+        std::string usage() {
+            return "usage: hyprctl hyprlua stats | trace [path] | tracing on|off | profile start | profile stop [path]\n";
+        }
+
+        /// @brief "profile start" samples all Lua from now on; "profile stop" writes the folded stacks to @p path and summarizes them
+        std::string profile(const std::string& action, const std::string& path) {
+            if (action == "start") {
+                return modules::start_profile() ? "profiling; reload or use the binds to measure, then run hyprctl hyprlua profile stop\n" : "a profile is already running\n";
+            }
+
+            const auto report = modules::stop_profile();
+            if (!report) {
+                return "no profile is running\n";
+            }
+            std::ofstream out(path, std::ios::trunc);
+            out << report->folded;
+            if (!out.flush()) {
+                return std::format("cannot write {}\n\n{}", path, modules::profile_summary(*report));
+            }
+            return std::format("folded stacks written to {}\n\n{}", path, modules::profile_summary(*report));
+        }
+
+        /// @brief Handle "hyprlua <subcommand> [args]"; Hyprland passes the whole request
+        std::string handle(eHyprCtlOutputFormat, std::string request) {
+            std::istringstream       in(request);
+            std::vector<std::string> words;
+            for (std::string word; in >> word;) {
+                words.push_back(word);
+            }
+
+            const std::string sub = words.size() > 1 ? words[1] : "stats";
+            if (sub == "stats") {
+                return stats();
+            }
+            if (sub == "trace") {
+                const std::string path = words.size() > 2 ? words[2] : DEFAULT_TRACE_PATH;
+                trace::requestCapture(path);
+                request_reload();
+                return std::format("capturing the next reload to {}\n", path);
+            }
+            if (sub == "profile" && words.size() > 2 && (words[2] == "start" || words[2] == "stop")) {
+                return profile(words[2], words.size() > 3 ? words[3] : DEFAULT_PROFILE_PATH);
+            }
+            if (sub == "tracing" && words.size() > 2 && (words[2] == "on" || words[2] == "off")) {
+                trace::setEnabled(words[2] == "on");
+                return "ok\n";
+            }
+            return usage();
+        }
+    }
+
+    void registerCommands() {
+        command = HyprlandAPI::registerHyprCtlCommand(PHANDLE, SHyprCtlCommand{.name = "hyprlua", .exact = false, .fn = &handle});
+        if (!command) {
+            log::error("Failed to register the hyprlua hyprctl command");
+        }
+    }
+
+    void unregisterCommands() {
+        if (command) {
+            HyprlandAPI::unregisterHyprCtlCommand(PHANDLE, command);
+            command.reset();
+        }
+    }
+
+} // namespace hyprlua::hyprctl
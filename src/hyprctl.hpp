@@ -0,0 +1,21 @@
+#pragma once
+
+/**
+ * @file hyprctl.hpp
+ * @brief `hyprctl hyprlua ...` commands
+ * @details Subcommands:
+ *          - stats: phase timings, bound function counts and module counters as JSON
+ *          - trace [path]: reload now and write the reload as Chrome trace-event JSON
+ *          - tracing on|off: switch the timers on or off at run time
+ */
+
+namespace hyprlua::hyprctl {
+
+    /// @brief Register the hyprlua command with Hyprland
+    /// @note Compositor thread only, after PHANDLE is set
+    void registerCommands();
+
+    /// @brief Remove the command again
+    void unregisterCommands();
+
+} // namespace hyprlua::hyprctl
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cmath>
+#include <concepts>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @file json.hpp
+ * @brief Helpers for the hand-written JSON hyprctl and trace output
+ */
+
+namespace hyprlua::json {
+
+    /// @brief @p text as a quoted JSON string
+    inline std::string quote(std::string_view text) {
+        std::string out = "\"";
+        for (char c : text) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        out += std::format("\\u{:04x}", c);
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+        return out + "\"";
+    }
+
+    /**
+     * @brief Builds one JSON document, placing the commas and quoting keys and strings
+     * @details Members are written in call order:
+     *          @code
+     *          json::Writer w;
+     *          w.beginObject().field("count", 3).beginObject("memory").field("bytes", n).end().end();
+     *          @endcode
+     *          Keys are ignored inside arrays. Non-finite numbers are written as null.
+     */
+    class Writer {
+      public:
+        Writer& beginObject(std::string_view key = {}) {
+            return open(key, '{');
+        }
+
+        Writer& beginArray(std::string_view key = {}) {
+            return open(key, '[');
+        }
+
+        /// @brief Close the innermost object or array
+        Writer& end() {
+            out += closers.back();
+            closers.pop_back();
+            first = false;
+            return *this;
+        }
+
+        Writer& field(std::string_view key, std::string_view value) {
+            member(key);
+            out += quote(value);
+            return *this;
+        }
+
+        Writer& field(std::string_view key, const char* value) {
+            return field(key, std::string_view(value));
+        }
+
+        Writer& field(std::string_view key, bool value) {
+            member(key);
+            out += value ? "true" : "false";
+            return *this;
+        }
+
+        template <typename T>
+            requires(std::integral<T> && !std::same_as<T, bool>)
+        Writer& field(std::string_view key, T value) {
+            member(key);
+            out += std::format("{}", value);
+            return *this;
+        }
+
+        Writer& field(std::string_view key, double value) {
+            member(key);
+            if (std::isfinite(value)) {
+                out += std::format("{}", value);
+            } else {
+                out += "null";
+            }
+            return *this;
+        }
+
+        /// @brief A member whose value is already encoded JSON
+        Writer& raw(std::string_view key, std::string_view json) {
+            member(key);
+            out += json;
+            return *this;
+        }
+
+        /// @brief The document; every object and array must be closed
+        const std::string& str() const {
+            return out;
+        }
+
+      private:
+        Writer& open(std::string_view key, char opener) {
+            member(key);
+            out += opener;
+            closers.push_back(opener == '{' ? '}' : ']');
+            first = true;
+            return *this;
+        }
+
+        void member(std::string_view key) {
+            if (!first) {
+                out += ", ";
+            }
+            first = false;
+            if (!closers.empty() && closers.back() == '}') {
+                out += quote(key);
+                out += ": ";
+            }
+        }
+
+        std::string       out;
+        std::vector<char> closers;
+        bool              first = true;
+    };
+
+} // namespace hyprlua::json
@@ -0,0 +1,275 @@
+#include "logger.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <ctime>
+#include <fcntl.h>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace hyprlua::log {
+
+    namespace detail {
+        std::atomic<uint8_t> runtimeLevel = static_cast<uint8_t>(Level::Info);
+    }
+
+    namespace {
+        /// @brief Number of slots; a power of two so positions map to slots with a mask
+        constexpr uint64_t CAPACITY = 2048;
+        constexpr uint64_t MASK     = CAPACITY - 1;
+
+        /// @brief Size of the writer's output buffer, flushed with a single write(2)
+        constexpr size_t BATCH_BYTES = 64 * 1024;
+
+        /**
+         * @brief Bounded multi-producer single-consumer ring
+         * @details Each slot's sequence tells who may touch it: a producer may claim
+         *          position p when sequence == p, the writer may read it once the
+         *          producer stored p + 1, and the writer frees it by storing p + CAPACITY.
+         */
+        struct Ring {
+            detail::Record                     slots[CAPACITY];
+            alignas(64) std::atomic<uint64_t>  enqueuePos = 0;
+            alignas(64) uint64_t               dequeuePos = 0;
+            alignas(64) std::atomic<uint64_t>  published  = 0;
+            std::atomic<uint64_t>              written    = 0;
+            std::atomic<uint64_t>              dropped    = 0;
+
+            // Writer wakeup: producers only notify when the writer announced it is idle
+            std::atomic<bool>     writerIdle = false;
+            std::atomic<uint32_t> wakeups    = 0;
+
+            Ring() {
+                for (uint64_t i = 0; i < CAPACITY; ++i) {
+                    slots[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+        };
+
+        Ring& ring() {
+            static Ring r;
+            return r;
+        }
+
+        // Writer thread state, only touched by init/shutdown/setPath and the writer
+        std::mutex        controlMutex;
+        std::thread       writer;
+        std::atomic<bool> stopping = false;
+        std::string       path     = "/tmp/hyprlua.log";
+        std::atomic<bool> reopen   = true;
+
+        const char*       level_name(Level level) {
+            switch (level) {
+                case Level::Debug: return "DEBUG";
+                case Level::Info: return "INFO";
+                case Level::Error: return "ERROR";
+                default: return "LOG";
+            }
+        }
+
+        void wake_writer() {
+            auto& r = ring();
+            r.wakeups.fetch_add(1, std::memory_order_release);
+            r.wakeups.notify_one();
+        }
+
+        /// @brief Append "[YYYY-mm-dd HH:MM:SS] [LEVEL] message\n" to the batch
+        size_t format_record(const detail::Record& record, char* out, size_t space) {
+            const time_t seconds = static_cast<time_t>(record.timeNs / 1000000000);
+            std::tm      tm{};
+            localtime_r(&seconds, &tm);
+
+            char   stamp[32];
+            size_t stampLen = std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm);
+
+            auto   result = std::format_to_n(out, space, "[{}] [{}] {}\n", std::string_view(stamp, stampLen), level_name(record.level),
+                                             std::string_view(record.text, record.length));
+            return static_cast<size_t>(result.out - out);
+        }
+
+        void flush_batch(int& fd, const char* data, size_t size) {
+            if (reopen.exchange(false)) {
+                if (fd >= 0) {
+                    close(fd);
+                }
+                std::lock_guard<std::mutex> lock(controlMutex);
+                fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+            }
+            while (fd >= 0 && size > 0) {
+                ssize_t n = ::write(fd, data, size);
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return;
+                }
+                data += n;
+                size -= static_cast<size_t>(n);
+            }
+        }
+
+        /// @brief Writer thread: drain the ring into a batch buffer, write it, sleep when empty
+        void writer_loop() {
+            auto&             r  = ring();
+            int               fd = -1;
+            std::vector<char> batch(BATCH_BYTES);
+
+            while (true) {
+                size_t   used  = 0;
+                uint64_t count = 0;
+
+                while (true) {
+                    auto& record = r.slots[r.dequeuePos & MASK];
+                    if (record.sequence.load(std::memory_order_acquire) != r.dequeuePos + 1) {
+                        break;
+                    }
+                    if (BATCH_BYTES - used < detail::MAX_MESSAGE + 64) {
+                        break;
+                    }
+
+                    used += format_record(record, batch.data() + used, BATCH_BYTES - used);
+                    record.sequence.store(r.dequeuePos + CAPACITY, std::memory_order_release);
+                    ++r.dequeuePos;
+                    ++count;
+                }
+
+                if (used > 0) {
+                    flush_batch(fd, batch.data(), used);
+                    r.written.fetch_add(count, std::memory_order_release);
+                    r.written.notify_all();
+                    continue;
+                }
+
+                if (stopping.load(std::memory_order_acquire)) {
+                    break;
+                }
+
+                // Announce idleness, then re-check so a record published in between is not missed
+                const uint32_t seen = r.wakeups.load(std::memory_order_acquire);
+                r.writerIdle.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                auto& next = r.slots[r.dequeuePos & MASK];
+                if (next.sequence.load(std::memory_order_acquire) == r.dequeuePos + 1 || stopping.load(std::memory_order_acquire)) {
+                    r.writerIdle.store(false, std::memory_order_relaxed);
+                    continue;
+                }
+                r.wakeups.wait(seen, std::memory_order_acquire);
+            }
+
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    namespace detail {
+        Record* acquire() {
+            auto&    r   = ring();
+            uint64_t pos = r.enqueuePos.load(std::memory_order_relaxed);
+
+            while (true) {
+                Record&        slot = r.slots[pos & MASK];
+                const uint64_t seq  = slot.sequence.load(std::memory_order_acquire);
+                const int64_t  diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+
+                if (diff == 0) {
+                    // The slot keeps sequence == pos until publish() marks it readable
+                    if (r.enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        return &slot;
+                    }
+                } else if (diff < 0) {
+                    r.dropped.fetch_add(1, std::memory_order_relaxed);
+                    return nullptr;
+                } else {
+                    pos = r.enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void publish(Record* record) {
+            auto&          r   = ring();
+            const uint64_t pos = record->sequence.load(std::memory_order_relaxed);
+            record->sequence.store(pos + 1, std::memory_order_release);
+            r.published.fetch_add(1, std::memory_order_relaxed);
+
+            // Pairs with the fence in writer_loop: either we see the writer idle, or it sees this record
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (r.writerIdle.load(std::memory_order_relaxed) && r.writerIdle.exchange(false, std::memory_order_acq_rel)) {
+                wake_writer();
+            }
+        }
+    }
+
+    void init() {
+        std::lock_guard<std::mutex> lock(controlMutex);
+        if (writer.joinable()) {
+            return;
+        }
+
+        if (const char* envPath = std::getenv("HYPRLUA_LOG_PATH"); envPath && *envPath) {
+            path = envPath;
+        }
+        if (const char* envLevel = std::getenv("HYPRLUA_LOG_LEVEL"); envLevel && *envLevel) {
+            setLevel(parseLevel(envLevel, Level::Info));
+        }
+
+        reopen   = true;
+        stopping = false;
+        writer   = std::thread(&writer_loop);
+    }
+
+    void shutdown() {
+        std::lock_guard<std::mutex> lock(controlMutex);
+        if (!writer.joinable()) {
+            return;
+        }
+
+        stopping.store(true, std::memory_order_release);
+        wake_writer();
+        writer.join();
+    }
+
+    void flush() {
+        auto& r      = ring();
+        auto  target = r.published.load(std::memory_order_acquire);
+        if (!writer.joinable()) {
+            return;
+        }
+
+        wake_writer();
+        for (auto done = r.written.load(std::memory_order_acquire); done < target; done = r.written.load(std::memory_order_acquire)) {
+            r.written.wait(done, std::memory_order_acquire);
+        }
+    }
+
+    void setLevel(Level level) {
+        detail::runtimeLevel.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+    }
+
+    Level parseLevel(std::string_view name, Level fallback) {
+        if (name == "debug")
+            return Level::Debug;
+        if (name == "info")
+            return Level::Info;
+        if (name == "error")
+            return Level::Error;
+        if (name == "off")
+            return Level::Off;
+        return fallback;
+    }
+
+    void setPath(const std::string& newPath) {
+        {
+            std::lock_guard<std::mutex> lock(controlMutex);
+            path = newPath;
+        }
+        reopen = true;
+    }
+
+    uint64_t dropped() {
+        return ring().dropped.load(std::memory_order_relaxed);
+    }
+
+} // namespace hyprlua::log
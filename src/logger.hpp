@@ -1,43 +1,131 @@
 #pragma once
 
-#include <fstream>
-#include <mutex>
-#include <string>
+#include <atomic>
 #include <chrono>
-#include <ctime>
-#include <iomanip>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/**
+ * @file logger.hpp
+ * @brief Asynchronous file logger
+ * @details Callers format straight into a slot of a bounded lock-free ring buffer;
+ *          a background thread drains it and writes whole batches with one write(2).
+ *          Levels below HYPRLUA_LOG_LEVEL are compiled out, levels below the runtime
+ *          level return before any formatting happens. When the buffer is full new
+ *          records are dropped and counted instead of blocking the caller.
+ */
+
+/// @brief Lowest level compiled in: 0 debug, 1 info, 2 error
+#ifndef HYPRLUA_LOG_LEVEL
+#define HYPRLUA_LOG_LEVEL 0
+#endif
 
 namespace hyprlua::log {
 
-inline std::ofstream& stream() {
-    static std::ofstream file("/tmp/hyprlua.log", std::ios::app);
-    return file;
-}
-
-inline std::string timestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto t_c = std::chrono::system_clock::to_time_t(now);
-    std::ostringstream ss;
-    ss << std::put_time(std::localtime(&t_c), "%Y-%m-%d %H:%M:%S");
-    return ss.str();
-}
-
-inline void write(const std::string& level, const std::string& message) {
-    static std::mutex mtx;
-    std::lock_guard<std::mutex> lock(mtx);
-    stream() << "[" << timestamp() << "] [" << level << "] " << message << std::endl;
-}
-
-inline void info(const std::string& message) {
-    write("INFO", message);
-}
-
-inline void debug(const std::string& message) {
-    write("DEBUG", message);
-}
-
-inline void error(const std::string& message) {
-    write("ERROR", message);
-}
+    enum class Level : uint8_t {
+        Debug = 0,
+        Info  = 1,
+        Error = 2,
+        Off   = 3,
+    };
+
+    /// @brief Levels below this are removed at compile time
+    inline constexpr Level COMPILED_LEVEL = static_cast<Level>(HYPRLUA_LOG_LEVEL);
+
+    namespace detail {
+        /// @brief Maximum length of one formatted message; longer ones are truncated
+        inline constexpr size_t MAX_MESSAGE = 232;
+
+        /// @brief One ring buffer slot, see logger.cpp for the sequencing protocol
+        struct alignas(64) Record {
+            std::atomic<uint64_t> sequence;
+            int64_t               timeNs;
+            Level                 level;
+            uint16_t              length;
+            char                  text[MAX_MESSAGE];
+        };
+
+        /// @brief Current runtime level, compared on every call
+        extern std::atomic<uint8_t> runtimeLevel;
+
+        /// @brief Claim a free slot, or nullptr (and count a drop) if the buffer is full
+        Record* acquire();
+
+        /// @brief Hand a filled slot to the writer thread
+        void publish(Record* record);
+    }
+
+    /// @brief Whether a message at @p level would be written
+    inline bool enabled(Level level) {
+        return level >= COMPILED_LEVEL && static_cast<uint8_t>(level) >= detail::runtimeLevel.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Start the writer thread
+     * @details Reads HYPRLUA_LOG_PATH and HYPRLUA_LOG_LEVEL from the environment.
+     *          Records logged before init() wait in the buffer.
+     */
+    void init();
+
+    /// @brief Write everything still buffered and stop the writer thread
+    void shutdown();
+
+    /// @brief Block until every record published so far has been written
+    void flush();
+
+    /// @brief Change the runtime level
+    void setLevel(Level level);
+
+    /// @brief Parse "debug", "info", "error" or "off"; returns @p fallback otherwise
+    Level parseLevel(std::string_view name, Level fallback);
+
+    /// @brief Log to @p path from now on; the default is /tmp/hyprlua.log
+    void setPath(const std::string& path);
+
+    /// @brief Records dropped because the buffer was full
+    uint64_t dropped();
+
+    template <typename... Args>
+    void write(Level level, std::format_string<Args...> fmt, Args&&... args) {
+        if (!enabled(level)) {
+            return;
+        }
+
+        detail::Record* record = detail::acquire();
+        if (!record) {
+            return;
+        }
+
+        record->timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        record->level  = level;
+        auto result    = std::format_to_n(record->text, detail::MAX_MESSAGE, fmt, std::forward<Args>(args)...);
+        record->length = static_cast<uint16_t>(result.out - record->text);
+        detail::publish(record);
+    }
+
+    template <typename... Args>
+    void info(std::format_string<Args...> fmt, Args&&... args) {
+        if constexpr (Level::Info >= COMPILED_LEVEL) {
+            write(Level::Info, fmt, std::forward<Args>(args)...);
+        }
+    }
+
+    template <typename... Args>
+    void debug(std::format_string<Args...> fmt, Args&&... args) {
+        if constexpr (Level::Debug >= COMPILED_LEVEL) {
+            write(Level::Debug, fmt, std::forward<Args>(args)...);
+        }
+    }
+
+    template <typename... Args>
+    void error(std::format_string<Args...> fmt, Args&&... args) {
+        if constexpr (Level::Error >= COMPILED_LEVEL) {
+            write(Level::Error, fmt, std::forward<Args>(args)...);
+        }
+    }
 
 } // namespace hyprlua::log
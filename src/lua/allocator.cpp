@@ -0,0 +1,170 @@
+#include "allocator.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+namespace hyprlua {
+
+    LuaAllocator::LuaAllocator(size_t limitBytes) {
+        m_stats.limit = limitBytes;
+    }
+
+    LuaAllocator::~LuaAllocator() {
+        for (void* chunk : m_chunks) {
+            std::free(chunk);
+        }
+    }
+
+    size_t LuaAllocator::defaultLimit() {
+        size_t mb = 256;
+        if (const char* env = std::getenv("HYPRLUA_LUA_MEMORY_MB")) {
+            const std::string_view text(env);
+            size_t                 value = 0;
+            const auto [end, ec]         = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (ec == std::errc{} && end == text.data() + text.size()) {
+                mb = value;
+            }
+        }
+        return mb * 1024 * 1024;
+    }
+
+    namespace {
+        /// @brief Size class for each 16-byte step up to MAX_SMALL, so lookups are one load
+        constexpr auto CLASS_BY_STEP = [] {
+            std::array<uint8_t, LuaAllocator::MAX_SMALL / 16 + 1> table{};
+            for (size_t step = 0, cls = 0; step < table.size(); ++step) {
+                while (LuaAllocator::CLASSES[cls] < step * 16) {
+                    ++cls;
+                }
+                table[step] = static_cast<uint8_t>(cls);
+            }
+            return table;
+        }();
+    }
+
+    size_t LuaAllocator::class_of(size_t size) {
+        return CLASS_BY_STEP[(size + 15) / 16];
+    }
+
+    void* LuaAllocator::allocate_small(size_t cls) {
+        if (FreeBlock* block = m_free[cls]) {
+            m_free[cls] = block->next;
+            return block;
+        }
+
+        const size_t size = CLASSES[cls];
+        if (m_bumpLeft < size) {
+            // The tail of the previous chunk goes to the free lists of the classes it still fits
+            while (m_bumpLeft >= CLASSES.front()) {
+                const size_t fit = std::upper_bound(CLASSES.begin(), CLASSES.end(), m_bumpLeft) - CLASSES.begin() - 1;
+                free_small(m_bump, fit);
+                m_bump += CLASSES[fit];
+                m_bumpLeft -= CLASSES[fit];
+            }
+
+            void* chunk = std::malloc(CHUNK);
+            if (!chunk) {
+                return nullptr;
+            }
+            m_chunks.push_back(chunk);
+            m_bump     = static_cast<char*>(chunk);
+            m_bumpLeft = CHUNK;
+            m_stats.poolBytes += CHUNK;
+        }
+
+        void* block = m_bump;
+        m_bump += size;
+        m_bumpLeft -= size;
+        return block;
+    }
+
+    void LuaAllocator::free_small(void* ptr, size_t cls) {
+        auto* block = static_cast<FreeBlock*>(ptr);
+        block->next = m_free[cls];
+        m_free[cls] = block;
+    }
+
+    void* LuaAllocator::allocate(size_t size) {
+        if (size <= MAX_SMALL) {
+            return allocate_small(class_of(size));
+        }
+        void* block = std::malloc(size);
+        if (block) {
+            m_stats.largeBytes += size;
+        }
+        return block;
+    }
+
+    void LuaAllocator::release(void* ptr, size_t size) {
+        if (size <= MAX_SMALL) {
+            free_small(ptr, class_of(size));
+        } else {
+            std::free(ptr);
+            m_stats.largeBytes -= size;
+        }
+    }
+
+    void* LuaAllocator::reallocate(void* ptr, size_t osize, size_t nsize) {
+        const size_t old = ptr ? osize : 0;
+
+        if (nsize == 0) {
+            if (ptr) {
+                release(ptr, old);
+                m_stats.bytes -= old;
+                ++m_stats.frees;
+            }
+            return nullptr;
+        }
+
+        if (nsize > old && m_stats.limit != 0 && m_stats.bytes - old + nsize > m_stats.limit) {
+            ++m_stats.limitHits;
+            return nullptr;
+        }
+
+        void* block = nullptr;
+        if (ptr && old <= MAX_SMALL && nsize <= MAX_SMALL && class_of(old) == class_of(nsize)) {
+            block = ptr;
+        } else if (ptr && old > MAX_SMALL && nsize > MAX_SMALL) {
+            block = std::realloc(ptr, nsize);
+            if (!block && nsize < old) {
+                block = ptr;
+            }
+            if (block) {
+                m_stats.largeBytes += nsize;
+                m_stats.largeBytes -= old;
+            }
+        } else {
+            block = allocate(nsize);
+            if (block) {
+                ++m_stats.allocations;
+                if (ptr) {
+                    std::memcpy(block, ptr, std::min(old, nsize));
+                    release(ptr, old);
+                    ++m_stats.frees;
+                }
+            }
+        }
+
+        if (!block && ptr && nsize < old && old <= MAX_SMALL) {
+            // Lua 5.3 relies on shrinking never failing. A pool block that keeps its
+            // class is simply filed under the smaller one when it is freed.
+            block = ptr;
+        }
+        if (!block) {
+            return nullptr;
+        }
+
+        m_stats.bytes += nsize;
+        m_stats.bytes -= old;
+        m_stats.peakBytes = std::max(m_stats.peakBytes, m_stats.bytes);
+        return block;
+    }
+
+    void* LuaAllocator::lua_alloc(void* ud, void* ptr, size_t osize, size_t nsize) {
+        return static_cast<LuaAllocator*>(ud)->reallocate(ptr, osize, nsize);
+    }
+
+} // namespace hyprlua
@@ -0,0 +1,87 @@
+// allocator.hpp
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file allocator.hpp
+ * @brief Memory allocator for the Lua states
+ * @details Each config state gets its own allocator. Small blocks, which are most
+ *          of what Lua allocates (strings, tables, closures), come from size-class
+ *          free lists carved out of 64 KiB chunks the allocator owns. Larger blocks
+ *          go to malloc. When a state is discarded its chunks are returned in one go,
+ *          so reloads do not leave Lua's small objects scattered over the
+ *          compositor's heap. Requests that would take the state past its limit
+ *          fail, which Lua reports as "not enough memory".
+ *          Nothing here depends on Lua, so it can be tested headless.
+ */
+
+namespace hyprlua {
+
+    class LuaAllocator {
+      public:
+        struct Stats {
+            uint64_t allocations = 0; ///< Blocks handed out, including moves on resize
+            uint64_t frees       = 0;
+            uint64_t bytes       = 0; ///< In use, as requested by Lua
+            uint64_t peakBytes   = 0;
+            uint64_t poolBytes   = 0; ///< Reserved in chunks for small blocks
+            uint64_t largeBytes  = 0; ///< In use by blocks too large for the pools
+            uint64_t limitHits   = 0; ///< Requests refused because of the limit
+            uint64_t limit       = 0; ///< 0 for none
+        };
+
+        /// @param limitBytes Most memory the state may use, 0 for no limit
+        explicit LuaAllocator(size_t limitBytes = 0);
+        ~LuaAllocator();
+
+        LuaAllocator(const LuaAllocator&)            = delete;
+        LuaAllocator& operator=(const LuaAllocator&) = delete;
+
+        /**
+         * @brief lua_Alloc semantics: allocate, resize or free
+         * @param osize Size of @p ptr; ignored when @p ptr is null, where Lua passes the object type
+         * @return The block, or nullptr for a free or a refused request; shrinking never fails
+         */
+        void*        reallocate(void* ptr, size_t osize, size_t nsize);
+
+        /// @brief lua_Alloc entry point; @p ud is the LuaAllocator
+        static void* lua_alloc(void* ud, void* ptr, size_t osize, size_t nsize);
+
+        const Stats& stats() const {
+            return m_stats;
+        }
+
+        /// @brief Most memory a state may use unless configured otherwise: HYPRLUA_LUA_MEMORY_MB, 256 MiB by default
+        static size_t defaultLimit();
+
+        /// @brief Largest size served from the pools
+        static constexpr size_t MAX_SMALL = 256;
+        static constexpr size_t CHUNK     = 64 * 1024;
+
+        /// @brief Size classes, multiples of 16 so every block keeps malloc's alignment
+        static constexpr std::array<size_t, 8> CLASSES = {16, 32, 48, 64, 96, 128, 192, 256};
+
+      private:
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        static size_t                          class_of(size_t size);
+
+        void*                                  allocate_small(size_t cls);
+        void                                   free_small(void* ptr, size_t cls);
+        void*                                  allocate(size_t size);
+        void                                   release(void* ptr, size_t size);
+
+        std::array<FreeBlock*, CLASSES.size()> m_free{};
+        std::vector<void*>                     m_chunks;
+        char*                                  m_bump     = nullptr;
+        size_t                                 m_bumpLeft = 0;
+        Stats                                  m_stats;
+    };
+
+} // namespace hyprlua
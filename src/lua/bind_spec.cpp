@@ -0,0 +1,277 @@
+#include "bind_spec.hpp"
+
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <format>
+#include <utility>
+#include <vector>
+
+namespace hyprlua {
+
+    namespace {
+        constexpr std::array<std::pair<std::string_view, uint32_t>, 14> MOD_NAMES = {{
+            {"SUPER", mod::SUPER},
+            {"WIN", mod::SUPER},
+            {"LOGO", mod::SUPER},
+            {"META", mod::SUPER},
+            {"MOD4", mod::SUPER},
+            {"CTRL", mod::CTRL},
+            {"CONTROL", mod::CTRL},
+            {"ALT", mod::ALT},
+            {"MOD1", mod::ALT},
+            {"SHIFT", mod::SHIFT},
+            {"CAPS", mod::CAPS},
+            {"MOD2", mod::MOD2},
+            {"MOD3", mod::MOD3},
+            {"MOD5", mod::MOD5},
+        }};
+
+        /// @brief Order modifiers are printed in; the first name of each bit in MOD_NAMES
+        constexpr std::array<std::pair<std::string_view, uint32_t>, 8> MOD_ORDER = {{
+            {"SUPER", mod::SUPER},
+            {"CTRL", mod::CTRL},
+            {"ALT", mod::ALT},
+            {"SHIFT", mod::SHIFT},
+            {"CAPS", mod::CAPS},
+            {"MOD2", mod::MOD2},
+            {"MOD3", mod::MOD3},
+            {"MOD5", mod::MOD5},
+        }};
+
+        std::string_view trim(std::string_view text) {
+            const auto first = text.find_first_not_of(" \t");
+            if (first == std::string_view::npos) {
+                return {};
+            }
+            const auto last = text.find_last_not_of(" \t");
+            return text.substr(first, last - first + 1);
+        }
+
+        bool iequals(std::string_view a, std::string_view b) {
+            if (a.size() != b.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < a.size(); ++i) {
+                if (std::toupper(static_cast<unsigned char>(a[i])) != std::toupper(static_cast<unsigned char>(b[i]))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// @brief Split on commas into at most @p limit fields; the last one keeps any further commas
+        std::vector<std::string_view> split_fields(std::string_view text, size_t limit) {
+            std::vector<std::string_view> fields;
+            while (fields.size() + 1 < limit) {
+                const auto comma = text.find(',');
+                if (comma == std::string_view::npos) {
+                    break;
+                }
+                fields.push_back(trim(text.substr(0, comma)));
+                text.remove_prefix(comma + 1);
+            }
+            fields.push_back(trim(text));
+            return fields;
+        }
+
+        std::string mods_text(uint32_t mods) {
+            std::string text;
+            for (const auto& [name, bit] : MOD_ORDER) {
+                if (mods & bit) {
+                    text += (text.empty() ? "" : " ") + std::string(name);
+                }
+            }
+            return text;
+        }
+    }
+
+    std::expected<uint32_t, std::string> parse_mods(std::string_view text) {
+        uint32_t mods = 0;
+        while (!text.empty()) {
+            const auto end  = text.find_first_of(" \t+_");
+            const auto name = text.substr(0, end);
+            text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+            if (name.empty()) {
+                continue;
+            }
+
+            bool known = false;
+            for (const auto& [keyword, bit] : MOD_NAMES) {
+                if (iequals(name, keyword)) {
+                    mods |= bit;
+                    known = true;
+                    break;
+                }
+            }
+            if (!known) {
+                return std::unexpected(std::format("unknown modifier '{}': expected SUPER, CTRL, ALT, SHIFT, CAPS, MOD2, MOD3 or MOD5", name));
+            }
+        }
+        return mods;
+    }
+
+    std::expected<void, std::string> parse_key(std::string_view text, BindSpec& spec) {
+        text          = trim(text);
+        spec.key      = "";
+        spec.keycode  = 0;
+        spec.catchAll = false;
+
+        if (text.empty()) {
+            return std::unexpected(std::string("bind without a key"));
+        }
+        if (text.starts_with("code:")) {
+            const auto digits = text.substr(5);
+            uint32_t   code   = 0;
+            const auto [end, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), code);
+            if (ec != std::errc{} || end != digits.data() + digits.size() || digits.empty()) {
+                return std::unexpected(std::format("invalid key '{}': expected code:<keycode>", text));
+            }
+            spec.keycode = code;
+            return {};
+        }
+        if (text == "catchall") {
+            spec.catchAll = true;
+            return {};
+        }
+        spec.key = text;
+        return {};
+    }
+
+    std::expected<void, std::string> parse_flags(std::string_view flags, BindSpec& spec) {
+        for (char c : flags) {
+            switch (c) {
+                case 'l': spec.locked = true; break;
+                case 'r': spec.release = true; break;
+                case 'c': spec.click = true; break;
+                case 'g': spec.drag = true; break;
+                case 'o': spec.longPress = true; break;
+                case 'e': spec.repeat = true; break;
+                case 'n': spec.nonConsuming = true; break;
+                case 'm': spec.mouse = true; break;
+                case 't': spec.transparent = true; break;
+                case 'i': spec.ignoreMods = true; break;
+                case 'p': spec.bypass = true; break;
+                case 'd': break; // Description given separately
+                case 's': return std::unexpected(std::string("flag 's' (multi-key binds) is not supported"));
+                default: return std::unexpected(std::format("unknown bind flag '{}': expected one of lrcgoenmtipd", c));
+            }
+        }
+        return {};
+    }
+
+    std::expected<void, std::string> validate_bind(const BindSpec& spec) {
+        if (spec.dispatcher.empty()) {
+            return std::unexpected(std::string("bind without a dispatcher"));
+        }
+        if (spec.mouse && spec.dispatcher != "movewindow" && spec.dispatcher != "resizewindow") {
+            return std::unexpected(std::format("mouse binds only take movewindow or resizewindow, not '{}'", spec.dispatcher));
+        }
+        if (spec.catchAll && spec.submap.empty()) {
+            return std::unexpected(std::string("catchall binds only work inside a submap"));
+        }
+        return {};
+    }
+
+    std::expected<BindSpec, std::string> parse_bind_line(std::string_view line, std::string_view submap) {
+        const auto eq = line.find('=');
+        if (eq == std::string_view::npos) {
+            return std::unexpected(std::format("invalid bind '{}': expected bind[FLAGS] = MODS, KEY, DISPATCHER[, ARG]", trim(line)));
+        }
+        const auto keyword = trim(line.substr(0, eq));
+        if (!keyword.starts_with("bind")) {
+            return std::unexpected(std::format("invalid bind keyword '{}': expected bind[FLAGS]", keyword));
+        }
+
+        BindSpec spec;
+        spec.submap = submap;
+
+        const auto flags = keyword.substr(4);
+        if (auto r = parse_flags(flags, spec); !r) {
+            return std::unexpected(r.error());
+        }
+
+        // With 'd' the description comes before the dispatcher
+        const bool described = flags.find('d') != std::string_view::npos;
+        const auto fields    = split_fields(line.substr(eq + 1), described ? 5 : 4);
+        if (fields.size() < (described ? 4u : 3u)) {
+            return std::unexpected(std::format("invalid bind '{}': expected MODS, KEY, {}DISPATCHER[, ARG]", trim(line.substr(eq + 1)), described ? "DESCRIPTION, " : ""));
+        }
+
+        auto mods = parse_mods(fields[0]);
+        if (!mods) {
+            return std::unexpected(mods.error());
+        }
+        spec.mods = *mods;
+        if (auto r = parse_key(fields[1], spec); !r) {
+            return std::unexpected(r.error());
+        }
+
+        size_t next = 2;
+        if (described) {
+            spec.description = fields[next++];
+        }
+        spec.dispatcher = fields[next++];
+        spec.arg        = next < fields.size() ? std::string(fields[next]) : "";
+
+        if (auto r = validate_bind(spec); !r) {
+            return std::unexpected(r.error());
+        }
+        return spec;
+    }
+
+    std::string trigger(const BindSpec& spec) {
+        if (spec.catchAll) {
+            return std::format("{}:catchall", spec.mods);
+        }
+        if (spec.key.empty()) {
+            return std::format("{}:code:{}", spec.mods, spec.keycode);
+        }
+        return std::format("{}:{}", spec.mods, spec.key);
+    }
+
+    std::string keys_text(const BindSpec& spec) {
+        std::string text = mods_text(spec.mods) + ", ";
+        if (spec.catchAll) {
+            text += "catchall";
+        } else if (spec.key.empty()) {
+            text += std::format("code:{}", spec.keycode);
+        } else {
+            text += spec.key;
+        }
+        return text;
+    }
+
+    std::string to_string(const BindSpec& spec) {
+        std::string line = "bind";
+        const std::array<std::pair<bool, char>, 11> flags = {{
+            {spec.locked, 'l'},
+            {spec.release, 'r'},
+            {spec.click, 'c'},
+            {spec.drag, 'g'},
+            {spec.longPress, 'o'},
+            {spec.repeat, 'e'},
+            {spec.nonConsuming, 'n'},
+            {spec.mouse, 'm'},
+            {spec.transparent, 't'},
+            {spec.ignoreMods, 'i'},
+            {spec.bypass, 'p'},
+        }};
+        for (const auto& [set, letter] : flags) {
+            if (set) {
+                line += letter;
+            }
+        }
+        if (!spec.description.empty()) {
+            line += 'd';
+        }
+
+        line += " = " + keys_text(spec);
+        if (!spec.description.empty()) {
+            line += ", " + spec.description;
+        }
+        line += ", " + spec.dispatcher + ", " + spec.arg;
+        return line;
+    }
+
+} // namespace hyprlua
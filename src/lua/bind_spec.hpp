@@ -0,0 +1,108 @@
+// bind_spec.hpp
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <string>
+#include <string_view>
+
+/**
+ * @file bind_spec.hpp
+ * @brief Parsed form of a Hyprland keybind
+ * @details Covers the syntax of Hyprland's `bind[flags] =` keywords: modifier list,
+ *          key (keysym name, mouse:N, code:N or catchall), dispatcher and argument,
+ *          and the flag letters. Parsing is strict like the monitor parser.
+ *          Nothing here depends on Hyprland or Lua, so it can be tested headless.
+ */
+
+namespace hyprlua {
+
+    /// @brief Modifier bits, identical to the wlroots/xkb modifier mask Hyprland uses
+    namespace mod {
+        constexpr uint32_t SHIFT = 1 << 0;
+        constexpr uint32_t CAPS  = 1 << 1;
+        constexpr uint32_t CTRL  = 1 << 2;
+        constexpr uint32_t ALT   = 1 << 3;
+        constexpr uint32_t MOD2  = 1 << 4;
+        constexpr uint32_t MOD3  = 1 << 5;
+        constexpr uint32_t SUPER = 1 << 6;
+        constexpr uint32_t MOD5  = 1 << 7;
+    }
+
+    /// @brief Dispatcher that runs bound Lua functions; its argument is the bind id
+    constexpr const char* LUA_DISPATCHER = "hyprlua";
+
+    struct BindSpec {
+        uint32_t    mods = 0;
+        std::string key;          ///< Keysym name or mouse:N; empty for code: and catchall binds
+        uint32_t    keycode  = 0; ///< From "code:N"
+        bool        catchAll = false;
+
+        std::string dispatcher;
+        std::string arg;
+        std::string submap; ///< Empty for the global submap
+        std::string description;
+
+        // Flag letters, see https://wiki.hyprland.org/Configuring/Binds/#bind-flags
+        bool        locked       = false; ///< l
+        bool        release      = false; ///< r
+        bool        click        = false; ///< c
+        bool        drag         = false; ///< g
+        bool        longPress    = false; ///< o
+        bool        repeat       = false; ///< e
+        bool        nonConsuming = false; ///< n
+        bool        mouse        = false; ///< m
+        bool        transparent  = false; ///< t
+        bool        ignoreMods   = false; ///< i
+        bool        bypass       = false; ///< p
+
+        bool        operator==(const BindSpec&) const = default;
+    };
+
+    /**
+     * @brief Parse a modifier list such as "SUPER SHIFT" or "CTRL+ALT"
+     * @details Accepts the names Hyprland does (SUPER, WIN, LOGO, META, MOD4, CTRL,
+     *          CONTROL, ALT, MOD1, SHIFT, CAPS, MOD2, MOD3, MOD5), case-insensitive,
+     *          separated by spaces, '+' or '_'
+     */
+    std::expected<uint32_t, std::string> parse_mods(std::string_view text);
+
+    /// @brief Parse "code:N", "catchall" or a key name into @p spec
+    std::expected<void, std::string> parse_key(std::string_view text, BindSpec& spec);
+
+    /**
+     * @brief Parse the letters after "bind", e.g. "le"
+     * @note 's' (multi-key binds) is not supported
+     */
+    std::expected<void, std::string> parse_flags(std::string_view flags, BindSpec& spec);
+
+    /// @brief Check combinations Hyprland rejects, such as a mouse bind to something other than movewindow or resizewindow
+    std::expected<void, std::string> validate_bind(const BindSpec& spec);
+
+    /**
+     * @brief Parse a Hyprland bind line
+     * @param line e.g. "binde = SUPER SHIFT, h, resizeactive, -50 0" or
+     *             "bindd = SUPER, q, Close window, killactive,"
+     * @param submap Submap the bind belongs to; a line cannot name one itself
+     */
+    std::expected<BindSpec, std::string> parse_bind_line(std::string_view line, std::string_view submap = "");
+
+    /// @brief Modifiers and key; Hyprland replaces or removes binds by this, whatever their flags
+    std::string trigger(const BindSpec& spec);
+
+    /// @brief Modifiers and key as written in a bind line, e.g. "SUPER SHIFT, h"
+    std::string keys_text(const BindSpec& spec);
+
+    /// @brief The spec as a bind line; parse_bind_line() reads it back to an equal spec, submap aside
+    std::string to_string(const BindSpec& spec);
+
+} // namespace hyprlua
+
+/// @brief Formats as to_string(), so a log call only builds the text when its level is enabled
+template <>
+struct std::formatter<hyprlua::BindSpec> : std::formatter<std::string_view> {
+    auto format(const hyprlua::BindSpec& spec, std::format_context& ctx) const {
+        return std::formatter<std::string_view>::format(hyprlua::to_string(spec), ctx);
+    }
+};
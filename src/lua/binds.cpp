@@ -0,0 +1,177 @@
+// binds.cpp
+#include "binds.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+#include "lua/callback.hpp"
+
+#include <sol/sol.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <format>
+
+namespace hyprlua::modules {
+
+    namespace {
+        /// @brief Keys a bind table may use; the first four may also be given by position
+        constexpr std::array<std::string_view, 7> TABLE_FIELDS = {"mods", "key", "dispatcher", "arg", "flags", "description", "submap"};
+
+        /// @brief Text of a string or number field
+        std::optional<std::string> field_text(const sol::object& value) {
+            switch (value.get_type()) {
+                case sol::type::string: return value.as<std::string>();
+                case sol::type::number: return std::format("{}", value.as<double>());
+                default: return std::nullopt;
+            }
+        }
+
+        /**
+         * @brief A BindSpec from the fields of a bind, validated like Hyprland would
+         * @param fields Values for TABLE_FIELDS; invalid or nil objects count as not given
+         * @param submap Submap for binds that do not name one
+         * @param callbacks Where a Lua function given as dispatcher goes; it is bound through the "hyprlua" dispatcher
+         */
+        std::expected<BindSpec, std::string> spec_from_fields(const std::array<sol::object, TABLE_FIELDS.size()>& fields, const std::string& submap, BindCallbacks& callbacks) {
+            const bool                                   function = fields[2].valid() && fields[2].get_type() == sol::type::function;
+            std::array<std::string, TABLE_FIELDS.size()> text;
+            for (size_t i = 0; i < fields.size(); ++i) {
+                if (!fields[i].valid() || fields[i].get_type() == sol::type::lua_nil || (i == 2 && function)) {
+                    continue;
+                }
+                auto value = field_text(fields[i]);
+                if (!value) {
+                    return std::unexpected(std::format("bind field '{}' must be a string", TABLE_FIELDS[i]));
+                }
+                text[i] = std::move(*value);
+            }
+
+            BindSpec spec;
+            auto     mods = parse_mods(text[0]);
+            if (!mods) {
+                return std::unexpected(mods.error());
+            }
+            spec.mods = *mods;
+            if (auto r = parse_key(text[1], spec); !r) {
+                return std::unexpected(r.error());
+            }
+            if (auto r = parse_flags(text[4], spec); !r) {
+                return std::unexpected(r.error());
+            }
+            spec.dispatcher  = std::move(text[2]);
+            spec.arg         = std::move(text[3]);
+            spec.description = std::move(text[5]);
+            spec.submap      = text[6].empty() ? submap : std::move(text[6]);
+
+            if (function) {
+                if (!spec.arg.empty()) {
+                    return std::unexpected(std::string("a bind to a Lua function takes no argument"));
+                }
+                spec.dispatcher = LUA_DISPATCHER;
+                spec.arg        = std::to_string(callbacks.entries.size());
+            }
+            if (auto r = validate_bind(spec); !r) {
+                return std::unexpected(r.error());
+            }
+
+            if (function) {
+                auto fn = fields[2].as<sol::main_protected_function>();
+                callbacks.entries.push_back({.fn = fn, .keys = keys_text(spec), .source = source_of(fn)});
+            }
+            return spec;
+        }
+
+        /**
+         * @brief Parse { mods, key, dispatcher, arg, flags = ..., description = ..., submap = ... }
+         * @details mods, key, dispatcher and arg may be given by name or as the first four
+         *          list entries. Unknown keys are errors, so a typo cannot drop a flag.
+         */
+        std::expected<BindSpec, std::string> spec_from_table(const sol::table& table, const std::string& submap, BindCallbacks& callbacks) {
+            std::array<sol::object, TABLE_FIELDS.size()> fields;
+            for (const auto& [k, v] : table) {
+                size_t index = TABLE_FIELDS.size();
+                if (k.get_type() == sol::type::number) {
+                    const double position = k.as<double>();
+                    if (position >= 1 && position <= 4 && position == static_cast<size_t>(position)) {
+                        index = static_cast<size_t>(position) - 1;
+                    }
+                } else if (k.get_type() == sol::type::string) {
+                    index = std::find(TABLE_FIELDS.begin(), TABLE_FIELDS.end(), k.as<std::string>()) - TABLE_FIELDS.begin();
+                }
+                if (index == TABLE_FIELDS.size()) {
+                    const auto name = k.get_type() == sol::type::string ? k.as<std::string>() : std::string("?");
+                    return std::unexpected(std::format("unknown bind field '{}': expected mods, key, dispatcher, arg, flags, description or submap", name));
+                }
+                fields[index] = v;
+            }
+            return spec_from_fields(fields, submap, callbacks);
+        }
+
+        /// @brief A BindSpec from a bind table or a `bind =` line
+        std::expected<BindSpec, std::string> spec_from_lua(const sol::object& value, const std::string& submap, BindCallbacks& callbacks) {
+            if (value.get_type() == sol::type::string) {
+                return parse_bind_line(value.as<std::string>(), submap);
+            }
+            if (value.get_type() == sol::type::table) {
+                return spec_from_table(value.as<sol::table>(), submap, callbacks);
+            }
+            return std::unexpected(std::string("expected a bind table or a bind line"));
+        }
+    }
+
+    BindCounters& bind_counters() {
+        static BindCounters counters;
+        return counters;
+    }
+
+    BindStats bind_stats() {
+        const auto& counters = bind_counters();
+        return {counters.added.load(std::memory_order_relaxed), counters.removed.load(std::memory_order_relaxed), counters.unchanged.load(std::memory_order_relaxed)};
+    }
+
+    void bind_binds(sol::state& lua, ChangeSet& changes, BindCallbacks& callbacks) {
+        log::info("Binding keybind Lua functions");
+
+        // Record only, like the monitor functions. Both return nothing, or the error for the Lua side to raise.
+        // A Lua function in place of the dispatcher is kept in callbacks until the config is replaced
+        lua.set_function("__hypr_add_bind", [&changes, &callbacks](const sol::object& value) -> sol::optional<std::string> {
+            HYPRLUA_TRACE_SCOPE("lua.__hypr_add_bind");
+            if (changes.committed) {
+                return std::string("hypr.binds.set can only be called while the config loads");
+            }
+            auto spec = spec_from_lua(value, "", callbacks);
+            if (!spec) {
+                return spec.error();
+            }
+            changes.binds.push_back(std::move(*spec));
+            return sol::nullopt;
+        });
+
+        // One call for a whole table of binds, so large bind tables cross into C++ once
+        lua.set_function("__hypr_add_binds", [&changes, &callbacks](const sol::table& list, sol::optional<std::string> submap) -> sol::optional<std::string> {
+            HYPRLUA_TRACE_SCOPE("lua.__hypr_add_binds");
+            if (changes.committed) {
+                return std::string("hypr.binds.set_many can only be called while the config loads");
+            }
+            const size_t count = list.size();
+            changes.binds.reserve(changes.binds.size() + count);
+            for (size_t i = 1; i <= count; ++i) {
+                sol::object entry = list[i];
+                auto        spec  = spec_from_lua(entry, submap.value_or(""), callbacks);
+                if (!spec) {
+                    return std::format("bind #{}: {}", i, spec.error());
+                }
+                changes.binds.push_back(std::move(*spec));
+            }
+            return sol::nullopt;
+        });
+
+        lua.set_function("__hypr_bind_stats", [](sol::this_state ts) {
+            sol::state_view lua(ts);
+            const auto      stats = bind_stats();
+            return lua.create_table_with("added", stats.added, "removed", stats.removed, "unchanged", stats.unchanged);
+        });
+
+        log::debug("Binds module successfully bound.");
+    }
+
+} // namespace hyprlua::modules
@@ -0,0 +1,75 @@
+// binds.hpp
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <sol/sol.hpp>
+#include <string>
+#include <vector>
+#include "lua/changeset.hpp"
+
+namespace hyprlua::modules {
+
+    /// @brief Keybinds added to and removed from Hyprland, and binds left in place as unchanged, since plugin load
+    struct BindStats {
+        uint64_t added     = 0;
+        uint64_t removed   = 0;
+        uint64_t unchanged = 0;
+    };
+
+    /// @brief The counters behind BindStats; written by the commit, read by __hypr_bind_stats from whichever thread runs the config
+    struct BindCounters {
+        std::atomic<uint64_t> added     = 0;
+        std::atomic<uint64_t> removed   = 0;
+        std::atomic<uint64_t> unchanged = 0;
+    };
+
+    /// @brief A Lua function bound to a key, with the time its calls took
+    struct BindCallback {
+        sol::main_protected_function fn;
+        std::string                  keys;   ///< e.g. "SUPER, x"
+        std::string                  source; ///< Where the function was defined, e.g. "hyprland.lua:12"
+        uint64_t                     count  = 0;
+        uint64_t                     lastNs = 0;
+        uint64_t                     maxNs  = 0;
+    };
+
+    /**
+     * @brief Lua functions bound to keys by one config run, indexed by bind id
+     * @details The binds themselves go through the "hyprlua" dispatcher with the id
+     *          as argument. Ids are handed out in call order, so an unchanged config
+     *          produces the same binds and the reload leaves them alone.
+     * @note Holds references into the config's Lua state; destroy it before the state
+     */
+    struct BindCallbacks {
+        std::vector<BindCallback> entries;
+    };
+
+    /// @brief Register the bind functions; calls are recorded into @p changes, Lua functions into @p callbacks
+    void bind_binds(sol::state& lua, ChangeSet& changes, BindCallbacks& callbacks);
+
+    BindCounters& bind_counters();
+    BindStats     bind_stats();
+
+    // The rest is binds_commit.cpp, which only the plugin links
+
+    /**
+     * @brief Commit recorded binds, adding and removing only those whose trigger changed
+     * @param callbacks The functions of the same config run; key presses call these from now on
+     * @note Compositor thread only
+     */
+    void commit_binds(const ChangeSet& changes, BindCallbacks& callbacks);
+
+    /// @brief Register the "hyprlua" dispatcher that runs bound Lua functions
+    void register_dispatcher();
+
+    /// @brief Add the committed binds again whenever Hyprland reloads its config and drops them
+    void register_bind_hooks();
+
+    /// @brief Remove every bind Hyprlua added, the dispatcher and the reload hook; called when the runtime shuts down
+    void remove_binds();
+
+    /// @brief Timings of the active config's Lua function binds as a JSON array, slowest first
+    std::string callbacks_json();
+
+} // namespace hyprlua::modules
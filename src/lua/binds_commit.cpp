@@ -0,0 +1,255 @@
+// binds_commit.cpp
+#include "binds.hpp"
+#include "utils.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+#include "globals.hpp"
+#include "json.hpp"
+#include "lua/watchdog.hpp"
+
+#include <hyprland/src/helpers/Color.hpp>
+#include <hyprland/src/managers/KeybindManager.hpp>
+#include <hyprland/src/plugins/PluginAPI.hpp>
+#include <sol/sol.hpp>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <unordered_map>
+#include <vector>
+
+namespace hyprlua::modules {
+
+    namespace {
+        /**
+         * @brief Binds Hyprlua added on one trigger, and Hyprland's copies of them
+         * @details Hyprland drops every bind when it reloads its own config; an
+         *          expired copy tells the next commit to add the group again.
+         */
+        struct AppliedGroup {
+            std::vector<BindSpec>     specs;
+            std::vector<WP<SKeybind>> keybinds;
+        };
+
+        // Compositor thread only
+        std::unordered_map<std::string, AppliedGroup> applied;
+
+        /// @brief Binds of the active config with a known dispatcher, added again when Hyprland reloads; compositor thread only
+        std::vector<BindSpec>                         committed;
+
+        SP<HOOK_CALLBACK_FN>                          reloadHook;
+
+        /// @brief Functions of the active config, called by the dispatcher; compositor thread only
+        BindCallbacks*                                activeCallbacks = nullptr;
+
+        constexpr const char*                         DISPATCHER = LUA_DISPATCHER;
+
+        /// @brief Callbacks slower than a frame at 60 Hz are logged
+        constexpr uint64_t                            SLOW_CALLBACK_NS = 16'000'000;
+
+        /**
+         * @brief Key press path of a Lua function bind
+         * @details The argument is the bind id; the function is an index away, with no
+         *          table lookup and no allocation unless the call fails or is slow
+         */
+        SDispatchResult run_callback(const std::string& arg) {
+            HYPRLUA_TRACE_SCOPE("bind.callback");
+            size_t id = 0;
+            const auto [end, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), id);
+            if (ec != std::errc{} || end != arg.data() + arg.size() || !activeCallbacks || id >= activeCallbacks->entries.size()) {
+                return {.success = false, .error = std::format("no Lua bind with id '{}'", arg)};
+            }
+
+            auto&                          callback = activeCallbacks->entries[id];
+            Budget                         budget(callback.fn.lua_state(), BudgetKind::Callback);
+            const auto                     start  = std::chrono::steady_clock::now();
+            sol::protected_function_result result = callback.fn();
+            const uint64_t                 ns       = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+            ++callback.count;
+            callback.lastNs = ns;
+            callback.maxNs  = std::max(callback.maxNs, ns);
+
+            if (!result.valid()) {
+                sol::error err = result;
+                log::error("Lua bind {} ({}) failed: {}", callback.keys, callback.source, err.what());
+                sendNotification(std::format("[Hyprlua] Bind {} failed: {}", callback.keys, err.what()), CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+                return {.success = false, .error = err.what()};
+            }
+            if (ns > SLOW_CALLBACK_NS) {
+                log::error("Slow Lua bind {} ({}) took {:.1f} ms", callback.keys, callback.source, ns / 1e6);
+            }
+            return {};
+        }
+
+        /// @brief Hyprland's form of a spec; mouse binds go through the "mouse" dispatcher
+        SKeybind make_keybind(const BindSpec& spec) {
+            SKeybind kb;
+            kb.key            = spec.key;
+            kb.keycode        = spec.keycode;
+            kb.catchAll       = spec.catchAll;
+            kb.modmask        = spec.mods;
+            kb.handler        = spec.mouse ? "mouse" : spec.dispatcher;
+            kb.arg            = spec.mouse ? spec.dispatcher : spec.arg;
+            kb.locked         = spec.locked;
+            kb.submap         = spec.submap;
+            kb.description    = spec.description;
+            kb.release        = spec.release;
+            kb.repeat         = spec.repeat;
+            kb.longPress      = spec.longPress;
+            kb.mouse          = spec.mouse;
+            kb.nonConsuming   = spec.nonConsuming;
+            kb.transparent    = spec.transparent;
+            kb.ignoreMods     = spec.ignoreMods;
+            kb.hasDescription = !spec.description.empty();
+            kb.dontInhibit    = spec.bypass;
+            kb.click          = spec.click;
+            kb.drag           = spec.drag;
+            return kb;
+        }
+
+        /// @brief Whether Hyprland still holds every bind of the group
+        bool present(const AppliedGroup& group) {
+            return std::ranges::none_of(group.keybinds, [](const WP<SKeybind>& kb) { return kb.expired(); });
+        }
+
+        /// @brief Remove the group's own binds; binds from hyprland.conf or another plugin on the same trigger stay
+        void remove_group(const AppliedGroup& group) {
+            const auto removed = std::erase_if(g_pKeybindManager->m_keybinds, [&group](const SP<SKeybind>& kb) {
+                return std::ranges::any_of(group.keybinds, [&kb](const WP<SKeybind>& own) { return own.lock() == kb; });
+            });
+            bind_counters().removed.fetch_add(removed, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Bring Hyprland's binds in line with @p binds
+         * @details Binds are grouped by trigger (modifiers and key), so their order
+         *          within a trigger is kept. Groups identical to the ones applied last
+         *          time are left alone; changed groups are removed and added again, and
+         *          groups no longer wanted are removed. Only the binds Hyprlua added
+         *          are removed, never others on the same trigger. Binds go straight to
+         *          the keybind manager, so none of this reparses Hyprland's config.
+         * @param announce Whether to notify about added and removed binds
+         */
+        void apply_binds(const std::vector<BindSpec>& binds, bool announce) {
+            std::vector<std::string>                                     order;
+            std::unordered_map<std::string, std::vector<const BindSpec*>> wanted;
+            for (const auto& spec : binds) {
+                auto [it, inserted] = wanted.try_emplace(trigger(spec));
+                if (inserted) {
+                    order.push_back(it->first);
+                }
+                it->second.push_back(&spec);
+            }
+
+            auto same = [](const AppliedGroup& group, const std::vector<const BindSpec*>& specs) {
+                return std::ranges::equal(group.specs, specs, [](const BindSpec& a, const BindSpec* b) { return a == *b; });
+            };
+
+            for (auto it = applied.begin(); it != applied.end();) {
+                auto next = wanted.find(it->first);
+                if (!present(it->second)) {
+                    // Hyprland reloaded its own config and dropped the group already
+                    it = applied.erase(it);
+                } else if (next == wanted.end() || !same(it->second, next->second)) {
+                    log::debug("Removing binds on {}", it->first);
+                    remove_group(it->second);
+                    if (announce && next == wanted.end()) {
+                        sendSummaryNotification("removed", "keybind", CHyprColor{0.2, 0.6, 1.0, 1.0}, 3000);
+                    }
+                    it = applied.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+
+            for (const auto& key : order) {
+                const auto& specs = wanted[key];
+                if (applied.contains(key)) {
+                    bind_counters().unchanged.fetch_add(specs.size(), std::memory_order_relaxed);
+                    continue;
+                }
+
+                AppliedGroup group;
+                for (const auto* spec : specs) {
+                    log::debug("Adding bind: {}", *spec);
+                    g_pKeybindManager->addKeybind(make_keybind(*spec));
+                    group.specs.push_back(*spec);
+                    group.keybinds.push_back(g_pKeybindManager->m_keybinds.back());
+                }
+                applied.emplace(key, std::move(group));
+                bind_counters().added.fetch_add(specs.size(), std::memory_order_relaxed);
+                if (announce) {
+                    sendSummaryNotification("applied", "keybind", CHyprColor{0.0, 1.0, 0.0, 1.0}, 3000);
+                }
+            }
+        }
+    }
+
+    /// @brief Apply the binds of a config run as one batch, see apply_binds()
+    void commit_binds(const ChangeSet& changes, BindCallbacks& callbacks) {
+        HYPRLUA_TRACE_SCOPE("binds.commit");
+        activeCallbacks = &callbacks;
+
+        committed.clear();
+        committed.reserve(changes.binds.size());
+        for (const auto& spec : changes.binds) {
+            // Checked here rather than while recording, since dispatchers belong to the compositor thread
+            if (!spec.mouse && !g_pKeybindManager->m_dispatchers.contains(spec.dispatcher)) {
+                log::error("Unknown dispatcher '{}' in {}", spec.dispatcher, to_string(spec));
+                sendNotification(std::format("[Hyprlua] Unknown dispatcher '{}' in {}", spec.dispatcher, to_string(spec)), CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+                continue;
+            }
+            committed.push_back(spec);
+        }
+        apply_binds(committed, true);
+    }
+
+    void register_bind_hooks() {
+        // A reload of hyprland.conf drops every bind, Hyprlua's included
+        reloadHook = HyprlandAPI::registerCallbackDynamic(PHANDLE, "configReloaded", [](void*, SCallbackInfo&, std::any) {
+            if (activeCallbacks) {
+                HYPRLUA_TRACE_SCOPE("binds.restore");
+                apply_binds(committed, false);
+            }
+        });
+    }
+
+    void register_dispatcher() {
+        HyprlandAPI::addDispatcherV2(PHANDLE, DISPATCHER, [](std::string arg) { return run_callback(arg); });
+    }
+
+    void remove_binds() {
+        for (const auto& [key, group] : applied) {
+            if (present(group)) {
+                remove_group(group);
+            }
+        }
+        applied.clear();
+        committed.clear();
+        reloadHook.reset();
+        activeCallbacks = nullptr;
+        HyprlandAPI::removeDispatcher(PHANDLE, DISPATCHER);
+    }
+
+    std::string callbacks_json() {
+        if (!activeCallbacks) {
+            return "[]";
+        }
+
+        std::vector<const BindCallback*> sorted;
+        for (const auto& callback : activeCallbacks->entries) {
+            sorted.push_back(&callback);
+        }
+        std::ranges::stable_sort(sorted, [](const BindCallback* a, const BindCallback* b) { return a->maxNs > b->maxNs; });
+
+        json::Writer w;
+        w.beginArray();
+        for (const auto* c : sorted) {
+            w.beginObject().field("keys", c->keys).field("source", c->source).field("count", c->count).field("last_us", std::round(c->lastNs / 100.0) / 10.0).field("max_us", std::round(c->maxNs / 100.0) / 10.0).end();
+        }
+        return w.end().str();
+    }
+
+} // namespace hyprlua::modules
@@ -0,0 +1,187 @@
+// bytecode_cache.cpp
+#include "bytecode_cache.hpp"
+#include "hash.hpp"
+#include "logger.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hyprlua::cache {
+
+    namespace fs = std::filesystem;
+
+    namespace {
+        /// @brief Fixed-size record in front of every cached chunk
+        struct EntryHeader {
+            char     magic[8];
+            uint64_t sourceHash;
+            uint64_t versionHash;
+        };
+
+        constexpr char ENTRY_MAGIC[8] = {'H', 'L', 'U', 'A', 'C', '0', '1', '\0'};
+
+        /// @brief Identifies the bytecode format: Lua release plus the sizes lua_dump depends on
+        uint64_t version_hash() {
+            static const uint64_t h = hash::fnv1a(std::string(LUA_RELEASE) + "/" + std::to_string(sizeof(lua_Integer)) + "/" + std::to_string(sizeof(lua_Number)) + "/" +
+                                                  std::to_string(sizeof(void*)));
+            return h;
+        }
+
+        bool read_file(const std::string& path, std::string& out) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file) {
+                return false;
+            }
+            std::ostringstream ss;
+            ss << file.rdbuf();
+            out = std::move(ss).str();
+            return true;
+        }
+
+        /**
+         * @brief directory(), created with mode 0700 if missing
+         * @return Empty if there is no cache directory, or it is not a directory only this user can write to;
+         *         entries from there could run as the config
+         */
+        std::string private_directory() {
+            const auto dir = directory();
+            if (dir.empty()) {
+                return "";
+            }
+
+            std::error_code ec;
+            fs::create_directories(fs::path(dir).parent_path(), ec);
+            if (::mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST) {
+                log::debug("Could not create bytecode cache directory {}", dir);
+                return "";
+            }
+
+            struct stat st {};
+            if (::lstat(dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode) || st.st_uid != ::geteuid() || (st.st_mode & (S_IWGRP | S_IWOTH)) != 0) {
+                log::debug("Bytecode cache off: {} is not a directory private to this user", dir);
+                return "";
+            }
+            return dir;
+        }
+
+        /// @brief Cache entry for a source file, named after the hash of its absolute path; empty if the cache is off
+        std::string entry_path(const std::string& source) {
+            const auto dir = private_directory();
+            if (dir.empty()) {
+                return "";
+            }
+
+            std::error_code ec;
+            const auto      absolute = fs::absolute(source, ec);
+            if (ec) {
+                return "";
+            }
+
+            char name[32];
+            std::snprintf(name, sizeof(name), "%016llx.luac", static_cast<unsigned long long>(hash::fnv1a(absolute.string())));
+            return dir + "/" + name;
+        }
+
+        int dump_writer(lua_State*, const void* p, size_t size, void* ud) {
+            static_cast<std::string*>(ud)->append(static_cast<const char*>(p), size);
+            return 0;
+        }
+
+        /// @brief Dump the chunk on top of the stack into the cache, leaving the stack untouched
+        void store(lua_State* L, const std::string& entry, uint64_t sourceHash) {
+            EntryHeader header;
+            std::memcpy(header.magic, ENTRY_MAGIC, sizeof(header.magic));
+            header.sourceHash  = sourceHash;
+            header.versionHash = version_hash();
+
+            std::string data(reinterpret_cast<const char*>(&header), sizeof(header));
+            if (lua_dump(L, &dump_writer, &data, 0) != 0) {
+                return;
+            }
+
+            // Write to a private name and rename, so readers never see a partial entry
+            std::error_code   ec;
+            const std::string tmp = entry + ".tmp." + std::to_string(getpid());
+            {
+                std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+                if (!out || !out.write(data.data(), static_cast<std::streamsize>(data.size()))) {
+                    log::debug("Could not write bytecode cache entry {}", tmp);
+                    fs::remove(tmp, ec);
+                    return;
+                }
+            }
+            fs::rename(tmp, entry, ec);
+            if (ec) {
+                fs::remove(tmp, ec);
+            }
+        }
+
+        /**
+         * @brief Push the chunk for @p path, or an error message, onto the stack
+         * @return LUA_OK or the status of the failed load
+         */
+        int load_chunk(lua_State* L, const std::string& path) {
+            std::string source;
+            if (!read_file(path, source)) {
+                lua_pushfstring(L, "cannot open %s", path.c_str());
+                return LUA_ERRFILE;
+            }
+
+            const std::string chunkname  = "@" + path;
+            const uint64_t    sourceHash = hash::fnv1a(source);
+            const std::string entry      = entry_path(path);
+
+            std::string       cached;
+            if (!entry.empty() && read_file(entry, cached) && cached.size() > sizeof(EntryHeader)) {
+                EntryHeader header;
+                std::memcpy(&header, cached.data(), sizeof(header));
+                if (std::memcmp(header.magic, ENTRY_MAGIC, sizeof(header.magic)) == 0 && header.sourceHash == sourceHash && header.versionHash == version_hash()) {
+                    if (luaL_loadbufferx(L, cached.data() + sizeof(header), cached.size() - sizeof(header), chunkname.c_str(), "b") == LUA_OK) {
+                        return LUA_OK;
+                    }
+                    // Unreadable entry: drop the error and recompile below
+                    lua_pop(L, 1);
+                }
+            }
+
+            // Like luaL_loadfile, ignore a leading #! line but keep line numbers intact
+            if (!source.empty() && source[0] == '#') {
+                source.erase(0, source.find('\n'));
+            }
+
+            const int status = luaL_loadbufferx(L, source.data(), source.size(), chunkname.c_str(), "t");
+            if (status == LUA_OK && !entry.empty()) {
+                store(L, entry, sourceHash);
+            }
+            return status;
+        }
+    }
+
+    std::string directory() {
+        if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+            return std::string(xdg) + "/hyprlua";
+        }
+        if (const char* home = std::getenv("HOME"); home && *home) {
+            return std::string(home) + "/.cache/hyprlua";
+        }
+        return "";
+    }
+
+    int load(lua_State* L, const std::string& path) {
+        return load_chunk(L, path);
+    }
+
+    sol::load_result load_file(sol::state_view lua, const std::string& path) {
+        lua_State* L      = lua.lua_state();
+        const int  status = load_chunk(L, path);
+        return sol::load_result(L, lua_absindex(L, -1), 1, 1, static_cast<sol::load_status>(status));
+    }
+
+} // namespace hyprlua::cache
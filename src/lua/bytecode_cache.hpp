@@ -0,0 +1,41 @@
+// bytecode_cache.hpp
+#pragma once
+
+#include <string>
+#include <sol/sol.hpp>
+
+/**
+ * @file bytecode_cache.hpp
+ * @brief On-disk cache of compiled Lua chunks
+ * @details Chunks are stored as lua_dump output under $XDG_CACHE_HOME/hyprlua,
+ *          one entry per source file. Each entry records the hash of the source
+ *          it was compiled from and the Lua version, and is recompiled as soon
+ *          as either differs, so no explicit invalidation is needed. The cache is
+ *          off when there is no cache directory, or when the directory is not
+ *          owned by this user.
+ */
+
+namespace hyprlua::cache {
+
+    /**
+     * @brief Directory holding cached chunks
+     * @return $XDG_CACHE_HOME/hyprlua, falling back to ~/.cache/hyprlua; empty if neither variable is set
+     */
+    std::string directory();
+
+    /**
+     * @brief Load a Lua file as a chunk, from the cache when it is still valid
+     * @param lua State to load the chunk into
+     * @param path Source file; also used as the chunk name so errors keep file and line
+     * @return The loaded chunk, or the load error
+     * @note A cache that cannot be read or written only costs the cache, never the load
+     */
+    sol::load_result load_file(sol::state_view lua, const std::string& path);
+
+    /**
+     * @brief load_file() for the C API: push the chunk, or an error message, onto the stack
+     * @return LUA_OK or the status of the failed load
+     */
+    int load(lua_State* L, const std::string& path);
+
+} // namespace hyprlua::cache
@@ -0,0 +1,30 @@
+// callback.hpp
+#pragma once
+
+#include <format>
+#include <sol/sol.hpp>
+#include <string>
+
+/**
+ * @file callback.hpp
+ * @brief Helpers for the Lua functions a config hands to the plugin to call later
+ * @details Binds, event subscriptions, rule predicates and timers keep the function
+ *          past the call that passed it in. They hold it as a sol::main_protected_function,
+ *          which is anchored on the state's main thread: a plain protected_function keeps
+ *          the lua_State it was passed from, and if that was a coroutine it is suspended
+ *          or dead by the time the callback runs.
+ */
+
+namespace hyprlua {
+
+    /// @brief "file:line" where @p fn was defined
+    template <typename Function>
+    std::string source_of(const Function& fn) {
+        lua_State* L = fn.lua_state();
+        fn.push();
+        lua_Debug ar;
+        lua_getinfo(L, ">S", &ar);
+        return std::format("{}:{}", ar.short_src, ar.linedefined);
+    }
+
+} // namespace hyprlua
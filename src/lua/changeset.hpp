@@ -0,0 +1,96 @@
+// changeset.hpp
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "lua/bind_spec.hpp"
+#include "lua/monitor_spec.hpp"
+#include "lua/option_spec.hpp"
+#include "lua/state_store.hpp"
+#include "lua/window_rules.hpp"
+
+/**
+ * @file changeset.hpp
+ * @brief Changes recorded while a Lua config runs
+ * @details Bound C++ functions never touch Hyprland while the config executes.
+ *          They append what the config asked for to a ChangeSet, which is applied
+ *          on the compositor thread once the whole config ran successfully.
+ */
+
+namespace hyprlua {
+
+    /// @brief hypr.notifications.configure call; configs without one get the defaults
+    struct NotificationSettings {
+        uint32_t burst      = 3;
+        uint32_t intervalMs = 1000;
+
+        bool     operator==(const NotificationSettings&) const = default;
+    };
+
+    /// @brief hypr.watchdog.configure call, in milliseconds; 0 disables a budget
+    /// @note The load budget is not here: it applies before any config is, see HYPRLUA_LOAD_MS
+    struct WatchdogSettings {
+        uint32_t reloadMs   = 3000;
+        uint32_t callbackMs = 50;
+
+        bool     operator==(const WatchdogSettings&) const = default;
+    };
+
+    /// @brief hypr.store.configure call; without one the store lives in memory only
+    struct StoreSettings {
+        bool     persist = false; ///< Keep a snapshot on disk, see paths::store_file()
+        uint32_t flushMs = 1000;  ///< Longest a write waits before the snapshot is rewritten
+
+        bool     operator==(const StoreSettings&) const = default;
+    };
+
+    /// @brief hypr.store.set call made while the config runs
+    struct StoreWrite {
+        std::string key;
+        StoreValue  value; ///< std::monostate removes the key
+    };
+
+    /// @brief What a ChangeSet held at one point, to tell whether anything was recorded since
+    struct ChangeMark {
+        size_t                              monitors    = 0;
+        size_t                              binds       = 0;
+        size_t                              options     = 0;
+        size_t                              rules       = 0;
+        size_t                              storeWrites = 0;
+        size_t                              storeReads  = 0;
+        std::optional<NotificationSettings> notifications;
+        std::optional<WatchdogSettings>     watchdog;
+        std::optional<StoreSettings>        store;
+
+        bool                                operator==(const ChangeMark&) const = default;
+    };
+
+    /// @brief Everything a config run wants applied, in call order
+    struct ChangeSet {
+        /// @brief One entry per hypr.monitors.add / hypr.monitors.disable call; specs are shared with the parse cache
+        std::vector<std::shared_ptr<const MonitorSpec>> monitors;
+        /// @brief One entry per bind, in call order
+        std::vector<BindSpec>                           binds;
+        /// @brief One entry per option of a setup{} call, in call order; the last value for a key wins
+        std::vector<OptionSetting>                      options;
+        /// @brief One entry per hypr.rules.add call, in call order; patterns are compiled already
+        std::vector<WindowRuleSpec>                     rules;
+        std::optional<NotificationSettings>             notifications;
+        std::optional<WatchdogSettings>                 watchdog;
+        std::optional<StoreSettings>                    store;
+        /// @brief One entry per hypr.store.set call, in call order; the shared store only sees them once the config is applied
+        std::vector<StoreWrite>                         storeWrites;
+        /// @brief hypr.store reads while the config ran; a module that read the store is not replayed
+        size_t                                          storeReads = 0;
+        /// @brief Set once applied; calls from the config's timers and callbacks after that are errors, there is nothing left to record into
+        bool                                            committed = false;
+
+        ChangeMark                                      mark() const {
+            return {monitors.size(), binds.size(), options.size(), rules.size(), storeWrites.size(), storeReads, notifications, watchdog, store};
+        }
+    };
+
+} // namespace hyprlua
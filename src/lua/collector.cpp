@@ -0,0 +1,59 @@
+// collector.cpp
+#include "collector.hpp"
+#include "trace.hpp"
+#include "lua/allocator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+namespace hyprlua::modules {
+
+    namespace {
+        /// @brief Growth below this never triggers a step, so small states are not collected after every callback
+        constexpr uint64_t             MIN_STEP_BYTES = 256 * 1024;
+
+        // Allocator of the active state, the lua_Alloc user data every thread of it shares
+        std::atomic<const void*>       paced = nullptr;
+
+        // Compositor thread only: bytes in use after the last step
+        uint64_t                       baseline = 0;
+
+        const LuaAllocator*            allocator_of(lua_State* L) {
+            void* ud = nullptr;
+            lua_getallocf(L, &ud);
+            return static_cast<const LuaAllocator*>(ud);
+        }
+    }
+
+    void pace_collector(lua_State* L) {
+        lua_gc(L, LUA_GCSTOP, 0);
+        const auto* allocator = allocator_of(L);
+        baseline              = allocator->stats().bytes;
+        paced.store(allocator, std::memory_order_relaxed);
+    }
+
+    void collect_step(lua_State* L) {
+        const auto* allocator = allocator_of(L);
+        if (allocator != paced.load(std::memory_order_relaxed)) {
+            return;
+        }
+        const uint64_t bytes = allocator->stats().bytes;
+        if (bytes < baseline + std::max(baseline / 5, MIN_STEP_BYTES)) {
+            return;
+        }
+        {
+            HYPRLUA_TRACE_SCOPE("lua.gc.step");
+            // As much work as the automatic collector would have done for this much allocation
+            const uint64_t kb = std::min<uint64_t>((bytes - baseline) / 1024, std::numeric_limits<int>::max());
+            lua_gc(L, LUA_GCSTEP, static_cast<int>(kb));
+        }
+        baseline = allocator->stats().bytes;
+    }
+
+    void remove_collector() {
+        paced.store(nullptr, std::memory_order_relaxed);
+        baseline = 0;
+    }
+
+} // namespace hyprlua::modules
@@ -0,0 +1,35 @@
+// collector.hpp
+#pragma once
+
+#include <sol/sol.hpp>
+
+/**
+ * @file collector.hpp
+ * @brief Garbage collection of the active config state, in timed steps
+ * @details Lua collects inside whichever allocation crosses its threshold, so its
+ *          pauses land in the middle of callbacks and cannot be told apart from the
+ *          callback's own time. Once a config is active its automatic collector is
+ *          stopped and the runtime steps it instead: after each callback, and from the
+ *          watchdog hook during long ones, whenever the state grew by a fifth since the
+ *          last step. Each step is timed as "lua.gc.step". Lua's emergency collection
+ *          still runs if an allocation fails at the memory limit.
+ */
+
+namespace hyprlua::modules {
+
+    /**
+     * @brief Take over collection of @p L, the state becoming active
+     * @note Compositor thread only
+     */
+    void pace_collector(lua_State* L);
+
+    /**
+     * @brief Run one timed collector step if @p L belongs to the paced state and grew enough
+     * @details Costs a pointer compare for any other state, so it may be called from any thread.
+     */
+    void collect_step(lua_State* L);
+
+    /// @brief Stop pacing; called when the runtime shuts down
+    void remove_collector();
+
+} // namespace hyprlua::modules
@@ -0,0 +1,138 @@
+// conf_writer.cpp
+#include "conf_writer.hpp"
+
+#include <algorithm>
+#include <format>
+#include <unordered_map>
+#include <vector>
+
+namespace hyprlua {
+
+    namespace {
+        /// @brief The last spec recorded per output, in the order outputs first appear
+        std::vector<const MonitorSpec*> collapse_monitors(const ChangeSet& changes) {
+            std::vector<const MonitorSpec*>         order;
+            std::unordered_map<std::string, size_t> index;
+            for (const auto& spec : changes.monitors) {
+                auto [it, inserted] = index.try_emplace(spec->name, order.size());
+                if (inserted) {
+                    order.push_back(spec.get());
+                } else {
+                    order[it->second] = spec.get();
+                }
+            }
+            return order;
+        }
+
+        /// @brief The last value recorded per option, in the order options were first set
+        std::vector<const OptionSetting*> collapse_options(const ChangeSet& changes) {
+            std::vector<const OptionSetting*>       order;
+            std::unordered_map<std::string, size_t> index;
+            for (const auto& setting : changes.options) {
+                auto [it, inserted] = index.try_emplace(setting.key, order.size());
+                if (inserted) {
+                    order.push_back(&setting);
+                } else {
+                    order[it->second] = &setting;
+                }
+            }
+            return order;
+        }
+
+        /// @brief Submaps in the order they are first bound in; the global one is always first
+        std::vector<std::string> submap_order(const ChangeSet& changes) {
+            std::vector<std::string> order{""};
+            for (const auto& spec : changes.binds) {
+                if (std::find(order.begin(), order.end(), spec.submap) == order.end()) {
+                    order.push_back(spec.submap);
+                }
+            }
+            return order;
+        }
+    }
+
+    ConfStats write_conf(const ChangeSet& changes, std::ostream& out, const std::string& source) {
+        ConfStats stats;
+        out << "# Generated by hyprlua-compile";
+        if (!source.empty()) {
+            out << " from " << source;
+        }
+        out << "; edits here are overwritten\n";
+
+        const auto options = collapse_options(changes);
+        if (!options.empty()) {
+            out << '\n';
+        }
+        for (const auto* setting : options) {
+            out << setting->key << " = " << option_text(setting->value) << '\n';
+            ++stats.options;
+        }
+
+        const auto monitors = collapse_monitors(changes);
+        if (!monitors.empty()) {
+            out << '\n';
+        }
+        for (const auto* spec : monitors) {
+            out << "monitor = " << to_string(*spec) << '\n';
+            ++stats.monitors;
+        }
+        for (const auto* spec : monitors) {
+            if (spec->disabled) {
+                continue;
+            }
+            for (size_t i = 0; i < spec->workspaces.size(); ++i) {
+                out << "workspace = " << spec->workspaces[i] << ",monitor:" << spec->name << (i == 0 ? ",default:true\n" : "\n");
+                ++stats.workspaces;
+            }
+        }
+
+        for (const auto& submap : submap_order(changes)) {
+            bool opened = false;
+            for (const auto& spec : changes.binds) {
+                if (spec.submap != submap) {
+                    continue;
+                }
+                if (!opened) {
+                    out << '\n';
+                    if (!submap.empty()) {
+                        out << "submap = " << submap << '\n';
+                    }
+                    opened = true;
+                }
+                if (spec.dispatcher == LUA_DISPATCHER) {
+                    // The id only means something to the plugin that recorded it
+                    out << "# " << keys_text(spec) << ": bound to a Lua function, which needs the plugin\n";
+                    ++stats.luaBinds;
+                    continue;
+                }
+                out << to_string(spec) << '\n';
+                ++stats.binds;
+            }
+            if (opened && !submap.empty()) {
+                out << "submap = reset\n";
+            }
+        }
+
+        if (!changes.rules.empty()) {
+            out << '\n';
+        }
+        for (const auto& rule : changes.rules) {
+            std::string fields;
+            for (size_t f = 0; f < RULE_FIELD_COUNT; ++f) {
+                if (!rule.fields[f].any()) {
+                    fields += std::format(", {}:{}", field_name(static_cast<RuleField>(f)), rule.fields[f].pattern());
+                }
+            }
+            for (const auto& action : rule.actions) {
+                if (rule.predicate >= 0) {
+                    out << "# windowrulev2 = " << action.text << fields << ": also has a Lua when function, which needs the plugin\n";
+                } else {
+                    out << "windowrulev2 = " << action.text << fields << '\n';
+                }
+            }
+            ++(rule.predicate >= 0 ? stats.luaRules : stats.rules);
+        }
+        return stats;
+    }
+
+} // namespace hyprlua
@@ -0,0 +1,41 @@
+// conf_writer.hpp
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include "lua/changeset.hpp"
+
+/**
+ * @file conf_writer.hpp
+ * @brief Write a recorded ChangeSet as a hyprland.conf
+ * @details Output is deterministic: options first, one line per option in the order
+ *          they were first set (the last value wins, as in commit_options()), then
+ *          monitors, one line per output in the order the outputs were first configured
+ *          (the last call for an output wins, as in commit_monitors()), then their
+ *          workspace rules, then binds in call order grouped by submap, then window
+ *          rules as one windowrulev2 line per action. Nothing here depends on
+ *          Hyprland or Lua.
+ */
+
+namespace hyprlua {
+
+    /// @brief What write_conf() wrote
+    struct ConfStats {
+        uint32_t options    = 0;
+        uint32_t monitors   = 0;
+        uint32_t workspaces = 0;
+        uint32_t binds      = 0;
+        uint32_t luaBinds   = 0; ///< Binds to Lua functions, written commented out
+        uint32_t rules      = 0;
+        uint32_t luaRules   = 0; ///< Window rules with a when function, written commented out
+    };
+
+    /**
+     * @brief Stream @p changes to @p out in hyprland.conf syntax
+     * @param source Named in the header comment; omitted if empty
+     * @note Binds to Lua functions and rules with a when function only work through the plugin and are written as comments
+     */
+    ConfStats write_conf(const ChangeSet& changes, std::ostream& out, const std::string& source = "");
+
+} // namespace hyprlua
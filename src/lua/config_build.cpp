@@ -0,0 +1,177 @@
+// config_build.cpp
+#include "config_build.hpp"
+
+#include <sol/sol.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <format>
+#include <string_view>
+#include "logger.hpp"
+#include "trace.hpp"
+#include "lua/bytecode_cache.hpp"
+
+// Modules
+#include "lua/monitors.hpp"
+#include "lua/notifications.hpp"
+#include "lua/options.hpp"
+#include "lua/profiler.hpp"
+#include "lua/stats.hpp"
+#include "lua/store.hpp"
+
+namespace hyprlua {
+
+    namespace fs = std::filesystem;
+
+    /**
+     * @brief Load a file through the bytecode cache and run it
+     * @return The error message, or std::nullopt on success
+     */
+    static std::optional<std::string> run_file(sol::state& lua, const std::string& path) {
+        sol::load_result chunk = cache::load_file(lua, path);
+        if (!chunk.valid()) {
+            sol::error err = chunk;
+            return err.what();
+        }
+
+        sol::protected_function        fn     = chunk;
+        sol::protected_function_result result = fn();
+        if (!result.valid()) {
+            sol::error err = result;
+            return err.what();
+        }
+        return std::nullopt;
+    }
+
+    /// @brief Log a Lua error one record per line, so a traceback is not cut off at the logger's record size
+    static void log_error_lines(std::string_view what, const std::string& text) {
+        log::error("{}", what);
+        for (size_t start = 0; start < text.size();) {
+            const size_t end = std::min(text.find('\n', start), text.size());
+            log::error("  {}", std::string_view(text).substr(start, end - start));
+            start = end + 1;
+        }
+    }
+
+    ModuleGraph& module_graph() {
+        static ModuleGraph graph;
+        return graph;
+    }
+
+    BuildResult build_config(const std::string& modules_path, const std::string& user_config_path, modules::BudgetKind budget) {
+        HYPRLUA_TRACE_SCOPE("config.build");
+        BuildResult result;
+        auto        state = std::make_unique<ConfigState>();
+        auto&       lua   = state->lua;
+
+#if LUA_VERSION_NUM >= 504
+        // Config tables live as long as the state while callbacks churn short-lived tables,
+        // which is the split the generational collector is built for
+        lua_gc(lua.lua_state(), LUA_GCGEN, 0, 0);
+#endif
+        modules::install_watchdog(lua.lua_state());
+
+        // Open only required libraries for safety
+        lua.open_libraries(sol::lib::base, sol::lib::package, sol::lib::coroutine, sol::lib::math, sol::lib::table, sol::lib::string);
+
+        // Resolve require() next to the user config and serve it from the bytecode cache
+        const std::string configDir = fs::path(user_config_path).parent_path().string();
+        lua["package"]["path"]      = configDir + "/?.lua;" + configDir + "/?/init.lua;" + lua["package"]["path"].get<std::string>();
+        state->modules = module_graph().attach(lua, state->changes, user_config_path,
+                                               [raw = state.get()] {
+                                                   return raw->callbacks.entries.size() + raw->subscriptions.entries.size() + raw->predicates.entries.size() + raw->timers.entries.size();
+                                               });
+
+        // Register all C++ modules
+        hyprlua::modules::bind_monitors(lua, state->changes);
+        hyprlua::modules::bind_binds(lua, state->changes, state->callbacks);
+        hyprlua::modules::bind_events(lua, state->subscriptions);
+        hyprlua::modules::bind_notifications(lua, state->changes);
+        hyprlua::modules::bind_watchdog(lua, state->changes);
+        hyprlua::modules::bind_options(lua, state->changes);
+        hyprlua::modules::bind_rules(lua, state->changes, state->predicates);
+        hyprlua::modules::bind_stats(lua, state->allocator);
+        hyprlua::modules::bind_profile(lua);
+        hyprlua::modules::bind_timers(lua, state->timers);
+        hyprlua::modules::bind_store(lua, state->changes);
+
+        // Optional: inject global table (like nvim)
+        lua["hypr"]                  = lua.create_table();
+        lua["hypr"]["version"]       = "0.1.0";
+        lua["hypr"]["monitors"]      = lua.create_table(); // prepare placeholder
+        lua["hypr"]["binds"]         = lua.create_table();
+        lua["hypr"]["events"]        = lua.create_table();
+        lua["hypr"]["notifications"] = lua.create_table();
+        lua["hypr"]["watchdog"]      = lua.create_table();
+        lua["hypr"]["general"]       = lua.create_table();
+        lua["hypr"]["decoration"]    = lua.create_table();
+        lua["hypr"]["rules"]         = lua.create_table();
+        lua["hyprlua"]               = lua["hypr"].get<sol::table>(); // the name the README and examples use
+
+        // Load Lua wrappers (monitors.lua, keybinds.lua, general.lua)
+        modules::Budget watchdog(lua.lua_state(), budget);
+        try {
+            for (const auto& script : {"monitors.lua", "binds.lua", "events.lua", "notifications.lua", "watchdog.lua", "stats.lua", "profile.lua", "timers.lua", "store.lua", "general.lua", "decoration.lua", "rules.lua"}) {
+                HYPRLUA_TRACE_SCOPE("config.module");
+                std::string script_path = modules_path + "/" + script;
+                if (!fs::exists(script_path)) {
+                    result.notices.push_back({"Module not found: " + script_path});
+                    log::error("Runtime module {} missing at {}", script, script_path);
+                    continue;
+                }
+                if (auto err = run_file(lua, script_path)) {
+                    log_error_lines(std::format("Error loading runtime module {}:", script), *err);
+                    result.notices.push_back({"Error loading module: " + script_path});
+                    return result;
+                }
+            }
+
+            // Load user config.lua
+            if (!fs::exists(user_config_path)) {
+                result.notices.push_back({"Cant find: " + user_config_path});
+                log::error("Config not found: {}", user_config_path);
+                return result;
+            }
+
+            HYPRLUA_TRACE_SCOPE("config.user");
+            state->modules->begin();
+            auto err = run_file(lua, user_config_path);
+            state->modules->finish();
+            result.files = state->modules->files();
+            if (err) {
+                log_error_lines(std::format("Error executing {}:", user_config_path), *err);
+                if (watchdog.expired()) {
+                    log::error("Config stopped by the watchdog");
+                    result.notices.push_back({"[Hyprlua] Config ran past its time budget and was stopped:\n" + *err, 10000});
+                } else if (const auto& memory = state->allocator.stats(); memory.limitHits > 0) {
+                    result.notices.push_back({std::format("[Hyprlua] Config exceeded its memory limit of {} MiB (HYPRLUA_LUA_MEMORY_MB)", memory.limit / (1024 * 1024))});
+                } else {
+                    result.notices.push_back({"Error executing: " + user_config_path});
+                }
+                return result;
+            }
+
+        } catch (const std::exception& e) {
+            log::error("Exception while running the Lua config: {}", e.what());
+            return result;
+        }
+
+        // Collect the config's garbage here, on the worker, rather than in the first
+        // callbacks that run on the compositor thread
+        {
+            HYPRLUA_TRACE_SCOPE("lua.gc");
+            lua_gc(lua.lua_state(), LUA_GCCOLLECT, 0);
+        }
+
+        result.state = std::move(state);
+        return result;
+    }
+
+    std::optional<ChangeSet> record_config(const std::string& modules_path, const std::string& user_config_path) {
+        auto result = build_config(modules_path, user_config_path, modules::BudgetKind::Load);
+        if (!result.state) {
+            return std::nullopt;
+        }
+        return result.state->changes;
+    }
+
+} // namespace hyprlua
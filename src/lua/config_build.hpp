@@ -0,0 +1,80 @@
+// config_build.hpp
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <sol/sol.hpp>
+#include "lua/allocator.hpp"
+#include "lua/changeset.hpp"
+#include "lua/module_graph.hpp"
+#include "lua/binds.hpp"
+#include "lua/events.hpp"
+#include "lua/rules.hpp"
+#include "lua/timers.hpp"
+#include "lua/watchdog.hpp"
+
+/**
+ * @file config_build.hpp
+ * @brief Running a config in record mode, shared by the plugin and hyprlua-compile
+ * @details Nothing here talks to Hyprland or the event loop: a build only records
+ *          what the config asks for. The plugin applies the result through the
+ *          commit functions of each module; hyprlua-compile writes it out.
+ */
+
+namespace hyprlua {
+
+    /**
+     * @brief A Lua state together with the changes its config run recorded
+     * @note changes is declared first so it outlives the bound functions referencing it;
+     *       callbacks, subscriptions, predicates and timers hold references into lua, so they are declared after it.
+     *       The allocator outlives lua and takes all of its memory with it when the state is discarded,
+     *       and the module run outlives the searcher lua calls it through.
+     */
+    struct ConfigState {
+        ChangeSet                         changes;
+        LuaAllocator                      allocator{LuaAllocator::defaultLimit()};
+        std::unique_ptr<ModuleGraph::Run> modules;
+        sol::state                  lua{sol::default_at_panic, &LuaAllocator::lua_alloc, &allocator};
+        modules::BindCallbacks      callbacks;
+        modules::EventSubscriptions subscriptions;
+        modules::RulePredicates     predicates;
+        modules::LuaTimers          timers;
+    };
+
+    /// @brief A build failure to show the user, besides the log
+    struct BuildNotice {
+        std::string text;
+        int         durationMs = 5000;
+    };
+
+    /// @brief What a config run left behind, whether it succeeded or not
+    struct BuildResult {
+        std::unique_ptr<ConfigState> state;   ///< nullptr if the config failed
+        std::vector<std::string>     files;   ///< Files the config run loaded; empty if it did not get to run
+        std::vector<BuildNotice>     notices; ///< The caller decides how to show them
+    };
+
+    /**
+     * @brief Create a fresh Lua state, register the C++ modules and run the config in record mode
+     * @param modules_path Directory holding the runtime modules (binds.lua, monitors.lua, ...)
+     * @param user_config_path The user's hyprland.lua
+     * @param budget Time budget the modules and the config run under together
+     * @note Does not touch Hyprland, so it may run on any thread, but only one build at a time
+     */
+    BuildResult              build_config(const std::string& modules_path, const std::string& user_config_path, modules::BudgetKind budget);
+
+    /**
+     * @brief Run a config in record mode and return what it recorded, applying nothing
+     * @details Used by hyprlua-compile. The Lua state is discarded afterwards, so
+     *          binds to Lua functions keep only their ids.
+     * @return std::nullopt if the config failed; the error was logged
+     * @note Not while the plugin's runtime is initialized, whose worker builds too
+     */
+    std::optional<ChangeSet> record_config(const std::string& modules_path, const std::string& user_config_path);
+
+    /// @brief Results of required modules, carried from one build to the next; thread-safe
+    ModuleGraph&             module_graph();
+
+} // namespace hyprlua
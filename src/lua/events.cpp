@@ -0,0 +1,39 @@
+// events.cpp
+#include "events.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+#include "lua/callback.hpp"
+
+#include <sol/sol.hpp>
+#include <format>
+
+namespace hyprlua::modules {
+
+    void bind_events(sol::state& lua, EventSubscriptions& subscriptions) {
+        log::info("Binding event Lua functions");
+
+        // Returns nothing, or the error for the Lua side to raise
+        lua.set_function("__hypr_on", [&subscriptions](const std::string& event, const sol::main_protected_function& fn, int debounceMs) -> sol::optional<std::string> {
+            HYPRLUA_TRACE_SCOPE("lua.__hypr_on");
+            if (subscriptions.committed) {
+                return std::string("hypr.on can only be called while the config loads");
+            }
+            auto type = event_type(event);
+            if (!type) {
+                std::string names;
+                for (const auto& info : EVENTS) {
+                    names += (names.empty() ? "" : ", ") + std::string(info.name);
+                }
+                return std::format("unknown event '{}': expected one of {}", event, names);
+            }
+            if (debounceMs < 0) {
+                return std::string("debounce_ms must be >= 0");
+            }
+            subscriptions.entries.push_back({.type = *type, .debounceMs = debounceMs, .fn = fn, .source = source_of(fn)});
+            return sol::nullopt;
+        });
+
+        log::debug("Events module successfully bound.");
+    }
+
+} // namespace hyprlua::modules
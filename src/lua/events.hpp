@@ -0,0 +1,88 @@
+// events.hpp
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <sol/sol.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hyprlua::modules {
+
+    /// @brief What Hyprland passes with an event, and so which fields the Lua table gets
+    enum class EventPayload : uint8_t {
+        None,
+        Monitor,       ///< PHLMONITOR: name, description
+        Workspace,     ///< PHLWORKSPACE: name, id, monitor
+        WorkspaceRaw,  ///< CWorkspace*: name, id, monitor
+        WorkspaceMove, ///< { PHLWORKSPACE, PHLMONITOR }: name, id, monitor
+        Window,        ///< PHLWINDOW: title, class, address
+        String,        ///< std::string: name
+    };
+
+    struct EventInfo {
+        std::string_view name;
+        EventPayload     payload;
+    };
+
+    /// @brief The events hypr.on accepts; EventSubscription::type indexes this
+    inline constexpr std::array<EventInfo, 12> EVENTS = {{
+        {"monitorAdded", EventPayload::Monitor},
+        {"monitorRemoved", EventPayload::Monitor},
+        {"focusedMon", EventPayload::Monitor},
+        {"workspace", EventPayload::Workspace},
+        {"createWorkspace", EventPayload::WorkspaceRaw},
+        {"destroyWorkspace", EventPayload::WorkspaceRaw},
+        {"moveWorkspace", EventPayload::WorkspaceMove},
+        {"activeWindow", EventPayload::Window},
+        {"openWindow", EventPayload::Window},
+        {"closeWindow", EventPayload::Window},
+        {"submap", EventPayload::String},
+        {"configReloaded", EventPayload::None},
+    }};
+
+    /// @brief Index of the event called @p name in EVENTS
+    inline std::optional<size_t> event_type(std::string_view name) {
+        for (size_t i = 0; i < EVENTS.size(); ++i) {
+            if (EVENTS[i].name == name) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// @brief One hypr.on call
+    struct EventSubscription {
+        size_t                       type       = 0; ///< Index into the supported events
+        int                          debounceMs = 0; ///< 0 delivers once per event loop iteration
+        sol::main_protected_function fn;
+        std::string                  source; ///< Where the function was defined, e.g. "hyprland.lua:12"
+    };
+
+    /**
+     * @brief Event handlers registered by one config run
+     * @note Holds references into the config's Lua state; destroy it before the state
+     */
+    struct EventSubscriptions {
+        std::vector<EventSubscription> entries;
+        bool                           committed = false; ///< Set once active; later hypr.on calls are errors
+    };
+
+    /// @brief Register __hypr_on; subscriptions are recorded into @p subscriptions
+    void bind_events(sol::state& lua, EventSubscriptions& subscriptions);
+
+    // events_commit.cpp, linked into the plugin only
+
+    /**
+     * @brief Hook the compositor events @p subscriptions listen to, and only those
+     * @details Events already queued for the previous config are dropped.
+     * @note Compositor thread only
+     */
+    void commit_events(EventSubscriptions& subscriptions);
+
+    /// @brief Unhook every event and drop queued ones; called when the runtime shuts down
+    void remove_event_hooks();
+
+} // namespace hyprlua::modules
@@ -0,0 +1,273 @@
+// events_commit.cpp
+#include "events.hpp"
+#include "eventloop.hpp"
+#include "globals.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+#include "utils.hpp"
+#include "lua/watchdog.hpp"
+
+#include <hyprland/src/Compositor.hpp>
+#include <hyprland/src/desktop/Window.hpp>
+#include <hyprland/src/desktop/Workspace.hpp>
+#include <hyprland/src/helpers/Color.hpp>
+#include <hyprland/src/helpers/Monitor.hpp>
+#include <hyprland/src/plugins/PluginAPI.hpp>
+#include <sol/sol.hpp>
+#include <algorithm>
+#include <any>
+#include <array>
+#include <chrono>
+#include <format>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace hyprlua::modules {
+
+    namespace {
+        /// @brief An event copied out of Hyprland's objects, so it can wait for delivery safely
+        struct QueuedEvent {
+            size_t      type = 0;
+            std::string name;   ///< Monitor, workspace or submap name, or window title
+            std::string detail; ///< Monitor description, workspace's monitor or window class
+            int64_t     id = 0; ///< Workspace id or window address
+        };
+
+        /**
+         * @brief Subscribers of one event with the same debounce, which share a queue and a delivery
+         * @details Grouping this way keeps the per-event cost independent of how many
+         *          functions listen: one copy into the queue, at most one timer update.
+         */
+        struct Channel {
+            size_t                                type       = 0;
+            int                                   debounceMs = 0;
+            std::vector<EventSubscription*>       subscribers;
+            std::vector<QueuedEvent>              events;
+            std::chrono::steady_clock::time_point firstQueued;
+            std::unique_ptr<eventloop::Timer>     timer;
+        };
+
+        /// @brief Events beyond this wait in a channel's queue push out the oldest
+        constexpr size_t                                 MAX_QUEUED_EVENTS = 256;
+
+        /// @brief A debounce is re-armed by new events only until the first one waited this many windows
+        constexpr int                                    MAX_DEBOUNCE_WINDOWS = 4;
+
+        // Compositor thread only
+        std::vector<std::unique_ptr<Channel>>            channels;
+        std::array<std::vector<Channel*>, EVENTS.size()> byType;
+        std::array<SP<HOOK_CALLBACK_FN>, EVENTS.size()>  hooks;
+        bool                                             immediateScheduled = false;
+
+        void fill_monitor(QueuedEvent& event, const PHLMONITOR& monitor) {
+            if (monitor) {
+                event.name   = monitor->m_name;
+                event.detail = monitor->m_description;
+            }
+        }
+
+        void fill_workspace(QueuedEvent& event, const CWorkspace* workspace) {
+            if (workspace) {
+                event.name = workspace->m_name;
+                event.id   = workspace->m_id;
+                if (auto monitor = workspace->m_monitor.lock()) {
+                    event.detail = monitor->m_name;
+                }
+            }
+        }
+
+        /// @brief Copy what the Lua side gets out of Hyprland's event data; mismatched data leaves the fields empty
+        QueuedEvent make_event(size_t type, const std::any& data) {
+            QueuedEvent event;
+            event.type = type;
+            switch (EVENTS[type].payload) {
+                case EventPayload::None: break;
+                case EventPayload::Monitor:
+                    if (const auto* monitor = std::any_cast<PHLMONITOR>(&data)) {
+                        fill_monitor(event, *monitor);
+                    }
+                    break;
+                case EventPayload::Workspace:
+                    if (const auto* workspace = std::any_cast<PHLWORKSPACE>(&data)) {
+                        fill_workspace(event, workspace->get());
+                    }
+                    break;
+                case EventPayload::WorkspaceRaw:
+                    if (const auto* workspace = std::any_cast<CWorkspace*>(&data)) {
+                        fill_workspace(event, *workspace);
+                    }
+                    break;
+                case EventPayload::WorkspaceMove:
+                    if (const auto* pair = std::any_cast<std::vector<std::any>>(&data); pair && pair->size() == 2) {
+                        if (const auto* workspace = std::any_cast<PHLWORKSPACE>(&(*pair)[0])) {
+                            fill_workspace(event, workspace->get());
+                        }
+                        if (const auto* monitor = std::any_cast<PHLMONITOR>(&(*pair)[1]); monitor && *monitor) {
+                            event.detail = (*monitor)->m_name;
+                        }
+                    }
+                    break;
+                case EventPayload::Window:
+                    if (const auto* window = std::any_cast<PHLWINDOW>(&data); window && *window) {
+                        event.name   = (*window)->m_title;
+                        event.detail = (*window)->m_class;
+                        event.id     = static_cast<int64_t>(reinterpret_cast<uintptr_t>(window->get()));
+                    }
+                    break;
+                case EventPayload::String:
+                    if (const auto* text = std::any_cast<std::string>(&data)) {
+                        event.name = *text;
+                    }
+                    break;
+            }
+            return event;
+        }
+
+        sol::table to_lua(sol::state_view& lua, const QueuedEvent& event) {
+            sol::table table = lua.create_table(0, 4);
+            table["event"]   = EVENTS[event.type].name;
+            switch (EVENTS[event.type].payload) {
+                case EventPayload::None: break;
+                case EventPayload::Monitor:
+                    table["name"]        = event.name;
+                    table["description"] = event.detail;
+                    break;
+                case EventPayload::Workspace:
+                case EventPayload::WorkspaceRaw:
+                case EventPayload::WorkspaceMove:
+                    table["name"]    = event.name;
+                    table["id"]      = event.id;
+                    table["monitor"] = event.detail;
+                    break;
+                case EventPayload::Window:
+                    table["title"]   = event.name;
+                    table["class"]   = event.detail;
+                    table["address"] = std::format("0x{:x}", static_cast<uint64_t>(event.id));
+                    break;
+                case EventPayload::String: table["name"] = event.name; break;
+            }
+            return table;
+        }
+
+        /// @brief Hand a channel's queued events to each of its subscribers in one call
+        void deliver(Channel& channel) {
+            if (channel.events.empty() || channel.subscribers.empty()) {
+                return;
+            }
+            HYPRLUA_TRACE_SCOPE("events.deliver");
+
+            // Handlers may cause more events; those queue up for the next delivery
+            std::vector<QueuedEvent> events;
+            events.swap(channel.events);
+
+            // The functions are anchored on the main thread, so the batch is built there too
+            sol::state_view lua(channel.subscribers.front()->fn.lua_state());
+            sol::table      batch = lua.create_table(static_cast<int>(events.size()), 0);
+            for (size_t i = 0; i < events.size(); ++i) {
+                batch[i + 1] = to_lua(lua, events[i]);
+            }
+
+            for (auto* subscription : channel.subscribers) {
+                Budget                         budget(subscription->fn.lua_state(), BudgetKind::Callback);
+                sol::protected_function_result result = subscription->fn(batch);
+                if (!result.valid()) {
+                    sol::error err = result;
+                    log::error("hypr.on(\"{}\") handler at {} failed: {}", EVENTS[channel.type].name, subscription->source, err.what());
+                    sendNotification(std::format("[Hyprlua] {} handler failed: {}", EVENTS[channel.type].name, err.what()), CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+                }
+            }
+        }
+
+        /// @brief Deliver every channel without a debounce; runs once per event loop iteration
+        void deliver_immediate() {
+            immediateScheduled = false;
+            for (const auto& channel : channels) {
+                if (channel->debounceMs == 0) {
+                    deliver(*channel);
+                }
+            }
+        }
+
+        void queue(Channel& channel, const QueuedEvent& event) {
+            if (channel.events.size() >= MAX_QUEUED_EVENTS) {
+                channel.events.erase(channel.events.begin());
+                log::debug("Event queue for {} full, dropping the oldest event", EVENTS[channel.type].name);
+            }
+            channel.events.push_back(event);
+
+            if (channel.debounceMs == 0) {
+                if (!immediateScheduled) {
+                    immediateScheduled = eventloop::post(&deliver_immediate);
+                }
+                return;
+            }
+
+            // Trailing debounce, capped so a steady stream of events is still delivered
+            const auto now = std::chrono::steady_clock::now();
+            if (channel.events.size() == 1) {
+                channel.firstQueued = now;
+            }
+            if (now - channel.firstQueued < std::chrono::milliseconds(channel.debounceMs * (MAX_DEBOUNCE_WINDOWS - 1))) {
+                channel.timer->arm(channel.debounceMs);
+            }
+        }
+
+        /// @brief Hyprland's callback for one event type; only registered while someone listens
+        void on_event(size_t type, const std::any& data) {
+            HYPRLUA_TRACE_SCOPE("events.queue");
+            const QueuedEvent event = make_event(type, data);
+            for (auto* channel : byType[type]) {
+                queue(*channel, event);
+            }
+        }
+    }
+
+    void commit_events(EventSubscriptions& subscriptions) {
+        HYPRLUA_TRACE_SCOPE("events.commit");
+        subscriptions.committed = true;
+
+        channels.clear();
+        for (auto& list : byType) {
+            list.clear();
+        }
+
+        for (auto& subscription : subscriptions.entries) {
+            auto& list = byType[subscription.type];
+            auto  it   = std::ranges::find_if(list, [&](const Channel* c) { return c->debounceMs == subscription.debounceMs; });
+            if (it == list.end()) {
+                auto channel        = std::make_unique<Channel>();
+                channel->type       = subscription.type;
+                channel->debounceMs = subscription.debounceMs;
+                if (subscription.debounceMs > 0) {
+                    channel->timer = std::make_unique<eventloop::Timer>([c = channel.get()] { deliver(*c); });
+                }
+                list.push_back(channel.get());
+                channels.push_back(std::move(channel));
+                it = list.end() - 1;
+            }
+            (*it)->subscribers.push_back(&subscription);
+        }
+
+        // Hook exactly the events someone listens to; the rest cost nothing
+        for (size_t type = 0; type < EVENTS.size(); ++type) {
+            if (byType[type].empty()) {
+                hooks[type].reset();
+            } else if (!hooks[type]) {
+                hooks[type] = HyprlandAPI::registerCallbackDynamic(PHANDLE, std::string(EVENTS[type].name), [type](void*, SCallbackInfo&, std::any data) { on_event(type, data); });
+            }
+        }
+        log::debug("Event subscriptions: {} in {} channels", subscriptions.entries.size(), channels.size());
+    }
+
+    void remove_event_hooks() {
+        for (auto& hook : hooks) {
+            hook.reset();
+        }
+        for (auto& list : byType) {
+            list.clear();
+        }
+        channels.clear();
+    }
+
+} // namespace hyprlua::modules
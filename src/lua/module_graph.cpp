@@ -0,0 +1,782 @@
+#include "module_graph.hpp"
+#include "hash.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+#include "lua/bytecode_cache.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace hyprlua {
+
+    namespace {
+        /// @brief Results nested deeper or with more table entries than this are not cached
+        constexpr int    MAX_DEPTH   = 16;
+        constexpr size_t MAX_ENTRIES = 4096;
+
+        /// @brief Reachable state nested deeper or with more table entries than this is not fingerprinted, and the module not replayed
+        constexpr int    MAX_REACH_DEPTH   = 128;
+        constexpr size_t MAX_REACH_ENTRIES = 1 << 16;
+
+        std::optional<uint64_t> source_hash(const std::string& path) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file) {
+                return std::nullopt;
+            }
+            std::ostringstream ss;
+            ss << file.rdbuf();
+            return hash::fnv1a(ss.str());
+        }
+
+        /**
+         * @brief Copy the value at @p index out of the state
+         * @return false for functions, userdata, threads, tables with a metatable, and cycles
+         */
+        bool capture(lua_State* L, int index, LuaValue& out, int depth, size_t& budget) {
+            index = lua_absindex(L, index);
+            switch (lua_type(L, index)) {
+                case LUA_TNIL: out.type = LuaValue::Type::Nil; return true;
+                case LUA_TBOOLEAN:
+                    out.type    = LuaValue::Type::Boolean;
+                    out.boolean = lua_toboolean(L, index);
+                    return true;
+                case LUA_TNUMBER:
+                    if (lua_isinteger(L, index)) {
+                        out.type    = LuaValue::Type::Integer;
+                        out.integer = lua_tointeger(L, index);
+                    } else {
+                        out.type   = LuaValue::Type::Number;
+                        out.number = lua_tonumber(L, index);
+                    }
+                    return true;
+                case LUA_TSTRING: {
+                    size_t      length = 0;
+                    const char* text   = lua_tolstring(L, index, &length);
+                    out.type           = LuaValue::Type::String;
+                    out.string.assign(text, length);
+                    return true;
+                }
+                case LUA_TTABLE: {
+                    if (depth >= MAX_DEPTH || !lua_checkstack(L, 4)) {
+                        return false;
+                    }
+                    if (lua_getmetatable(L, index)) {
+                        lua_pop(L, 1);
+                        return false;
+                    }
+                    out.type = LuaValue::Type::Table;
+                    lua_pushnil(L);
+                    while (lua_next(L, index)) {
+                        LuaValue key, value;
+                        if (budget == 0 || !capture(L, -2, key, depth + 1, budget) || !capture(L, -1, value, depth + 1, budget)) {
+                            lua_pop(L, 2);
+                            return false;
+                        }
+                        --budget;
+                        out.table.emplace_back(std::move(key), std::move(value));
+                        lua_pop(L, 1);
+                    }
+                    return true;
+                }
+                default: return false;
+            }
+        }
+
+        void push(lua_State* L, const LuaValue& value) {
+            switch (value.type) {
+                case LuaValue::Type::Nil: lua_pushnil(L); break;
+                case LuaValue::Type::Boolean: lua_pushboolean(L, value.boolean); break;
+                case LuaValue::Type::Integer: lua_pushinteger(L, value.integer); break;
+                case LuaValue::Type::Number: lua_pushnumber(L, value.number); break;
+                case LuaValue::Type::String: lua_pushlstring(L, value.string.data(), value.string.size()); break;
+                case LuaValue::Type::Table:
+                    luaL_checkstack(L, 3, "module result too deep");
+                    lua_createtable(L, 0, static_cast<int>(value.table.size()));
+                    for (const auto& [k, v] : value.table) {
+                        push(L, k);
+                        push(L, v);
+                        lua_rawset(L, -3);
+                    }
+                    break;
+            }
+        }
+
+        template <typename T>
+        uint64_t mix(uint64_t seed, const T& value) {
+            return hash::fnv1a(std::string_view(reinterpret_cast<const char*>(&value), sizeof(value)), seed);
+        }
+
+        /**
+         * @class Reach
+         * @brief Fingerprint of the Lua values reachable from some roots
+         * @details Every table and function reached adds the hash of its own entries,
+         *          metatable or upvalues, with references hashed by identity. The sum does
+         *          not depend on the order tables are traversed in, so it changes only when
+         *          something reachable did. Walking only reads the state: nothing here
+         *          allocates in Lua or can raise an error.
+         */
+        class Reach {
+          public:
+            /// @param skip Names whose package.loaded entries are left out
+            explicit Reach(lua_State* L, const std::unordered_map<std::string, uint64_t>* skip = nullptr) : m_lua(L), m_skip(skip) {
+                lua_getfield(L, LUA_REGISTRYINDEX, LUA_LOADED_TABLE);
+                m_loaded = lua_topointer(L, -1);
+                lua_pop(L, 1);
+            }
+
+            /// @brief Add the value at @p index and everything reachable from it; false if there was too much to walk
+            bool add(int index) {
+                m_sum += edge(index);
+                return visit(index, 0);
+            }
+
+            uint64_t value() const {
+                return m_sum;
+            }
+
+            bool reached(const void* object) const {
+                return m_seen.contains(object);
+            }
+
+          private:
+            /// @brief Hash of the value at @p index as an entry of something: primitives by content, everything else by identity
+            uint64_t edge(int index) const {
+                lua_State* L    = m_lua;
+                const int  type = lua_type(L, index);
+                uint64_t   h    = mix(hash::FNV_OFFSET, type);
+                switch (type) {
+                    case LUA_TNIL: return h;
+                    case LUA_TBOOLEAN: return mix(h, lua_toboolean(L, index));
+                    case LUA_TNUMBER:
+                        if (lua_isinteger(L, index)) {
+                            return mix(h, static_cast<int64_t>(lua_tointeger(L, index)));
+                        }
+                        return mix(mix(h, 0.5), static_cast<double>(lua_tonumber(L, index)));
+                    case LUA_TSTRING: {
+                        size_t      length = 0;
+                        const char* text   = lua_tolstring(L, index, &length);
+                        return hash::fnv1a(std::string_view(text, length), h);
+                    }
+                    default: return mix(h, lua_topointer(L, index));
+                }
+            }
+
+            bool skipped(int key) const {
+                if (!m_skip || lua_type(m_lua, key) != LUA_TSTRING) {
+                    return false;
+                }
+                size_t      length = 0;
+                const char* text   = lua_tolstring(m_lua, key, &length);
+                return m_skip->contains(std::string(text, length));
+            }
+
+            bool visit(int index, int depth) {
+                lua_State* L    = m_lua;
+                index           = lua_absindex(L, index);
+                const int type  = lua_type(L, index);
+                if (type != LUA_TTABLE && type != LUA_TFUNCTION) {
+                    return true;
+                }
+                const void* self = lua_topointer(L, index);
+                if (!m_seen.insert(self).second) {
+                    return true;
+                }
+                if (depth >= MAX_REACH_DEPTH || !lua_checkstack(L, 4)) {
+                    return false;
+                }
+
+                uint64_t own = mix(hash::FNV_OFFSET, self);
+                if (type == LUA_TFUNCTION) {
+                    for (int i = 1; lua_getupvalue(L, index, i); ++i) {
+                        own           = mix(own, edge(-1));
+                        const bool ok = visit(-1, depth + 1);
+                        lua_pop(L, 1);
+                        if (!ok) {
+                            return false;
+                        }
+                    }
+                    m_sum += own;
+                    return true;
+                }
+
+                if (lua_getmetatable(L, index)) {
+                    own           = mix(own, edge(-1));
+                    const bool ok = visit(-1, depth + 1);
+                    lua_pop(L, 1);
+                    if (!ok) {
+                        return false;
+                    }
+                }
+                const bool loaded  = self == m_loaded;
+                uint64_t   entries = 0;
+                lua_pushnil(L);
+                while (lua_next(L, index)) {
+                    if (m_budget == 0) {
+                        lua_pop(L, 2);
+                        return false;
+                    }
+                    --m_budget;
+                    if (loaded && skipped(-2)) {
+                        lua_pop(L, 1);
+                        continue;
+                    }
+                    entries += mix(edge(-2), edge(-1));
+                    if (!visit(-2, depth + 1) || !visit(-1, depth + 1)) {
+                        lua_pop(L, 2);
+                        return false;
+                    }
+                    lua_pop(L, 1);
+                }
+                m_sum += mix(own, entries);
+                return true;
+            }
+
+            lua_State*                                       m_lua;
+            const std::unordered_map<std::string, uint64_t>* m_skip;
+            const void*                                      m_loaded = nullptr;
+            std::unordered_set<const void*>                  m_seen;
+            size_t                                           m_budget = MAX_REACH_ENTRIES;
+            uint64_t                                         m_sum    = 0;
+        };
+
+        /**
+         * @brief Walk what a module can reach besides its own locals into @p reach
+         * @param string Registry reference to a string, for the string metatable
+         * @return false if there was too much to walk
+         */
+        bool reach_state(lua_State* L, int string, Reach& reach) {
+            if (!lua_checkstack(L, 4)) {
+                return false;
+            }
+            lua_pushglobaltable(L);
+            bool ok = reach.add(-1);
+            lua_getfield(L, LUA_REGISTRYINDEX, LUA_LOADED_TABLE);
+            ok = ok && reach.add(-1);
+            lua_rawgeti(L, LUA_REGISTRYINDEX, string);
+            if (lua_getmetatable(L, -1)) {
+                ok = ok && reach.add(-1);
+                lua_pop(L, 1);
+            }
+            lua_pop(L, 3);
+            return ok;
+        }
+
+        /// @brief The name of the package.loaded entry whose key is at @p index, if it is one of @p names
+        const std::string* loaded_name(lua_State* L, int index, const std::unordered_map<std::string, uint64_t>& names) {
+            if (lua_type(L, index) != LUA_TSTRING) {
+                return nullptr;
+            }
+            size_t      length = 0;
+            const char* text   = lua_tolstring(L, index, &length);
+            const auto  found  = names.find(std::string(text, length));
+            return found == names.end() ? nullptr : &found->first;
+        }
+
+        /// @brief Whether no table in the plain value at @p index was reached by @p reach, i.e. all of them are new
+        bool fresh(lua_State* L, int index, const Reach& reach) {
+            index = lua_absindex(L, index);
+            if (lua_type(L, index) != LUA_TTABLE) {
+                return true;
+            }
+            if (reach.reached(lua_topointer(L, index)) || !lua_checkstack(L, 3)) {
+                return false;
+            }
+            lua_pushnil(L);
+            while (lua_next(L, index)) {
+                if (!fresh(L, -2, reach) || !fresh(L, -1, reach)) {
+                    lua_pop(L, 2);
+                    return false;
+                }
+                lua_pop(L, 1);
+            }
+            return true;
+        }
+
+        template <typename T>
+        T* upvalue(lua_State* L) {
+            return static_cast<T*>(lua_touserdata(L, lua_upvalueindex(1)));
+        }
+    }
+
+    std::unique_ptr<ModuleGraph::Run> ModuleGraph::attach(sol::state& lua, ChangeSet& changes, const std::string& root, std::function<size_t()> luaReferences) {
+        return std::make_unique<Run>(*this, lua.lua_state(), changes, root, std::move(luaReferences));
+    }
+
+    void ModuleGraph::invalidate(const std::string& path) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<std::string>    stale = {path};
+        while (!stale.empty()) {
+            const std::string current = std::move(stale.back());
+            stale.pop_back();
+            if (m_entries.erase(current) == 0 && current != path) {
+                continue;
+            }
+            for (const auto& [other, entry] : m_entries) {
+                if (std::ranges::any_of(entry.deps, [&](const auto& dep) { return dep.first == current; })) {
+                    stale.push_back(other);
+                }
+            }
+        }
+    }
+
+    ModuleGraph::Stats ModuleGraph::stats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_last;
+    }
+
+    ModuleGraph::Run::Run(ModuleGraph& graph, lua_State* L, ChangeSet& changes, std::string root, std::function<size_t()> luaReferences) :
+        m_graph(graph), m_lua(L), m_changes(changes), m_root(std::move(root)), m_luaReferences(std::move(luaReferences)) {
+        record_file(m_root);
+
+        lua_newtable(L);
+        m_proxies = luaL_ref(L, LUA_REGISTRYINDEX);
+        lua_pushliteral(L, "");
+        m_string = luaL_ref(L, LUA_REGISTRYINDEX);
+
+        // Our searcher goes in front of the Lua file searcher; slot 1 is the preload searcher
+        lua_getglobal(L, "package");
+        lua_getfield(L, -1, "searchers");
+        for (lua_Integer i = luaL_len(L, -1); i >= 2; --i) {
+            lua_rawgeti(L, -1, i);
+            lua_rawseti(L, -2, i + 1);
+        }
+        lua_pushlightuserdata(L, this);
+        lua_pushcclosure(L, &searcher, 1);
+        lua_rawseti(L, -2, 2);
+        lua_pop(L, 2);
+
+        // require answers repeated requires from package.loaded without a searcher, so it is wrapped to see those too
+        lua_pushlightuserdata(L, this);
+        lua_getglobal(L, "require");
+        lua_pushcclosure(L, &require_hook, 2);
+        lua_setglobal(L, "require");
+    }
+
+    void ModuleGraph::Run::begin() {
+        lua_State* L = m_lua;
+        lua_newtable(L);
+        lua_pushglobaltable(L);
+        lua_pushnil(L);
+        while (lua_next(L, -2)) {
+            lua_pop(L, 1);
+            if (lua_type(L, -1) == LUA_TSTRING) {
+                lua_pushvalue(L, -1);
+                lua_pushboolean(L, 1);
+                lua_rawset(L, -5);
+            }
+        }
+        lua_pop(L, 1);
+        m_standard = luaL_ref(L, LUA_REGISTRYINDEX);
+        m_tracking = true;
+    }
+
+    void ModuleGraph::Run::finish() {
+        lua_State* L = m_lua;
+        m_tracking   = false;
+
+        // Plain tables make the module environments as cheap as _G for the functions that outlive the run
+        lua_newtable(L);
+        lua_pushglobaltable(L);
+        lua_setfield(L, -2, "__index");
+        lua_pushglobaltable(L);
+        lua_setfield(L, -2, "__newindex");
+        lua_rawgeti(L, LUA_REGISTRYINDEX, m_proxies);
+        for (lua_Integer i = 1, n = luaL_len(L, -1); i <= n; ++i) {
+            lua_rawgeti(L, -1, i);
+            lua_pushvalue(L, -3);
+            lua_setmetatable(L, -2);
+            lua_pop(L, 1);
+        }
+        lua_pop(L, 2);
+        luaL_unref(L, LUA_REGISTRYINDEX, m_proxies);
+        m_proxies = LUA_NOREF;
+
+        m_stats.files = static_cast<uint32_t>(m_files.size());
+        std::lock_guard<std::mutex> lock(m_graph.m_mutex);
+        m_graph.m_last = m_stats;
+    }
+
+    std::vector<std::string> ModuleGraph::Run::files() const {
+        return m_files;
+    }
+
+    void ModuleGraph::Run::record_file(const std::string& path) {
+        if (m_seen.insert(path).second) {
+            m_files.push_back(path);
+        }
+    }
+
+    /**
+     * @brief package.searchers entry: resolve the name like Lua's file searcher and hand back our loader
+     * @details Returns a "not found" message when the name does not resolve, so require tries the next searcher
+     */
+    int ModuleGraph::Run::searcher(lua_State* L) {
+        const char* name = luaL_checkstring(L, 1);
+
+        lua_getglobal(L, "package");
+        lua_getfield(L, -1, "searchpath");
+        lua_pushstring(L, name);
+        lua_getfield(L, -4, "path");
+        lua_call(L, 2, 2);
+
+        if (lua_isnil(L, -2)) {
+            return 1;
+        }
+
+        lua_pushvalue(L, lua_upvalueindex(1));
+        lua_pushcclosure(L, &loader, 1);
+        lua_pushvalue(L, -3);
+        return 2;
+    }
+
+    int ModuleGraph::Run::loader(lua_State* L) {
+        auto*       run  = upvalue<Run>(L);
+        const char* name = luaL_checkstring(L, 1);
+        const char* path = luaL_checkstring(L, 2);
+
+        // No C++ object may be alive when lua_error unwinds
+        const int   results = run->load(name, path);
+        if (results < 0) {
+            return lua_error(L);
+        }
+        return results;
+    }
+
+    int ModuleGraph::Run::require_hook(lua_State* L) {
+        auto*       run  = upvalue<Run>(L);
+        const char* name = luaL_checkstring(L, 1);
+
+        if (run->m_tracking && !run->m_stack.empty() && run->is_loaded(name)) {
+            if (const auto path = run->m_paths.find(name); path != run->m_paths.end()) {
+                run->m_stack.back().deps.push_back(path->second);
+            } else {
+                // Loaded by something other than a file this run tracked, e.g. package.preload
+                run->m_stack.back().impure = true;
+            }
+        }
+
+        const int arguments = lua_gettop(L);
+        lua_pushvalue(L, lua_upvalueindex(2));
+        lua_insert(L, 1);
+        lua_call(L, arguments, LUA_MULTRET);
+        return lua_gettop(L);
+    }
+
+    /// @brief __index of a module environment: a global the config set itself makes the module's result depend on more than its files
+    int ModuleGraph::Run::env_index(lua_State* L) {
+        auto* run = upvalue<Run>(L);
+        if (run->m_tracking && !run->m_stack.empty()) {
+            bool standard = false;
+            if (lua_type(L, 2) == LUA_TSTRING) {
+                lua_rawgeti(L, LUA_REGISTRYINDEX, run->m_standard);
+                lua_pushvalue(L, 2);
+                lua_rawget(L, -2);
+                standard = lua_toboolean(L, -1);
+                lua_pop(L, 2);
+            }
+            if (!standard) {
+                run->m_stack.back().impure = true;
+            }
+        }
+
+        lua_pushglobaltable(L);
+        lua_pushvalue(L, 2);
+        lua_gettable(L, -2);
+        return 1;
+    }
+
+    /// @brief __newindex of a module environment: assigning a global is a side effect a replay would lose
+    int ModuleGraph::Run::env_newindex(lua_State* L) {
+        auto* run = upvalue<Run>(L);
+        if (run->m_tracking && !run->m_stack.empty()) {
+            run->m_stack.back().impure = true;
+        }
+
+        lua_pushglobaltable(L);
+        lua_pushvalue(L, 2);
+        lua_pushvalue(L, 3);
+        lua_settable(L, -3);
+        return 0;
+    }
+
+    bool ModuleGraph::Run::is_loaded(const std::string& name) {
+        lua_State* L = m_lua;
+        lua_getfield(L, LUA_REGISTRYINDEX, LUA_LOADED_TABLE);
+        lua_getfield(L, -1, name.c_str());
+        const bool loaded = lua_toboolean(L, -1);
+        lua_pop(L, 2);
+        return loaded;
+    }
+
+    int ModuleGraph::Run::load(const std::string& name, const std::string& path) {
+        HYPRLUA_TRACE_SCOPE("config.require");
+        lua_State* L = m_lua;
+        record_file(path);
+        m_paths[name] = path;
+        if (!m_stack.empty()) {
+            m_stack.back().deps.push_back(path);
+            m_stack.back().loaded.push_back(path);
+        }
+
+        if (m_tracking) {
+            if (const int replayed = replay(name, path); replayed != 0) {
+                if (replayed > 0) {
+                    ++m_stats.replayed;
+                }
+                return replayed;
+            }
+        }
+
+        const auto sourceHash = source_hash(path);
+        if (cache::load(L, path) != LUA_OK) {
+            lua_pushfstring(L, "error loading module '%s' from file '%s':\n\t%s", name.c_str(), path.c_str(), lua_tostring(L, -1));
+            return -1;
+        }
+
+        if (m_tracking) {
+            // Give the chunk an environment that sees every global but notes which ones the module reads and writes
+            lua_newtable(L);
+            lua_newtable(L);
+            lua_pushlightuserdata(L, this);
+            lua_pushcclosure(L, &env_index, 1);
+            lua_setfield(L, -2, "__index");
+            lua_pushlightuserdata(L, this);
+            lua_pushcclosure(L, &env_newindex, 1);
+            lua_setfield(L, -2, "__newindex");
+            lua_setmetatable(L, -2);
+
+            lua_rawgeti(L, LUA_REGISTRYINDEX, m_proxies);
+            lua_pushvalue(L, -2);
+            lua_rawseti(L, -2, static_cast<lua_Integer>(lua_rawlen(L, -2)) + 1);
+            lua_pop(L, 1);
+
+            // The only upvalue of a main chunk is _ENV
+            if (!lua_setupvalue(L, -2, 1)) {
+                lua_pop(L, 1);
+            }
+            Frame frame;
+            frame.path          = path;
+            frame.mark          = m_changes.mark();
+            frame.luaReferences = m_luaReferences ? m_luaReferences() : 0;
+            Reach reach(L);
+            if (reach_state(L, m_string, reach)) {
+                frame.reach = reach.value();
+            } else {
+                frame.impure = true;
+            }
+            m_stack.push_back(std::move(frame));
+        }
+
+        lua_pushstring(L, name.c_str());
+        lua_pushstring(L, path.c_str());
+        const int status = lua_pcall(L, 2, 1, 0);
+        if (!m_tracking) {
+            return status == LUA_OK ? 1 : -1;
+        }
+
+        Frame frame = std::move(m_stack.back());
+        m_stack.pop_back();
+        if (status != LUA_OK) {
+            return -1;
+        }
+        ++m_stats.executed;
+
+        LuaValue   result;
+        size_t     budget    = MAX_ENTRIES;
+        const bool plain     = capture(L, -1, result, 0, budget);
+        const bool unchanged = settled(frame, lua_gettop(L));
+
+        // The parent is only as pure as what it loaded stays: it must not change their values either
+        if (!m_stack.empty()) {
+            m_stack.back().children.insert(frame.children.begin(), frame.children.end());
+            note_child(name, -1);
+        }
+
+        std::lock_guard<std::mutex> lock(m_graph.m_mutex);
+        auto&                       entries = m_graph.m_entries;
+
+        Entry                       entry;
+        entry.name       = name;
+        entry.sourceHash = sourceHash.value_or(0);
+        entry.pure       = plain && unchanged && sourceHash && !frame.impure && m_changes.mark() == frame.mark &&
+            (m_luaReferences ? m_luaReferences() : 0) == frame.luaReferences;
+
+        uint64_t fingerprint = hash::fnv1a(std::string_view(reinterpret_cast<const char*>(&entry.sourceHash), sizeof(entry.sourceHash)));
+        for (const auto& dep : frame.deps) {
+            const auto found = entries.find(dep);
+            if (found == entries.end() || !found->second.pure) {
+                entry.pure = false;
+                continue;
+            }
+            entry.deps.emplace_back(dep, found->second.fingerprint);
+            fingerprint = hash::fnv1a(std::string_view(reinterpret_cast<const char*>(&found->second.fingerprint), sizeof(uint64_t)), fingerprint);
+        }
+        entry.fingerprint = fingerprint;
+        entry.loaded      = std::move(frame.loaded);
+        if (entry.pure) {
+            entry.result = std::move(result);
+        } else {
+            // Keep the edges so editing a dependency still invalidates it, but nothing to replay
+            entry.deps.clear();
+            for (auto& dep : frame.deps) {
+                entry.deps.emplace_back(std::move(dep), 0);
+            }
+        }
+
+        m_validated[path] = entry.pure;
+        entries[path]     = std::move(entry);
+        return 1;
+    }
+
+    bool ModuleGraph::Run::valid(const std::string& path) {
+        if (const auto memo = m_validated.find(path); memo != m_validated.end()) {
+            return memo->second;
+        }
+        // Counts as invalid while being checked, which ends dependency cycles
+        m_validated[path] = false;
+
+        const auto found = m_graph.m_entries.find(path);
+        if (found == m_graph.m_entries.end() || !found->second.pure || source_hash(path) != found->second.sourceHash) {
+            return false;
+        }
+        for (const auto& [dep, fingerprint] : found->second.deps) {
+            if (!valid(dep) || m_graph.m_entries.at(dep).fingerprint != fingerprint) {
+                return false;
+            }
+        }
+        m_validated[path] = true;
+        return true;
+    }
+
+    bool ModuleGraph::Run::replayable(const Entry& entry, std::unordered_set<std::string>& pending) {
+        for (const auto& [dep, fingerprint] : entry.deps) {
+            const auto& child   = m_graph.m_entries.at(dep);
+            const bool  present = pending.contains(child.name) || is_loaded(child.name);
+            if (std::ranges::find(entry.loaded, dep) != entry.loaded.end()) {
+                // It ran this module itself, so replaying this entry puts its value back too
+                if (present) {
+                    return false;
+                }
+                pending.insert(child.name);
+                if (!replayable(child, pending)) {
+                    return false;
+                }
+            } else if (!present) {
+                // It found this module loaded, so its value comes from whoever loads it first
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void ModuleGraph::Run::collect(const Entry& entry, Replayed& out) {
+        for (const auto& path : entry.loaded) {
+            const auto& child = m_graph.m_entries.at(path);
+            out.paths.push_back(path);
+            out.loaded.emplace_back(child.name, child.result);
+            collect(child, out);
+        }
+    }
+
+    int ModuleGraph::Run::push_replayed(lua_State* L) {
+        const auto* replayed = static_cast<const Replayed*>(lua_touserdata(L, 1));
+        lua_getfield(L, LUA_REGISTRYINDEX, LUA_LOADED_TABLE);
+        for (const auto& [name, value] : replayed->loaded) {
+            push(L, value);
+            if (lua_isnil(L, -1)) {
+                lua_pop(L, 1);
+                lua_pushboolean(L, 1);
+            }
+            lua_setfield(L, -2, name.c_str());
+        }
+        push(L, replayed->result);
+        return 1;
+    }
+
+    int ModuleGraph::Run::replay(const std::string& name, const std::string& path) {
+        // Copied out, so the lock is not held while the values are built: that allocates in Lua, which can raise
+        Replayed replayed;
+        {
+            std::lock_guard<std::mutex> lock(m_graph.m_mutex);
+            if (!valid(path)) {
+                return 0;
+            }
+            const auto&                     entry = m_graph.m_entries.at(path);
+            std::unordered_set<std::string> pending;
+            if (!replayable(entry, pending)) {
+                return 0;
+            }
+            collect(entry, replayed);
+            replayed.result = entry.result;
+        }
+
+        for (size_t i = 0; i < replayed.paths.size(); ++i) {
+            record_file(replayed.paths[i]);
+            m_paths[replayed.loaded[i].first] = replayed.paths[i];
+        }
+
+        // Protected, so an out-of-memory error unwinds no further than here and `replayed` is freed
+        lua_State* L = m_lua;
+        lua_pushcfunction(L, &push_replayed);
+        lua_pushlightuserdata(L, &replayed);
+        if (lua_pcall(L, 1, 1, 0) != LUA_OK) {
+            return -1;
+        }
+
+        if (!m_stack.empty()) {
+            std::unordered_map<std::string, uint64_t> names;
+            for (const auto& [child, _] : replayed.loaded) {
+                names.emplace(child, 0);
+            }
+            lua_getfield(L, LUA_REGISTRYINDEX, LUA_LOADED_TABLE);
+            lua_pushnil(L);
+            while (lua_next(L, -2)) {
+                if (const auto* child = loaded_name(L, -2, names)) {
+                    note_child(*child, -1);
+                }
+                lua_pop(L, 1);
+            }
+            lua_pop(L, 1);
+            note_child(name, -1);
+        }
+        return 1;
+    }
+
+    void ModuleGraph::Run::note_child(const std::string& name, int index) {
+        lua_State* L = m_lua;
+        index        = lua_absindex(L, index);
+        // require stores true for a module that returned nothing
+        lua_pushboolean(L, 1);
+        Reach reach(L);
+        reach.add(lua_isnil(L, index) ? -1 : index);
+        lua_pop(L, 1);
+        m_stack.back().children[name] = reach.value();
+    }
+
+    bool ModuleGraph::Run::settled(Frame& frame, int value) {
+        lua_State* L = m_lua;
+        value        = lua_absindex(L, value);
+
+        // What the module can reach, except the modules it loaded itself: those are new, and checked below
+        Reach reach(L, &frame.children);
+        bool  ok = !frame.impure && reach_state(L, m_string, reach) && reach.value() == frame.reach && fresh(L, value, reach);
+
+        // The values of the modules it loaded must be as they were when each returned
+        size_t found = 0;
+        lua_getfield(L, LUA_REGISTRYINDEX, LUA_LOADED_TABLE);
+        lua_pushnil(L);
+        while (lua_next(L, -2)) {
+            if (const auto* name = loaded_name(L, -2, frame.children)) {
+                Reach child(L);
+                ok                             = child.add(-1) && ok && child.value() == frame.children[*name] && fresh(L, value, child);
+                frame.children[*name]          = child.value();
+                ++found;
+            }
+            lua_pop(L, 1);
+        }
+        lua_pop(L, 1);
+        return ok && found == frame.children.size();
+    }
+
+} // namespace hyprlua
@@ -0,0 +1,210 @@
+// module_graph.hpp
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <sol/sol.hpp>
+#include "lua/changeset.hpp"
+
+/**
+ * @file module_graph.hpp
+ * @brief The files a config is made of, and the results of its required modules
+ * @details A searcher in front of Lua's own records which module required which,
+ *          so every file of a split config can be watched. It also remembers what
+ *          each module returned. On the next reload a module whose file and
+ *          dependencies are unchanged is not run again: its return value is rebuilt,
+ *          so a reload costs about as much as the modules that were edited.
+ *
+ *          Only pure modules are replayed: ones whose return value is all there is
+ *          to them. A pure module returns plain data it built itself (nil, booleans,
+ *          numbers, strings and fresh tables of those), reads no globals the config
+ *          set itself and nothing from hypr.store, records nothing into the
+ *          ChangeSet, and leaves every value it can reach as it found it: globals,
+ *          the tables and upvalues behind them, and the values of other modules.
+ *          Whether it did is told by fingerprinting everything reachable from the
+ *          globals and package.loaded before and after it runs. Everything else
+ *          runs on every reload, as before.
+ */
+
+namespace hyprlua {
+
+    /// @brief A Lua value that can be rebuilt in another state
+    struct LuaValue {
+        enum class Type {
+            Nil,
+            Boolean,
+            Integer,
+            Number,
+            String,
+            Table,
+        };
+
+        Type                                         type    = Type::Nil;
+        bool                                         boolean = false;
+        int64_t                                      integer = 0;
+        double                                       number  = 0;
+        std::string                                  string;
+        std::vector<std::pair<LuaValue, LuaValue>>   table;
+    };
+
+    class ModuleGraph {
+      public:
+        /// @brief Modules run and replayed by the last config run, and the files it loaded
+        struct Stats {
+            uint32_t executed = 0;
+            uint32_t replayed = 0;
+            uint32_t files    = 0;
+        };
+
+        class Run;
+
+        /**
+         * @brief Track a config run: install the searcher in @p lua
+         * @param changes Where the config records its changes
+         * @param root The config file, always run and always watched
+         * @param luaReferences Count of recorded changes that refer to Lua values, such as function binds
+         * @return The run; it must outlive every require() made in @p lua
+         */
+        std::unique_ptr<Run> attach(sol::state& lua, ChangeSet& changes, const std::string& root, std::function<size_t()> luaReferences);
+
+        /**
+         * @brief Forget the results of the module at @p path and of every module depending on it
+         * @note Thread-safe; called from the file watcher
+         */
+        void                 invalidate(const std::string& path);
+
+        /// @brief Stats of the last finished run; thread-safe
+        Stats                stats() const;
+
+      private:
+        struct Entry {
+            std::string                                    name; ///< Name it was required by
+            uint64_t                                       sourceHash  = 0;
+            uint64_t                                       fingerprint = 0; ///< Of its source and every dependency's, changes when its result may
+            std::vector<std::pair<std::string, uint64_t>> deps;             ///< Paths it required directly and their fingerprints then
+            std::vector<std::string>                       loaded;          ///< The deps it loaded itself; the rest were loaded already
+            bool                                           pure = false;
+            LuaValue                                       result;
+        };
+
+        mutable std::mutex                     m_mutex;
+        std::unordered_map<std::string, Entry> m_entries; ///< By resolved path
+        Stats                                  m_last;
+    };
+
+    /**
+     * @class ModuleGraph::Run
+     * @brief Tracks the requires of one config run
+     */
+    class ModuleGraph::Run {
+      public:
+        Run(ModuleGraph& graph, lua_State* L, ChangeSet& changes, std::string root, std::function<size_t()> luaReferences);
+
+        Run(const Run&)            = delete;
+        Run& operator=(const Run&) = delete;
+
+        /**
+         * @brief Call right before the config runs
+         * @details Globals present now are the ones a module may read and still be replayed
+         */
+        void                     begin();
+
+        /// @brief Call once the config ran; module functions stop tracking global reads
+        void                     finish();
+
+        /// @brief The config and every module it required, in load order
+        std::vector<std::string> files() const;
+
+        Stats                    stats() const {
+            return m_stats;
+        }
+
+      private:
+        /// @brief A module whose chunk is running
+        struct Frame {
+            std::string                                   path;
+            ChangeMark                                    mark;
+            size_t                                        luaReferences = 0;
+            uint64_t                                      reach         = 0; ///< Fingerprint of the reachable values before it ran
+            bool                                          impure        = false;
+            std::vector<std::string>                      deps;
+            std::vector<std::string>                      loaded;
+            std::unordered_map<std::string, uint64_t>     children; ///< Every module loaded while it ran, by name, and the fingerprint of its value when it returned
+        };
+
+        /// @brief Cached values of a module and of the modules it loaded, copied out of the graph
+        struct Replayed {
+            std::vector<std::string>                      paths;  ///< Of the modules it loaded, in load order
+            std::vector<std::pair<std::string, LuaValue>> loaded; ///< Their names and values, in the same order
+            LuaValue                                      result;
+        };
+
+        static int               searcher(lua_State* L);
+        static int               loader(lua_State* L);
+        static int               require_hook(lua_State* L);
+        static int               env_index(lua_State* L);
+        static int               env_newindex(lua_State* L);
+
+        /// @brief Rebuild the Replayed at index 1 in the state, run protected; pushes its result
+        static int               push_replayed(lua_State* L);
+
+        /// @brief Load or replay a module; pushes its value, or an error message and returns -1
+        int                      load(const std::string& name, const std::string& path);
+
+        /**
+         * @brief Push the cached value of @p path if it can be replayed
+         * @return 1 once pushed, 0 if the module has to run, -1 with an error message pushed
+         */
+        int                      replay(const std::string& name, const std::string& path);
+
+        /// @brief Whether the cached result of @p path still holds; m_graph.m_mutex must be held
+        bool                     valid(const std::string& path);
+
+        /**
+         * @brief Whether replaying @p entry loads the same modules as running it did
+         * @param pending Names the replay will have put into package.loaded before this entry
+         */
+        bool                     replayable(const Entry& entry, std::unordered_set<std::string>& pending);
+
+        /// @brief Copy the values of the modules @p entry loaded into @p out; m_graph.m_mutex must be held
+        void                     collect(const Entry& entry, Replayed& out);
+
+        /// @brief Record the value at @p index of the module @p name, loaded while the innermost frame runs
+        void                     note_child(const std::string& name, int index);
+
+        /**
+         * @brief Whether the module of @p frame left everything it can reach as it found it and returned values of its own
+         * @param value Index of what it returned
+         * @details Also updates the fingerprints in frame.children, for its parent to check against
+         */
+        bool                     settled(Frame& frame, int value);
+
+        bool                     is_loaded(const std::string& name);
+
+        void                     record_file(const std::string& path);
+
+        ModuleGraph&                             m_graph;
+        lua_State*                               m_lua;
+        ChangeSet&                               m_changes;
+        std::string                              m_root;
+        std::function<size_t()>                  m_luaReferences;
+        std::vector<Frame>                       m_stack;
+        std::vector<std::string>                 m_files;
+        std::unordered_set<std::string>          m_seen;
+        std::unordered_map<std::string, std::string> m_paths;     ///< Module name to path, for requires answered from package.loaded
+        std::unordered_map<std::string, bool>    m_validated; ///< Per run, so each file is hashed once
+        int                                      m_standard = LUA_NOREF; ///< Set of globals present at begin()
+        int                                      m_proxies  = LUA_NOREF; ///< Environments of the modules run
+        int                                      m_string   = LUA_NOREF; ///< A string, to reach the string metatable through
+        bool                                     m_tracking = false;
+        Stats                                    m_stats;
+    };
+
+} // namespace hyprlua
@@ -0,0 +1,62 @@
+// monitor_index.cpp
+#include "monitor_index.hpp"
+
+#include <algorithm>
+
+namespace hyprlua {
+
+    void MonitorIndex::rebuild(std::vector<Output> outputs) {
+        m_outputs = std::move(outputs);
+        m_byName.clear();
+        m_bySerial.clear();
+        m_namesSorted.clear();
+        m_descriptionsSorted.clear();
+
+        for (size_t i = 0; i < m_outputs.size(); ++i) {
+            const auto& output = m_outputs[i];
+            m_byName.try_emplace(output.name, i);
+            if (!output.serial.empty()) {
+                m_bySerial.try_emplace(output.serial, i);
+            }
+            m_namesSorted.emplace_back(output.name, i);
+            m_descriptionsSorted.emplace_back(output.description, i);
+        }
+        std::sort(m_namesSorted.begin(), m_namesSorted.end());
+        std::sort(m_descriptionsSorted.begin(), m_descriptionsSorted.end());
+    }
+
+    void MonitorIndex::prefix_matches(const Sorted& sorted, std::string_view prefix, std::vector<size_t>& out) {
+        auto it = std::lower_bound(sorted.begin(), sorted.end(), prefix, [](const auto& entry, std::string_view key) { return std::string_view(entry.first) < key; });
+        for (; it != sorted.end() && it->first.starts_with(prefix); ++it) {
+            out.push_back(it->second);
+        }
+        std::sort(out.begin(), out.end());
+    }
+
+    std::vector<size_t> MonitorIndex::match(std::string_view selector) const {
+        std::vector<size_t> out;
+        if (selector.starts_with("desc:")) {
+            // Hyprland applies a desc: rule to the first output that matches only
+            prefix_matches(m_descriptionsSorted, selector.substr(5), out);
+            out.resize(std::min<size_t>(out.size(), 1));
+        } else if (selector.starts_with("serial:")) {
+            if (auto it = m_bySerial.find(std::string(selector.substr(7))); it != m_bySerial.end()) {
+                out.push_back(it->second);
+            }
+        } else if (selector.ends_with('*')) {
+            prefix_matches(m_namesSorted, selector.substr(0, selector.size() - 1), out);
+        } else if (auto it = m_byName.find(std::string(selector)); it != m_byName.end()) {
+            out.push_back(it->second);
+        }
+        return out;
+    }
+
+    std::string MonitorIndex::serial_of(std::string_view description) {
+        while (!description.empty() && description.back() == ' ') {
+            description.remove_suffix(1);
+        }
+        const size_t space = description.rfind(' ');
+        return space == std::string_view::npos ? std::string() : std::string(description.substr(space + 1));
+    }
+
+} // namespace hyprlua
@@ -0,0 +1,57 @@
+// monitor_index.hpp
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @file monitor_index.hpp
+ * @brief Outputs by name, description and serial, for resolving the output a monitor rule names
+ * @details A rule's name selects outputs in one of four ways:
+ *          - "DP-1": the output with that connector name
+ *          - "DP-*": every output whose name starts with "DP-"
+ *          - "desc:Dell Inc. U2720Q": the first output whose description starts with the text, as Hyprland matches it
+ *          - "serial:ABC123": the output with that serial number
+ *          Nothing here depends on Hyprland or Lua, so it can be tested headless.
+ */
+
+namespace hyprlua {
+
+    class MonitorIndex {
+      public:
+        struct Output {
+            std::string name;        ///< Connector, e.g. "DP-1"
+            std::string description; ///< "make model serial"
+            std::string serial;
+        };
+
+        /// @brief Index @p outputs; match() returns positions in this list
+        void                       rebuild(std::vector<Output> outputs);
+
+        /// @brief Positions of the outputs @p selector names, in output order; empty if none is present
+        std::vector<size_t>        match(std::string_view selector) const;
+
+        const std::vector<Output>& outputs() const {
+            return m_outputs;
+        }
+
+        /// @brief The serial number in a "make model serial" description: its last word
+        static std::string serial_of(std::string_view description);
+
+      private:
+        /// @brief Sorted by key, so a prefix is a lower_bound and a short scan
+        using Sorted = std::vector<std::pair<std::string, size_t>>;
+
+        static void                             prefix_matches(const Sorted& sorted, std::string_view prefix, std::vector<size_t>& out);
+
+        std::vector<Output>                     m_outputs;
+        std::unordered_map<std::string, size_t> m_byName;
+        std::unordered_map<std::string, size_t> m_bySerial;
+        Sorted                                  m_namesSorted;
+        Sorted                                  m_descriptionsSorted;
+    };
+
+} // namespace hyprlua
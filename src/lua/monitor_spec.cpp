@@ -0,0 +1,276 @@
+#include "monitor_spec.hpp"
+
+#include <array>
+#include <charconv>
+#include <format>
+#include <utility>
+
+namespace hyprlua {
+
+    namespace {
+        constexpr std::array<std::pair<std::string_view, MonitorSpec::Mode>, 4> MODES = {{
+            {"preferred", MonitorSpec::Mode::Preferred},
+            {"highres", MonitorSpec::Mode::HighRes},
+            {"highrr", MonitorSpec::Mode::HighRR},
+            {"maxwidth", MonitorSpec::Mode::MaxWidth},
+        }};
+
+        constexpr std::array<std::pair<std::string_view, MonitorSpec::Placement>, 9> PLACEMENTS = {{
+            {"auto", MonitorSpec::Placement::AutoRight},
+            {"auto-right", MonitorSpec::Placement::AutoRight},
+            {"auto-left", MonitorSpec::Placement::AutoLeft},
+            {"auto-up", MonitorSpec::Placement::AutoUp},
+            {"auto-down", MonitorSpec::Placement::AutoDown},
+            {"auto-center-right", MonitorSpec::Placement::AutoCenterRight},
+            {"auto-center-left", MonitorSpec::Placement::AutoCenterLeft},
+            {"auto-center-up", MonitorSpec::Placement::AutoCenterUp},
+            {"auto-center-down", MonitorSpec::Placement::AutoCenterDown},
+        }};
+
+        std::string_view trim(std::string_view text) {
+            const auto first = text.find_first_not_of(" \t");
+            if (first == std::string_view::npos) {
+                return {};
+            }
+            const auto last = text.find_last_not_of(" \t");
+            return text.substr(first, last - first + 1);
+        }
+
+        /// @brief Parse the whole of @p text as a number; partial matches fail
+        template <typename T>
+        std::optional<T> parse_number(std::string_view text) {
+            T value{};
+            const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (ec != std::errc{} || end != text.data() + text.size() || text.empty()) {
+                return std::nullopt;
+            }
+            return value;
+        }
+
+        /// @brief Split "AxB" into two integers
+        std::optional<std::pair<int, int>> parse_pair(std::string_view text) {
+            const auto sep = text.find('x');
+            if (sep == std::string_view::npos) {
+                return std::nullopt;
+            }
+            auto a = parse_number<int>(text.substr(0, sep));
+            auto b = parse_number<int>(text.substr(sep + 1));
+            if (!a || !b) {
+                return std::nullopt;
+            }
+            return std::pair{*a, *b};
+        }
+
+        /// @brief Shortest decimal form of a number, without a trailing ".0"
+        std::string number(double value) {
+            char buffer[32];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            return std::string(buffer, result.ptr);
+        }
+    }
+
+    std::expected<void, std::string> parse_resolution(std::string_view text, MonitorSpec& spec) {
+        text = trim(text);
+        for (const auto& [keyword, mode] : MODES) {
+            if (text == keyword) {
+                spec.mode    = mode;
+                spec.width   = 0;
+                spec.height  = 0;
+                spec.refresh = 0;
+                return {};
+            }
+        }
+
+        const auto                         at      = text.find('@');
+        std::string_view                   size    = text.substr(0, at);
+        std::optional<double>              refresh = 0.0;
+        std::optional<std::pair<int, int>> wh      = parse_pair(size);
+        if (at != std::string_view::npos) {
+            // Hyprland's own syntax allows a trailing "Hz"
+            std::string_view rate = text.substr(at + 1);
+            if (rate.ends_with("Hz")) {
+                rate.remove_suffix(2);
+            }
+            refresh = parse_number<double>(rate);
+        }
+        if (!wh || wh->first <= 0 || wh->second <= 0 || !refresh || *refresh < 0) {
+            return std::unexpected(std::format("invalid resolution '{}': expected WIDTHxHEIGHT[@HZ], preferred, highres, highrr or maxwidth", text));
+        }
+
+        spec.mode    = MonitorSpec::Mode::Explicit;
+        spec.width   = wh->first;
+        spec.height  = wh->second;
+        spec.refresh = *refresh;
+        return {};
+    }
+
+    std::expected<void, std::string> parse_position(std::string_view text, MonitorSpec& spec) {
+        text = trim(text);
+        for (const auto& [keyword, placement] : PLACEMENTS) {
+            if (text == keyword) {
+                spec.placement = placement;
+                spec.x         = 0;
+                spec.y         = 0;
+                return {};
+            }
+        }
+
+        auto xy = parse_pair(text);
+        if (!xy) {
+            return std::unexpected(std::format("invalid position '{}': expected XxY, auto or auto-(right|left|up|down|center-*)", text));
+        }
+        spec.placement = MonitorSpec::Placement::Explicit;
+        spec.x         = xy->first;
+        spec.y         = xy->second;
+        return {};
+    }
+
+    std::expected<void, std::string> parse_scale(std::string_view text, MonitorSpec& spec) {
+        text = trim(text);
+        if (text == "auto") {
+            spec.scale.reset();
+            return {};
+        }
+
+        auto scale = parse_number<double>(text);
+        if (!scale || *scale <= 0) {
+            return std::unexpected(std::format("invalid scale '{}': expected a positive number or auto", text));
+        }
+        spec.scale = *scale;
+        return {};
+    }
+
+    std::expected<void, std::string> parse_option(std::string_view key, std::string_view value, MonitorSpec& spec) {
+        key   = trim(key);
+        value = trim(value);
+
+        if (key == "transform") {
+            auto transform = parse_number<int>(value);
+            if (!transform || *transform < 0 || *transform > 7) {
+                return std::unexpected(std::format("invalid transform '{}': expected 0-7", value));
+            }
+            spec.transform = *transform;
+        } else if (key == "bitdepth") {
+            auto depth = parse_number<int>(value);
+            if (!depth || (*depth != 8 && *depth != 10)) {
+                return std::unexpected(std::format("invalid bitdepth '{}': expected 8 or 10", value));
+            }
+            spec.bitdepth = *depth;
+        } else if (key == "vrr") {
+            auto vrr = parse_number<int>(value);
+            if (!vrr || *vrr < 0 || *vrr > 2) {
+                return std::unexpected(std::format("invalid vrr '{}': expected 0, 1 or 2", value));
+            }
+            spec.vrr = *vrr;
+        } else if (key == "mirror") {
+            if (value.empty()) {
+                return std::unexpected(std::string("mirror needs the name of the output to mirror"));
+            }
+            spec.mirror = value;
+        } else {
+            return std::unexpected(std::format("unknown monitor option '{}': expected transform, mirror, bitdepth or vrr", key));
+        }
+        return {};
+    }
+
+    std::expected<MonitorSpec, std::string> parse_monitor_line(std::string_view line) {
+        std::vector<std::string_view> fields;
+        while (true) {
+            const auto comma = line.find(',');
+            fields.push_back(trim(line.substr(0, comma)));
+            if (comma == std::string_view::npos) {
+                break;
+            }
+            line.remove_prefix(comma + 1);
+        }
+
+        MonitorSpec spec;
+        spec.name = fields[0];
+        if (spec.name.empty()) {
+            return std::unexpected(std::string("monitor rule without an output name"));
+        }
+
+        if (fields.size() == 2 && fields[1] == "disable") {
+            spec.disabled = true;
+            return spec;
+        }
+        if (fields.size() < 4) {
+            return std::unexpected(std::format("monitor '{}': expected NAME, RESOLUTION, POSITION, SCALE[, OPTION, VALUE...] or NAME, disable", spec.name));
+        }
+
+        auto check = [&](std::expected<void, std::string> result) -> std::expected<void, std::string> {
+            if (!result) {
+                return std::unexpected(std::format("monitor '{}': {}", spec.name, result.error()));
+            }
+            return {};
+        };
+
+        if (auto r = check(parse_resolution(fields[1], spec)); !r) {
+            return std::unexpected(r.error());
+        }
+        if (auto r = check(parse_position(fields[2], spec)); !r) {
+            return std::unexpected(r.error());
+        }
+        if (auto r = check(parse_scale(fields[3], spec)); !r) {
+            return std::unexpected(r.error());
+        }
+        for (size_t i = 4; i < fields.size(); i += 2) {
+            if (i + 1 >= fields.size()) {
+                return std::unexpected(std::format("monitor '{}': option '{}' has no value", spec.name, fields[i]));
+            }
+            if (auto r = check(parse_option(fields[i], fields[i + 1], spec)); !r) {
+                return std::unexpected(r.error());
+            }
+        }
+        return spec;
+    }
+
+    std::string to_string(const MonitorSpec& spec) {
+        if (spec.disabled) {
+            return spec.name + ",disable";
+        }
+
+        std::string line = spec.name + ",";
+        if (spec.mode == MonitorSpec::Mode::Explicit) {
+            line += std::format("{}x{}", spec.width, spec.height);
+            if (spec.refresh > 0) {
+                line += "@" + number(spec.refresh);
+            }
+        } else {
+            for (const auto& [keyword, mode] : MODES) {
+                if (mode == spec.mode) {
+                    line += keyword;
+                }
+            }
+        }
+
+        line += ",";
+        if (spec.placement == MonitorSpec::Placement::Explicit) {
+            line += std::format("{}x{}", spec.x, spec.y);
+        } else {
+            // "auto" comes first and wins for AutoRight
+            for (const auto& [keyword, placement] : PLACEMENTS) {
+                if (placement == spec.placement) {
+                    line += keyword;
+                    break;
+                }
+            }
+        }
+
+        line += "," + (spec.scale ? number(*spec.scale) : std::string("auto"));
+        if (spec.transform != 0) {
+            line += std::format(",transform,{}", spec.transform);
+        }
+        if (!spec.mirror.empty()) {
+            line += ",mirror," + spec.mirror;
+        }
+        if (spec.bitdepth != 8) {
+            line += std::format(",bitdepth,{}", spec.bitdepth);
+        }
+        if (spec.vrr) {
+            line += std::format(",vrr,{}", *spec.vrr);
+        }
+        return line;
+    }
+
+} // namespace hyprlua
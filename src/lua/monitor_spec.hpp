@@ -0,0 +1,101 @@
+// monitor_spec.hpp
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @file monitor_spec.hpp
+ * @brief Parsed form of a Hyprland monitor rule
+ * @details Covers the syntax of Hyprland's `monitor =` keyword: resolution with
+ *          refresh rate or one of the mode keywords, explicit or automatic position,
+ *          scale, and the transform, mirror, bitdepth and vrr options. Parsing is
+ *          strict: anything not understood is an error rather than a default.
+ *          Nothing here depends on Hyprland or Lua, so it can be tested headless.
+ */
+
+namespace hyprlua {
+
+    struct MonitorSpec {
+        /// @brief How the output mode is chosen
+        enum class Mode : uint8_t {
+            Explicit,
+            Preferred,
+            HighRes,
+            HighRR,
+            MaxWidth,
+        };
+
+        /// @brief How the output position is chosen
+        enum class Placement : uint8_t {
+            Explicit,
+            AutoRight,
+            AutoLeft,
+            AutoUp,
+            AutoDown,
+            AutoCenterRight,
+            AutoCenterLeft,
+            AutoCenterUp,
+            AutoCenterDown,
+        };
+
+        std::string              name{};
+
+        Mode                     mode    = Mode::Preferred;
+        int                      width   = 0;
+        int                      height  = 0;
+        double                   refresh = 0; ///< 0 when not given
+
+        Placement                placement = Placement::AutoRight;
+        int                      x         = 0;
+        int                      y         = 0;
+
+        std::optional<double>    scale{};       ///< std::nullopt for "auto"
+        int                      transform = 0; ///< wl_output_transform, 0-7
+        int                      bitdepth  = 8; ///< 8 or 10
+        std::optional<int>       vrr{};         ///< 0 off, 1 on, 2 fullscreen only
+        std::string              mirror{};
+        std::vector<std::string> workspaces{};
+        bool                     disabled = false;
+
+        bool                     operator==(const MonitorSpec&) const = default;
+    };
+
+    /// @brief Parse "WxH", "WxH@Hz", "preferred", "highres", "highrr" or "maxwidth" into @p spec
+    std::expected<void, std::string> parse_resolution(std::string_view text, MonitorSpec& spec);
+
+    /// @brief Parse "XxY", "auto" or one of the "auto-*" directions into @p spec
+    std::expected<void, std::string> parse_position(std::string_view text, MonitorSpec& spec);
+
+    /// @brief Parse a positive number or "auto" into @p spec
+    std::expected<void, std::string> parse_scale(std::string_view text, MonitorSpec& spec);
+
+    /**
+     * @brief Parse an optional rule argument ("transform", "mirror", "bitdepth" or "vrr")
+     * @return An error for unknown keys or out-of-range values
+     */
+    std::expected<void, std::string> parse_option(std::string_view key, std::string_view value, MonitorSpec& spec);
+
+    /**
+     * @brief Parse the value of a Hyprland `monitor =` line
+     * @param line e.g. "DP-1, 2560x1440@144, 0x0, 1, transform, 1, vrr, 1" or "DP-2, disable"
+     */
+    std::expected<MonitorSpec, std::string> parse_monitor_line(std::string_view line);
+
+    /// @brief The spec as a `monitor =` line; parse_monitor_line() reads it back to an equal spec, workspaces aside
+    std::string to_string(const MonitorSpec& spec);
+
+} // namespace hyprlua
+
+/// @brief Formats as to_string(), so a log call only builds the text when its level is enabled
+template <>
+struct std::formatter<hyprlua::MonitorSpec> : std::formatter<std::string_view> {
+    auto format(const hyprlua::MonitorSpec& spec, std::format_context& ctx) const {
+        return std::formatter<std::string_view>::format(hyprlua::to_string(spec), ctx);
+    }
+};
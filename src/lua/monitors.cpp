@@ -1,102 +1,260 @@
+// monitors.cpp
 #include "monitors.hpp"
-#include "utils.hpp"
 #include "logger.hpp"
+#include "trace.hpp"
 
-#include <hyprland/src/Compositor.hpp>
-#include <hyprland/src/helpers/Color.hpp>
-#include <hyprland/src/helpers/Monitor.hpp>
 #include <sol/sol.hpp>
-#include <iostream>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
-#include <sstream>
+#include <format>
 
 namespace hyprlua::modules {
 
-    void add_monitor(const std::string& name, const std::string& resolution, const std::string& position, const double_t& scale, sol::optional<std::vector<double_t>> workspaces) {
-        sendNotification("Applying monitor with Hyprland API", CHyprColor{1.0, 0.5, 0.0, 1.0}, 5000);
-        log::info("Starting add_monitor");
-
-        std::ostringstream debugLog;
-        debugLog << "Add Monitor:\n"
-                 << "  Name:       " << name << "\n"
-                 << "  Resolution: " << resolution << "\n"
-                 << "  Position:   " << position << "\n"
-                 << "  Scale:      " << scale << "\n";
-
-        if (workspaces) {
-            debugLog << "  Workspaces: ";
-            for (const auto& w : workspaces.value())
-                debugLog << w << " ";
-            debugLog << "\n";
-        }
-        log::debug(debugLog.str());
+    namespace {
+        using SpecPtr = std::shared_ptr<MonitorSpec>;
 
-        SMonitorRule rule;
-        rule.name = name;
+        /**
+         * @brief Parsed specs by their source text, shared between config runs
+         * @details A reload that repeats a monitor line gets the spec object parsed
+         *          the first time, which also lets commit_monitors() compare by pointer.
+         *          Filled from whichever thread builds the config.
+         */
+        std::mutex                                specCacheMutex;
+        std::unordered_map<std::string, SpecPtr>  specCache;
+        constexpr size_t                          SPEC_CACHE_LIMIT = 256;
 
-        int resX = 1920, resY = 1080;
-        sscanf(resolution.c_str(), "%dx%d", &resX, &resY);
-        rule.resolution = Vector2D(resX, resY);
+        /// @brief Keys a monitor table may use, in the order they form the cache key
+        constexpr std::array<std::string_view, 9> TABLE_FIELDS = {"name", "resolution", "position", "scale", "transform", "mirror", "bitdepth", "vrr", "workspaces"};
 
-        int posX = 0, posY = 0;
-        sscanf(position.c_str(), "%dx%d", &posX, &posY);
-        rule.offset = Vector2D(posX, posY);
+        template <typename Parse>
+        std::expected<SpecPtr, std::string> cached_spec(const std::string& key, Parse&& parse) {
+            {
+                std::lock_guard<std::mutex> lock(specCacheMutex);
+                if (auto it = specCache.find(key); it != specCache.end()) {
+                    return it->second;
+                }
+            }
 
-        rule.scale    = static_cast<float>(scale);
-        rule.disabled = false;
+            std::expected<MonitorSpec, std::string> parsed = parse();
+            if (!parsed) {
+                return std::unexpected(parsed.error());
+            }
 
-        auto monitor = g_pCompositor->getMonitorFromName(name);
-        if (!monitor) {
-            log::error("Monitor not found: " + name);
-            std::cerr << "[hyprlua] Monitor not found: " << name << "\n";
-            return;
+            auto                        spec = std::make_shared<MonitorSpec>(std::move(*parsed));
+            std::lock_guard<std::mutex> lock(specCacheMutex);
+            if (specCache.size() >= SPEC_CACHE_LIMIT) {
+                specCache.clear();
+            }
+            specCache.emplace(key, spec);
+            return spec;
         }
 
-        monitor->applyMonitorRule(&rule, true);
-        log::info("Monitor rule applied: " + name);
-        sendNotification("Monitor rule applied", CHyprColor{0.0, 1.0, 0.0, 1.0}, 3000);
-    }
+        /// @brief Text of a scalar table field; numbers print without a trailing ".0"
+        std::optional<std::string> field_text(const sol::object& value) {
+            switch (value.get_type()) {
+                case sol::type::string: return value.as<std::string>();
+                case sol::type::number: return std::format("{}", value.as<double>());
+                case sol::type::boolean: return value.as<bool>() ? "1" : "0";
+                default: return std::nullopt;
+            }
+        }
+
+        /// @brief Workspace names or ids; ids must be whole numbers
+        std::expected<std::vector<std::string>, std::string> workspace_list(const sol::object& value) {
+            if (value.get_type() != sol::type::table) {
+                return std::unexpected(std::string("workspaces must be a list of workspace ids or names"));
+            }
+
+            std::vector<std::string> workspaces;
+            sol::table               list = value.as<sol::table>();
+            for (size_t i = 1; i <= list.size(); ++i) {
+                sol::object entry = list[i];
+                if (entry.get_type() == sol::type::number) {
+                    const double id = entry.as<double>();
+                    if (id != std::floor(id) || id < 1) {
+                        return std::unexpected(std::format("invalid workspace id {}: expected a positive whole number", id));
+                    }
+                    workspaces.push_back(std::format("{}", static_cast<int64_t>(id)));
+                } else if (entry.get_type() == sol::type::string) {
+                    workspaces.push_back(entry.as<std::string>());
+                } else {
+                    return std::unexpected(std::format("workspace #{} must be a number or a name", i));
+                }
+            }
+            return workspaces;
+        }
+
+        /**
+         * @brief Parse { name = ..., resolution = ..., position = ..., scale = ..., ... }
+         * @details resolution, position and scale default to "preferred", "auto" and 1.
+         *          Unknown keys are errors, so a typo cannot silently drop an option.
+         */
+        std::expected<SpecPtr, std::string> spec_from_table(const sol::table& table) {
+            std::array<sol::object, TABLE_FIELDS.size()> fields;
+
+            for (const auto& [k, v] : table) {
+                const auto name = k.get_type() == sol::type::string ? k.as<std::string>() : std::string("?");
+                const auto it   = std::find(TABLE_FIELDS.begin(), TABLE_FIELDS.end(), name);
+                if (it == TABLE_FIELDS.end()) {
+                    return std::unexpected(std::format("unknown monitor field '{}': expected name, resolution, position, scale, transform, mirror, bitdepth, vrr or workspaces", name));
+                }
+                fields[it - TABLE_FIELDS.begin()] = v;
+            }
 
-    void disable_monitor(const std::string& name) {
-        sendNotification("Disabling monitor", CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
-        log::info("Disabling monitor: " + name);
+            // Scalars become "key=value" text, which doubles as the cache key
+            std::array<std::optional<std::string>, TABLE_FIELDS.size()> text;
+            std::string                                                 key = "table";
+            for (size_t i = 0; i + 1 < TABLE_FIELDS.size(); ++i) {
+                if (!fields[i].valid() || fields[i].get_type() == sol::type::lua_nil) {
+                    continue;
+                }
+                text[i] = field_text(fields[i]);
+                if (!text[i]) {
+                    return std::unexpected(std::format("monitor field '{}' must be a string or number", TABLE_FIELDS[i]));
+                }
+                key += std::format("\x1f{}={}", TABLE_FIELDS[i], *text[i]);
+            }
 
-        SMonitorRule rule;
-        rule.name     = name;
-        rule.disabled = true;
+            std::vector<std::string> workspaces;
+            if (const auto& ws = fields.back(); ws.valid() && ws.get_type() != sol::type::lua_nil) {
+                auto list = workspace_list(ws);
+                if (!list) {
+                    return std::unexpected(list.error());
+                }
+                workspaces = std::move(*list);
+                for (const auto& w : workspaces) {
+                    key += "\x1fws=" + w;
+                }
+            }
 
-        auto monitor = g_pCompositor->getMonitorFromName(name);
+            if (!text[0] || text[0]->empty()) {
+                return std::unexpected(std::string("monitor table needs a name"));
+            }
 
-        if (!monitor) {
-            log::error("Monitor not found for disabling: " + name);
-            std::cerr << "[hyprlua] Monitor not found: " << name << "\n";
-            return;
+            return cached_spec(key, [&]() -> std::expected<MonitorSpec, std::string> {
+                MonitorSpec spec;
+                spec.name       = *text[0];
+                spec.scale      = 1.0;
+                spec.workspaces = std::move(workspaces);
+
+                auto fail = [&](const std::string& error) { return std::unexpected(std::format("monitor '{}': {}", spec.name, error)); };
+                if (text[1]) {
+                    if (auto r = parse_resolution(*text[1], spec); !r) {
+                        return fail(r.error());
+                    }
+                }
+                if (text[2]) {
+                    if (auto r = parse_position(*text[2], spec); !r) {
+                        return fail(r.error());
+                    }
+                }
+                if (text[3]) {
+                    if (auto r = parse_scale(*text[3], spec); !r) {
+                        return fail(r.error());
+                    }
+                }
+                for (size_t i = 4; i + 1 < TABLE_FIELDS.size(); ++i) {
+                    if (text[i]) {
+                        if (auto r = parse_option(TABLE_FIELDS[i], *text[i], spec); !r) {
+                            return fail(r.error());
+                        }
+                    }
+                }
+                return spec;
+            });
         }
 
-        monitor->applyMonitorRule(&rule, true);
-        log::info("Monitor disabled: " + name);
-        sendNotification("Monitor disabled", CHyprColor{1.0, 0.0, 0.0, 1.0}, 3000);
+        /// @brief A MonitorSpec from a spec, a monitor table or a `monitor =` line
+        std::expected<SpecPtr, std::string> spec_from_lua(const sol::object& value) {
+            if (value.is<MonitorSpec>()) {
+                return value.as<SpecPtr>();
+            }
+            if (value.get_type() == sol::type::string) {
+                const auto line = value.as<std::string>();
+                return cached_spec("line\x1f" + line, [&] { return parse_monitor_line(line); });
+            }
+            if (value.get_type() == sol::type::table) {
+                return spec_from_table(value.as<sol::table>());
+            }
+            return std::unexpected(std::string("expected a monitor table, a monitor line or a MonitorSpec"));
+        }
     }
 
-    std::vector<std::string> list_monitors() {
-        std::vector<std::string> names;
-        // iterate the full list (including disabled/fallback outputs)
-        for (auto& pMon : g_pCompositor->m_realMonitors) {
-            if (!pMon)
-                continue;
-            names.emplace_back(pMon->m_name);
-        }
-        return names;
+    MonitorCounters& monitor_counters() {
+        static MonitorCounters counters;
+        return counters;
     }
 
-    void bind_monitors(sol::state& lua) {
-        sendNotification("Binding monitors module", CHyprColor{0.2, 0.8, 0.2, 1.0}, 4000);
+    MonitorStats monitor_stats() {
+        const auto& counters = monitor_counters();
+        return {counters.applied.load(std::memory_order_relaxed), counters.skipped.load(std::memory_order_relaxed), counters.pending.load(std::memory_order_relaxed),
+                counters.hotplug.load(std::memory_order_relaxed)};
+    }
+
+    void bind_monitors(sol::state& lua, ChangeSet& changes) {
         log::info("Binding monitor Lua functions");
 
-        lua.set_function("__hypr_add_monitor", &add_monitor);
-        lua.set_function("__hypr_disable_monitor", &disable_monitor);
+        // Read-only view of a parsed spec; tostring() gives the equivalent monitor line
+        lua.new_usertype<MonitorSpec>("MonitorSpec", sol::no_constructor,
+                                      "name", sol::readonly(&MonitorSpec::name),
+                                      "width", sol::readonly(&MonitorSpec::width),
+                                      "height", sol::readonly(&MonitorSpec::height),
+                                      "refresh", sol::readonly(&MonitorSpec::refresh),
+                                      "x", sol::readonly(&MonitorSpec::x),
+                                      "y", sol::readonly(&MonitorSpec::y),
+                                      "scale", sol::readonly(&MonitorSpec::scale),
+                                      "transform", sol::readonly(&MonitorSpec::transform),
+                                      "bitdepth", sol::readonly(&MonitorSpec::bitdepth),
+                                      "vrr", sol::readonly(&MonitorSpec::vrr),
+                                      "mirror", sol::readonly(&MonitorSpec::mirror),
+                                      "disabled", sol::readonly(&MonitorSpec::disabled),
+                                      "workspaces", sol::property([](const MonitorSpec& spec) { return sol::as_table(spec.workspaces); }),
+                                      sol::meta_function::to_string, [](const MonitorSpec& spec) { return to_string(spec); });
+
+        // Returns the spec, or nil and the parse error so the Lua side can raise it at the caller's line
+        lua.set_function("__hypr_monitor_spec", [](const sol::object& value) -> std::tuple<SpecPtr, sol::optional<std::string>> {
+            HYPRLUA_TRACE_SCOPE("lua.__hypr_monitor_spec");
+            auto spec = spec_from_lua(value);
+            if (!spec) {
+                return {nullptr, spec.error()};
+            }
+            return {*spec, sol::nullopt};
+        });
+
+        // Record only: this runs while the config executes, possibly off the compositor thread.
+        // Returns nothing, or the error for the Lua side to raise
+        lua.set_function("__hypr_add_monitor", [&changes](const SpecPtr& spec) -> sol::optional<std::string> {
+            HYPRLUA_TRACE_SCOPE("lua.__hypr_add_monitor");
+            if (changes.committed) {
+                return std::string("hypr.monitors.add can only be called while the config loads");
+            }
+            // nil or another type converts to an empty pointer, which commit_monitors() would dereference
+            if (!spec) {
+                return std::string("expected a MonitorSpec from hypr.monitors.spec");
+            }
+            changes.monitors.push_back(spec);
+            return sol::nullopt;
+        });
+        lua.set_function("__hypr_disable_monitor", [&changes](const std::string& name) -> sol::optional<std::string> {
+            HYPRLUA_TRACE_SCOPE("lua.__hypr_disable_monitor");
+            if (changes.committed) {
+                return std::string("hypr.monitors.disable can only be called while the config loads");
+            }
+            auto spec = cached_spec("disable\x1f" + name, [&]() -> std::expected<MonitorSpec, std::string> { return MonitorSpec{.name = name, .disabled = true}; });
+            changes.monitors.push_back(*spec);
+            return sol::nullopt;
+        });
+        lua.set_function("__hypr_monitor_stats", [](sol::this_state ts) {
+            sol::state_view lua(ts);
+            const auto      stats = monitor_stats();
+            return lua.create_table_with("applied", stats.applied, "skipped", stats.skipped, "pending", stats.pending, "hotplug", stats.hotplug);
+        });
 
-        std::cout << "[hyprlua] Monitors module loaded.\n";
         log::debug("Monitors module successfully bound.");
     }
 
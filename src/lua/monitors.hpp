@@ -1,11 +1,53 @@
 // monitors.hpp
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <sol/sol.hpp>
+#include "lua/changeset.hpp"
 
 namespace hyprlua::modules {
 
+    /// @brief Monitor rules committed to Hyprland versus skipped as unchanged, since plugin load
+    struct MonitorStats {
+        uint64_t applied = 0;
+        uint64_t skipped = 0;
+        uint64_t pending = 0; ///< Rules of the active config whose output is not plugged in
+        uint64_t hotplug = 0; ///< Outputs plugged in while a config was active
+    };
+
+    /// @brief The counters behind MonitorStats; written by the commit and the hooks, read from any thread
+    struct MonitorCounters {
+        std::atomic<uint64_t> applied = 0;
+        std::atomic<uint64_t> skipped = 0;
+        std::atomic<uint64_t> pending = 0;
+        std::atomic<uint64_t> hotplug = 0;
+    };
+
+    /// @brief Register the monitor functions; calls are recorded into @p changes
+    void bind_monitors(sol::state& lua, ChangeSet& changes);
+
+    MonitorCounters& monitor_counters();
+    MonitorStats     monitor_stats();
+
+    // Applying the rules is monitors_commit.cpp, which hyprlua-compile leaves out
+
+    /// @brief Names of the outputs Hyprland reports, disabled and fallback ones included
     std::vector<std::string> list_monitors();
-    void                     bind_monitors(sol::state& lua);
+
+    /// @brief Commit recorded monitor changes, reconfiguring only outputs whose rule changed
+    /// @note Compositor thread only
+    void commit_monitors(const ChangeSet& changes);
+
+    /**
+     * @brief Follow outputs being plugged in and removed
+     * @details A plugged-in output gets the rule of the last commit that selects it,
+     *          without running the config again. After Hyprland reloads its config,
+     *          every output gets its committed rule again.
+     */
+    void register_monitor_hooks();
+
+    /// @brief Remove the hotplug and reload hooks and forget the committed rules; called when the runtime shuts down
+    void remove_monitor_hooks();
 
 } // namespace hyprlua::modules
@@ -0,0 +1,365 @@
+// monitors_commit.cpp
+#include "monitors.hpp"
+#include "utils.hpp"
+#include "eventloop.hpp"
+#include "globals.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+#include "lua/monitor_index.hpp"
+
+#include <hyprland/src/Compositor.hpp>
+#include <hyprland/src/config/ConfigManager.hpp>
+#include <hyprland/src/desktop/Workspace.hpp>
+#include <hyprland/src/helpers/Color.hpp>
+#include <hyprland/src/helpers/Monitor.hpp>
+#include <hyprland/src/plugins/PluginAPI.hpp>
+#include <algorithm>
+#include <any>
+#include <charconv>
+#include <climits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <format>
+
+namespace hyprlua::modules {
+
+    namespace {
+        /// @brief Spec last applied to an output, and the output object it was applied to
+        struct AppliedRule {
+            std::shared_ptr<const MonitorSpec> spec;
+            PHLMONITORREF                      monitor;
+        };
+
+        // Compositor thread only
+        std::unordered_map<std::string, AppliedRule>     applied; ///< By output name
+
+        /// @brief Present outputs, parallel to index.outputs(); rebuilt per commit and after hotplug
+        std::vector<PHLMONITORREF>                       indexed;
+        MonitorIndex                                     index;
+        bool                                             indexValid = false;
+
+        /// @brief Workspace rules Hyprlua set, by workspace, as the value of their workspace keyword
+        std::unordered_map<std::string, std::string>     workspaceRules;
+
+        /// @brief Rules of the last commit, one per name in call order; hotplugged outputs are matched against these
+        std::vector<std::shared_ptr<const MonitorSpec>> committed;
+
+        SP<HOOK_CALLBACK_FN>                             addedHook;
+        SP<HOOK_CALLBACK_FN>                             removedHook;
+        SP<HOOK_CALLBACK_FN>                             reloadHook;
+
+        /// @brief The index of the outputs present now, rebuilt if an output came or went since
+        const MonitorIndex& monitor_index() {
+            if (!indexValid) {
+                HYPRLUA_TRACE_SCOPE("monitors.index");
+                std::vector<MonitorIndex::Output> outputs;
+                indexed.clear();
+                for (const auto& monitor : g_pCompositor->m_realMonitors) {
+                    if (!monitor) {
+                        continue;
+                    }
+                    outputs.push_back({monitor->m_name, monitor->m_description, MonitorIndex::serial_of(monitor->m_description)});
+                    indexed.push_back(monitor);
+                }
+                index.rebuild(std::move(outputs));
+                indexValid = true;
+            }
+            return index;
+        }
+
+        /// @brief Outputs the rule @p selector names, see monitor_index.hpp
+        std::vector<PHLMONITOR> find_monitors(const std::string& selector) {
+            std::vector<PHLMONITOR> found;
+            for (const size_t i : monitor_index().match(selector)) {
+                if (auto monitor = indexed[i].lock()) {
+                    found.push_back(std::move(monitor));
+                }
+            }
+            return found;
+        }
+
+        /// @brief The rule for @p monitor; selectors Hyprland does not know are replaced by the output's name
+        SMonitorRule make_rule(const MonitorSpec& spec, const PHLMONITOR& monitor) {
+            SMonitorRule rule;
+            rule.name = spec.name.starts_with("desc:") ? spec.name : monitor->m_name;
+
+            if (spec.disabled) {
+                rule.disabled = true;
+                return rule;
+            }
+
+            // Hyprland encodes the mode keywords as sentinel resolutions
+            switch (spec.mode) {
+                case MonitorSpec::Mode::Explicit: rule.resolution = Vector2D(spec.width, spec.height); break;
+                case MonitorSpec::Mode::Preferred: rule.resolution = Vector2D(); break;
+                case MonitorSpec::Mode::HighRR: rule.resolution = Vector2D(-1, -1); break;
+                case MonitorSpec::Mode::HighRes: rule.resolution = Vector2D(-1, -2); break;
+                case MonitorSpec::Mode::MaxWidth: rule.resolution = Vector2D(-1, -3); break;
+            }
+            if (spec.refresh > 0) {
+                rule.refreshRate = static_cast<float>(spec.refresh);
+            }
+
+            if (spec.placement == MonitorSpec::Placement::Explicit) {
+                rule.offset = Vector2D(spec.x, spec.y);
+            } else {
+                rule.offset = Vector2D(-INT32_MAX, -INT32_MAX);
+                switch (spec.placement) {
+                    case MonitorSpec::Placement::AutoLeft: rule.autoDir = DIR_AUTO_LEFT; break;
+                    case MonitorSpec::Placement::AutoUp: rule.autoDir = DIR_AUTO_UP; break;
+                    case MonitorSpec::Placement::AutoDown: rule.autoDir = DIR_AUTO_DOWN; break;
+                    case MonitorSpec::Placement::AutoCenterRight: rule.autoDir = DIR_AUTO_CENTER_RIGHT; break;
+                    case MonitorSpec::Placement::AutoCenterLeft: rule.autoDir = DIR_AUTO_CENTER_LEFT; break;
+                    case MonitorSpec::Placement::AutoCenterUp: rule.autoDir = DIR_AUTO_CENTER_UP; break;
+                    case MonitorSpec::Placement::AutoCenterDown: rule.autoDir = DIR_AUTO_CENTER_DOWN; break;
+                    default: rule.autoDir = DIR_AUTO_RIGHT; break;
+                }
+            }
+
+            rule.scale       = spec.scale ? static_cast<float>(*spec.scale) : -1.f;
+            rule.transform   = static_cast<wl_output_transform>(spec.transform);
+            rule.mirrorOf    = spec.mirror;
+            rule.enable10bit = spec.bitdepth == 10;
+            if (spec.vrr) {
+                rule.vrr = *spec.vrr;
+            }
+            rule.disabled = false;
+            return rule;
+        }
+
+        /// @brief Set the workspace rule for @p workspace unless it already is @p value
+        void set_workspace_rule(const std::string& workspace, const std::string& value) {
+            auto& current = workspaceRules[workspace];
+            if (current == value) {
+                return;
+            }
+            // Straight to the config manager: a hyprctl keyword would also recalculate every output, once per rule
+            if (auto error = g_pConfigManager->parseKeyword("workspace", value); !error.empty()) {
+                log::error("Workspace rule '{}' not set: {}", value, error);
+            }
+            current = value;
+        }
+
+        /**
+         * @brief Bind the spec's workspaces to its output
+         * @details Sets a workspace rule for each, so workspaces created later open there
+         *          (the first one is the output's default), and moves the ones that already exist.
+         */
+        void assign_workspaces(const MonitorSpec& spec, const PHLMONITOR& monitor) {
+            for (size_t i = 0; i < spec.workspaces.size(); ++i) {
+                const auto& workspace = spec.workspaces[i];
+                set_workspace_rule(workspace, std::format("{},monitor:{}{}", workspace, monitor->m_name, i == 0 ? ",default:true" : ""));
+
+                int64_t    id       = 0;
+                const auto result   = std::from_chars(workspace.data(), workspace.data() + workspace.size(), id);
+                const bool numeric  = result.ec == std::errc{} && result.ptr == workspace.data() + workspace.size();
+                auto       existing = numeric ? g_pCompositor->getWorkspaceByID(id) : g_pCompositor->getWorkspaceByName(workspace);
+                if (existing && existing->m_monitor.lock() != monitor) {
+                    g_pCompositor->moveWorkspaceToMonitor(existing, monitor);
+                }
+            }
+        }
+
+        /**
+         * @brief Release the workspaces no committed rule assigns any more
+         * @details Hyprland cannot drop a single workspace rule; a rule naming neither an
+         *          output nor a default takes the place of Hyprlua's, so the workspace
+         *          opens wherever it is created again.
+         */
+        void release_workspaces() {
+            std::unordered_set<std::string> wanted;
+            for (const auto& spec : committed) {
+                if (!spec->disabled) {
+                    wanted.insert(spec->workspaces.begin(), spec->workspaces.end());
+                }
+            }
+            for (auto it = workspaceRules.begin(); it != workspaceRules.end();) {
+                if (wanted.contains(it->first)) {
+                    ++it;
+                    continue;
+                }
+                log::debug("Releasing workspace {}", it->first);
+                if (auto error = g_pConfigManager->parseKeyword("workspace", std::format("{},default:false", it->first)); !error.empty()) {
+                    log::error("Workspace {} not released: {}", it->first, error);
+                }
+                it = workspaceRules.erase(it);
+            }
+        }
+
+        /**
+         * @brief Apply @p spec to @p monitor unless the output already runs it
+         * @details A re-plugged output is a new object and always gets its rule again
+         */
+        void apply_rule(const std::shared_ptr<const MonitorSpec>& spec, const PHLMONITOR& monitor) {
+            auto last = applied.find(monitor->m_name);
+            if (last != applied.end() && last->second.monitor.lock() == monitor && (last->second.spec == spec || *last->second.spec == *spec)) {
+                monitor_counters().skipped.fetch_add(1, std::memory_order_relaxed);
+                log::debug("Monitor rule unchanged, skipping: {}", monitor->m_name);
+                return;
+            }
+
+            log::debug("Applying monitor rule to {}: {}", monitor->m_name, *spec);
+            SMonitorRule rule = make_rule(*spec, monitor);
+            monitor->applyMonitorRule(&rule, true);
+            if (!spec->disabled) {
+                assign_workspaces(*spec, monitor);
+            }
+            applied[monitor->m_name] = {spec, monitor};
+            monitor_counters().applied.fetch_add(1, std::memory_order_relaxed);
+
+            // One toast per kind for the whole commit, however many outputs changed
+            if (rule.disabled) {
+                log::info("Monitor disabled: {}", monitor->m_name);
+                sendSummaryNotification("disabled", "monitor", CHyprColor{1.0, 0.0, 0.0, 1.0}, 3000);
+            } else {
+                log::info("Monitor rule applied: {}", monitor->m_name);
+                sendSummaryNotification("applied", "monitor rule", CHyprColor{0.0, 1.0, 0.0, 1.0}, 3000);
+            }
+        }
+
+        /// @brief The recorded rules with one per name: the last call wins, in the order names first appear
+        std::vector<std::shared_ptr<const MonitorSpec>> collapse(const ChangeSet& changes) {
+            std::vector<std::shared_ptr<const MonitorSpec>> order;
+            std::unordered_map<std::string, size_t>         position;
+            for (const auto& spec : changes.monitors) {
+                auto [it, inserted] = position.try_emplace(spec->name, order.size());
+                if (inserted) {
+                    order.push_back(spec);
+                } else {
+                    order[it->second] = spec;
+                }
+            }
+            return order;
+        }
+
+        /**
+         * @brief The committed rule for each present output
+         * @details An output may be selected by several rules, e.g. "DP-*" and "DP-1"; the later one wins
+         * @param absent Set to the names of the rules that select no present output
+         */
+        std::vector<std::pair<PHLMONITOR, std::shared_ptr<const MonitorSpec>>> resolve(std::vector<std::string>& absent) {
+            std::vector<std::pair<PHLMONITOR, std::shared_ptr<const MonitorSpec>>> targets;
+            std::unordered_map<CMonitor*, size_t>                                  position;
+            absent.clear();
+            for (const auto& spec : committed) {
+                auto monitors = find_monitors(spec->name);
+                if (monitors.empty()) {
+                    absent.push_back(spec->name);
+                    continue;
+                }
+                for (auto& monitor : monitors) {
+                    auto [it, inserted] = position.try_emplace(monitor.get(), targets.size());
+                    if (inserted) {
+                        targets.emplace_back(std::move(monitor), spec);
+                    } else {
+                        targets[it->second].second = spec;
+                    }
+                }
+            }
+            return targets;
+        }
+
+        /// @brief An output was plugged in: apply the committed rule that selects it, without running the config
+        void on_monitor_added(const PHLMONITORREF& added) {
+            HYPRLUA_TRACE_SCOPE("monitors.hotplug");
+            auto monitor = added.lock();
+            if (!monitor) {
+                return;
+            }
+
+            std::vector<std::string> absent;
+            for (auto& [target, spec] : resolve(absent)) {
+                if (target == monitor) {
+                    log::info("Monitor {} plugged in, applying its rule", monitor->m_name);
+                    apply_rule(spec, target);
+                }
+            }
+            monitor_counters().pending.store(absent.size(), std::memory_order_relaxed);
+            monitor_counters().hotplug.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /// @brief Apply the committed rules to the present outputs that do not run them yet
+        void apply_committed() {
+            std::vector<std::string> absent;
+            for (const auto& [monitor, spec] : resolve(absent)) {
+                apply_rule(spec, monitor);
+            }
+            for (const auto& name : absent) {
+                log::info("Monitor {} not present, its rule applies once it is plugged in", name);
+            }
+            monitor_counters().pending.store(absent.size(), std::memory_order_relaxed);
+            release_workspaces();
+        }
+
+        /// @brief Hyprland reloaded its config and applied its own monitor rules over the committed ones
+        void on_config_reloaded() {
+            HYPRLUA_TRACE_SCOPE("monitors.restore");
+            // It dropped the workspace rules too
+            applied.clear();
+            workspaceRules.clear();
+            indexValid = false;
+            apply_committed();
+        }
+    }
+
+    /**
+     * @brief Apply the monitor part of a config run as one transaction
+     * @details Calls are collapsed per rule name (the last call wins) and resolved
+     *          against an index of the outputs built once for the commit. Each output's
+     *          spec is compared with the spec last applied to it. Only outputs whose
+     *          spec changed, or that were re-plugged since, are reconfigured, so
+     *          re-applying an unchanged config costs no modeset. Specs repeated from
+     *          the previous run are the same cached object, so the comparison is
+     *          usually a pointer check. Rules for absent outputs stay pending until
+     *          the output is plugged in.
+     */
+    void commit_monitors(const ChangeSet& changes) {
+        HYPRLUA_TRACE_SCOPE("monitors.commit");
+        committed  = collapse(changes);
+        indexValid = false;
+        apply_committed();
+    }
+
+    void register_monitor_hooks() {
+        // Hyprland emits these while it sets the output up; apply once it is done
+        addedHook = HyprlandAPI::registerCallbackDynamic(PHANDLE, "monitorAdded", [](void*, SCallbackInfo&, std::any data) {
+            indexValid = false;
+            if (const auto* monitor = std::any_cast<PHLMONITOR>(&data); monitor && *monitor && !committed.empty()) {
+                PHLMONITORREF added = *monitor;
+                if (!eventloop::post([added] { on_monitor_added(added); })) {
+                    on_monitor_added(added);
+                }
+            }
+        });
+        removedHook = HyprlandAPI::registerCallbackDynamic(PHANDLE, "monitorRemoved", [](void*, SCallbackInfo&, std::any) { indexValid = false; });
+        // Every output then runs its hyprland.conf rule, whatever was applied before
+        reloadHook = HyprlandAPI::registerCallbackDynamic(PHANDLE, "configReloaded", [](void*, SCallbackInfo&, std::any) {
+            if (committed.empty()) {
+                return;
+            }
+            if (!eventloop::post([] { on_config_reloaded(); })) {
+                on_config_reloaded();
+            }
+        });
+    }
+
+    void remove_monitor_hooks() {
+        addedHook.reset();
+        removedHook.reset();
+        reloadHook.reset();
+        committed.clear();
+        indexed.clear();
+        indexValid = false;
+    }
+
+    std::vector<std::string> list_monitors() {
+        std::vector<std::string> names;
+        // The full list, disabled and fallback outputs included
+        for (const auto& output : monitor_index().outputs()) {
+            names.push_back(output.name);
+        }
+        return names;
+    }
+
+} // namespace hyprlua::modules
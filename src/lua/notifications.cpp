@@ -0,0 +1,28 @@
+#include "notifications.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+
+#include <sol/sol.hpp>
+
+namespace hyprlua::modules {
+
+    void bind_notifications(sol::state& lua, ChangeSet& changes) {
+        log::info("Binding notification Lua functions");
+
+        // Returns nothing, or the error for the Lua side to raise
+        lua.set_function("__hypr_configure_notifications", [&changes](sol::table options) -> sol::optional<std::string> {
+            HYPRLUA_TRACE_SCOPE("lua.__hypr_configure_notifications");
+            if (changes.committed) {
+                return std::string("hypr.notifications.configure can only be called while the config loads");
+            }
+            NotificationSettings settings = changes.notifications.value_or(NotificationSettings{});
+            settings.burst                = options.get_or("burst", settings.burst);
+            settings.intervalMs           = options.get_or("interval_ms", settings.intervalMs);
+            changes.notifications         = settings;
+            return sol::nullopt;
+        });
+
+        log::debug("Notifications module successfully bound.");
+    }
+
+} // namespace hyprlua::modules
@@ -0,0 +1,17 @@
+// notifications.hpp
+#pragma once
+
+#include <sol/sol.hpp>
+#include "lua/changeset.hpp"
+
+namespace hyprlua::modules {
+
+    /// @brief Register the notification functions; settings are recorded into @p changes
+    void bind_notifications(sol::state& lua, ChangeSet& changes);
+
+    // notifications_commit.cpp, next to the plugin's notification helpers
+
+    /// @brief Apply the recorded rate limit, or the defaults if the config set none
+    void commit_notifications(const ChangeSet& changes);
+
+} // namespace hyprlua::modules
@@ -0,0 +1,14 @@
+// notifications_commit.cpp
+#include "notifications.hpp"
+#include "utils.hpp"
+#include "logger.hpp"
+
+namespace hyprlua::modules {
+
+    void commit_notifications(const ChangeSet& changes) {
+        const auto settings = changes.notifications.value_or(NotificationSettings{});
+        setNotificationRateLimit(settings.burst, settings.intervalMs);
+        log::debug("Notification rate limit: burst={} interval={}ms", settings.burst, settings.intervalMs);
+    }
+
+} // namespace hyprlua::modules
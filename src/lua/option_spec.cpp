@@ -0,0 +1,23 @@
+// option_spec.cpp
+#include "option_spec.hpp"
+
+#include <format>
+
+namespace hyprlua {
+
+    std::string option_key(std::string_view parent, std::string_view key) {
+        const auto last = parent.substr(parent.find_last_of(":.") + 1);
+        return std::format("{}{}{}", parent, last == "col" ? "." : ":", key);
+    }
+
+    std::string option_text(const OptionValue& value) {
+        if (const auto* i = std::get_if<int64_t>(&value)) {
+            return std::to_string(*i);
+        }
+        if (const auto* d = std::get_if<double>(&value)) {
+            return std::format("{}", *d);
+        }
+        return std::get<std::string>(value);
+    }
+
+} // namespace hyprlua
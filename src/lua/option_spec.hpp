@@ -0,0 +1,41 @@
+// option_spec.hpp
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <variant>
+
+/**
+ * @file option_spec.hpp
+ * @brief A Hyprland config option as recorded from a setup{} table
+ * @details Keys are full Hyprland option names ("general:gaps_in",
+ *          "general:col.active_border", "decoration:blur:size"). Values keep the
+ *          type Lua gave them: booleans become 0 or 1, integral numbers stay integers.
+ *          Nothing here depends on Hyprland or Lua, so it can be tested headless.
+ */
+
+namespace hyprlua {
+
+    using OptionValue = std::variant<int64_t, double, std::string>;
+
+    /// @brief One option set by a config, e.g. {"general:border_size", 2}
+    struct OptionSetting {
+        std::string key;
+        OptionValue value;
+
+        bool        operator==(const OptionSetting&) const = default;
+    };
+
+    /**
+     * @brief Full name of @p key nested in the table at @p parent
+     * @details Tables under a "col" key are colors and join with a dot, as in
+     *          "general:col.active_border"; every other table is a subcategory and
+     *          joins with a colon, as in "decoration:blur:size"
+     */
+    std::string option_key(std::string_view parent, std::string_view key);
+
+    /// @brief @p value the way it is written in hyprland.conf
+    std::string option_text(const OptionValue& value);
+
+} // namespace hyprlua
@@ -0,0 +1,195 @@
+// option_store.cpp
+#include "option_store.hpp"
+#include "globals.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+
+#include <hyprland/src/Compositor.hpp>
+#include <hyprland/src/config/ConfigDataValues.hpp>
+#include <hyprland/src/config/ConfigManager.hpp>
+#include <hyprland/src/managers/LayoutManager.hpp>
+#include <hyprland/src/plugins/PluginAPI.hpp>
+#include <hyprland/src/render/Renderer.hpp>
+#include <hyprlang.hpp>
+#include <any>
+#include <format>
+#include <typeinfo>
+#include <utility>
+
+namespace hyprlua {
+
+    namespace {
+        template <typename T>
+        T* data(Hyprlang::CConfigValue* value) {
+            return static_cast<T*>(*value->getDataStaticPtr());
+        }
+
+        /// @brief What Hyprland's `keyword` request does after decoration and layout options changed, once for the whole batch
+        void refresh() {
+            HYPRLUA_TRACE_SCOPE("options.refresh");
+            if (!g_pCompositor) {
+                return;
+            }
+            for (const auto& monitor : g_pCompositor->m_monitors) {
+                g_pLayoutManager->getCurrentLayout()->recalculateMonitor(monitor->m_id);
+                g_pHyprRenderer->damageMonitor(monitor);
+            }
+            g_pCompositor->updateAllWindowsAnimatedDecorationValues();
+        }
+    }
+
+    OptionStore::Handle* OptionStore::resolve(const std::string& key) {
+        if (auto it = m_handles.find(key); it != m_handles.end()) {
+            return &it->second;
+        }
+        // Misses are not cached: options registered later, e.g. by another plugin, are found once they exist
+        auto* value = HyprlandAPI::getConfigValue(PHANDLE, key);
+        if (!value) {
+            return nullptr;
+        }
+
+        Handle     handle{.value = value};
+        const auto current = value->getValue();
+        if (current.type() == typeid(Hyprlang::INT)) {
+            handle.kind = Kind::Int;
+        } else if (current.type() == typeid(Hyprlang::FLOAT)) {
+            handle.kind = Kind::Float;
+        } else if (current.type() == typeid(Hyprlang::STRING)) {
+            handle.kind = Kind::String;
+        }
+        return &m_handles.emplace(key, handle).first->second;
+    }
+
+    bool OptionStore::holds(const Handle& handle, const OptionValue& value) {
+        const auto* i = std::get_if<int64_t>(&value);
+        const auto* d = std::get_if<double>(&value);
+        switch (handle.kind) {
+            case Kind::Int: {
+                const auto live = *data<Hyprlang::INT>(handle.value);
+                return i ? *i == live : d && *d == static_cast<double>(live);
+            }
+            case Kind::Float: {
+                const auto live = *data<Hyprlang::FLOAT>(handle.value);
+                return (i || d) && static_cast<Hyprlang::FLOAT>(i ? static_cast<double>(*i) : *d) == live;
+            }
+            case Kind::String: {
+                const auto* live = std::any_cast<Hyprlang::STRING>(handle.value->getValue());
+                return live && option_text(value) == live;
+            }
+            case Kind::Parsed: return handle.written == value;
+        }
+        return false;
+    }
+
+    OptionValue OptionStore::current(const Handle& handle) {
+        switch (handle.kind) {
+            case Kind::Int: return int64_t{*data<Hyprlang::INT>(handle.value)};
+            case Kind::Float: return static_cast<double>(*data<Hyprlang::FLOAT>(handle.value));
+            case Kind::String: {
+                const auto* live = std::any_cast<Hyprlang::STRING>(handle.value->getValue());
+                return std::string(live ? live : "");
+            }
+            case Kind::Parsed: {
+                // What hyprctl getoption prints for the type, which its parser reads back
+                const auto value = handle.value->getValue();
+                const auto* ptr  = std::any_cast<void*>(&value);
+                return ptr && *ptr ? static_cast<ICustomConfigValueData*>(*ptr)->toString() : std::string();
+            }
+        }
+        return std::string();
+    }
+
+    std::string OptionStore::write(const std::string& key, Handle& handle, const OptionValue& value) {
+        const auto* i = std::get_if<int64_t>(&value);
+        const auto* d = std::get_if<double>(&value);
+        if (handle.kind == Kind::Int && i) {
+            *data<Hyprlang::INT>(handle.value) = *i;
+        } else if (handle.kind == Kind::Float && (i || d)) {
+            *data<Hyprlang::FLOAT>(handle.value) = static_cast<Hyprlang::FLOAT>(i ? static_cast<double>(*i) : *d);
+        } else {
+            // Strings are owned by hyprlang, and colors, gradients and gaps have their own parsers
+            auto error = g_pConfigManager->parseKeyword(key, option_text(value));
+            if (!error.empty()) {
+                return error;
+            }
+        }
+        handle.written = value;
+        return "";
+    }
+
+    std::vector<std::string> OptionStore::apply(const std::vector<OptionSetting>& settings) {
+        HYPRLUA_TRACE_SCOPE("options.apply");
+        std::vector<std::string> errors;
+
+        // The last value per key, in the order keys were first set
+        std::vector<const OptionSetting*>       order;
+        std::unordered_map<std::string, size_t> index;
+        for (const auto& setting : settings) {
+            auto [it, inserted] = index.try_emplace(setting.key, order.size());
+            if (inserted) {
+                order.push_back(&setting);
+            } else {
+                order[it->second] = &setting;
+            }
+        }
+
+        size_t written = 0;
+        for (const auto* setting : order) {
+            auto* handle = resolve(setting->key);
+            if (!handle) {
+                errors.push_back(std::format("unknown option '{}'", setting->key));
+                ++m_stats.failed;
+                continue;
+            }
+            if (holds(*handle, setting->value)) {
+                ++m_stats.skipped;
+                continue;
+            }
+            auto original = handle->original ? std::nullopt : std::optional(current(*handle));
+            if (auto error = write(setting->key, *handle, setting->value); !error.empty()) {
+                errors.push_back(std::format("{} = {}: {}", setting->key, option_text(setting->value), error));
+                ++m_stats.failed;
+                continue;
+            }
+            if (original) {
+                handle->original = std::move(original);
+            }
+            ++m_stats.written;
+            ++written;
+        }
+
+        // Options set before that this batch leaves out
+        for (auto& [key, handle] : m_handles) {
+            if (!handle.original || index.contains(key)) {
+                continue;
+            }
+            const auto original = *std::exchange(handle.original, std::nullopt);
+            if (holds(handle, original)) {
+                ++m_stats.skipped;
+                continue;
+            }
+            if (auto error = write(key, handle, original); !error.empty()) {
+                errors.push_back(std::format("{}: could not restore {}: {}", key, option_text(original), error));
+                ++m_stats.failed;
+                continue;
+            }
+            ++m_stats.written;
+            ++written;
+        }
+
+        if (written > 0) {
+            refresh();
+            ++m_stats.refreshes;
+        }
+        log::debug("Options: {} set, {} written, {} failed", order.size(), written, errors.size());
+        return errors;
+    }
+
+    void OptionStore::invalidate() {
+        for (auto& [key, handle] : m_handles) {
+            handle.written.reset();
+            handle.original.reset();
+        }
+    }
+
+} // namespace hyprlua
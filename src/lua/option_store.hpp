@@ -0,0 +1,91 @@
+// option_store.hpp
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "lua/option_spec.hpp"
+
+namespace Hyprlang {
+    class CConfigValue;
+}
+
+/**
+ * @file option_store.hpp
+ * @brief Writes config options to Hyprland through cached config-value handles
+ * @details Each key is looked up with HyprlandAPI::getConfigValue once; the handle
+ *          stays valid for as long as Hyprland runs. Integer and float options are
+ *          written straight into the value Hyprland reads, everything else (strings,
+ *          colors, gradients, gaps) goes through Hyprland's own keyword parser.
+ *          A batch skips options that already hold the value and refreshes layout
+ *          and rendering once at the end, instead of once per option. The value an
+ *          option had before the store first wrote it is kept, so that a batch which
+ *          no longer sets the option can put it back.
+ */
+
+namespace hyprlua {
+
+    /// @brief Options written versus skipped as unchanged, over the store's lifetime
+    struct OptionStats {
+        uint64_t written   = 0;
+        uint64_t skipped   = 0;
+        uint64_t failed    = 0; ///< Unknown options and values Hyprland rejected
+        uint64_t refreshes = 0; ///< Batches that changed something and refreshed layout and rendering
+    };
+
+    class OptionStore {
+      public:
+        /**
+         * @brief Write @p settings as one batch; the last value for a key wins
+         * @details @p settings is every option the config sets: options an earlier batch
+         *          wrote that it leaves out go back to the value they had before.
+         * @return One message per option that could not be set
+         * @note Compositor thread only
+         */
+        std::vector<std::string> apply(const std::vector<OptionSetting>& settings);
+
+        /**
+         * @brief Forget the values written so far and the ones they replaced, keeping the handles
+         * @details For when Hyprland reset its options, e.g. after reloading hyprland.conf
+         */
+        void                     invalidate();
+
+        OptionStats              stats() const {
+            return m_stats;
+        }
+
+      private:
+        /// @brief How a value is written
+        enum class Kind : uint8_t {
+            Int,
+            Float,
+            String,
+            Parsed, ///< A type with its own parser in Hyprland
+        };
+
+        struct Handle {
+            Hyprlang::CConfigValue*    value = nullptr;
+            Kind                       kind  = Kind::Parsed;
+            std::optional<OptionValue> written{};  ///< Last value set through this store
+            std::optional<OptionValue> original{}; ///< Value before this store first set it
+        };
+
+        /// @brief The cached handle for @p key, looked up on first use; nullptr for unknown options
+        Handle*                                 resolve(const std::string& key);
+
+        /// @brief Whether @p handle already holds @p value
+        static bool                             holds(const Handle& handle, const OptionValue& value);
+
+        /// @brief The value @p handle holds now, as text for types with their own parser
+        static OptionValue                      current(const Handle& handle);
+
+        /// @brief Set @p value; returns Hyprland's error, or an empty string
+        static std::string                      write(const std::string& key, Handle& handle, const OptionValue& value);
+
+        std::unordered_map<std::string, Handle> m_handles;
+        OptionStats                             m_stats;
+    };
+
+} // namespace hyprlua
@@ -0,0 +1,77 @@
+// options.cpp
+#include "options.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <expected>
+#include <format>
+#include <vector>
+
+namespace hyprlua::modules {
+
+    namespace {
+        /// @brief Number as Lua gave it: integral values stay integers, so they can be written to INT options directly
+        OptionValue number_value(double number) {
+            if (std::trunc(number) == number && std::abs(number) < 9.0e15) {
+                return static_cast<int64_t>(number);
+            }
+            return number;
+        }
+
+        /**
+         * @brief Append the options of @p table to @p out, keys sorted so the recorded order does not depend on pairs()
+         * @param prefix Full name of the table, e.g. "general" or "decoration:blur"
+         */
+        std::expected<void, std::string> flatten(const sol::table& table, const std::string& prefix, std::vector<OptionSetting>& out) {
+            std::vector<std::pair<std::string, sol::object>> entries;
+            for (const auto& [key, value] : table) {
+                if (key.get_type() != sol::type::string) {
+                    return std::unexpected(std::format("{}: option names must be strings", prefix));
+                }
+                entries.emplace_back(key.as<std::string>(), value);
+            }
+            std::ranges::sort(entries, {}, &std::pair<std::string, sol::object>::first);
+
+            for (const auto& [name, value] : entries) {
+                const auto key = option_key(prefix, name);
+                switch (value.get_type()) {
+                    case sol::type::boolean: out.push_back({key, int64_t{value.as<bool>()}}); break;
+                    case sol::type::number: out.push_back({key, number_value(value.as<double>())}); break;
+                    case sol::type::string: out.push_back({key, value.as<std::string>()}); break;
+                    case sol::type::table: {
+                        if (auto r = flatten(value.as<sol::table>(), key, out); !r) {
+                            return r;
+                        }
+                        break;
+                    }
+                    default: return std::unexpected(std::format("{}: expected a boolean, number, string or table, got {}", key, sol::type_name(value.lua_state(), value.get_type())));
+                }
+            }
+            return {};
+        }
+    }
+
+    void bind_options(sol::state& lua, ChangeSet& changes) {
+        log::info("Binding option Lua functions");
+
+        // Record only: whether an option exists is checked when the batch is committed.
+        // Returns nothing, or the error for the Lua side to raise.
+        lua.set_function("__hypr_set_options", [&changes](const std::string& section, const sol::table& options) -> sol::optional<std::string> {
+            HYPRLUA_TRACE_SCOPE("lua.__hypr_set_options");
+            if (changes.committed) {
+                return std::format("hypr.{}.setup can only be called while the config loads", section);
+            }
+            std::vector<OptionSetting> settings;
+            if (auto r = flatten(options, section, settings); !r) {
+                return r.error();
+            }
+            changes.options.insert(changes.options.end(), std::make_move_iterator(settings.begin()), std::make_move_iterator(settings.end()));
+            return sol::nullopt;
+        });
+
+        log::debug("Options module successfully bound.");
+    }
+
+} // namespace hyprlua::modules
@@ -0,0 +1,32 @@
+// options.hpp
+#pragma once
+
+#include <sol/sol.hpp>
+#include "lua/changeset.hpp"
+#include "lua/option_store.hpp"
+
+namespace hyprlua::modules {
+
+    /// @brief Register __hypr_set_options; setup{} tables are recorded into @p changes
+    void bind_options(sol::state& lua, ChangeSet& changes);
+
+    // Writing them to Hyprland is options_commit.cpp; hyprlua-compile only records
+
+    /**
+     * @brief Write the recorded options to Hyprland as one batch
+     * @details Options already holding their value are skipped, and layout and
+     *          rendering are refreshed once if anything changed. Options a config
+     *          stops setting keep their last value.
+     * @note Compositor thread only
+     */
+    void commit_options(const ChangeSet& changes);
+
+    /// @brief Re-apply the committed options whenever Hyprland reloads hyprland.conf, which resets them
+    void register_option_hooks();
+
+    /// @brief Remove the reload hook and forget the committed options; called when the runtime shuts down
+    void remove_option_hooks();
+
+    OptionStats option_stats();
+
+} // namespace hyprlua::modules
@@ -0,0 +1,59 @@
+// options_commit.cpp
+#include "options.hpp"
+#include "utils.hpp"
+#include "globals.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+
+#include <hyprland/src/helpers/Color.hpp>
+#include <hyprland/src/plugins/PluginAPI.hpp>
+#include <vector>
+
+namespace hyprlua::modules {
+
+    namespace {
+        // Compositor thread only
+        OptionStore                store;
+        std::vector<OptionSetting> committed;
+        SP<HOOK_CALLBACK_FN>       reloadHook;
+
+        void apply_committed() {
+            const auto errors = store.apply(committed);
+            if (errors.empty()) {
+                return;
+            }
+            std::string text;
+            for (const auto& error : errors) {
+                log::error("Option not set: {}", error);
+                text += "\n" + error;
+            }
+            sendNotification("[Hyprlua] Some options were not set:" + text, CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+        }
+    }
+
+    void commit_options(const ChangeSet& changes) {
+        HYPRLUA_TRACE_SCOPE("options.commit");
+        committed = changes.options;
+        apply_committed();
+    }
+
+    void register_option_hooks() {
+        // A reload of hyprland.conf puts every option back to its value there
+        reloadHook = HyprlandAPI::registerCallbackDynamic(PHANDLE, "configReloaded", [](void*, SCallbackInfo&, std::any) {
+            store.invalidate();
+            if (!committed.empty()) {
+                apply_committed();
+            }
+        });
+    }
+
+    void remove_option_hooks() {
+        reloadHook.reset();
+        committed.clear();
+    }
+
+    OptionStats option_stats() {
+        return store.stats();
+    }
+
+} // namespace hyprlua::modules
@@ -0,0 +1,220 @@
+// profile_table.cpp
+#include "profile_table.hpp"
+#include "hash.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <unordered_map>
+
+namespace hyprlua {
+
+    namespace {
+        /// @brief Hash slots for @p capacity entries, a power of two at most half full
+        size_t slot_count(size_t capacity) {
+            return std::bit_ceil(std::max<size_t>(capacity * 2, 16));
+        }
+
+        uint64_t mix(uint64_t a, uint64_t b) {
+            uint64_t h = a * 0x9e3779b97f4a7c15ULL ^ (b + 0x632be59bd9b4e019ULL + (a << 6) + (a >> 2));
+            h ^= h >> 29;
+            return h;
+        }
+    }
+
+    ProfileTable::ProfileTable(size_t maxNodes, size_t stringBytes) :
+        m_textSlots(slot_count(2 * maxNodes), NONE), m_frameSlots(slot_count(maxNodes), NONE), m_nodeSlots(slot_count(maxNodes), NONE), m_chars(stringBytes) {
+        // A node adds at most one frame, and a frame at most two strings
+        m_texts.reserve(2 * maxNodes);
+        m_frames.reserve(maxNodes);
+        m_nodes.reserve(maxNodes);
+    }
+
+    void ProfileTable::clear() {
+        std::ranges::fill(m_textSlots, NONE);
+        std::ranges::fill(m_frameSlots, NONE);
+        std::ranges::fill(m_nodeSlots, NONE);
+        m_texts.clear();
+        m_frames.clear();
+        m_nodes.clear();
+        m_charsUsed = 0;
+        m_samples   = 0;
+        m_dropped   = 0;
+    }
+
+    std::string_view ProfileTable::text(uint32_t id) const {
+        return {m_chars.data() + m_texts[id].offset, m_texts[id].size};
+    }
+
+    uint32_t ProfileTable::intern(std::string_view value) {
+        const size_t mask = m_textSlots.size() - 1;
+        for (size_t slot = hash::fnv1a(value) & mask;; slot = (slot + 1) & mask) {
+            const uint32_t id = m_textSlots[slot];
+            if (id == NONE) {
+                if (m_texts.size() == m_texts.capacity() || m_chars.size() - m_charsUsed < value.size()) {
+                    return NONE;
+                }
+                std::ranges::copy(value, m_chars.begin() + static_cast<ptrdiff_t>(m_charsUsed));
+                m_texts.push_back({static_cast<uint32_t>(m_charsUsed), static_cast<uint32_t>(value.size())});
+                m_charsUsed += value.size();
+                m_textSlots[slot] = static_cast<uint32_t>(m_texts.size() - 1);
+                return m_textSlots[slot];
+            }
+            if (text(id) == value) {
+                return id;
+            }
+        }
+    }
+
+    uint32_t ProfileTable::frame_id(const ProfileFrame& frame) {
+        const uint32_t function = intern(frame.function);
+        const uint32_t source   = intern(frame.source);
+        if (function == NONE || source == NONE) {
+            return NONE;
+        }
+
+        const size_t mask = m_frameSlots.size() - 1;
+        const auto   h    = mix(mix(function, source), mix(static_cast<uint32_t>(frame.line), static_cast<uint32_t>(frame.defined)));
+        for (size_t slot = h & mask;; slot = (slot + 1) & mask) {
+            const uint32_t id = m_frameSlots[slot];
+            if (id == NONE) {
+                if (m_frames.size() == m_frames.capacity()) {
+                    return NONE;
+                }
+                m_frames.push_back({function, source, frame.line, frame.defined});
+                m_frameSlots[slot] = static_cast<uint32_t>(m_frames.size() - 1);
+                return m_frameSlots[slot];
+            }
+            const auto& f = m_frames[id];
+            if (f.function == function && f.source == source && f.line == frame.line && f.defined == frame.defined) {
+                return id;
+            }
+        }
+    }
+
+    uint32_t ProfileTable::child(uint32_t parent, uint32_t frame) {
+        const size_t mask = m_nodeSlots.size() - 1;
+        for (size_t slot = mix(parent, frame) & mask;; slot = (slot + 1) & mask) {
+            const uint32_t id = m_nodeSlots[slot];
+            if (id == NONE) {
+                if (m_nodes.size() == m_nodes.capacity()) {
+                    return NONE;
+                }
+                m_nodes.push_back({parent, frame, 0});
+                m_nodeSlots[slot] = static_cast<uint32_t>(m_nodes.size() - 1);
+                return m_nodeSlots[slot];
+            }
+            if (m_nodes[id].parent == parent && m_nodes[id].frame == frame) {
+                return id;
+            }
+        }
+    }
+
+    bool ProfileTable::record(std::span<const ProfileFrame> frames) {
+        frames = frames.first(std::min(frames.size(), MAX_DEPTH));
+        if (frames.empty()) {
+            ++m_dropped;
+            return false;
+        }
+
+        // Outermost frame first, so stacks sharing callers share nodes
+        uint32_t node = NONE;
+        for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+            const uint32_t frame = frame_id(*it);
+            node                 = frame == NONE ? NONE : child(node, frame);
+            if (node == NONE) {
+                ++m_dropped;
+                return false;
+            }
+        }
+        ++m_nodes[node].self;
+        ++m_samples;
+        return true;
+    }
+
+    std::string ProfileTable::frame_label(uint32_t frame) const {
+        const auto& f = m_frames[frame];
+        if (f.line < 0) {
+            return std::format("{} ({})", text(f.function), text(f.source));
+        }
+        return std::format("{} ({}:{})", text(f.function), text(f.source), f.line);
+    }
+
+    void ProfileTable::write_folded(std::ostream& out) const {
+        std::vector<std::string> labels(m_frames.size());
+        for (uint32_t i = 0; i < m_frames.size(); ++i) {
+            // ';' separates frames, so it cannot appear inside one
+            labels[i] = frame_label(i);
+            std::ranges::replace(labels[i], ';', ':');
+        }
+
+        std::vector<uint32_t> path;
+        for (const auto& node : m_nodes) {
+            if (node.self == 0) {
+                continue;
+            }
+            path.clear();
+            for (const Node* n = &node;; n = &m_nodes[n->parent]) {
+                path.push_back(n->frame);
+                if (n->parent == NONE) {
+                    break;
+                }
+            }
+            for (auto it = path.rbegin(); it != path.rend(); ++it) {
+                out << labels[*it] << (it + 1 == path.rend() ? ' ' : ';');
+            }
+            out << node.self << '\n';
+        }
+    }
+
+    std::vector<ProfileHotspot> ProfileTable::hottest(size_t n, bool byFunction) const {
+        std::unordered_map<std::string, ProfileHotspot> spots;
+        std::vector<std::string>                        seen;
+        for (const auto& node : m_nodes) {
+            if (node.self == 0) {
+                continue;
+            }
+            // Count each line or function once per stack, however deep it recurses
+            seen.clear();
+            for (const Node* n = &node;; n = &m_nodes[n->parent]) {
+                const auto& f     = m_frames[n->frame];
+                auto        label = byFunction ? std::format("{} ({}:{})", text(f.function), text(f.source), f.defined) : std::format("{}:{}", text(f.source), f.line);
+                if (f.line < 0) {
+                    label = byFunction ? std::format("{} ({})", text(f.function), text(f.source)) : std::string(text(f.source));
+                }
+                auto& spot = spots[label];
+                spot.label = label;
+                if (n == &node) {
+                    spot.self += node.self;
+                }
+                if (std::ranges::find(seen, label) == seen.end()) {
+                    spot.total += node.self;
+                    seen.push_back(std::move(label));
+                }
+                if (n->parent == NONE) {
+                    break;
+                }
+            }
+        }
+
+        std::vector<ProfileHotspot> out;
+        out.reserve(spots.size());
+        for (auto& [_, spot] : spots) {
+            out.push_back(std::move(spot));
+        }
+        std::ranges::sort(out, [](const ProfileHotspot& a, const ProfileHotspot& b) {
+            return a.self != b.self ? a.self > b.self : a.total != b.total ? a.total > b.total : a.label < b.label;
+        });
+        out.resize(std::min(out.size(), n));
+        return out;
+    }
+
+    std::vector<ProfileHotspot> ProfileTable::hottest_lines(size_t n) const {
+        return hottest(n, false);
+    }
+
+    std::vector<ProfileHotspot> ProfileTable::hottest_functions(size_t n) const {
+        return hottest(n, true);
+    }
+
+} // namespace hyprlua
@@ -0,0 +1,128 @@
+// profile_table.hpp
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @file profile_table.hpp
+ * @brief Fixed-size call tree the Lua profiler aggregates its samples into
+ * @details Every sample is a stack of frames, each a function at the line it was
+ *          running. Stacks are merged into a call tree whose nodes, frames and
+ *          strings all live in storage reserved by the constructor, so recording a
+ *          sample never allocates; a sample that does not fit is counted as dropped.
+ *          Nothing here depends on Lua.
+ */
+
+namespace hyprlua {
+
+    /// @brief One level of a sampled stack; the views only need to live during record()
+    struct ProfileFrame {
+        std::string_view function; ///< e.g. "on_open", or "?" when Lua cannot name it
+        std::string_view source;   ///< e.g. "hyprland.lua", "[C]" for C functions
+        int32_t          line    = -1; ///< The line running, -1 for C functions
+        int32_t          defined = -1; ///< The line the function starts at
+    };
+
+    /// @brief Samples attributed to one line or function
+    struct ProfileHotspot {
+        std::string label;     ///< "hyprland.lua:12", or "on_open (hyprland.lua:10)" for a function
+        uint64_t    self  = 0; ///< Samples taken while it was the innermost frame
+        uint64_t    total = 0; ///< Samples taken while it was anywhere on the stack
+    };
+
+    /**
+     * @class ProfileTable
+     * @brief Samples merged into a call tree of bounded size
+     * @note Not thread-safe; the profiler serializes record() itself
+     */
+    class ProfileTable {
+      public:
+        /// @brief Deepest stack kept; deeper samples keep their innermost frames
+        static constexpr size_t MAX_DEPTH = 48;
+
+        /**
+         * @param maxNodes Call tree nodes, one per distinct stack prefix
+         * @param stringBytes Room for the distinct function and file names
+         */
+        explicit ProfileTable(size_t maxNodes = 16384, size_t stringBytes = 64 * 1024);
+
+        /**
+         * @brief Add one sample
+         * @param frames The stack, innermost frame first
+         * @return false if the sample did not fit and was dropped
+         */
+        bool                        record(std::span<const ProfileFrame> frames);
+
+        /// @brief Forget every sample; keeps the reserved storage
+        void                        clear();
+
+        uint64_t                    samples() const {
+            return m_samples;
+        }
+
+        uint64_t                    dropped() const {
+            return m_dropped;
+        }
+
+        /**
+         * @brief Write one line per distinct stack, "outer;...;inner count"
+         * @details The folded format flamegraph.pl, inferno and speedscope read.
+         *          Frames are "function (file:line)".
+         */
+        void                        write_folded(std::ostream& out) const;
+
+        /// @brief The @p n lines with the most samples, by self then total samples
+        std::vector<ProfileHotspot> hottest_lines(size_t n) const;
+
+        /// @brief The @p n functions with the most samples, by self then total samples
+        std::vector<ProfileHotspot> hottest_functions(size_t n) const;
+
+      private:
+        static constexpr uint32_t NONE = UINT32_MAX;
+
+        /// @brief An interned string: offset and length in m_chars
+        struct Text {
+            uint32_t offset = 0;
+            uint32_t size   = 0;
+        };
+
+        struct Frame {
+            uint32_t function = 0; ///< Index into m_texts
+            uint32_t source   = 0;
+            int32_t  line     = -1;
+            int32_t  defined  = -1;
+        };
+
+        struct Node {
+            uint32_t parent = NONE; ///< NONE for stacks' outermost frames
+            uint32_t frame  = 0;
+            uint64_t self   = 0;
+        };
+
+        uint32_t                    intern(std::string_view text);
+        uint32_t                    frame_id(const ProfileFrame& frame);
+        uint32_t                    child(uint32_t parent, uint32_t frame);
+        std::string_view            text(uint32_t id) const;
+        std::string                 frame_label(uint32_t frame) const;
+        std::vector<ProfileHotspot> hottest(size_t n, bool byFunction) const;
+
+        // Open-addressed hash slots holding indices into the vectors below, or NONE
+        std::vector<uint32_t> m_textSlots;
+        std::vector<uint32_t> m_frameSlots;
+        std::vector<uint32_t> m_nodeSlots;
+
+        std::vector<char>     m_chars;
+        std::vector<Text>     m_texts;
+        std::vector<Frame>    m_frames;
+        std::vector<Node>     m_nodes;
+        size_t                m_charsUsed = 0;
+        uint64_t              m_samples   = 0;
+        uint64_t              m_dropped   = 0;
+    };
+
+} // namespace hyprlua
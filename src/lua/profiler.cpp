@@ -0,0 +1,143 @@
+// profiler.cpp
+#include "profiler.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+namespace hyprlua::modules {
+
+    namespace {
+        /// @brief Hotspots listed by profile_summary()
+        constexpr size_t                                  SUMMARY_ENTRIES = 10;
+
+        std::atomic<bool>                                 active    = false;
+        std::atomic<uint64_t>                             contended = 0;
+
+        // Guarded by tableMutex; the sample buffers are only touched with it held
+        std::mutex                                        tableMutex;
+        std::unique_ptr<ProfileTable>                     table;
+        std::chrono::steady_clock::time_point             startedAt;
+        std::array<lua_Debug, ProfileTable::MAX_DEPTH>    levels;
+        std::array<ProfileFrame, ProfileTable::MAX_DEPTH> frames;
+
+        /// @brief The report of the running profile; tableMutex held
+        ProfileReport                                     report_locked() {
+            ProfileReport      report;
+            std::ostringstream folded;
+            table->write_folded(folded);
+            report.folded    = std::move(folded).str();
+            report.samples   = table->samples();
+            report.dropped   = table->dropped() + contended.load(std::memory_order_relaxed);
+            report.seconds   = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+            report.lines     = table->hottest_lines(SUMMARY_ENTRIES);
+            report.functions = table->hottest_functions(SUMMARY_ENTRIES);
+            return report;
+        }
+    }
+
+    bool profiling() {
+        return active.load(std::memory_order_relaxed);
+    }
+
+    void profile_sample(lua_State* L) {
+        // Another thread's sample is in the table; losing this one beats stalling that thread's Lua
+        std::unique_lock<std::mutex> lock(tableMutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            contended.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (!table) {
+            return;
+        }
+
+        size_t depth = 0;
+        for (; depth < levels.size() && lua_getstack(L, static_cast<int>(depth), &levels[depth]); ++depth) {
+            auto& ar = levels[depth];
+            lua_getinfo(L, "Sln", &ar);
+            const char* name = ar.name ? ar.name : std::string_view(ar.what) == "main" ? "main chunk" : "?";
+            frames[depth]    = {name, ar.short_src, ar.currentline, ar.linedefined};
+        }
+        table->record({frames.data(), depth});
+    }
+
+    bool start_profile() {
+        std::lock_guard<std::mutex> lock(tableMutex);
+        if (active.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        if (!table) {
+            table = std::make_unique<ProfileTable>();
+        }
+        table->clear();
+        contended.store(0, std::memory_order_relaxed);
+        startedAt = std::chrono::steady_clock::now();
+        active.store(true, std::memory_order_relaxed);
+        log::info("Lua profiling started");
+        return true;
+    }
+
+    std::optional<ProfileReport> stop_profile() {
+        std::lock_guard<std::mutex> lock(tableMutex);
+        if (!active.exchange(false, std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+        auto report = report_locked();
+        log::info("Lua profiling stopped: {} samples, {} dropped", report.samples, report.dropped);
+        return report;
+    }
+
+    std::string profile_summary(const ProfileReport& report) {
+        std::string out = std::format("{} samples in {:.1f}s, {} dropped\n", report.samples, report.seconds, report.dropped);
+        auto        add = [&out, &report](const char* title, const std::vector<ProfileHotspot>& spots) {
+            if (spots.empty()) {
+                return;
+            }
+            out += std::format("\n{:>6} {:>6}  {}\n", "self", "total", title);
+            for (const auto& spot : spots) {
+                out += std::format("{:>5.1f}% {:>5.1f}%  {}\n", 100.0 * spot.self / report.samples, 100.0 * spot.total / report.samples, spot.label);
+            }
+        };
+        add("line", report.lines);
+        add("function", report.functions);
+        return out;
+    }
+
+    void bind_profile(sol::state& lua) {
+        log::info("Binding profiler Lua functions");
+
+        // Returns the report, or nil and an error
+        lua.set_function("__hypr_profile", [](sol::object fn, sol::variadic_args args) -> std::tuple<sol::optional<std::string>, sol::optional<std::string>> {
+            if (fn.get_type() != sol::type::function) {
+                // No function: report on the profile started through hyprctl, if any
+                std::lock_guard<std::mutex> lock(tableMutex);
+                if (!active.load(std::memory_order_relaxed)) {
+                    return {sol::nullopt, sol::nullopt};
+                }
+                return {report_locked().folded, sol::nullopt};
+            }
+
+            HYPRLUA_TRACE_SCOPE("lua.__hypr_profile");
+            if (!start_profile()) {
+                return {sol::nullopt, "a profile is already running"};
+            }
+            // Stopped before returning whatever fn does, so an error cannot leave every state sampling
+            sol::protected_function_result result = fn.as<sol::protected_function>()(args);
+            auto                           report = stop_profile();
+            if (!result.valid()) {
+                sol::error err = result;
+                return {sol::nullopt, std::string(err.what())};
+            }
+            return {report ? report->folded : std::string(), sol::nullopt};
+        });
+
+        log::debug("Profiler module successfully bound.");
+    }
+
+} // namespace hyprlua::modules
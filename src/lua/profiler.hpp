@@ -0,0 +1,58 @@
+// profiler.hpp
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <sol/sol.hpp>
+#include <string>
+#include <vector>
+#include "lua/profile_table.hpp"
+
+/**
+ * @file profiler.hpp
+ * @brief Opt-in sampling profiler for the config and its callbacks
+ * @details While a profile runs, the watchdog's count hook fires every
+ *          PROFILE_INTERVAL VM instructions instead of every few thousand and
+ *          records the Lua stack at that point into a ProfileTable. Lua states
+ *          pick up the shorter interval at their next hook. Samples count
+ *          instructions, not time: Lua waiting inside a C++ function is not seen.
+ *          Off, profiling costs one relaxed load per hook.
+ */
+
+namespace hyprlua::modules {
+
+    /// @brief VM instructions between samples while profiling
+    constexpr int PROFILE_INTERVAL = 1000;
+
+    /// @brief What a finished profile found
+    struct ProfileReport {
+        std::string                 folded;  ///< One "outer;...;inner count" line per distinct stack
+        uint64_t                    samples = 0;
+        uint64_t                    dropped = 0; ///< Samples that did not fit the table or met another thread's sample
+        double                      seconds = 0;
+        std::vector<ProfileHotspot> lines;
+        std::vector<ProfileHotspot> functions;
+    };
+
+    /// @brief Whether a profile is running; checked by the watchdog hook
+    bool                         profiling();
+
+    /// @brief Record the stack of @p L; called from the count hook, never allocates
+    void                         profile_sample(lua_State* L);
+
+    /**
+     * @brief Start sampling every Lua state, on every thread
+     * @return false if a profile is already running
+     */
+    bool                         start_profile();
+
+    /// @brief Stop sampling and report; std::nullopt if no profile was running
+    std::optional<ProfileReport> stop_profile();
+
+    /// @brief Samples, the hottest lines and the hottest functions as a few lines of text
+    std::string                  profile_summary(const ProfileReport& report);
+
+    /// @brief Register __hypr_profile, the backing function of hypr.profile()
+    void                         bind_profile(sol::state& lua);
+
+} // namespace hyprlua::modules
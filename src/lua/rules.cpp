@@ -0,0 +1,140 @@
+// rules.cpp
+#include "rules.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+#include "lua/callback.hpp"
+
+#include <sol/sol.hpp>
+#include <expected>
+#include <format>
+#include <optional>
+#include <vector>
+
+namespace hyprlua::modules {
+
+    namespace {
+        /// @brief Rule field by its key in a hypr.rules.add table
+        std::optional<RuleField> field_of(std::string_view key) {
+            if (key == "class") {
+                return RuleField::Class;
+            }
+            if (key == "title") {
+                return RuleField::Title;
+            }
+            if (key == "initial_class") {
+                return RuleField::InitialClass;
+            }
+            if (key == "initial_title") {
+                return RuleField::InitialTitle;
+            }
+            return std::nullopt;
+        }
+
+        /**
+         * @brief Parse a hypr.rules.add table, compiling its patterns
+         * @details Unknown keys are errors, so a typo cannot silently widen a rule.
+         */
+        std::expected<WindowRuleSpec, std::string> spec_from_lua(const sol::table& table, std::optional<sol::main_protected_function>& when) {
+            WindowRuleSpec spec;
+            bool           patterns = false;
+            for (const auto& [k, value] : table) {
+                if (k.get_type() != sol::type::string) {
+                    return std::unexpected("rule keys must be strings");
+                }
+                const auto key = k.as<std::string>();
+                if (auto field = field_of(key)) {
+                    if (value.get_type() != sol::type::string) {
+                        return std::unexpected(std::format("{} must be a string pattern", key));
+                    }
+                    auto matcher = Matcher::compile(value.as<std::string>());
+                    if (!matcher) {
+                        return std::unexpected(std::format("{}: {}", key, matcher.error()));
+                    }
+                    patterns                                  = patterns || !matcher->any();
+                    spec.fields[static_cast<size_t>(*field)] = std::move(*matcher);
+                } else if (key == "actions") {
+                    std::vector<std::string> texts;
+                    if (value.get_type() == sol::type::string) {
+                        texts.push_back(value.as<std::string>());
+                    } else if (value.get_type() == sol::type::table) {
+                        const sol::table list = value.as<sol::table>();
+                        for (size_t i = 1; i <= list.size(); ++i) {
+                            sol::object entry = list[i];
+                            if (entry.get_type() != sol::type::string) {
+                                return std::unexpected(std::format("actions[{}] must be a string", i));
+                            }
+                            texts.push_back(entry.as<std::string>());
+                        }
+                    } else {
+                        return std::unexpected("actions must be a string or a list of strings");
+                    }
+                    for (const auto& text : texts) {
+                        auto action = parse_rule_action(text);
+                        if (!action) {
+                            return std::unexpected(action.error());
+                        }
+                        spec.actions.push_back(std::move(*action));
+                    }
+                } else if (key == "when") {
+                    if (value.get_type() != sol::type::function) {
+                        return std::unexpected("when must be a function");
+                    }
+                    when = value.as<sol::main_protected_function>();
+                } else {
+                    return std::unexpected(std::format("unknown key '{}': expected class, title, initial_class, initial_title, actions or when", key));
+                }
+            }
+            if (spec.actions.empty()) {
+                return std::unexpected("a rule needs at least one action");
+            }
+            if (!patterns && !when) {
+                return std::unexpected("a rule needs a pattern or a when function");
+            }
+            return spec;
+        }
+    }
+
+    RuleCounters& rule_counters() {
+        static RuleCounters counters;
+        return counters;
+    }
+
+    RuleStats rule_stats() {
+        const auto& counters = rule_counters();
+        return {counters.windows.load(std::memory_order_relaxed), counters.checked.load(std::memory_order_relaxed), counters.applied.load(std::memory_order_relaxed),
+                counters.predicates.load(std::memory_order_relaxed)};
+    }
+
+    void bind_rules(sol::state& lua, ChangeSet& changes, RulePredicates& predicates) {
+        log::info("Binding window rule Lua functions");
+
+        // Record only, like the monitor functions: patterns are compiled here, on the reload worker.
+        // Returns nothing, or the error for the Lua side to raise.
+        lua.set_function("__hypr_add_rule", [&changes, &predicates](const sol::table& table) -> sol::optional<std::string> {
+            HYPRLUA_TRACE_SCOPE("lua.__hypr_add_rule");
+            if (changes.committed) {
+                return std::string("hypr.rules.add can only be called while the config loads");
+            }
+            std::optional<sol::main_protected_function> when;
+            auto                                        spec = spec_from_lua(table, when);
+            if (!spec) {
+                return spec.error();
+            }
+            if (when) {
+                spec->predicate = static_cast<int32_t>(predicates.entries.size());
+                predicates.entries.push_back({.fn = *when, .source = source_of(*when)});
+            }
+            changes.rules.push_back(std::move(*spec));
+            return sol::nullopt;
+        });
+
+        lua.set_function("__hypr_rule_stats", [](sol::this_state ts) {
+            sol::state_view lua(ts);
+            const auto      stats = rule_stats();
+            return lua.create_table_with("windows", stats.windows, "checked", stats.checked, "applied", stats.applied, "predicates", stats.predicates);
+        });
+
+        log::debug("Rules module successfully bound.");
+    }
+
+} // namespace hyprlua::modules
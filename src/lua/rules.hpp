@@ -0,0 +1,64 @@
+// rules.hpp
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <sol/sol.hpp>
+#include <string>
+#include <vector>
+#include "lua/changeset.hpp"
+
+namespace hyprlua::modules {
+
+    /// @brief Windows checked against the rules and what that did, since plugin load
+    struct RuleStats {
+        uint64_t windows    = 0; ///< Windows opened or retitled while rules were active
+        uint64_t checked    = 0; ///< Rules whose patterns were tested; the index keeps this far below rules times windows
+        uint64_t applied    = 0; ///< Rules that matched and had their actions run
+        uint64_t predicates = 0; ///< Calls into Lua for rules with a when function
+    };
+
+    /// @brief The counters behind RuleStats; written on the compositor thread, read by __hypr_rule_stats from whichever thread runs the config
+    struct RuleCounters {
+        std::atomic<uint64_t> windows    = 0;
+        std::atomic<uint64_t> checked    = 0;
+        std::atomic<uint64_t> applied    = 0;
+        std::atomic<uint64_t> predicates = 0;
+    };
+
+    /// @brief A when function of a rule; WindowRuleSpec::predicate indexes these
+    struct RulePredicate {
+        sol::main_protected_function fn;
+        std::string                  source; ///< Where the function was defined, e.g. "hyprland.lua:12"
+    };
+
+    /**
+     * @brief Lua predicates of one config run's rules
+     * @note Holds references into the config's Lua state; destroy it before the state
+     */
+    struct RulePredicates {
+        std::vector<RulePredicate> entries;
+    };
+
+    /// @brief Register __hypr_add_rule; rules are recorded into @p changes, their when functions into @p predicates
+    void bind_rules(sol::state& lua, ChangeSet& changes, RulePredicates& predicates);
+
+    RuleCounters& rule_counters();
+    RuleStats     rule_stats();
+
+    // Matching windows against them happens in rules_commit.cpp, part of the plugin only
+
+    /**
+     * @brief Make the recorded rules the active ones
+     * @details Windows opened from now on get the rules' actions; a window whose title
+     *          changes gets the actions of rules it did not match before. The window
+     *          hooks are only registered while there are rules.
+     * @param predicates The when functions of the same config run
+     * @note Compositor thread only
+     */
+    void commit_rules(const ChangeSet& changes, RulePredicates& predicates);
+
+    /// @brief Unhook the window events and drop the rules; called when the runtime shuts down
+    void remove_rule_hooks();
+
+} // namespace hyprlua::modules
@@ -0,0 +1,215 @@
+// rules_commit.cpp
+#include "rules.hpp"
+#include "eventloop.hpp"
+#include "globals.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+#include "utils.hpp"
+#include "lua/watchdog.hpp"
+
+#include <hyprland/src/Compositor.hpp>
+#include <hyprland/src/desktop/Window.hpp>
+#include <hyprland/src/helpers/Color.hpp>
+#include <hyprland/src/managers/KeybindManager.hpp>
+#include <hyprland/src/plugins/PluginAPI.hpp>
+#include <sol/sol.hpp>
+#include <algorithm>
+#include <any>
+#include <format>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace hyprlua::modules {
+
+    namespace {
+        /// @brief An action with its dispatcher looked up once per commit
+        struct CompiledAction {
+            const RuleAction*                            action = nullptr;
+            std::function<SDispatchResult(std::string)> fn;
+        };
+
+        /// @brief A window and the rules it matched last, so a title change only runs rules it newly matches
+        struct TrackedWindow {
+            PHLWINDOWREF          window;
+            std::vector<uint32_t> matched;
+        };
+
+        // Compositor thread only
+        RuleSet                                            ruleSet;
+        std::vector<std::vector<CompiledAction>>           ruleActions; ///< By rule index
+        RulePredicates*                                    activePredicates = nullptr;
+        std::unordered_map<const CWindow*, TrackedWindow> tracked;
+        SP<HOOK_CALLBACK_FN>                               openHook;
+        SP<HOOK_CALLBACK_FN>                               titleHook;
+        SP<HOOK_CALLBACK_FN>                               closeHook;
+
+        std::string address_of(const CWindow& window) {
+            return std::format("0x{:x}", reinterpret_cast<uintptr_t>(&window));
+        }
+
+        WindowFields fields_of(const CWindow& window) {
+            return {{window.m_class, window.m_title, window.m_initialClass, window.m_initialTitle}};
+        }
+
+        /// @brief Call the when function of @p rule; errors count as not matching
+        bool predicate_holds(const WindowRuleSpec& rule, const CWindow& window, std::optional<sol::table>& info) {
+            if (!activePredicates || rule.predicate < 0 || static_cast<size_t>(rule.predicate) >= activePredicates->entries.size()) {
+                return false;
+            }
+            HYPRLUA_TRACE_SCOPE("rules.predicate");
+            const auto& predicate = activePredicates->entries[rule.predicate];
+            if (!info) {
+                sol::state_view lua(predicate.fn.lua_state());
+                info = lua.create_table_with("class", window.m_class, "title", window.m_title, "initial_class", window.m_initialClass, "initial_title", window.m_initialTitle,
+                                             "address", address_of(window));
+            }
+
+            rule_counters().predicates.fetch_add(1, std::memory_order_relaxed);
+            Budget                         budget(predicate.fn.lua_state(), BudgetKind::Callback);
+            sol::protected_function_result result = predicate.fn(*info);
+            if (!result.valid()) {
+                sol::error err = result;
+                log::error("Window rule predicate at {} failed: {}", predicate.source, err.what());
+                sendNotification(std::format("[Hyprlua] Window rule at {} failed: {}", predicate.source, err.what()), CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+                return false;
+            }
+            // Lua truthiness: everything but nil and false
+            const sol::object value = result;
+            return value.get_type() != sol::type::lua_nil && value.get_type() != sol::type::none && (value.get_type() != sol::type::boolean || value.as<bool>());
+        }
+
+        /// @brief Rules that apply to @p window, in rule order; Lua only runs for rules with a when function
+        void evaluate(const CWindow& window, std::vector<uint32_t>& out) {
+            const uint64_t before = ruleSet.checked();
+            ruleSet.match(fields_of(window), out);
+            rule_counters().checked.fetch_add(ruleSet.checked() - before, std::memory_order_relaxed);
+
+            std::optional<sol::table> info;
+            std::erase_if(out, [&](uint32_t i) {
+                const auto& rule = ruleSet.rules()[i];
+                return rule.predicate >= 0 && !predicate_holds(rule, window, info);
+            });
+        }
+
+        void run_actions(const CWindow& window, const std::vector<uint32_t>& rules) {
+            if (rules.empty()) {
+                return;
+            }
+            const auto address = address_of(window);
+            for (const auto i : rules) {
+                for (const auto& compiled : ruleActions[i]) {
+                    if (!compiled.fn) {
+                        continue;
+                    }
+                    const auto result = compiled.fn(compiled.action->argument(address));
+                    if (!result.success) {
+                        log::error("Window rule action '{}' failed: {}", compiled.action->text, result.error);
+                    }
+                }
+                rule_counters().applied.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        void on_open(const PHLWINDOW& window) {
+            HYPRLUA_TRACE_SCOPE("rules.open");
+            rule_counters().windows.fetch_add(1, std::memory_order_relaxed);
+            auto& entry  = tracked[window.get()];
+            entry.window = window;
+            evaluate(*window, entry.matched);
+            run_actions(*window, entry.matched);
+        }
+
+        void on_title(const PHLWINDOW& window) {
+            HYPRLUA_TRACE_SCOPE("rules.title");
+            rule_counters().windows.fetch_add(1, std::memory_order_relaxed);
+            auto& entry  = tracked[window.get()];
+            entry.window = window;
+
+            std::vector<uint32_t> matched;
+            evaluate(*window, matched);
+            std::vector<uint32_t> added;
+            std::ranges::set_difference(matched, entry.matched, std::back_inserter(added));
+            entry.matched = std::move(matched);
+            run_actions(*window, added);
+        }
+
+        void register_hooks() {
+            // Hyprland emits openWindow while it still sets the window up; run the actions once it is done
+            openHook = HyprlandAPI::registerCallbackDynamic(PHANDLE, "openWindow", [](void*, SCallbackInfo&, std::any data) {
+                if (const auto* window = std::any_cast<PHLWINDOW>(&data); window && *window) {
+                    PHLWINDOWREF opened = *window;
+                    if (!eventloop::post([opened] {
+                            if (auto w = opened.lock()) {
+                                on_open(w);
+                            }
+                        })) {
+                        on_open(*window);
+                    }
+                }
+            });
+            titleHook = HyprlandAPI::registerCallbackDynamic(PHANDLE, "windowTitle", [](void*, SCallbackInfo&, std::any data) {
+                if (const auto* window = std::any_cast<PHLWINDOW>(&data); window && *window) {
+                    on_title(*window);
+                }
+            });
+            closeHook = HyprlandAPI::registerCallbackDynamic(PHANDLE, "closeWindow", [](void*, SCallbackInfo&, std::any data) {
+                if (const auto* window = std::any_cast<PHLWINDOW>(&data); window && *window) {
+                    tracked.erase(window->get());
+                }
+            });
+        }
+    }
+
+    void commit_rules(const ChangeSet& changes, RulePredicates& predicates) {
+        HYPRLUA_TRACE_SCOPE("rules.commit");
+        ruleSet          = RuleSet(changes.rules);
+        activePredicates = &predicates;
+
+        ruleActions.assign(ruleSet.rules().size(), {});
+        for (size_t i = 0; i < ruleSet.rules().size(); ++i) {
+            for (const auto& action : ruleSet.rules()[i].actions) {
+                auto it = g_pKeybindManager->m_dispatchers.find(action.dispatcher);
+                if (it == g_pKeybindManager->m_dispatchers.end()) {
+                    log::error("Window rule action '{}' needs the {} dispatcher, which Hyprland does not have", action.text, action.dispatcher);
+                    continue;
+                }
+                ruleActions[i].push_back({&action, it->second});
+            }
+        }
+
+        tracked.clear();
+        if (ruleSet.rules().empty()) {
+            openHook.reset();
+            titleHook.reset();
+            closeHook.reset();
+            return;
+        }
+        if (!openHook) {
+            register_hooks();
+        }
+
+        // Open windows keep what earlier rules did; note what they match now, so only
+        // rules they newly match on a title change run their actions
+        if (g_pCompositor) {
+            for (const auto& window : g_pCompositor->m_windows) {
+                auto& entry  = tracked[window.get()];
+                entry.window = window;
+                evaluate(*window, entry.matched);
+            }
+        }
+        log::debug("Window rules: {} rules, {} open windows", ruleSet.rules().size(), tracked.size());
+    }
+
+    void remove_rule_hooks() {
+        openHook.reset();
+        titleHook.reset();
+        closeHook.reset();
+        tracked.clear();
+        ruleActions.clear();
+        ruleSet          = RuleSet();
+        activePredicates = nullptr;
+    }
+
+} // namespace hyprlua::modules
@@ -4,87 +4,298 @@
 #include <hyprland/src/Compositor.hpp>
 #include <hyprland/src/helpers/Color.hpp>
 #include <sol/sol.hpp>
-#include <iostream>
-#include <filesystem>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
 #include "logger.hpp"
+#include "eventloop.hpp"
+#include "globals.hpp"
+#include "trace.hpp"
+#include "watcher.hpp"
+#include "lua/config_build.hpp"
 
 // Modules
+#include "lua/binds.hpp"
+#include "lua/collector.hpp"
+#include "lua/events.hpp"
 #include "lua/monitors.hpp"
+#include "lua/notifications.hpp"
+#include "lua/options.hpp"
+#include "lua/rules.hpp"
+#include "lua/store.hpp"
+#include "lua/timers.hpp"
+#include "lua/watchdog.hpp"
 #include "utils.hpp"
 
 namespace hyprlua {
 
-    namespace fs = std::filesystem;
+    // Owned by the compositor thread
+    static std::unique_ptr<ConfigState> active;
+    static std::string                  modulesPath;
+    static std::string                  userConfigPath;
 
-    static sol::state lua;
-    static bool       initialized = false;
+    // Shared between the compositor thread and the reload worker, guarded by workerMutex
+    static std::mutex                                workerMutex;
+    static std::condition_variable                   workerCv;
+    static std::thread                               worker;
+    static bool                                      workerStopping = false;
+    static uint64_t                                  requestedGeneration = 0;
+    static std::unique_ptr<ConfigState>              pending;
+    static std::vector<std::unique_ptr<ConfigState>> retired;
 
-    sol::state&       get_lua_state() {
-        return lua;
+    // From request_reload() to the new config being active, across threads
+    static trace::Site                               reloadSite("reload.total");
+    static std::atomic<int64_t>                      reloadRequestedNs = 0;
+
+    // From init_lua_runtime() to the first config being active; compositor thread only
+    static trace::Site                               startupSite("startup.total");
+    static int64_t                                   startupNs = 0;
+    static bool                                      loaded    = false;
+
+    sol::state&                                      get_lua_state() {
+        return active->lua;
     }
 
-    void init_lua_runtime(const std::string& modules_path, const std::string& user_config_path) {
-        if (initialized) {
-            std::cerr << "[hyprlua] Lua runtime already initialized." << std::endl;
-            return;
+    std::optional<LuaAllocator::Stats> memory_stats() {
+        if (!active) {
+            return std::nullopt;
         }
+        return active->allocator.stats();
+    }
 
-        std::cout << "[hyprlua] Initializing Lua runtime..." << std::endl;
-
-        // Open only required libraries for safety
-        lua.open_libraries(sol::lib::base, sol::lib::package, sol::lib::math, sol::lib::table, sol::lib::string);
+    /// @brief Watch the files the last config run loaded, including those of a run that failed
+    static void watch(std::vector<std::string> files) {
+        eventloop::post([files = std::move(files)] {
+            if (g_FileWatcher) {
+                g_FileWatcher->setFiles(files);
+            }
+        });
+    }
 
-        // Register all C++ modules
-        hyprlua::modules::bind_monitors(lua);
+    /// @brief Build the config on the calling thread and report how it went, but apply nothing
+    static std::unique_ptr<ConfigState> build(modules::BudgetKind budget) {
+        auto result = build_config(modulesPath, userConfigPath, budget);
+        if (!result.files.empty()) {
+            watch(std::move(result.files));
+        }
+        for (const auto& notice : result.notices) {
+            sendNotification(notice.text, CHyprColor{1.0, 0.2, 0.2, 1.0}, notice.durationMs);
+        }
+        return std::move(result.state);
+    }
 
-        // Now log all monitors:
+    /**
+     * @brief Apply a built config and make it the active state
+     * @details The previous state is handed to the worker thread, so closing it
+     *          does not add to the time the compositor spends in the reload
+     * @note Compositor thread only
+     */
+    static void activate(std::unique_ptr<ConfigState> next) {
+        HYPRLUA_TRACE_SCOPE("config.apply");
         auto names = modules::list_monitors();
         log::info("Hyprland reports these monitors:");
         for (auto& n : names) {
-            log::info("  • " + n);
+            log::info("  • {}", n);
         }
 
-        // Optional: inject global table (like nvim)
-        lua["hypr"]             = lua.create_table();
-        lua["hypr"]["version"]  = "0.1.0";
-        lua["hypr"]["monitors"] = lua.create_table(); // prepare placeholder
-
-        // Load Lua wrappers (monitors.lua, keybinds.lua, general.lua)
-        try {
-            for (const auto& script : {"monitors.lua"}) {
-                std::string script_path = modules_path + "/" + script;
-                if (!fs::exists(script_path)) {
-                    sendNotification("Module not found: " + script_path, CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
-                    std::cerr << "[hyprlua] Warning: missing " << script << " at " << script_path << std::endl;
-                    continue;
-                }
-                lua.script_file(script_path);
+        modules::commit_notifications(next->changes);
+        modules::commit_watchdog(next->changes);
+        modules::commit_monitors(next->changes);
+        modules::commit_options(next->changes);
+        modules::commit_binds(next->changes, next->callbacks);
+        modules::commit_events(next->subscriptions);
+        modules::commit_rules(next->changes, next->predicates);
+        modules::commit_timers(next->timers);
+        modules::commit_store(next->changes);
+        next->changes.committed = true;
+        // From here on its collector runs in timed steps between and during callbacks
+        modules::pace_collector(next->lua.lua_state());
+
+        std::swap(active, next);
+        if (next) {
+            std::lock_guard<std::mutex> lock(workerMutex);
+            retired.push_back(std::move(next));
+            workerCv.notify_one();
+        }
+    }
+
+    /// @brief Compositor-thread side of a reload: take the newest built state, if any
+    static void apply_pending() {
+        std::unique_ptr<ConfigState> next;
+        {
+            std::lock_guard<std::mutex> lock(workerMutex);
+            next = std::move(pending);
+        }
+        if (!next || !active) {
+            return;
+        }
+
+        activate(std::move(next));
+        loaded = true;
+        if (startupNs != 0) {
+            startupSite.record(std::chrono::nanoseconds(std::chrono::steady_clock::now().time_since_epoch().count() - startupNs));
+            startupNs = 0;
+            log::info("Lua config loaded: {}", userConfigPath);
+        } else {
+            sendNotification("[Hyprlua] Config reloaded", CHyprColor{0.2, 0.6, 1.0, 1.0}, 3000);
+        }
+
+        if (const int64_t requested = reloadRequestedNs.exchange(0); requested != 0) {
+            reloadSite.record(std::chrono::nanoseconds(std::chrono::steady_clock::now().time_since_epoch().count() - requested));
+        }
+        if (auto path = trace::finishCapture(); !path.empty()) {
+            sendNotification("[Hyprlua] Reload trace written to " + path, CHyprColor{0.2, 0.6, 1.0, 1.0}, 5000);
+        }
+    }
+
+    /**
+     * @brief Reload worker: builds configs off the compositor thread
+     * @details The first build is the startup load, under the load budget.
+     *          A request that arrives while a build is running makes the worker
+     *          build again, so the state handed over always reflects the newest file.
+     *          States built but not yet applied are replaced rather than queued.
+     */
+    static void worker_loop() {
+        uint64_t                     builtGeneration = 0;
+        std::unique_lock<std::mutex> lock(workerMutex);
+
+        while (true) {
+            workerCv.wait(lock, [&] { return workerStopping || !retired.empty() || requestedGeneration != builtGeneration; });
+
+            // Close replaced states outside the lock
+            auto toClose = std::move(retired);
+            retired.clear();
+            if (!toClose.empty()) {
+                lock.unlock();
+                toClose.clear();
+                lock.lock();
             }
 
-            // Load user config.lua
-            if (!fs::exists(user_config_path)) {
-                sendNotification("Cant find: " + user_config_path, CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
-                std::cerr << "[hyprlua] Error: config not found in " << user_config_path << std::endl;
+            if (workerStopping) {
                 return;
             }
-
-            sol::protected_function_result result = lua.safe_script_file(user_config_path);
-            if (!result.valid()) {
-                sol::error err = result;
-                std::cerr << "[hyprlua] Error executing config.lua:\n" << err.what() << std::endl;
-                sendNotification("Error executing: " + user_config_path, CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+            if (requestedGeneration == builtGeneration) {
+                continue;
             }
 
-        } catch (const std::exception& e) {
-            std::cerr << "[hyprlua] Runtime initialization failed: " << e.what() << std::endl;
+            const uint64_t generation = requestedGeneration;
+            const bool     startup    = builtGeneration == 0;
+            lock.unlock();
+            log::info("{} Lua config: {}", startup ? "Loading" : "Reloading", userConfigPath);
+            trace::startCaptureIfRequested();
+            auto next = build(startup ? modules::BudgetKind::Load : modules::BudgetKind::Reload);
+            lock.lock();
 
-            std::ofstream log("/tmp/hyprlua.log", std::ios::app);
-            if (log.is_open()) {
-                log << "[hyprlua] Exception during runtime initialization: " << e.what() << "\n";
+            builtGeneration = generation;
+            if (requestedGeneration != generation) {
+                // The file changed again while building; this result is already stale
+                if (next) {
+                    retired.push_back(std::move(next));
+                }
+                continue;
+            }
+            if (!next) {
+                log::error("Config build failed, keeping the previous Lua state");
+                reloadRequestedNs = 0;
+                trace::finishCapture();
+                continue;
+            }
+
+            const bool wake = !pending;
+            pending         = std::move(next);
+            if (wake) {
+                lock.unlock();
+                eventloop::post(&apply_pending);
+                lock.lock();
             }
         }
+    }
+
+    void init_lua_runtime(const std::string& modules_path, const std::string& user_config_path) {
+        if (active) {
+            log::error("Lua runtime already initialized");
+            return;
+        }
+
+        HYPRLUA_TRACE_SCOPE("runtime.init");
+        log::info("Initializing Lua runtime");
+
+        startupNs      = std::chrono::steady_clock::now().time_since_epoch().count();
+        modulesPath    = modules_path;
+        userConfigPath = user_config_path;
+        modules::register_dispatcher();
+        modules::register_bind_hooks();
+        modules::register_monitor_hooks();
+        modules::register_option_hooks();
+        // Before the first config runs, so it reads what the last session stored
+        modules::load_store();
+
+        // An empty state until the worker has built the config, so get_lua_state() and the first load have something to replace
+        active = std::make_unique<ConfigState>();
+
+        // The config is loaded and run on the worker like a reload; only applying it waits for the compositor thread
+        {
+            std::lock_guard<std::mutex> lock(workerMutex);
+            workerStopping = false;
+            ++requestedGeneration;
+        }
+        worker = std::thread(&worker_loop);
+    }
+
+    void file_changed(const std::string& path) {
+        module_graph().invalidate(path);
+        request_reload();
+    }
+
+    bool config_loaded() {
+        return loaded;
+    }
+
+    ModuleGraph::Stats module_stats() {
+        return module_graph().stats();
+    }
+
+    void request_reload() {
+        // Keep the oldest pending request so coalesced reloads report their full latency
+        int64_t expected = 0;
+        reloadRequestedNs.compare_exchange_strong(expected, std::chrono::steady_clock::now().time_since_epoch().count());
+
+        std::lock_guard<std::mutex> lock(workerMutex);
+        ++requestedGeneration;
+        workerCv.notify_one();
+    }
+
+    void shutdown_lua_runtime() {
+        {
+            std::lock_guard<std::mutex> lock(workerMutex);
+            workerStopping = true;
+            workerCv.notify_one();
+        }
+        if (worker.joinable()) {
+            worker.join();
+        }
+
+        // Binds are Hyprlua's to clean up; a reloaded plugin would otherwise add them twice.
+        // This also drops the dispatcher's pointer into the active state's callbacks.
+        modules::remove_binds();
+        modules::remove_event_hooks();
+        modules::remove_monitor_hooks();
+        modules::remove_option_hooks();
+        modules::remove_rule_hooks();
+        modules::remove_timers();
+        modules::remove_store();
+        modules::remove_collector();
 
-        initialized = true;
+        pending.reset();
+        retired.clear();
+        active.reset();
+        loaded = false;
     }
 
 } // namespace hyprlua
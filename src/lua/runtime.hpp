@@ -1,12 +1,51 @@
 // runtime.hpp
 #pragma once
 
+#include <optional>
 #include <string>
 #include <sol/sol.hpp>
+#include "lua/allocator.hpp"
+#include "lua/changeset.hpp"
+#include "lua/module_graph.hpp"
 
 namespace hyprlua {
 
-void init_lua_runtime(const std::string& config_path, const std::string& user_config_path);
+/**
+ * @brief Start the Lua runtime and begin loading the user config
+ * @details Returns without running any Lua: the config is loaded, compiled and run on
+ *          the reload worker, and applied on the compositor thread once it is built.
+ *          Until then get_lua_state() is an empty state.
+ * @param modules_path Directory holding the runtime modules (binds.lua, monitors.lua, ...)
+ * @param user_config_path The user's hyprland.lua
+ */
+void init_lua_runtime(const std::string& modules_path, const std::string& user_config_path);
 sol::state& get_lua_state();
 
+/// @brief Allocation counters of the active state; compositor thread only
+std::optional<LuaAllocator::Stats> memory_stats();
+
+/**
+ * @brief Rebuild the config in a second Lua state and swap it in if it succeeds
+ * @details The config runs on a worker thread in record mode; only applying the
+ *          recorded changes and swapping the states happens on the compositor thread.
+ *          The active state is kept if the new config fails.
+ * @note Thread-safe; requests made before the rebuild finishes are coalesced into one
+ */
+void request_reload();
+
+/**
+ * @brief A file of the config changed: forget the results of the modules depending on it and reload
+ * @note Thread-safe; called from the file watcher
+ */
+void file_changed(const std::string& path);
+
+/// @brief Whether a user config has been applied since init_lua_runtime(); compositor thread only
+bool config_loaded();
+
+/// @brief Modules run and replayed by the last config run; thread-safe
+ModuleGraph::Stats module_stats();
+
+/// @brief Stop the reload worker, destroy the Lua states and remove the binds they added; called on plugin exit
+void shutdown_lua_runtime();
+
 } // namespace hyprlua
@@ -0,0 +1,316 @@
+// state_store.cpp
+#include "state_store.hpp"
+#include "hash.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hyprlua {
+
+    namespace fs = std::filesystem;
+
+    namespace {
+        /// @brief Fixed-size record in front of the entries of a snapshot
+        struct SnapshotHeader {
+            char     magic[8];
+            uint32_t version;
+            uint32_t count;       ///< Top-level keys
+            uint64_t payloadSize; ///< Bytes after the header
+            uint64_t payloadHash; ///< FNV-1a of those bytes
+        };
+
+        constexpr char SNAPSHOT_MAGIC[8] = {'H', 'L', 'U', 'A', 'S', 'T', 'O', 'R'};
+
+        /// @brief Type byte in front of every encoded value
+        enum class Tag : uint8_t {
+            False = 1,
+            True,
+            Integer, ///< int64_t
+            Number,  ///< double
+            String,  ///< uint32_t length, then the bytes
+            Table,   ///< uint32_t count, then count key/value pairs
+        };
+
+        template <typename T>
+        void put(std::string& out, T value) {
+            out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        void put_string(std::string& out, std::string_view value) {
+            put(out, static_cast<uint32_t>(value.size()));
+            out.append(value);
+        }
+
+        void encode(std::string& out, const StoreValue& value) {
+            if (const auto* b = std::get_if<bool>(&value)) {
+                put(out, *b ? Tag::True : Tag::False);
+            } else if (const auto* i = std::get_if<int64_t>(&value)) {
+                put(out, Tag::Integer);
+                put(out, *i);
+            } else if (const auto* d = std::get_if<double>(&value)) {
+                put(out, Tag::Number);
+                put(out, *d);
+            } else if (const auto* s = std::get_if<std::string>(&value)) {
+                put(out, Tag::String);
+                put_string(out, *s);
+            } else if (const auto* t = std::get_if<std::shared_ptr<const StoreTable>>(&value)) {
+                put(out, Tag::Table);
+                put(out, static_cast<uint32_t>((*t)->entries.size()));
+                for (const auto& [k, v] : (*t)->entries) {
+                    encode(out, k);
+                    encode(out, v);
+                }
+            }
+        }
+
+        /// @brief Bounds-checked cursor over a snapshot's payload
+        struct Reader {
+            std::string_view data;
+            size_t           pos = 0;
+
+            template <typename T>
+            bool get(T& out) {
+                if (data.size() - pos < sizeof(T)) {
+                    return false;
+                }
+                std::memcpy(&out, data.data() + pos, sizeof(T));
+                pos += sizeof(T);
+                return true;
+            }
+
+            bool get_string(std::string_view& out) {
+                uint32_t size = 0;
+                if (!get(size) || data.size() - pos < size) {
+                    return false;
+                }
+                out = data.substr(pos, size);
+                pos += size;
+                return true;
+            }
+        };
+
+        bool decode(Reader& in, StoreValue& out, size_t depth) {
+            Tag tag{};
+            if (!in.get(tag)) {
+                return false;
+            }
+            switch (tag) {
+                case Tag::False: out = false; return true;
+                case Tag::True: out = true; return true;
+                case Tag::Integer: {
+                    int64_t value = 0;
+                    if (!in.get(value)) {
+                        return false;
+                    }
+                    out = value;
+                    return true;
+                }
+                case Tag::Number: {
+                    double value = 0;
+                    if (!in.get(value)) {
+                        return false;
+                    }
+                    out = value;
+                    return true;
+                }
+                case Tag::String: {
+                    std::string_view value;
+                    if (!in.get_string(value)) {
+                        return false;
+                    }
+                    out = std::string(value);
+                    return true;
+                }
+                case Tag::Table: {
+                    uint32_t count = 0;
+                    // Every pair takes at least two bytes, which bounds the reserve for a damaged count
+                    if (depth >= StateStore::MAX_DEPTH || !in.get(count) || count > (in.data.size() - in.pos) / 2) {
+                        return false;
+                    }
+                    auto table = std::make_shared<StoreTable>();
+                    table->entries.resize(count);
+                    for (auto& [k, v] : table->entries) {
+                        if (!decode(in, k, depth + 1) || !decode(in, v, depth + 1)) {
+                            return false;
+                        }
+                    }
+                    out = std::shared_ptr<const StoreTable>(std::move(table));
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+
+    StoreValue StateStore::get(std::string_view key) const {
+        std::shared_lock lock(m_mutex);
+        const auto       it = m_values.find(key);
+        return it == m_values.end() ? StoreValue{} : it->second;
+    }
+
+    bool StateStore::set(std::string_view key, StoreValue value) {
+        std::unique_lock lock(m_mutex);
+        auto             it = m_values.find(key);
+        if (std::holds_alternative<std::monostate>(value)) {
+            if (it == m_values.end()) {
+                return false;
+            }
+            m_values.erase(it);
+        } else if (it == m_values.end()) {
+            m_values.emplace(std::string(key), std::move(value));
+        } else if (it->second == value) {
+            return false;
+        } else {
+            it->second = std::move(value);
+        }
+        ++m_generation;
+        return true;
+    }
+
+    std::vector<std::string> StateStore::keys() const {
+        std::vector<std::string> out;
+        {
+            std::shared_lock lock(m_mutex);
+            out.reserve(m_values.size());
+            for (const auto& [key, _] : m_values) {
+                out.push_back(key);
+            }
+        }
+        std::ranges::sort(out);
+        return out;
+    }
+
+    size_t StateStore::size() const {
+        std::shared_lock lock(m_mutex);
+        return m_values.size();
+    }
+
+    uint64_t StateStore::generation() const {
+        std::shared_lock lock(m_mutex);
+        return m_generation;
+    }
+
+    std::string StateStore::serialize_locked(uint64_t& generation) const {
+        std::string out(sizeof(SnapshotHeader), '\0');
+        for (const auto& [key, value] : m_values) {
+            put_string(out, key);
+            encode(out, value);
+        }
+
+        SnapshotHeader header;
+        std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version     = FORMAT_VERSION;
+        header.count       = static_cast<uint32_t>(m_values.size());
+        header.payloadSize = out.size() - sizeof(header);
+        header.payloadHash = hash::fnv1a(std::string_view(out).substr(sizeof(header)));
+        std::memcpy(out.data(), &header, sizeof(header));
+        generation = m_generation;
+        return out;
+    }
+
+    std::string StateStore::serialize() const {
+        std::shared_lock lock(m_mutex);
+        uint64_t         generation = 0;
+        return serialize_locked(generation);
+    }
+
+    StateStore::LoadResult StateStore::deserialize(std::string_view data) {
+        SnapshotHeader header;
+        if (data.size() < sizeof(header)) {
+            return LoadResult::Corrupt;
+        }
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) {
+            return LoadResult::Corrupt;
+        }
+        if (header.version != FORMAT_VERSION) {
+            return LoadResult::Outdated;
+        }
+        const auto payload = data.substr(sizeof(header));
+        if (header.payloadSize != payload.size() || header.payloadHash != hash::fnv1a(payload)) {
+            return LoadResult::Corrupt;
+        }
+
+        // Decoded aside, so a bad entry leaves the store untouched
+        decltype(m_values) values;
+        values.reserve(header.count);
+        Reader in{payload};
+        for (uint32_t i = 0; i < header.count; ++i) {
+            std::string_view key;
+            StoreValue       value;
+            if (!in.get_string(key) || !decode(in, value, 0)) {
+                return LoadResult::Corrupt;
+            }
+            values.insert_or_assign(std::string(key), std::move(value));
+        }
+        if (in.pos != payload.size()) {
+            return LoadResult::Corrupt;
+        }
+
+        std::unique_lock lock(m_mutex);
+        m_values = std::move(values);
+        ++m_generation;
+        return LoadResult::Loaded;
+    }
+
+    std::optional<uint64_t> StateStore::save(const std::string& path) const {
+        uint64_t          generation = 0;
+        std::string       data;
+        {
+            std::shared_lock lock(m_mutex);
+            data = serialize_locked(generation);
+        }
+
+        std::error_code ec;
+        fs::create_directories(fs::path(path).parent_path(), ec);
+
+        // Write to a private name and rename, so a crash mid-write leaves the previous snapshot intact
+        const std::string tmp = path + ".tmp." + std::to_string(getpid());
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            out.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!out.flush()) {
+                fs::remove(tmp, ec);
+                return std::nullopt;
+            }
+        }
+        fs::rename(tmp, path, ec);
+        if (ec) {
+            fs::remove(tmp, ec);
+            return std::nullopt;
+        }
+        return generation;
+    }
+
+    StateStore::LoadResult StateStore::load(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return errno == ENOENT ? LoadResult::Missing : LoadResult::Corrupt;
+        }
+
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            close(fd);
+            return LoadResult::Corrupt;
+        }
+        const auto  size = static_cast<size_t>(st.st_size);
+        void* const map  = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) {
+            return LoadResult::Corrupt;
+        }
+
+        const auto result = deserialize({static_cast<const char*>(map), size});
+        munmap(map, size);
+        return result;
+    }
+
+} // namespace hyprlua
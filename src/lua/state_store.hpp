@@ -0,0 +1,106 @@
+// state_store.hpp
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/**
+ * @file state_store.hpp
+ * @brief Key/value state owned by C++, behind hypr.store
+ * @details Values live outside any Lua state, so they survive reloads and the
+ *          swap of one config state for the next. Scalars and strings are held
+ *          directly in one flat map; a table is copied out of Lua once, when it is
+ *          written, and frozen, so every later read shares that copy. The store can
+ *          be written to a snapshot file and mapped back in, which carries it over
+ *          a compositor restart. Snapshots use the host's byte order and are only
+ *          read back by a build with the same FORMAT_VERSION.
+ */
+
+namespace hyprlua {
+
+    struct StoreTable;
+
+    /// @brief nil, boolean, integer, number, string or table; nil is never stored
+    using StoreValue = std::variant<std::monostate, bool, int64_t, double, std::string, std::shared_ptr<const StoreTable>>;
+
+    /// @brief A table as it was written, keys and values in Lua's traversal order
+    struct StoreTable {
+        std::vector<std::pair<StoreValue, StoreValue>> entries;
+    };
+
+    /**
+     * @class StateStore
+     * @note Thread-safe: configs write it on the reload worker, callbacks on the compositor thread
+     */
+    class StateStore {
+      public:
+        /// @brief Bumped whenever the snapshot layout changes; older snapshots are ignored
+        static constexpr uint32_t FORMAT_VERSION = 1;
+        /// @brief Deepest table nesting stored or read back
+        static constexpr size_t   MAX_DEPTH = 32;
+
+        enum class LoadResult {
+            Loaded,
+            Missing,  ///< No snapshot at the path
+            Outdated, ///< Written with another FORMAT_VERSION
+            Corrupt,  ///< Truncated, damaged, unreadable, or not a snapshot
+        };
+
+        /// @brief The value under @p key, or std::monostate if there is none
+        StoreValue               get(std::string_view key) const;
+
+        /**
+         * @brief Store @p value under @p key; std::monostate removes the key
+         * @return Whether the store changed; writing the value a key already holds does not
+         */
+        bool                     set(std::string_view key, StoreValue value);
+
+        /// @brief Every key, sorted
+        std::vector<std::string> keys() const;
+
+        size_t                   size() const;
+
+        /// @brief Counts changes, so a snapshot can tell whether it is still current
+        uint64_t                 generation() const;
+
+        /// @brief The snapshot file contents: a versioned header and the entries
+        std::string              serialize() const;
+
+        /// @brief Replace the contents with those of a snapshot; on failure the store is left as it was
+        LoadResult               deserialize(std::string_view data);
+
+        /**
+         * @brief Write a snapshot to @p path, through a temporary file renamed into place
+         * @return The generation the snapshot holds, or std::nullopt if it could not be written
+         */
+        std::optional<uint64_t>  save(const std::string& path) const;
+
+        /// @brief Read the snapshot at @p path through a read-only mapping, see deserialize()
+        LoadResult               load(const std::string& path);
+
+      private:
+        /// @brief Lets keys be looked up with a string_view
+        struct KeyHash {
+            using is_transparent = void;
+
+            size_t operator()(std::string_view key) const {
+                return std::hash<std::string_view>{}(key);
+            }
+        };
+
+        std::string                                                           serialize_locked(uint64_t& generation) const;
+
+        mutable std::shared_mutex                                             m_mutex;
+        std::unordered_map<std::string, StoreValue, KeyHash, std::equal_to<>> m_values;
+        uint64_t                                                              m_generation = 0;
+    };
+
+} // namespace hyprlua
@@ -0,0 +1,32 @@
+#include "stats.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+
+namespace hyprlua::modules {
+
+    void bind_stats(sol::state& lua, const LuaAllocator& allocator) {
+        log::info("Binding stats Lua functions");
+
+        // Read only, so it is safe from whichever thread runs the config
+        lua.set_function("__hypr_stats", [](sol::this_state ts) {
+            sol::state_view lua(ts);
+            sol::table      result = lua.create_table();
+            for (const auto& s : trace::summaries()) {
+                result[s.name] = lua.create_table_with("count", s.count, "last_us", s.lastUs, "p50_us", s.p50Us, "p99_us", s.p99Us, "max_us", s.maxUs,
+                                                       "total_us", s.totalUs);
+            }
+            return result;
+        });
+
+        // The allocator belongs to the state this function is bound in, so it lives as long as the function
+        lua.set_function("__hypr_memory_stats", [&allocator](sol::this_state ts) {
+            sol::state_view lua(ts);
+            const auto&     s = allocator.stats();
+            return lua.create_table_with("allocations", s.allocations, "frees", s.frees, "bytes", s.bytes, "peak_bytes", s.peakBytes, "pool_bytes", s.poolBytes, "large_bytes",
+                                         s.largeBytes, "limit", s.limit, "limit_hits", s.limitHits);
+        });
+
+        log::debug("Stats module successfully bound.");
+    }
+
+} // namespace hyprlua::modules
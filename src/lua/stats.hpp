@@ -0,0 +1,12 @@
+// stats.hpp
+#pragma once
+
+#include <sol/sol.hpp>
+#include "lua/allocator.hpp"
+
+namespace hyprlua::modules {
+
+    /// @brief Register __hypr_stats and __hypr_memory_stats, the backing functions of hypr.stats() and hypr.memory()
+    void bind_stats(sol::state& lua, const LuaAllocator& allocator);
+
+} // namespace hyprlua::modules
@@ -0,0 +1,226 @@
+// store.cpp
+#include "store.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <utility>
+#include <variant>
+
+namespace hyprlua::modules {
+
+    namespace {
+        /// @brief Error text of a failed write; a fixed buffer, since Lua may unwind past it
+        using ErrorBuffer = std::array<char, 128>;
+
+        /**
+         * @brief Copy the Lua value at @p index into @p out
+         * @details Reads the state without allocating in it, so no Lua error can
+         *          unwind past the C++ objects built here. Metatables are ignored.
+         */
+        bool to_store(lua_State* L, int index, size_t depth, StoreValue& out, ErrorBuffer& err) {
+            switch (lua_type(L, index)) {
+                case LUA_TNONE:
+                case LUA_TNIL: out = std::monostate{}; return true;
+                case LUA_TBOOLEAN: out = lua_toboolean(L, index) != 0; return true;
+                case LUA_TNUMBER:
+                    if (lua_isinteger(L, index)) {
+                        out = static_cast<int64_t>(lua_tointeger(L, index));
+                    } else {
+                        out = static_cast<double>(lua_tonumber(L, index));
+                    }
+                    return true;
+                case LUA_TSTRING: {
+                    size_t      size = 0;
+                    const char* data = lua_tolstring(L, index, &size);
+                    out              = std::string(data, size);
+                    return true;
+                }
+                case LUA_TTABLE: {
+                    if (depth >= StateStore::MAX_DEPTH || !lua_checkstack(L, 3)) {
+                        std::snprintf(err.data(), err.size(), "tables nest deeper than %zu levels; does one contain itself?", StateStore::MAX_DEPTH);
+                        return false;
+                    }
+                    index      = lua_absindex(L, index);
+                    auto table = std::make_shared<StoreTable>();
+                    lua_pushnil(L);
+                    while (lua_next(L, index) != 0) {
+                        StoreValue key;
+                        StoreValue value;
+                        if (!to_store(L, -2, depth + 1, key, err) || !to_store(L, -1, depth + 1, value, err)) {
+                            lua_pop(L, 2);
+                            return false;
+                        }
+                        table->entries.emplace_back(std::move(key), std::move(value));
+                        lua_pop(L, 1);
+                    }
+                    out = std::shared_ptr<const StoreTable>(std::move(table));
+                    return true;
+                }
+                default: std::snprintf(err.data(), err.size(), "cannot store a %s", lua_typename(L, lua_type(L, index))); return false;
+            }
+        }
+
+        /// @brief Push @p value; tables are built fresh, so the caller may change them freely
+        void push(lua_State* L, const StoreValue& value) {
+            if (const auto* b = std::get_if<bool>(&value)) {
+                lua_pushboolean(L, *b);
+            } else if (const auto* i = std::get_if<int64_t>(&value)) {
+                lua_pushinteger(L, static_cast<lua_Integer>(*i));
+            } else if (const auto* d = std::get_if<double>(&value)) {
+                lua_pushnumber(L, static_cast<lua_Number>(*d));
+            } else if (const auto* s = std::get_if<std::string>(&value)) {
+                lua_pushlstring(L, s->data(), s->size());
+            } else if (const auto* t = std::get_if<std::shared_ptr<const StoreTable>>(&value)) {
+                int sequence = 0;
+                for (const auto& [k, _] : (*t)->entries) {
+                    sequence += std::holds_alternative<int64_t>(k);
+                }
+                luaL_checkstack(L, 3, "hypr.store value");
+                lua_createtable(L, sequence, static_cast<int>((*t)->entries.size()) - sequence);
+                for (const auto& [k, v] : (*t)->entries) {
+                    push(L, k);
+                    push(L, v);
+                    lua_rawset(L, -3);
+                }
+            } else {
+                lua_pushnil(L);
+            }
+        }
+
+        /// @brief Push the StoreValue whose address is at index 1; run protected by store_get()
+        int push_protected(lua_State* L) {
+            push(L, *static_cast<const StoreValue*>(lua_touserdata(L, 1)));
+            return 1;
+        }
+
+        /// @brief The ChangeSet of the state a store function was registered in, its upvalue
+        ChangeSet& changes_of(lua_State* L) {
+            return *static_cast<ChangeSet*>(lua_touserdata(L, lua_upvalueindex(1)));
+        }
+
+        /// @brief The last write to @p key the loading config recorded, if there is one
+        const StoreValue* pending(const ChangeSet& changes, std::string_view key) {
+            for (auto it = changes.storeWrites.rbegin(); it != changes.storeWrites.rend(); ++it) {
+                if (it->key == key) {
+                    return &it->value;
+                }
+            }
+            return nullptr;
+        }
+
+        /// @brief __hypr_store_get(key): the stored value, or nil; a loading config sees its own writes
+        int store_get(lua_State* L) {
+            size_t      size    = 0;
+            const char* key     = luaL_checklstring(L, 1, &size);
+            auto&       changes = changes_of(L);
+            shared_store().reads.fetch_add(1, std::memory_order_relaxed);
+            if (!changes.committed) {
+                ++changes.storeReads;
+                if (const auto* value = pending(changes, {key, size})) {
+                    push(L, *value);
+                    return 1;
+                }
+            }
+            int status = LUA_OK;
+            {
+                // Holds the frozen table while it is copied into Lua, even if another thread replaces it.
+                // The copy allocates, so it runs protected: an error must not unwind past this reference.
+                StoreValue value = shared_store().store.get({key, size});
+                lua_pushcfunction(L, &push_protected);
+                lua_pushlightuserdata(L, &value);
+                status = lua_pcall(L, 1, 1, 0);
+            }
+            if (status != LUA_OK) {
+                return lua_error(L);
+            }
+            return 1;
+        }
+
+        /// @brief __hypr_store_set(key, value): true, or false and the error for the Lua side to raise
+        int store_set(lua_State* L) {
+            size_t      size = 0;
+            const char* key  = luaL_checklstring(L, 1, &size);
+            ErrorBuffer err{};
+            bool        ok = false;
+            {
+                HYPRLUA_TRACE_SCOPE("lua.__hypr_store_set");
+                auto&      changes = changes_of(L);
+                StoreValue value;
+                ok = to_store(L, 2, 0, value, err);
+                if (ok && !changes.committed) {
+                    // Applied with the rest of the config, so a run that fails or is superseded leaves the store alone
+                    changes.storeWrites.push_back({std::string(key, size), std::move(value)});
+                } else if (auto& shared = shared_store(); ok && shared.store.set({key, size}, std::move(value))) {
+                    shared.writes.fetch_add(1, std::memory_order_relaxed);
+                    // Only an active config gets here, on the compositor thread
+                    if (shared.changed) {
+                        shared.changed();
+                    }
+                }
+            }
+            lua_pushboolean(L, ok);
+            if (ok) {
+                return 1;
+            }
+            lua_pushstring(L, err.data());
+            return 2;
+        }
+    }
+
+    SharedStore& shared_store() {
+        static SharedStore shared;
+        return shared;
+    }
+
+    void bind_store(sol::state& lua, ChangeSet& changes) {
+        log::info("Binding store Lua functions");
+
+        // Plain C functions: values are converted straight between the stack and the store
+        lua_State* L = lua.lua_state();
+        for (const auto& [name, fn] : {std::pair{"__hypr_store_get", &store_get}, std::pair{"__hypr_store_set", &store_set}}) {
+            lua_pushlightuserdata(L, &changes);
+            lua_pushcclosure(L, fn, 1);
+            lua_setglobal(L, name);
+        }
+
+        lua.set_function("__hypr_store_keys", [&changes] {
+            auto keys = shared_store().store.keys();
+            if (changes.committed) {
+                return sol::as_table(std::move(keys));
+            }
+            ++changes.storeReads;
+            for (const auto& write : changes.storeWrites) {
+                const bool removed = std::holds_alternative<std::monostate>(write.value);
+                const auto it      = std::ranges::lower_bound(keys, write.key);
+                if (it != keys.end() && *it == write.key) {
+                    if (removed) {
+                        keys.erase(it);
+                    }
+                } else if (!removed) {
+                    keys.insert(it, write.key);
+                }
+            }
+            return sol::as_table(std::move(keys));
+        });
+
+        // Returns nothing, or the error for the Lua side to raise
+        lua.set_function("__hypr_configure_store", [&changes](sol::table options) -> sol::optional<std::string> {
+            HYPRLUA_TRACE_SCOPE("lua.__hypr_configure_store");
+            if (changes.committed) {
+                return std::string("hypr.store.configure can only be called while the config loads");
+            }
+            StoreSettings settings = changes.store.value_or(StoreSettings{});
+            settings.persist       = options.get_or("persist", settings.persist);
+            settings.flushMs       = options.get_or("flush_ms", settings.flushMs);
+            changes.store          = settings;
+            return sol::nullopt;
+        });
+
+        log::debug("Store module successfully bound.");
+    }
+
+} // namespace hyprlua::modules
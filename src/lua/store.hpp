@@ -0,0 +1,66 @@
+// store.hpp
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <sol/sol.hpp>
+#include "lua/changeset.hpp"
+#include "lua/state_store.hpp"
+
+/**
+ * @file store.hpp
+ * @brief hypr.store, the Lua side of the StateStore
+ * @details One store serves every config state, so what a config wrote is still
+ *          there after a reload. Writes made while a config loads are recorded in
+ *          its ChangeSet and reach the store only when the config is applied, so a
+ *          run that fails or is superseded by a newer reload changes nothing; the
+ *          config's own reads see them meanwhile. With persistence on, changes are
+ *          written to the snapshot at most once per flush interval, on the
+ *          compositor thread, and once more when the plugin unloads.
+ */
+
+namespace hyprlua::modules {
+
+    /// @brief hypr.store since plugin load
+    struct StoreStats {
+        uint64_t keys        = 0;
+        uint64_t reads       = 0;
+        uint64_t writes      = 0; ///< Writes that changed the store
+        uint64_t saves       = 0; ///< Snapshots written
+        uint64_t failedSaves = 0;
+        bool     persist     = false;
+    };
+
+    /// @brief The store every config state shares, and what its Lua side counted
+    struct SharedStore {
+        StateStore            store;
+        std::atomic<uint64_t> reads  = 0;
+        std::atomic<uint64_t> writes = 0;
+        std::function<void()> changed; ///< Called after an active config wrote; set by commit_store
+    };
+
+    /// @brief Register the __hypr_store_* functions; hypr.store.configure is recorded into @p changes
+    void         bind_store(sol::state& lua, ChangeSet& changes);
+
+    SharedStore& shared_store();
+
+    // Loading, applying and saving is store_commit.cpp; hyprlua-compile does not link it
+
+    /// @brief Restore the snapshot left by an earlier session, if there is one; called once at startup
+    void         load_store();
+
+    /**
+     * @brief Apply the config's store writes and settings
+     * @details Turning persistence off removes the snapshot, so the next start does not
+     *          restore state the config no longer asks to keep.
+     * @note Compositor thread only
+     */
+    void         commit_store(const ChangeSet& changes);
+
+    /// @brief Write a pending snapshot and stop the flush timer; called when the runtime shuts down
+    void         remove_store();
+
+    StoreStats   store_stats();
+
+} // namespace hyprlua::modules
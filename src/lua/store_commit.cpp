@@ -0,0 +1,139 @@
+// store_commit.cpp
+#include "store.hpp"
+#include "eventloop.hpp"
+#include "logger.hpp"
+#include "paths.hpp"
+#include "trace.hpp"
+#include "utils.hpp"
+
+#include <hyprland/src/helpers/Color.hpp>
+#include <atomic>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <optional>
+
+namespace hyprlua::modules {
+
+    namespace {
+        SharedStore&                      shared = shared_store();
+
+        std::atomic<uint64_t>             saves       = 0;
+        std::atomic<uint64_t>             failedSaves = 0;
+
+        // Set on the compositor thread; read by writes on either thread
+        std::atomic<bool>                 persist     = false;
+        std::atomic<uint32_t>             flushMs     = StoreSettings{}.flushMs;
+        std::atomic<bool>                 flushQueued = false;
+
+        // Compositor thread only
+        std::unique_ptr<eventloop::Timer> flushTimer;
+        std::optional<uint64_t>           savedGeneration; ///< Generation the snapshot on disk holds, if there is one
+        bool                              lastSaveFailed = false;
+
+        /// @brief Write the snapshot if the store changed since the last one
+        void                              flush() {
+            if (!persist.load(std::memory_order_relaxed) || shared.store.generation() == savedGeneration) {
+                return;
+            }
+            HYPRLUA_TRACE_SCOPE("store.flush");
+            const auto path  = paths::store_file();
+            const auto saved = shared.store.save(path);
+            if (saved) {
+                savedGeneration = *saved;
+                lastSaveFailed  = false;
+                saves.fetch_add(1, std::memory_order_relaxed);
+                log::debug("Lua store: {} keys written to {}", shared.store.size(), path);
+                return;
+            }
+
+            failedSaves.fetch_add(1, std::memory_order_relaxed);
+            log::error("Lua store: cannot write {}", path);
+            // Once per run of failures; every flush after the first would repeat it
+            if (!lastSaveFailed) {
+                sendNotification(std::format("[Hyprlua] Cannot write the hypr.store snapshot to {}", path), CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+            }
+            lastSaveFailed = true;
+        }
+
+        /// @brief Have the compositor thread flush within flushMs; any number of writes until then share one flush
+        void schedule_flush() {
+            if (!persist.load(std::memory_order_relaxed) || flushQueued.exchange(true)) {
+                return;
+            }
+            const bool posted = eventloop::post([] {
+                if (!flushTimer) {
+                    flushTimer = std::make_unique<eventloop::Timer>([] {
+                        flushQueued.store(false);
+                        flush();
+                    });
+                }
+                flushTimer->arm(static_cast<int>(flushMs.load(std::memory_order_relaxed)));
+            });
+            if (!posted) {
+                flushQueued.store(false);
+            }
+        }
+
+    }
+
+    void load_store() {
+        HYPRLUA_TRACE_SCOPE("store.load");
+        const auto path = paths::store_file();
+        switch (shared.store.load(path)) {
+            case StateStore::LoadResult::Loaded:
+                savedGeneration = shared.store.generation();
+                log::info("Lua store: {} keys restored from {}", shared.store.size(), path);
+                break;
+            case StateStore::LoadResult::Missing: break;
+            case StateStore::LoadResult::Outdated: log::info("Lua store: {} was written in another format and is not restored", path); break;
+            case StateStore::LoadResult::Corrupt:
+                log::error("Lua store: {} is damaged and was not restored", path);
+                sendNotification(std::format("[Hyprlua] The hypr.store snapshot {} is damaged and was not restored", path), CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+                break;
+        }
+    }
+
+    void commit_store(const ChangeSet& changes) {
+        for (const auto& write : changes.storeWrites) {
+            if (shared.store.set(write.key, write.value)) {
+                shared.writes.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        shared.changed      = schedule_flush;
+        const auto settings = changes.store.value_or(StoreSettings{});
+        flushMs.store(settings.flushMs, std::memory_order_relaxed);
+        persist.store(settings.persist, std::memory_order_relaxed);
+        if (settings.persist) {
+            // Covers what the config wrote, and anything written before persistence was on
+            schedule_flush();
+            return;
+        }
+
+        std::error_code ec;
+        if (const auto path = paths::store_file(); std::filesystem::remove(path, ec)) {
+            savedGeneration.reset();
+            log::info("Lua store: persistence is off, removed {}", path);
+        }
+    }
+
+    void remove_store() {
+        shared.changed = nullptr;
+        flushTimer.reset();
+        flushQueued.store(false);
+        flush();
+    }
+
+    StoreStats store_stats() {
+        return {
+            .keys        = shared.store.size(),
+            .reads       = shared.reads.load(std::memory_order_relaxed),
+            .writes      = shared.writes.load(std::memory_order_relaxed),
+            .saves       = saves.load(std::memory_order_relaxed),
+            .failedSaves = failedSaves.load(std::memory_order_relaxed),
+            .persist     = persist.load(std::memory_order_relaxed),
+        };
+    }
+
+} // namespace hyprlua::modules
@@ -0,0 +1,51 @@
+// timers.cpp
+#include "timers.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+#include "lua/callback.hpp"
+
+#include <format>
+
+namespace hyprlua::modules {
+
+    TimerCounters& timer_counters() {
+        static TimerCounters counters;
+        return counters;
+    }
+
+    void bind_timers(sol::state& lua, LuaTimers& timers) {
+        log::info("Binding timer Lua functions");
+
+        // Returns the timer's id, or nil and the error for the Lua side to raise
+        lua.set_function("__hypr_timer", [&timers](int delayMs, const sol::main_protected_function& fn, int repeatMs) -> std::tuple<sol::optional<uint64_t>, sol::optional<std::string>> {
+            HYPRLUA_TRACE_SCOPE("lua.__hypr_timer");
+            if (delayMs < 0 || repeatMs < 0) {
+                return {sol::nullopt, std::string("delays must be >= 0 ms")};
+            }
+            const uint64_t id    = timers.nextId++;
+            auto&          timer = timers.entries[id];
+            timer                = {.fn = fn, .delayMs = delayMs, .repeatMs = repeatMs, .source = source_of(fn)};
+            if (timers.committed) {
+                timers.start(timer, id);
+            }
+            return {id, sol::nullopt};
+        });
+
+        // Stopping from inside the timer's own callback keeps a repeating timer from running again
+        lua.set_function("__hypr_timer_stop", [&timers](uint64_t id) {
+            auto it = timers.entries.find(id);
+            if (it == timers.entries.end()) {
+                return false;
+            }
+            if (timers.committed) {
+                timers.cancel(it->second);
+            }
+            timers.entries.erase(it);
+            timer_counters().cancelled.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        });
+
+        log::debug("Timer module successfully bound.");
+    }
+
+} // namespace hyprlua::modules
@@ -0,0 +1,75 @@
+// timers.hpp
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <sol/sol.hpp>
+#include <string>
+#include <unordered_map>
+#include "eventloop.hpp"
+
+namespace hyprlua::modules {
+
+    /// @brief Lua timers since plugin load
+    struct TimerStats {
+        uint64_t scheduled = 0; ///< Runs put on the queue, each repeat counted
+        uint64_t fired     = 0; ///< Callbacks called
+        uint64_t failed    = 0; ///< Callbacks that raised an error
+        uint64_t cancelled = 0; ///< Timers stopped from Lua before they ran
+        uint64_t pending   = 0; ///< Timers waiting on the queue now
+    };
+
+    /// @brief The counters behind TimerStats; scheduled also by configs loading on the reload worker
+    struct TimerCounters {
+        std::atomic<uint64_t> scheduled = 0;
+        std::atomic<uint64_t> fired     = 0;
+        std::atomic<uint64_t> failed    = 0;
+        std::atomic<uint64_t> cancelled = 0;
+    };
+
+    /// @brief One hypr.timer call
+    struct LuaTimer {
+        sol::main_protected_function fn;
+        int                          delayMs  = 0;
+        int                          repeatMs = 0; ///< 0 for a one-shot timer
+        std::string                  source;       ///< Where the function was defined, e.g. "hyprland.lua:12"
+        eventloop::TimerQueue::Id    queued = 0;   ///< Its run on the queue, once the config is active
+    };
+
+    /**
+     * @brief Timers created by one config state, by the id hypr.timer returned
+     * @details Timers created while the config loads wait here until it becomes the
+     *          active config; they are never started for a config that fails.
+     * @note Holds references into the config's Lua state; destroy it before the state
+     */
+    struct LuaTimers {
+        std::unordered_map<uint64_t, LuaTimer>   entries;
+        uint64_t                                 nextId    = 1;
+        bool                                     committed = false; ///< Set once active; new timers start right away
+        std::function<void(LuaTimer&, uint64_t)> start;             ///< Puts a timer on the queue; set with committed
+        std::function<void(const LuaTimer&)>     cancel;            ///< Takes a started timer off the queue; set with committed
+    };
+
+    /// @brief Register __hypr_timer and __hypr_timer_stop; timers are recorded into @p timers
+    void           bind_timers(sol::state& lua, LuaTimers& timers);
+
+    TimerCounters& timer_counters();
+
+    // Running them on the compositor's event loop is timers_commit.cpp
+
+    /**
+     * @brief Start the timers of the config becoming active
+     * @details Every timer of the previous config is cancelled first, so nothing of
+     *          a replaced state runs again; coroutines it left sleeping are never resumed.
+     * @note Compositor thread only
+     */
+    void           commit_timers(LuaTimers& timers);
+
+    /// @brief Cancel every timer; called when the runtime shuts down
+    void           remove_timers();
+
+    /// @brief Compositor thread only
+    TimerStats     timer_stats();
+
+} // namespace hyprlua::modules
@@ -0,0 +1,108 @@
+// timers_commit.cpp
+#include "timers.hpp"
+#include "globals.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+#include "utils.hpp"
+#include "lua/watchdog.hpp"
+
+#include <hyprland/src/helpers/Color.hpp>
+#include <algorithm>
+#include <format>
+#include <memory>
+#include <vector>
+
+namespace hyprlua::modules {
+
+    namespace {
+        // Compositor thread only
+        std::unique_ptr<eventloop::TimerQueue> queue;
+        LuaTimers*                             activeTimers = nullptr;
+
+        void run(uint64_t id);
+
+        /// @brief Put timer @p id of the active config on the queue
+        void start(LuaTimer& timer, uint64_t id) {
+            if (!queue) {
+                queue = std::make_unique<eventloop::TimerQueue>();
+            }
+            timer.queued = queue->schedule(timer.delayMs, [id] { run(id); });
+            timer_counters().scheduled.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void run(uint64_t id) {
+            if (!activeTimers) {
+                return;
+            }
+            auto it = activeTimers->entries.find(id);
+            if (it == activeTimers->entries.end()) {
+                return;
+            }
+            HYPRLUA_TRACE_SCOPE("timers.run");
+
+            // Settle the timer before calling into Lua, which may stop it or start others
+            sol::main_protected_function fn     = it->second.fn;
+            const std::string            source = it->second.source;
+            if (it->second.repeatMs > 0) {
+                it->second.delayMs = it->second.repeatMs;
+                start(it->second, id);
+            } else {
+                activeTimers->entries.erase(it);
+            }
+
+            timer_counters().fired.fetch_add(1, std::memory_order_relaxed);
+            Budget                         budget(fn.lua_state(), BudgetKind::Callback);
+            sol::protected_function_result result = fn();
+            if (!result.valid()) {
+                sol::error err = result;
+                timer_counters().failed.fetch_add(1, std::memory_order_relaxed);
+                log::error("Timer at {} failed: {}", source, err.what());
+                sendNotification(std::format("[Hyprlua] Timer at {} failed: {}", source, err.what()), CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+            }
+        }
+    }
+
+    void commit_timers(LuaTimers& timers) {
+        HYPRLUA_TRACE_SCOPE("timers.commit");
+        if (queue) {
+            queue->clear();
+        }
+        activeTimers     = &timers;
+        timers.start     = start;
+        timers.cancel    = [](const LuaTimer& timer) {
+            if (queue) {
+                queue->cancel(timer.queued);
+            }
+        };
+        timers.committed = true;
+
+        // In creation order, so timers with the same delay run in the order the config made them
+        std::vector<uint64_t> ids;
+        ids.reserve(timers.entries.size());
+        for (const auto& [id, _] : timers.entries) {
+            ids.push_back(id);
+        }
+        std::ranges::sort(ids);
+        for (const auto id : ids) {
+            start(timers.entries.at(id), id);
+        }
+        log::debug("Lua timers: {} started", ids.size());
+    }
+
+    void remove_timers() {
+        queue.reset();
+        activeTimers = nullptr;
+    }
+
+    TimerStats timer_stats() {
+        const auto& counters = timer_counters();
+        return {
+            .scheduled = counters.scheduled.load(std::memory_order_relaxed),
+            .fired     = counters.fired.load(std::memory_order_relaxed),
+            .failed    = counters.failed.load(std::memory_order_relaxed),
+            .cancelled = counters.cancelled.load(std::memory_order_relaxed),
+            .pending   = queue ? queue->size() : 0,
+        };
+    }
+
+} // namespace hyprlua::modules
@@ -0,0 +1,157 @@
+#include "watchdog.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+#include "lua/collector.hpp"
+#include "lua/profiler.hpp"
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+namespace hyprlua::modules {
+
+    namespace {
+        /// @brief VM instructions between clock reads; a clock read costs about as much as 20 instructions
+        constexpr int         CHECK_INTERVAL = 10000;
+
+        /// @brief Budget of the first config run when HYPRLUA_LOAD_MS does not set one
+        constexpr uint32_t    DEFAULT_LOAD_MS = 1000;
+
+        // Settable from the compositor thread, read by whichever thread runs Lua
+        std::atomic<uint32_t> reloadMs   = WatchdogSettings{}.reloadMs;
+        std::atomic<uint32_t> callbackMs = WatchdogSettings{}.callbackMs;
+        std::atomic<uint64_t> aborts     = 0;
+
+        // The innermost Budget on this thread; 0 means unlimited
+        thread_local int64_t  deadlineNs = 0;
+        thread_local uint32_t budgetMs   = 0;
+        thread_local bool     expiredNow = false;
+
+        int64_t               now_ns() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        void hook(lua_State* L, lua_Debug*) {
+            if (!expiredNow) {
+                // Long callbacks collect as they go, as Lua's own collector would have
+                collect_step(L);
+                // The profiler shares this hook, at a shorter interval while it samples
+                const bool sampling = profiling();
+                if (sampling) {
+                    profile_sample(L);
+                }
+                if (const int interval = sampling ? PROFILE_INTERVAL : CHECK_INTERVAL; lua_gethookcount(L) != interval) {
+                    lua_sethook(L, &hook, LUA_MASKCOUNT, interval);
+                }
+            }
+            if (deadlineNs == 0 || now_ns() < deadlineNs) {
+                return;
+            }
+            if (!expiredNow) {
+                expiredNow = true;
+                aborts.fetch_add(1, std::memory_order_relaxed);
+                lua_sethook(L, &hook, LUA_MASKCOUNT, 1);
+            }
+            // lua_error does not return, so nothing here may need a destructor
+            char message[96];
+            std::snprintf(message, sizeof(message), "script exceeded its %u ms budget and was aborted", budgetMs);
+            luaL_traceback(L, L, message, 1);
+            lua_error(L);
+        }
+
+        /// @brief HYPRLUA_LOAD_MS, read when the first config runs; no config has been applied yet to set it
+        uint32_t load_ms() {
+            static const uint32_t ms = [] {
+                uint32_t value = DEFAULT_LOAD_MS;
+                if (const char* env = std::getenv("HYPRLUA_LOAD_MS"); env && env[0]) {
+                    const std::string_view text(env);
+                    uint32_t               parsed = 0;
+                    const auto [end, ec]          = std::from_chars(text.data(), text.data() + text.size(), parsed);
+                    if (ec == std::errc{} && end == text.data() + text.size()) {
+                        value = parsed;
+                    } else {
+                        log::error("Ignoring HYPRLUA_LOAD_MS={}: expected a whole number of milliseconds", text);
+                    }
+                }
+                return value;
+            }();
+            return ms;
+        }
+
+        uint32_t budget_ms(BudgetKind kind) {
+            switch (kind) {
+                case BudgetKind::Load: return load_ms();
+                case BudgetKind::Reload: return reloadMs.load(std::memory_order_relaxed);
+                case BudgetKind::Callback: return callbackMs.load(std::memory_order_relaxed);
+            }
+            return 0;
+        }
+    }
+
+    void install_watchdog(lua_State* L) {
+        lua_sethook(L, &hook, LUA_MASKCOUNT, profiling() ? PROFILE_INTERVAL : CHECK_INTERVAL);
+    }
+
+    Budget::Budget(lua_State* L, BudgetKind kind) : m_lua(L), m_kind(kind), m_previousDeadline(deadlineNs), m_previousMs(budgetMs) {
+        const uint32_t ms = budget_ms(kind);
+        if (ms == 0) {
+            return;
+        }
+        const int64_t deadline = now_ns() + static_cast<int64_t>(ms) * 1000000;
+        if (deadlineNs == 0 || deadline < deadlineNs) {
+            deadlineNs = deadline;
+            budgetMs   = ms;
+        }
+    }
+
+    Budget::~Budget() {
+        deadlineNs = m_previousDeadline;
+        budgetMs   = m_previousMs;
+        if (expiredNow && deadlineNs == 0) {
+            // Back to the normal interval once the outermost budget is done
+            expiredNow = false;
+            install_watchdog(m_lua);
+        }
+        if (m_kind == BudgetKind::Callback) {
+            collect_step(m_lua);
+        }
+    }
+
+    bool Budget::expired() const {
+        return expiredNow;
+    }
+
+    void bind_watchdog(sol::state& lua, ChangeSet& changes) {
+        log::info("Binding watchdog Lua functions");
+
+        // Returns nothing, or the error for the Lua side to raise
+        lua.set_function("__hypr_configure_watchdog", [&changes](sol::table options) -> sol::optional<std::string> {
+            HYPRLUA_TRACE_SCOPE("lua.__hypr_configure_watchdog");
+            if (changes.committed) {
+                return std::string("hypr.watchdog.configure can only be called while the config loads");
+            }
+            WatchdogSettings settings = changes.watchdog.value_or(WatchdogSettings{});
+            settings.reloadMs         = options.get_or("reload_ms", settings.reloadMs);
+            settings.callbackMs       = options.get_or("callback_ms", settings.callbackMs);
+            changes.watchdog          = settings;
+            return sol::nullopt;
+        });
+
+        log::debug("Watchdog module successfully bound.");
+    }
+
+    void commit_watchdog(const ChangeSet& changes) {
+        const auto settings = changes.watchdog.value_or(WatchdogSettings{});
+        reloadMs.store(settings.reloadMs, std::memory_order_relaxed);
+        callbackMs.store(settings.callbackMs, std::memory_order_relaxed);
+        log::debug("Lua budgets: reload={}ms callback={}ms", settings.reloadMs, settings.callbackMs);
+    }
+
+    uint64_t watchdog_aborts() {
+        return aborts.load(std::memory_order_relaxed);
+    }
+
+} // namespace hyprlua::modules
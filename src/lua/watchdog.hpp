@@ -0,0 +1,65 @@
+// watchdog.hpp
+#pragma once
+
+#include <cstdint>
+#include <sol/sol.hpp>
+#include "lua/changeset.hpp"
+
+/**
+ * @file watchdog.hpp
+ * @brief Time budgets for Lua code
+ * @details A count hook installed in every config state reads the clock once every
+ *          few thousand VM instructions. Past the deadline of the innermost Budget
+ *          scope it raises an error carrying a traceback, so a looping config or
+ *          callback is aborted instead of freezing the compositor. Time spent inside
+ *          C++ functions is counted but cannot be interrupted. The profiler samples
+ *          from the same hook, since a state has only one.
+ */
+
+namespace hyprlua::modules {
+
+    /// @brief Which budget a piece of Lua runs under
+    enum class BudgetKind {
+        Load,     ///< The config run at startup, on the reload worker
+        Reload,   ///< A config rebuilt on the reload worker
+        Callback, ///< Bind, event and timer callbacks, on the compositor thread
+    };
+
+    /// @brief Install the budget hook in a new state; code outside a Budget scope runs unlimited
+    void install_watchdog(lua_State* L);
+
+    /**
+     * @class Budget
+     * @brief Puts the Lua code run during its lifetime under a time budget
+     * @details Nested scopes keep the earlier deadline. After expiry the hook fires on
+     *          every instruction, so a pcall inside the script cannot swallow the abort.
+     *          A callback scope ends with a collector step, see collect_step().
+     */
+    class Budget {
+      public:
+        Budget(lua_State* L, BudgetKind kind);
+        ~Budget();
+
+        Budget(const Budget&)            = delete;
+        Budget& operator=(const Budget&) = delete;
+
+        /// @brief Whether the code was aborted for running out of time
+        bool expired() const;
+
+      private:
+        lua_State* m_lua;
+        BudgetKind m_kind;
+        int64_t    m_previousDeadline;
+        uint32_t   m_previousMs;
+    };
+
+    /// @brief Register __hypr_configure_watchdog; budgets are recorded into @p changes
+    void bind_watchdog(sol::state& lua, ChangeSet& changes);
+
+    /// @brief Apply the recorded budgets, or the defaults if the config set none; they take effect from the next run
+    void commit_watchdog(const ChangeSet& changes);
+
+    /// @brief Scripts aborted for exceeding a budget since the plugin loaded
+    uint64_t watchdog_aborts();
+
+} // namespace hyprlua::modules
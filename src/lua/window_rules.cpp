@@ -0,0 +1,290 @@
+// window_rules.cpp
+#include "window_rules.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <mutex>
+
+namespace hyprlua {
+
+    namespace {
+        constexpr std::array<std::string_view, RULE_FIELD_COUNT>           FIELD_NAMES = {"class", "title", "initialClass", "initialTitle"};
+
+        /// @brief Compiled regexes by pattern, shared across rules and reloads; cleared when full
+        constexpr size_t                                                   REGEX_CACHE_LIMIT = 4096;
+        std::mutex                                                         regexCacheMutex;
+        std::unordered_map<std::string, std::shared_ptr<const std::regex>> regexCache;
+
+        std::expected<std::shared_ptr<const std::regex>, std::string> cached_regex(const std::string& pattern) {
+            {
+                std::lock_guard<std::mutex> lock(regexCacheMutex);
+                if (auto it = regexCache.find(pattern); it != regexCache.end()) {
+                    return it->second;
+                }
+            }
+
+            std::shared_ptr<const std::regex> regex;
+            try {
+                regex = std::make_shared<const std::regex>(pattern, std::regex::ECMAScript | std::regex::optimize);
+            } catch (const std::regex_error& e) {
+                return std::unexpected(std::format("invalid pattern '{}': {}", pattern, e.what()));
+            }
+
+            std::lock_guard<std::mutex> lock(regexCacheMutex);
+            if (regexCache.size() >= REGEX_CACHE_LIMIT) {
+                regexCache.clear();
+            }
+            regexCache.emplace(pattern, regex);
+            return regex;
+        }
+
+        /// @brief Whether @p text has no regex syntax, so it only matches itself
+        bool is_literal(std::string_view text) {
+            return text.find_first_of(".[]{}()*+?|^$\\") == std::string_view::npos;
+        }
+
+        /**
+         * @brief The longest text every match of @p pattern contains, or "" when there is none
+         * @details Only looks at characters outside groups and classes; a top-level
+         *          alternative means nothing is required. For ".* - Project 3$" this is
+         *          " - Project 3", which rules out most titles without running the regex.
+         */
+        std::string required_literal(std::string_view pattern) {
+            std::string best;
+            std::string run;
+            int         depth = 0;
+            auto        flush = [&] {
+                if (run.size() > best.size()) {
+                    best = run;
+                }
+                run.clear();
+            };
+            for (size_t i = 0; i < pattern.size(); ++i) {
+                const char c          = pattern[i];
+                const bool quantified = i + 1 < pattern.size() && std::string_view("*+?{").contains(pattern[i + 1]);
+                if (c == '\\') {
+                    // An escaped metacharacter is itself; \d, \w and friends are classes
+                    const char next = i + 1 < pattern.size() ? pattern[i + 1] : '\0';
+                    ++i;
+                    const bool escapedQuantified = i + 1 < pattern.size() && std::string_view("*+?{").contains(pattern[i + 1]);
+                    if (depth == 0 && next != '\0' && std::string_view(".[]{}()*+?|^$\\/-").contains(next) && !escapedQuantified) {
+                        run += next;
+                    } else {
+                        flush();
+                    }
+                } else if (c == '[') {
+                    flush();
+                    // Skip the class, including a leading ] and escapes inside it
+                    size_t end = i + 1;
+                    if (end < pattern.size() && pattern[end] == '^') {
+                        ++end;
+                    }
+                    if (end < pattern.size() && pattern[end] == ']') {
+                        ++end;
+                    }
+                    while (end < pattern.size() && pattern[end] != ']') {
+                        end += pattern[end] == '\\' ? 2 : 1;
+                    }
+                    i = end;
+                } else if (c == '{') {
+                    // A repeat count belongs to what came before it, which flush() already dropped
+                    flush();
+                    i = std::min(pattern.find('}', i), pattern.size());
+                } else if (c == '(') {
+                    flush();
+                    ++depth;
+                } else if (c == ')') {
+                    flush();
+                    depth = std::max(0, depth - 1);
+                } else if (c == '|' && depth == 0) {
+                    return "";
+                } else if (depth > 0 || quantified || std::string_view(".^$*+?}|").contains(c)) {
+                    flush();
+                } else {
+                    run += c;
+                }
+            }
+            flush();
+            return best;
+        }
+
+        /// @brief @p text split on spaces
+        std::vector<std::string_view> words(std::string_view text) {
+            std::vector<std::string_view> out;
+            size_t                        pos = 0;
+            while ((pos = text.find_first_not_of(' ', pos)) != std::string_view::npos) {
+                const size_t end = std::min(text.find(' ', pos), text.size());
+                out.push_back(text.substr(pos, end - pos));
+                pos = end;
+            }
+            return out;
+        }
+
+        /// @brief A number, optionally a percentage as Hyprland accepts for sizes and positions
+        bool is_amount(std::string_view text, bool percent) {
+            if (percent && text.ends_with('%')) {
+                text.remove_suffix(1);
+            }
+            double     value = 0;
+            const auto r     = std::from_chars(text.data(), text.data() + text.size(), value);
+            return !text.empty() && r.ec == std::errc() && r.ptr == text.data() + text.size();
+        }
+
+        /// @brief Append @p ids to @p out keeping it sorted; both are sorted already
+        void merge_into(std::vector<uint32_t>& out, const std::vector<uint32_t>& ids) {
+            const size_t middle = out.size();
+            out.insert(out.end(), ids.begin(), ids.end());
+            std::inplace_merge(out.begin(), out.begin() + middle, out.end());
+        }
+    }
+
+    std::string_view field_name(RuleField field) {
+        return FIELD_NAMES[static_cast<size_t>(field)];
+    }
+
+    std::expected<Matcher, std::string> Matcher::compile(const std::string& pattern) {
+        Matcher matcher;
+        matcher.m_pattern = pattern;
+        if (pattern.empty()) {
+            return matcher;
+        }
+
+        // "^(text)$" is the usual spelling in Hyprland configs; it means the same as "^text$"
+        std::string_view body     = pattern;
+        const bool       anchored = body.starts_with('^');
+        if (anchored) {
+            body.remove_prefix(1);
+        }
+        const bool ended = body.ends_with('$') && !body.ends_with("\\$");
+        if (ended) {
+            body.remove_suffix(1);
+        }
+        if (anchored && ended && body.size() >= 2 && body.front() == '(' && body.back() == ')') {
+            body = body.substr(1, body.size() - 2);
+        }
+
+        if (is_literal(body)) {
+            matcher.m_literal = std::string(body);
+            matcher.m_kind    = anchored ? (ended ? Kind::Exact : Kind::Prefix) : (ended ? Kind::Suffix : Kind::Contains);
+            return matcher;
+        }
+
+        auto regex = cached_regex(pattern);
+        if (!regex) {
+            return std::unexpected(regex.error());
+        }
+        matcher.m_kind    = Kind::Regex;
+        matcher.m_regex   = std::move(*regex);
+        matcher.m_literal = required_literal(pattern);
+        return matcher;
+    }
+
+    bool Matcher::matches(std::string_view text) const {
+        switch (m_kind) {
+            case Kind::Any: return true;
+            case Kind::Exact: return text == m_literal;
+            case Kind::Prefix: return text.starts_with(m_literal);
+            case Kind::Suffix: return text.ends_with(m_literal);
+            case Kind::Contains: return text.find(m_literal) != std::string_view::npos;
+            case Kind::Regex: return text.find(m_literal) != std::string_view::npos && std::regex_search(text.begin(), text.end(), *m_regex);
+        }
+        return false;
+    }
+
+    std::string RuleAction::argument(std::string_view address) const {
+        return std::format("{}address:{}{}", before, address, after);
+    }
+
+    std::expected<RuleAction, std::string> parse_rule_action(std::string_view text) {
+        const auto w = words(text);
+        if (w.empty()) {
+            return std::unexpected("empty action");
+        }
+
+        RuleAction action;
+        action.text     = std::string(text);
+        const auto name = w[0];
+        auto       fail = [&](std::string_view usage) { return std::unexpected(std::format("invalid action '{}': expected {}", text, usage)); };
+        if (name == "float" || name == "tile" || name == "pin") {
+            if (w.size() != 1) {
+                return fail(name);
+            }
+            action.dispatcher = name == "float" ? "setfloating" : name == "tile" ? "settiled" : "pin";
+        } else if (name == "workspace") {
+            if (w.size() < 2 || w.size() > 3 || (w.size() == 3 && w[2] != "silent")) {
+                return fail("workspace <name> [silent]");
+            }
+            action.dispatcher = w.size() == 3 ? "movetoworkspacesilent" : "movetoworkspace";
+            action.before     = std::format("{},", w[1]);
+        } else if (name == "size" || name == "move") {
+            if (w.size() != 3 || !is_amount(w[1], true) || !is_amount(w[2], true)) {
+                return fail(std::format("{} <{}> <{}>", name, name == "size" ? "w" : "x", name == "size" ? "h" : "y"));
+            }
+            action.dispatcher = name == "size" ? "resizewindowpixel" : "movewindowpixel";
+            action.before     = std::format("exact {} {},", w[1], w[2]);
+        } else if (name == "opacity") {
+            if (w.size() != 2 || !is_amount(w[1], false)) {
+                return fail("opacity <alpha>");
+            }
+            action.dispatcher = "setprop";
+            action.after      = std::format(" alpha {}", w[1]);
+        } else {
+            return std::unexpected(std::format("unknown action '{}': expected float, tile, pin, workspace, size, move or opacity", name));
+        }
+        return action;
+    }
+
+    RuleSet::RuleSet(std::vector<WindowRuleSpec> rules) : m_rules(std::move(rules)) {
+        for (uint32_t i = 0; i < m_rules.size(); ++i) {
+            const auto& rule = m_rules[i];
+            if (const auto cls = rule.field(RuleField::Class).exact(); !cls.empty()) {
+                m_byClass[std::string(cls)].push_back(i);
+            } else if (const auto initial = rule.field(RuleField::InitialClass).exact(); !initial.empty()) {
+                m_byInitialClass[std::string(initial)].push_back(i);
+            } else {
+                m_unindexed.push_back(i);
+            }
+        }
+    }
+
+    bool RuleSet::matches(const WindowRuleSpec& rule, const WindowFields& window) const {
+        ++m_checked;
+        for (size_t f = 0; f < RULE_FIELD_COUNT; ++f) {
+            if (!rule.fields[f].matches(window.values[f])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void RuleSet::match(const WindowFields& window, std::vector<uint32_t>& out) const {
+        out.clear();
+        if (m_rules.empty()) {
+            return;
+        }
+
+        const auto byClass   = m_byClass.find(window[RuleField::Class]);
+        const auto byInitial = m_byInitialClass.find(window[RuleField::InitialClass]);
+        const bool bucketed  = byClass != m_byClass.end() || byInitial != m_byInitialClass.end();
+
+        // Candidates in rule order: the unindexed rules plus the buckets of this class and initial class
+        std::vector<uint32_t> merged;
+        if (bucketed) {
+            merged = m_unindexed;
+            if (byClass != m_byClass.end()) {
+                merge_into(merged, byClass->second);
+            }
+            if (byInitial != m_byInitialClass.end()) {
+                merge_into(merged, byInitial->second);
+            }
+        }
+
+        for (const auto i : bucketed ? merged : m_unindexed) {
+            if (matches(m_rules[i], window)) {
+                out.push_back(i);
+            }
+        }
+    }
+
+} // namespace hyprlua
@@ -0,0 +1,176 @@
+// window_rules.hpp
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file window_rules.hpp
+ * @brief Window rules compiled once per config and matched without Lua
+ * @details A rule matches a window when every pattern it sets is found in the
+ *          window's field, like Hyprland's windowrulev2: "^firefox$" for the whole
+ *          name, "firefox" anywhere in it. Patterns that are plain text are compared
+ *          as text; only the rest become a std::regex, compiled once and shared by
+ *          every rule and reload using the same pattern, and only run on text that
+ *          contains the literal part every match needs. A RuleSet indexes its rules
+ *          by exact class and initial class, so a window is only checked against the
+ *          rules that could match it. Nothing here depends on Hyprland or Lua.
+ */
+
+namespace hyprlua {
+
+    /// @brief The window fields a rule can match on
+    enum class RuleField : uint8_t {
+        Class,
+        Title,
+        InitialClass,
+        InitialTitle,
+    };
+
+    constexpr size_t RULE_FIELD_COUNT = 4;
+
+    /// @brief Key of @p field in hypr.rules.add tables and in windowrulev2, e.g. "initialClass"
+    std::string_view field_name(RuleField field);
+
+    /**
+     * @class Matcher
+     * @brief A compiled pattern; copies share the compiled regex
+     */
+    class Matcher {
+      public:
+        /// @brief Compile @p pattern; an empty pattern matches everything
+        static std::expected<Matcher, std::string> compile(const std::string& pattern);
+
+        bool                                       matches(std::string_view text) const;
+
+        /// @brief Whether the pattern is empty and so matches everything
+        bool                                       any() const {
+            return m_kind == Kind::Any;
+        }
+
+        /// @brief The text a "^text$" pattern matches, or an empty view for other patterns
+        std::string_view                           exact() const {
+            return m_kind == Kind::Exact ? std::string_view(m_literal) : std::string_view();
+        }
+
+        const std::string&                         pattern() const {
+            return m_pattern;
+        }
+
+        bool                                       operator==(const Matcher& other) const {
+            return m_pattern == other.m_pattern;
+        }
+
+      private:
+        enum class Kind : uint8_t {
+            Any,
+            Exact,    ///< ^text$
+            Prefix,   ///< ^text
+            Suffix,   ///< text$
+            Contains, ///< text
+            Regex,
+        };
+
+        Kind                              m_kind = Kind::Any;
+        std::string                       m_pattern;
+        std::string                       m_literal; ///< The text itself, or for a regex the text every match contains
+        std::shared_ptr<const std::regex> m_regex;
+    };
+
+    /// @brief One effect of a rule as a dispatcher call on the window, e.g. "workspace 3 silent"
+    struct RuleAction {
+        std::string text;       ///< As written in the config, which is also its windowrulev2 effect
+        std::string dispatcher; ///< e.g. "movetoworkspacesilent"
+        std::string before;     ///< Dispatcher argument ahead of the window, e.g. "3,"
+        std::string after;      ///< Dispatcher argument after the window
+
+        /// @brief The dispatcher argument for the window at @p address, e.g. "3,address:0x1234"
+        std::string argument(std::string_view address) const;
+
+        bool        operator==(const RuleAction&) const = default;
+    };
+
+    /**
+     * @brief Parse a rule action
+     * @details float, tile, pin, workspace <name> [silent], size <w> <h>,
+     *          move <x> <y> and opacity <alpha>, with Hyprland's windowrulev2 meaning
+     */
+    std::expected<RuleAction, std::string> parse_rule_action(std::string_view text);
+
+    /// @brief One hypr.rules.add call
+    struct WindowRuleSpec {
+        std::array<Matcher, RULE_FIELD_COUNT> fields;
+        std::vector<RuleAction>               actions;
+        int32_t                               predicate = -1; ///< Index of the config's Lua predicate, or -1 for none
+
+        const Matcher&                        field(RuleField f) const {
+            return fields[static_cast<size_t>(f)];
+        }
+
+        bool                                  operator==(const WindowRuleSpec&) const = default;
+    };
+
+    /// @brief Lets the rule index be searched with a string_view
+    struct RuleKeyHash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view text) const {
+            return std::hash<std::string_view>{}(text);
+        }
+    };
+
+    /// @brief What a rule is matched against; views into the window, valid during the call
+    struct WindowFields {
+        std::array<std::string_view, RULE_FIELD_COUNT> values;
+
+        std::string_view                               operator[](RuleField f) const {
+            return values[static_cast<size_t>(f)];
+        }
+    };
+
+    /**
+     * @class RuleSet
+     * @brief The rules of one config, indexed for matching
+     */
+    class RuleSet {
+      public:
+        RuleSet() = default;
+        explicit RuleSet(std::vector<WindowRuleSpec> rules);
+
+        /**
+         * @brief Indices of the rules whose patterns all match @p window, in rule order
+         * @details Rules with a predicate are included when their patterns match; calling
+         *          the predicate is up to the caller
+         */
+        void                               match(const WindowFields& window, std::vector<uint32_t>& out) const;
+
+        const std::vector<WindowRuleSpec>& rules() const {
+            return m_rules;
+        }
+
+        /// @brief Rules checked by match() calls so far; with the index, far fewer than rules times windows
+        uint64_t                           checked() const {
+            return m_checked;
+        }
+
+      private:
+        bool                                                   matches(const WindowRuleSpec& rule, const WindowFields& window) const;
+
+        using Index = std::unordered_map<std::string, std::vector<uint32_t>, RuleKeyHash, std::equal_to<>>;
+
+        std::vector<WindowRuleSpec>                            m_rules;
+        Index                                                  m_byClass;        ///< Rules with an exact class
+        Index                                                  m_byInitialClass; ///< Rules with an exact initial class and no exact class
+        std::vector<uint32_t>                                  m_unindexed;      ///< Every other rule
+        mutable uint64_t                                       m_checked = 0;
+    };
+
+} // namespace hyprlua
@@ -1,13 +1,18 @@
 #include "globals.hpp"
 #include "watcher.hpp"
 #include "utils.hpp"
+#include "eventloop.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+#include "hyprctl.hpp"
+#include "paths.hpp"
 #include "lua/runtime.hpp"
 
-#include <filesystem>
+#include <hyprland/src/Compositor.hpp>
+
 #include <string>
 #include <stdexcept>
 #include <iostream> // Logging
-#include <cstdlib>  // getenv()
 
 /**
  * @file main.cpp
@@ -41,41 +46,53 @@ APICALL EXPORT std::string PLUGIN_API_VERSION() {
  * @details Performs:
  * 1. API version validation
  * 2. Environment configuration parsing
- * 3. File watcher initialization
- * 4. Initial notification setup
+ * 3. Compositor event loop hookup for reloads
+ * 4. File watcher initialization
+ * 5. Initial notification setup
+ * 6. Starting the config load on the reload worker
  *
- * @note Uses HYPRLUA_CONFIG_PATH environment variable for config location
+ * @note The config is located through HYPRLUA_CONFIG_PATH and the XDG directories
+ *       (see paths.hpp). It is applied once built, after this returns, so the
+ *       compositor does not wait for Lua before its first frame.
  */
 APICALL EXPORT PLUGIN_DESCRIPTION_INFO PLUGIN_INIT(HANDLE handle) {
     try {
+        HYPRLUA_TRACE_SCOPE("plugin.init");
         PHANDLE                = handle;
         const std::string HASH = __hyprland_api_get_hash();
 
+        // Log path and level come from HYPRLUA_LOG_PATH / HYPRLUA_LOG_LEVEL
+        hyprlua::log::init();
+        hyprlua::trace::init();
+
         // // Validate API compatibility
         // if (HASH != GIT_COMMIT_HASH) {
         //     sendNotification("[Hyprlua] Mismatched headers! Can't proceed.", ERROR_COLOR, ERROR_TIMEOUT);
         //     throw std::runtime_error("[Hyprlua] Version mismatch");
         // }
 
-        // Handle config path resolution
-        const char* configPathEnv = std::getenv("HYPRLUA_CONFIG_PATH");
-        std::string filepath      = configPathEnv ? configPathEnv : "~/.config/hypr/hyprland.lua";
-        filepath                  = expandTilde(filepath);
+        const std::string filepath = hyprlua::paths::config_file();
 
-        // Set up filesystem monitoring
-        std::filesystem::path filePathObj(filepath);
-        const std::string     directory = filePathObj.parent_path().string();
+        // Reloads are requested from the watcher thread and run on the compositor thread
+        if (!hyprlua::eventloop::init(g_pCompositor->m_wlEventLoop)) {
+            throw std::runtime_error("[Hyprlua] Failed to register with the compositor event loop");
+        }
 
-        // Initialize file watcher
-        g_FileWatcher = std::make_unique<FileWatcher>(filepath, directory);
+        // Initialize file watcher; the runtime adds the modules the config requires once it ran
+        g_FileWatcher = std::make_unique<FileWatcher>(filepath, [](const std::string& path) { hyprlua::file_changed(path); });
         if (!g_FileWatcher) {
             throw std::runtime_error("[Hyprlua] Failed to allocate FileWatcher");
         }
 
-        g_FileWatcher->start();
+        // Without the watcher the config still loads; it just is not reloaded on save
+        if (!g_FileWatcher->start()) {
+            hyprlua::log::error("Failed to start the file watcher for {}", filepath);
+            sendNotification("[Hyprlua] Cannot watch the config; changes will not be reloaded automatically", ERROR_COLOR, ERROR_TIMEOUT);
+        }
+        hyprlua::hyprctl::registerCommands();
         sendNotification("[Hyprlua] Plugin initialized successfully.", SUCCESS_COLOR, SUCCESS_TIMEOUT);
 
-        hyprlua::init_lua_runtime("/home/cacarico/ghq/github.com/cacarico/hyprlua/runtime/modules/", "/home/cacarico/.config/hypr/hyprland.lua");
+        hyprlua::init_lua_runtime(hyprlua::paths::modules_dir(), filepath);
 
         return {"Hyprlua", "A plugin to enable Lua support for Hyprland", "cacarico", "0.1"};
     } catch (const std::exception& e) {
@@ -88,17 +105,24 @@ APICALL EXPORT PLUGIN_DESCRIPTION_INFO PLUGIN_INIT(HANDLE handle) {
  * @brief Clean up plugin resources
  * @details Performs:
  * 1. File watcher termination
- * 2. Resource deallocation
+ * 2. Lua runtime and event loop teardown
  * 3. Final status notification
  * @note Guarantees safe shutdown even if exceptions occur
  */
 APICALL EXPORT void PLUGIN_EXIT() {
     try {
+        hyprlua::hyprctl::unregisterCommands();
         if (g_FileWatcher) {
             g_FileWatcher->stop();
             g_FileWatcher.reset();
         }
 
+        // No reload may run once the plugin code is unloaded
+        hyprlua::eventloop::shutdown();
+        hyprlua::shutdown_lua_runtime();
+        shutdownNotifications();
+
         sendNotification("[Hyprlua] Plugin exiting. Stopped file monitoring.", SUCCESS_COLOR, SUCCESS_TIMEOUT);
+        hyprlua::log::shutdown();
     } catch (const std::exception& e) { std::cerr << "[Hyprlua] Error during exit: " << e.what() << std::endl; }
 }
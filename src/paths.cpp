@@ -0,0 +1,87 @@
+// paths.cpp
+#include "paths.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <string_view>
+
+namespace hyprlua::paths {
+
+    namespace fs = std::filesystem;
+
+    namespace {
+        /// @brief A single-directory XDG variable's value, or @p fallback if it is unset, empty or relative
+        std::string xdg(const char* name, const std::string& fallback) {
+            const char* value = std::getenv(name);
+            if (!value || value[0] != '/') {
+                return fallback;
+            }
+            return value;
+        }
+
+        std::string home(std::string_view sub) {
+            return expand_tilde("~/" + std::string(sub));
+        }
+    }
+
+    std::string expand_tilde(const std::string& path) {
+        if (path.empty() || path[0] != '~') {
+            return path;
+        }
+        if (const char* home = std::getenv("HOME")) {
+            return std::string(home) + path.substr(1);
+        }
+        return path.substr(1);
+    }
+
+    std::string config_file() {
+        if (const char* env = std::getenv("HYPRLUA_CONFIG_PATH"); env && env[0]) {
+            return expand_tilde(env);
+        }
+        return xdg("XDG_CONFIG_HOME", home(".config")) + "/hypr/hyprland.lua";
+    }
+
+    std::vector<std::string> module_dirs() {
+        if (const char* env = std::getenv("HYPRLUA_MODULES_PATH"); env && env[0]) {
+            return {expand_tilde(env)};
+        }
+
+        std::vector<std::string> dirs{xdg("XDG_DATA_HOME", home(".local/share")) + "/hyprlua/modules"};
+
+        const char*              env      = std::getenv("XDG_DATA_DIRS");
+        const std::string        dataDirs = env && env[0] ? env : "/usr/local/share:/usr/share";
+        for (size_t start = 0; start <= dataDirs.size();) {
+            const size_t end = std::min(dataDirs.find(':', start), dataDirs.size());
+            // Relative entries are ignored, like relative XDG variables
+            if (end > start && dataDirs[start] == '/') {
+                dirs.push_back(dataDirs.substr(start, end - start) + "/hyprlua/modules");
+            }
+            start = end + 1;
+        }
+
+#ifdef HYPRLUA_SOURCE_MODULES_DIR
+        dirs.push_back(HYPRLUA_SOURCE_MODULES_DIR);
+#endif
+        return dirs;
+    }
+
+    std::string modules_dir() {
+        const auto      dirs = module_dirs();
+        std::error_code ec;
+        for (const auto& dir : dirs) {
+            if (fs::is_directory(dir, ec)) {
+                return dir;
+            }
+        }
+        return dirs.front();
+    }
+
+    std::string store_file() {
+        if (const char* env = std::getenv("HYPRLUA_STORE_PATH"); env && env[0]) {
+            return expand_tilde(env);
+        }
+        return xdg("XDG_STATE_HOME", home(".local/state")) + "/hyprlua/store.bin";
+    }
+
+} // namespace hyprlua::paths
@@ -0,0 +1,46 @@
+// paths.hpp
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @file paths.hpp
+ * @brief Where the user config, the Lua runtime modules and the store snapshot are looked up
+ * @details Follows the XDG base directory spec; relative XDG variables are ignored as it requires.
+ */
+
+namespace hyprlua::paths {
+
+    /**
+     * @brief Expand a leading tilde to the home directory
+     * @return @p path with "~" replaced by $HOME; without HOME the tilde is dropped
+     */
+    std::string              expand_tilde(const std::string& path);
+
+    /**
+     * @brief The user config file
+     * @return HYPRLUA_CONFIG_PATH if set, else $XDG_CONFIG_HOME/hypr/hyprland.lua,
+     *         else ~/.config/hypr/hyprland.lua; a leading tilde is expanded
+     */
+    std::string              config_file();
+
+    /**
+     * @brief Directories that may hold the runtime modules, most preferred first
+     * @details HYPRLUA_MODULES_PATH alone if set; otherwise hyprlua/modules under $XDG_DATA_HOME
+     *          (default ~/.local/share) and each of $XDG_DATA_DIRS (default /usr/local/share:/usr/share),
+     *          then the source tree the plugin was built from
+     */
+    std::vector<std::string> module_dirs();
+
+    /// @brief The first of module_dirs() that exists, or the first candidate if none does
+    std::string              modules_dir();
+
+    /**
+     * @brief The snapshot of hypr.store, when the config persists it
+     * @return HYPRLUA_STORE_PATH if set, else $XDG_STATE_HOME/hyprlua/store.bin,
+     *         else ~/.local/state/hyprlua/store.bin; a leading tilde is expanded
+     */
+    std::string              store_file();
+
+} // namespace hyprlua::paths
@@ -0,0 +1,221 @@
+#include "trace.hpp"
+#include "json.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <string_view>
+#include <unistd.h>
+
+namespace hyprlua::trace {
+
+    std::atomic<bool> active = true;
+
+    namespace detail {
+        std::atomic<bool> capturing = false;
+    }
+
+    namespace {
+        // Sites register once and live until the plugin unloads
+        std::mutex         registryMutex;
+        std::vector<Site*> registry;
+
+        /// @brief One complete ("ph":"X") trace event
+        struct Event {
+            const char* name;
+            int64_t     startNs;
+            int64_t     durationNs;
+            int         tid;
+        };
+
+        /// @brief Events beyond this are dropped so a runaway config cannot exhaust memory
+        constexpr size_t                      MAX_EVENTS = 100000;
+
+        std::mutex                            captureMutex;
+        std::string                           capturePath;
+        bool                                  captureRequested = false;
+        std::chrono::steady_clock::time_point captureStart;
+        std::vector<Event>                    events;
+
+        size_t                                bucket_index(uint64_t ns) {
+            if (ns < 4) {
+                return ns;
+            }
+            const unsigned exponent = 63 - std::countl_zero(ns);
+            const unsigned step     = (ns >> (exponent - 2)) & 3;
+            return exponent * 4 + step;
+        }
+
+        /// @brief Midpoint of the range a bucket covers, in nanoseconds
+        double bucket_value(size_t index) {
+            if (index < 4) {
+                return static_cast<double>(index);
+            }
+            const unsigned exponent = index / 4;
+            const unsigned step     = index % 4;
+            const double   width    = std::ldexp(1.0, static_cast<int>(exponent) - 2);
+            return (4 + step) * width + width / 2;
+        }
+    }
+
+    Site::Site(const char* name) : m_name(name) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(this);
+    }
+
+    void Site::record(std::chrono::nanoseconds duration) {
+        const uint64_t ns = duration.count() > 0 ? static_cast<uint64_t>(duration.count()) : 0;
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_lastNs.store(ns, std::memory_order_relaxed);
+        m_totalNs.fetch_add(ns, std::memory_order_relaxed);
+        m_buckets[bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t max = m_maxNs.load(std::memory_order_relaxed);
+        while (ns > max && !m_maxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {}
+    }
+
+    Summary Site::summary() const {
+        Summary summary;
+        summary.name    = m_name;
+        summary.count   = m_count.load(std::memory_order_relaxed);
+        summary.lastUs  = m_lastNs.load(std::memory_order_relaxed) / 1000.0;
+        summary.maxUs   = m_maxNs.load(std::memory_order_relaxed) / 1000.0;
+        summary.totalUs = m_totalNs.load(std::memory_order_relaxed) / 1000.0;
+
+        // Snapshot the buckets first so both percentiles come from the same counts
+        uint32_t counts[BUCKETS];
+        uint64_t total = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+        if (total == 0) {
+            return summary;
+        }
+
+        auto percentile = [&](double q) {
+            const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * total)));
+            uint64_t       seen   = 0;
+            for (size_t i = 0; i < BUCKETS; ++i) {
+                seen += counts[i];
+                if (seen >= target) {
+                    return bucket_value(i) / 1000.0;
+                }
+            }
+            return summary.maxUs;
+        };
+        summary.p50Us = percentile(0.50);
+        summary.p99Us = percentile(0.99);
+        return summary;
+    }
+
+    void setEnabled(bool enabled) {
+        active.store(enabled, std::memory_order_relaxed);
+    }
+
+    void init() {
+        if (const char* env = std::getenv("HYPRLUA_TRACE"); env && std::string_view(env) == "0") {
+            setEnabled(false);
+        }
+    }
+
+    std::vector<Summary> summaries() {
+        std::vector<Site*> sites;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            sites = registry;
+        }
+
+        std::vector<Summary> out;
+        for (const auto* site : sites) {
+            auto summary = site->summary();
+            if (summary.count > 0) {
+                out.push_back(std::move(summary));
+            }
+        }
+        return out;
+    }
+
+    std::string statsJson() {
+        // Tenths of a microsecond are as far as the percentiles are meaningful
+        const auto   us = [](double value) { return std::round(value * 10.0) / 10.0; };
+        json::Writer w;
+        w.beginObject();
+        for (const auto& s : summaries()) {
+            w.beginObject(s.name)
+                .field("count", s.count)
+                .field("last_us", us(s.lastUs))
+                .field("p50_us", us(s.p50Us))
+                .field("p99_us", us(s.p99Us))
+                .field("max_us", us(s.maxUs))
+                .field("total_us", us(s.totalUs))
+                .end();
+        }
+        return w.end().str();
+    }
+
+    void requestCapture(const std::string& path) {
+        std::lock_guard<std::mutex> lock(captureMutex);
+        capturePath      = path;
+        captureRequested = true;
+    }
+
+    void startCaptureIfRequested() {
+        std::lock_guard<std::mutex> lock(captureMutex);
+        if (!captureRequested || detail::capturing.load(std::memory_order_relaxed)) {
+            return;
+        }
+        captureRequested = false;
+        events.clear();
+        captureStart = std::chrono::steady_clock::now();
+        detail::capturing.store(true, std::memory_order_relaxed);
+    }
+
+    std::string finishCapture() {
+        std::vector<Event> captured;
+        std::string        path;
+        {
+            std::lock_guard<std::mutex> lock(captureMutex);
+            if (!detail::capturing.load(std::memory_order_relaxed)) {
+                return "";
+            }
+            detail::capturing.store(false, std::memory_order_relaxed);
+            captured.swap(events);
+            path = capturePath;
+        }
+
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) {
+            return "";
+        }
+        json::Writer w;
+        w.beginObject().beginArray("traceEvents");
+        for (const auto& e : captured) {
+            w.beginObject()
+                .field("name", e.name)
+                .field("cat", "hyprlua")
+                .field("ph", "X")
+                .field("ts", e.startNs / 1000.0)
+                .field("dur", e.durationNs / 1000.0)
+                .field("pid", getpid())
+                .field("tid", e.tid)
+                .end();
+        }
+        w.end().field("displayTimeUnit", "ms").end();
+        out << w.str() << "\n";
+        return out ? path : "";
+    }
+
+    namespace detail {
+        void addEvent(const Site& site, std::chrono::steady_clock::time_point start, std::chrono::nanoseconds duration) {
+            std::lock_guard<std::mutex> lock(captureMutex);
+            if (!capturing.load(std::memory_order_relaxed) || events.size() >= MAX_EVENTS) {
+                return;
+            }
+            events.push_back({site.name(), std::chrono::duration_cast<std::chrono::nanoseconds>(start - captureStart).count(), duration.count(), static_cast<int>(gettid())});
+        }
+    }
+
+} // namespace hyprlua::trace
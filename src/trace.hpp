@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file trace.hpp
+ * @brief Scoped timers with per-site histograms and an optional Chrome trace capture
+ * @details Every instrumented place is a Site with a static lifetime. A Scope times
+ *          the enclosing block and adds the duration to the site's histogram with a
+ *          few relaxed atomic increments, so sites may be hit from any thread.
+ *          Tracing off costs one relaxed load per scope; building with
+ *          HYPRLUA_TRACE=0 removes the scopes entirely.
+ */
+
+/// @brief Set to 0 to compile HYPRLUA_TRACE_SCOPE out
+#ifndef HYPRLUA_TRACE
+#define HYPRLUA_TRACE 1
+#endif
+
+namespace hyprlua::trace {
+
+    /// @brief Summary of one site, durations in microseconds
+    struct Summary {
+        std::string name;
+        uint64_t    count   = 0;
+        double      lastUs  = 0;
+        double      p50Us   = 0;
+        double      p99Us   = 0;
+        double      maxUs   = 0;
+        double      totalUs = 0;
+    };
+
+    /**
+     * @class Site
+     * @brief A named place whose durations are recorded
+     * @note Construct with static storage duration only; sites register themselves
+     *       and are never removed
+     */
+    class Site {
+      public:
+        explicit Site(const char* name);
+
+        Site(const Site&)            = delete;
+        Site& operator=(const Site&) = delete;
+
+        /// @brief Record one duration; thread-safe
+        void        record(std::chrono::nanoseconds duration);
+
+        Summary     summary() const;
+
+        const char* name() const {
+            return m_name;
+        }
+
+        /// @brief Buckets: 4 linear steps per power of two of nanoseconds, so percentiles are within ~12%
+        static constexpr size_t BUCKETS = 64 * 4;
+
+      private:
+        const char*           m_name;
+        std::atomic<uint64_t> m_count = 0;
+        std::atomic<uint64_t> m_lastNs = 0;
+        std::atomic<uint64_t> m_maxNs = 0;
+        std::atomic<uint64_t> m_totalNs = 0;
+        std::atomic<uint32_t> m_buckets[BUCKETS] = {};
+    };
+
+    /// @brief Whether scopes currently measure anything
+    extern std::atomic<bool> active;
+
+    /// @brief Turn measuring on or off at run time; on by default, HYPRLUA_TRACE=0 in the environment turns it off
+    void setEnabled(bool enabled);
+
+    /// @brief Read HYPRLUA_TRACE from the environment
+    void init();
+
+    /// @brief Every site hit at least once, in registration order
+    std::vector<Summary> summaries();
+
+    /// @brief summaries() as a JSON object keyed by site name
+    std::string statsJson();
+
+    /**
+     * @brief Record the next reload as Chrome trace events
+     * @param path File the trace is written to once finishCapture() runs
+     */
+    void requestCapture(const std::string& path);
+
+    /// @brief Start recording events if a capture was requested; called when a reload begins
+    void startCaptureIfRequested();
+
+    /**
+     * @brief Stop recording and write the trace-event JSON
+     * @return The path written, or an empty string if nothing was being captured
+     */
+    std::string finishCapture();
+
+    namespace detail {
+        /// @brief Set while a capture is running, checked by every Scope
+        extern std::atomic<bool> capturing;
+
+        void                     addEvent(const Site& site, std::chrono::steady_clock::time_point start, std::chrono::nanoseconds duration);
+    }
+
+    /**
+     * @class Scope
+     * @brief Times its own lifetime into a Site
+     */
+    class Scope {
+      public:
+        explicit Scope(Site& site) : m_site(site) {
+            if (active.load(std::memory_order_relaxed)) {
+                m_start = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~Scope() {
+            if (m_start == std::chrono::steady_clock::time_point{}) {
+                return;
+            }
+            const auto duration = std::chrono::steady_clock::now() - m_start;
+            m_site.record(duration);
+            if (detail::capturing.load(std::memory_order_relaxed)) {
+                detail::addEvent(m_site, m_start, duration);
+            }
+        }
+
+        Scope(const Scope&)            = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        Site&                                 m_site;
+        std::chrono::steady_clock::time_point m_start{};
+    };
+
+} // namespace hyprlua::trace
+
+#define HYPRLUA_TRACE_CONCAT_(a, b) a##b
+#define HYPRLUA_TRACE_CONCAT(a, b)  HYPRLUA_TRACE_CONCAT_(a, b)
+
+#if HYPRLUA_TRACE
+/// @brief Time the rest of the enclosing block under @p name (a string literal)
+#define HYPRLUA_TRACE_SCOPE(name)                                                                                                                                                  \
+    static ::hyprlua::trace::Site HYPRLUA_TRACE_CONCAT(traceSite_, __LINE__){name};                                                                                                \
+    ::hyprlua::trace::Scope       HYPRLUA_TRACE_CONCAT(traceScope_, __LINE__) {                                                                                                    \
+        HYPRLUA_TRACE_CONCAT(traceSite_, __LINE__)                                                                                                                                 \
+    }
+#else
+#define HYPRLUA_TRACE_SCOPE(name)                                                                                                                                                  \
+    do {                                                                                                                                                                           \
+    } while (0)
+#endif
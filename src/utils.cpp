@@ -1,53 +1,181 @@
 #include "utils.hpp"
+#include "eventloop.hpp"
 #include "globals.hpp"
-#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
-/**
- * @var std::mutex notificationMutex
- * @brief Mutex instance for notification thread safety
- * @details Shared across all threads accessing Hyprland's notification API
- */
-std::mutex notificationMutex;
+namespace {
+    /// @brief A queued toast; summaries have a noun and count events instead of repeats
+    struct QueuedNotification {
+        std::string message;
+        std::string noun{};
+        CHyprColor  color;
+        int         duration = 0;
+        uint64_t    count    = 1;
+    };
+
+    /// @brief Distinct messages kept waiting; anything beyond is only counted
+    constexpr size_t                  MAX_QUEUED = 16;
+
+    std::mutex                        queueMutex;
+    std::vector<QueuedNotification>   queue;
+    uint64_t                          suppressed     = 0;
+    bool                              flushScheduled = false;
+
+    std::atomic<uint32_t>             rateBurst      = 3;
+    std::atomic<uint32_t>             rateIntervalMs = 1000;
+
+    // Compositor thread only
+    double                                     tokens     = 3;
+    std::chrono::steady_clock::time_point      lastRefill = std::chrono::steady_clock::now();
+    std::unique_ptr<hyprlua::eventloop::Timer> retryTimer;
+
+    std::string                                render(const QueuedNotification& n) {
+        if (!n.noun.empty()) {
+            return std::format("[Hyprlua] {} {} {}{}", n.message, n.count, n.noun, n.count == 1 ? "" : "s");
+        }
+        if (n.count > 1) {
+            return std::format("{} (x{})", n.message, n.count);
+        }
+        return n.message;
+    }
+
+    void deliver(const std::vector<QueuedNotification>& ready, uint64_t dropped) {
+        if (!PHANDLE) {
+            return;
+        }
+        for (const auto& n : ready) {
+            HyprlandAPI::addNotification(PHANDLE, render(n), n.color, n.duration);
+        }
+        if (dropped > 0) {
+            HyprlandAPI::addNotification(PHANDLE, std::format("[Hyprlua] {} more notifications suppressed", dropped), CHyprColor{1.0, 0.5, 0.0, 1.0}, 3000);
+        }
+    }
+
+    /// @brief Take everything queued, bypassing the rate limit
+    void flushAll() {
+        std::vector<QueuedNotification> ready;
+        uint64_t                        dropped = 0;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            ready.swap(queue);
+            dropped        = suppressed;
+            suppressed     = 0;
+            flushScheduled = false;
+        }
+        deliver(ready, dropped);
+    }
+
+    /**
+     * @brief Show as much of the queue as the rate limit allows
+     * @details A token bucket: up to rateBurst toasts back to back, then one more
+     *          every rateIntervalMs. Whatever is left waits for the retry timer and
+     *          keeps merging repeats in the meantime.
+     * @note Compositor thread only
+     */
+    void flushNotifications() {
+        const uint32_t burst    = std::max<uint32_t>(rateBurst.load(std::memory_order_relaxed), 1);
+        const uint32_t interval = rateIntervalMs.load(std::memory_order_relaxed);
+        const auto     now      = std::chrono::steady_clock::now();
+        if (interval > 0) {
+            const double elapsedMs = std::chrono::duration<double, std::milli>(now - lastRefill).count();
+            tokens                 = std::min<double>(burst, tokens + elapsedMs / interval);
+        } else {
+            tokens = burst;
+        }
+        lastRefill = now;
+
+        std::vector<QueuedNotification> ready;
+        uint64_t                        dropped = 0;
+        int                             retryMs = 0;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            size_t                      taken = 0;
+            while (taken < queue.size() && (interval == 0 || tokens >= 1)) {
+                ready.push_back(std::move(queue[taken++]));
+                tokens -= interval > 0 ? 1 : 0;
+            }
+            queue.erase(queue.begin(), queue.begin() + static_cast<ptrdiff_t>(taken));
+            if (suppressed > 0 && queue.empty() && (interval == 0 || tokens >= 1)) {
+                dropped    = suppressed;
+                suppressed = 0;
+                tokens -= interval > 0 ? 1 : 0;
+            }
+
+            if (queue.empty() && suppressed == 0) {
+                flushScheduled = false;
+            } else {
+                retryMs = static_cast<int>(std::ceil((1 - tokens) * interval));
+            }
+        }
+
+        deliver(ready, dropped);
+
+        if (retryMs > 0) {
+            if (!retryTimer) {
+                retryTimer = std::make_unique<hyprlua::eventloop::Timer>(&flushNotifications);
+            }
+            if (!retryTimer->arm(retryMs)) {
+                flushAll();
+            }
+        }
+    }
+
+    void enqueue(QueuedNotification notification) {
+        bool schedule = false;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            auto                        it = std::find_if(queue.begin(), queue.end(), [&](const QueuedNotification& queued) {
+                return queued.message == notification.message && queued.noun == notification.noun;
+            });
+            if (it != queue.end()) {
+                it->count += notification.count;
+            } else if (queue.size() < MAX_QUEUED) {
+                queue.push_back(std::move(notification));
+            } else {
+                ++suppressed;
+            }
+            schedule       = !flushScheduled;
+            flushScheduled = true;
+        }
+
+        // Without an event loop (plugin init and exit) the caller is the compositor thread
+        if (schedule && !hyprlua::eventloop::post(&flushNotifications)) {
+            flushAll();
+        }
+    }
+}
 
 /**
- * @brief Implementation of thread-safe notification delivery
- * @details Uses lock_guard to ensure mutual exclusion when accessing Hyprland API
+ * @brief Queue a notification for the compositor thread
+ * @details Only a short lock around the queue is taken here; Hyprland is called from
+ *          flushNotifications() on the compositor thread, outside of that lock.
  * @param message Notification content (max 1 line recommended)
  * @param color RGBA color tuple {r, g, b, a} (0.0-1.0 range)
  * @param duration Visibility time in ms (3000 = 3 seconds)
- * @warning PHANDLE must be initialized before calling this function
+ * @warning PHANDLE must be initialized before the queue is flushed
  */
 void sendNotification(const std::string& message, const CHyprColor& color, int duration) {
-    std::lock_guard<std::mutex> lock(notificationMutex);
-    if (PHANDLE) {
-        HyprlandAPI::addNotification(PHANDLE, message, color, duration);
-    }
+    enqueue({.message = message, .color = color, .duration = duration});
 }
 
-/**
- * @brief Expands tilde prefix to current user's home directory
- * @details Implementation details:
- * - Returns empty string for empty input
- * - Only expands leading tilde
- * - Uses $HOME environment variable on UNIX-like systems
- * - Falls back to tilde removal if $HOME not set
- * @param path Input filesystem path (e.g. "~/.config/hypr")
- * @return Expanded path (e.g. "/home/user/.config/hypr")
- * @note Windows support is limited - considers USERPROFILE but focuses on *nix
- */
-std::string expandTilde(const std::string& path) {
-    if (path.empty()) {
-        return "";
-    }
+void sendSummaryNotification(const std::string& action, const std::string& noun, const CHyprColor& color, int duration) {
+    enqueue({.message = action, .noun = noun, .color = color, .duration = duration});
+}
 
-    if (path[0] == '~') {
-        const char* home = std::getenv("HOME");
-        if (home) {
-            return std::string(home) + path.substr(1);
-        }
-        return path.substr(1);
-    }
+void setNotificationRateLimit(uint32_t burst, uint32_t intervalMs) {
+    rateBurst.store(std::max<uint32_t>(burst, 1), std::memory_order_relaxed);
+    rateIntervalMs.store(intervalMs, std::memory_order_relaxed);
+}
 
-    return path;
+void shutdownNotifications() {
+    flushAll();
+    retryTimer.reset();
 }
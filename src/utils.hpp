@@ -1,6 +1,6 @@
 #pragma once
 #include <hyprland/src/helpers/Color.hpp>
-#include <mutex>
+#include <cstdint>
 #include <string>
 
 /**
@@ -10,20 +10,39 @@
 
 /**
  * @brief Send a notification through Hyprland's notification system
+ * @details The message is queued and shown from the compositor thread. Repeats of a
+ *          message still waiting in the queue are merged into it with a count, and
+ *          toasts beyond the rate limit wait in the queue instead of stacking up.
  * @param message The text content to display
  * @param color The color scheme for the notification (RGBA)
  * @param duration Display duration in milliseconds
- * @note Thread-safe through mutex locking
+ * @note Thread-safe; never calls into Hyprland from the calling thread once the
+ *       event loop is initialized
  */
 void sendNotification(const std::string& message, const CHyprColor& color, int duration);
 
-/// @brief Mutex for synchronizing notifications across threads
-extern std::mutex notificationMutex;
+/**
+ * @brief Count one occurrence of an event that is reported as a single summary toast
+ * @details All calls with the same @p action and @p noun made before the queue is
+ *          flushed become one notification, e.g. "[Hyprlua] applied 12 monitor rules".
+ * @param action Verb in the past tense ("applied")
+ * @param noun Singular noun ("monitor rule"); an "s" is appended for counts above one
+ * @param color The color scheme for the notification (RGBA)
+ * @param duration Display duration in milliseconds
+ * @note Thread-safe
+ */
+void sendSummaryNotification(const std::string& action, const std::string& noun, const CHyprColor& color, int duration);
+
+/**
+ * @brief Configure the notification rate limit
+ * @param burst Toasts that may be shown back to back (at least 1)
+ * @param intervalMs Time for one more toast to become available; 0 disables the limit
+ * @note Thread-safe
+ */
+void setNotificationRateLimit(uint32_t burst, uint32_t intervalMs);
 
 /**
- * @brief Expand tilde (~) in paths to user's home directory
- * @param path Input path potentially containing tilde
- * @return Expanded path if tilde exists, original path otherwise
- * @note Handles both "~" and "~/subpath" formats
+ * @brief Show whatever is still queued and release the retry timer
+ * @note Compositor thread only, before the event loop is shut down
  */
-std::string expandTilde(const std::string& path);
+void shutdownNotifications();
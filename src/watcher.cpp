@@ -1,104 +1,280 @@
 #include "watcher.hpp"
+#include "hash.hpp"
 #include "utils.hpp"
 #include <cstring>
 #include <cerrno>
 #include <unistd.h>
 #include <sys/inotify.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <fcntl.h>
-#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
 
-FileWatcher::FileWatcher(const std::string& filepath, const std::string& directory) : m_filepath(filepath), m_directory(directory), m_keepWatching(true) {}
+namespace {
+    /// @brief A writer closing the file, or a new version renamed into place; not the writes in between
+    constexpr uint32_t      WATCH_MASK = IN_CLOSE_WRITE | IN_MOVED_TO;
+
+    std::optional<uint64_t> content_hash(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return std::nullopt;
+        }
+        std::ostringstream ss;
+        ss << file.rdbuf();
+        return hyprlua::hash::fnv1a(ss.str());
+    }
+}
+
+FileWatcher::FileWatcher(const std::string& filepath, Callback onChange) : m_files{filepath}, m_onChange(std::move(onChange)) {
+    if (!m_onChange) {
+        m_onChange = [](const std::string& path) { sendNotification("File was modified: " + path, CHyprColor{0.2, 0.6, 1.0, 1.0}, 3000); };
+    }
+}
 
 FileWatcher::~FileWatcher() {
     stop();
 }
 
 /**
- * @brief Launch the monitoring thread
- * @details Creates a new thread that executes the watch() method
+ * @brief Set up inotify, the shutdown eventfd and epoll, then launch the monitoring thread
+ * @details Descriptors are created on the caller's thread so that failures are reported
+ *          synchronously and no change made right after start() returns can be missed
  */
-void FileWatcher::start() {
+bool FileWatcher::start() {
+    if (m_thread.joinable()) {
+        return true;
+    }
+
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd < 0) {
+        sendNotification("[Hyprlua] inotify_init1 error: " + std::string(std::strerror(errno)), CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+        return false;
+    }
+
+    std::string first;
+    bool        watching = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        applyFiles();
+        watching = !m_watches.empty();
+        first    = m_files.empty() ? "the config" : m_files.front();
+    }
+    if (!watching) {
+        sendNotification("[Hyprlua] Failed to add watch for " + first + ": " + std::string(std::strerror(errno)), CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+        closeDescriptors();
+        return false;
+    }
+
+    m_stopFd  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_stopFd < 0 || m_epollFd < 0) {
+        sendNotification("[Hyprlua] epoll setup error: " + std::string(std::strerror(errno)), CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+        closeDescriptors();
+        return false;
+    }
+
+    epoll_event ev{};
+    ev.events  = EPOLLIN;
+    ev.data.fd = m_inotifyFd;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_inotifyFd, &ev);
+    ev.data.fd = m_stopFd;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_stopFd, &ev);
+
     m_thread = std::thread(&FileWatcher::watch, this);
+    return true;
 }
 
 /**
  * @brief Stop and join the monitoring thread
- * @details Sets the termination flag and waits for the thread to exit
+ * @details Signals the shutdown eventfd, which makes the blocked epoll_wait
+ *          return immediately, then joins the thread and releases descriptors
  */
 void FileWatcher::stop() {
-    m_keepWatching = false;
     if (m_thread.joinable()) {
+        const uint64_t one = 1;
+        if (write(m_stopFd, &one, sizeof(one)) < 0) {
+            sendNotification("[Hyprlua] Failed to signal watcher: " + std::string(std::strerror(errno)), CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+        }
         m_thread.join();
     }
+    closeDescriptors();
+}
+
+void FileWatcher::setFiles(const std::vector<std::string>& files) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_files = files;
+    if (m_inotifyFd >= 0) {
+        applyFiles();
+    }
+}
+
+/**
+ * @brief Watch the directory of every file, and of its symlink target if it has one
+ * @details inotify hands out one descriptor per directory inode, so two paths to the
+ *          same directory share an entry. Descriptors no longer needed are removed.
+ */
+void FileWatcher::applyFiles() {
+    namespace fs = std::filesystem;
+    std::unordered_map<int, std::unordered_map<std::string, std::string>> watches;
+
+    auto                                                                  add = [&](const fs::path& path, const std::string& reported) {
+        const fs::path directory = path.parent_path().empty() ? fs::path(".") : path.parent_path();
+        const int      wd        = inotify_add_watch(m_inotifyFd, directory.c_str(), WATCH_MASK);
+        if (wd >= 0) {
+            watches[wd].emplace(path.filename().string(), reported);
+        }
+    };
+
+    for (const auto& file : m_files) {
+        add(file, file);
+        std::error_code ec;
+        const auto      target = fs::canonical(file, ec);
+        if (!ec && target != fs::path(file)) {
+            add(target, file);
+        }
+    }
+
+    for (const auto& [wd, names] : m_watches) {
+        if (!watches.contains(wd)) {
+            inotify_rm_watch(m_inotifyFd, wd);
+        }
+    }
+    m_watches = std::move(watches);
+
+    std::unordered_map<std::string, std::optional<uint64_t>> hashes;
+    for (const auto& file : m_files) {
+        const auto known = m_hashes.find(file);
+        hashes[file]     = known != m_hashes.end() ? known->second : content_hash(file);
+    }
+    m_hashes = std::move(hashes);
+}
+
+const std::string* FileWatcher::lookup(int wd, const std::string& name) const {
+    const auto directory = m_watches.find(wd);
+    if (directory == m_watches.end()) {
+        return nullptr;
+    }
+    const auto file = directory->second.find(name);
+    return file == directory->second.end() ? nullptr : &file->second;
+}
+
+uint64_t FileWatcher::wakeups() const {
+    return m_wakeups.load(std::memory_order_relaxed);
+}
+
+void FileWatcher::closeDescriptors() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Closing the inotify instance drops its watches
+    m_watches.clear();
+    for (int* fd : {&m_epollFd, &m_stopFd, &m_inotifyFd}) {
+        if (*fd >= 0) {
+            close(*fd);
+        }
+        *fd = -1;
+    }
 }
 
 /**
  * @brief Core file monitoring implementation using inotify
  * @details This method:
- * 1. Initializes inotify in non-blocking mode
- * 2. Sets up watches for modify/close/move/create events
- * 3. Implements a debounced event detection loop
+ * 1. Blocks in epoll_wait on the inotify and shutdown descriptors
+ * 2. Drains all pending inotify events when the directory changes
+ * 3. Hashes each file that was closed after writing or renamed into place and
+ *    reports it if the content differs from the last version seen
  * 4. Handles errors through UI notifications
- * 5. Maintains a 500ms event processing interval
+ * 5. Exits as soon as stop() signals the shutdown eventfd
  *
- * @note Uses IN_NONBLOCK to prevent blocking the thread during exit
- * @note Implements 500ms debouncing to prevent duplicate notifications
+ * @note There is no timeout, so the thread does not run at all while idle
+ * @note There is no time-based debounce: saves in quick succession are each
+ *       reported, and several events for one save collapse through the hash
  */
 void FileWatcher::watch() {
-    // Initialize inotify with non-blocking mode
-    int inotifyFd = inotify_init1(IN_NONBLOCK);
-    if (inotifyFd < 0) {
-        sendNotification("[Hyprlua] inotify_init1 error: " + std::string(std::strerror(errno)), CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
-        return;
+    // Notify that monitoring has started
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        sendNotification("[Hyprlua] Monitoring '" + (m_files.empty() ? std::string() : m_files.front()) + "' for changes...", CHyprColor{0.2, 1.0, 0.2, 1.0}, 3000);
     }
 
-    // Add a watch on the specified directory for relevant events
-    int watchDesc = inotify_add_watch(inotifyFd, m_directory.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
-    if (watchDesc < 0) {
-        sendNotification("[Hyprlua] Failed to add watch for " + m_directory + ": " + std::string(std::strerror(errno)), CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
-        close(inotifyFd);
-        return;
-    }
+    // Event loop
+    while (true) {
+        epoll_event events[2];
+        int         ready = epoll_wait(m_epollFd, events, 2, -1);
+        m_wakeups.fetch_add(1, std::memory_order_relaxed);
 
-    // Notify that monitoring has started
-    sendNotification("[Hyprlua] Monitoring '" + m_filepath + "' for changes...", CHyprColor{0.2, 1.0, 0.2, 1.0}, 3000);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            sendNotification("[Hyprlua] epoll_wait error: " + std::string(std::strerror(errno)), CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+            return;
+        }
 
-    // Initialize the last event time for debouncing
-    auto lastEventTime = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+        bool inotifyReady = false;
+        for (int i = 0; i < ready; ++i) {
+            if (events[i].data.fd == m_stopFd) {
+                return;
+            }
+            inotifyReady = inotifyReady || events[i].data.fd == m_inotifyFd;
+        }
 
-    // Event loop
-    while (m_keepWatching) {
-        char    buffer[4096] __attribute__((aligned(__alignof__(inotify_event))));
-        ssize_t numRead = read(inotifyFd, buffer, sizeof(buffer));
-
-        if (numRead > 0) {
-            for (char* ptr = buffer; ptr < buffer + numRead;) {
-                auto* event = reinterpret_cast<inotify_event*>(ptr);
-
-                if (event->len > 0) {
-                    std::string eventFile = m_directory + event->name;
-
-                    if (eventFile == m_filepath) {
-                        auto now = std::chrono::steady_clock::now();
-                        if (now - lastEventTime > std::chrono::milliseconds(500)) { // Debounce
-                            sendNotification("File was modified: " + m_filepath, CHyprColor{0.2, 0.6, 1.0, 1.0}, 3000);
-                            lastEventTime = now;
-                        }
+        if (!inotifyReady) {
+            continue;
+        }
+
+        // Drain the inotify queue; the fd is non-blocking so the last read ends with EAGAIN
+        while (true) {
+            char    buffer[4096] __attribute__((aligned(__alignof__(inotify_event))));
+            ssize_t numRead = read(m_inotifyFd, buffer, sizeof(buffer));
+
+            if (numRead <= 0) {
+                if (numRead == -1 && errno != EAGAIN && errno != EINTR) {
+                    // An error occurred during read
+                    sendNotification("[Hyprlua] read error: " + std::string(std::strerror(errno)), CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+                }
+                break;
+            }
+
+            std::vector<std::string> touched;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (char* ptr = buffer; ptr < buffer + numRead;) {
+                    auto* event = reinterpret_cast<inotify_event*>(ptr);
+                    ptr += sizeof(inotify_event) + event->len;
+
+                    if (event->mask & IN_IGNORED) {
+                        // The directory was removed or unwatched; its descriptor may be reused
+                        m_watches.erase(event->wd);
+                        continue;
                     }
+
+                    // Match by directory descriptor and name, so it does not matter how the directory was spelled
+                    const std::string* path = event->len > 0 ? lookup(event->wd, event->name) : nullptr;
+                    if (path && std::find(touched.begin(), touched.end(), *path) == touched.end()) {
+                        touched.push_back(*path);
+                    }
+                }
+            }
+
+            // Read the files outside the lock, then keep only those whose content changed
+            std::vector<std::string> changed;
+            for (const auto& path : touched) {
+                const auto                  hash = content_hash(path);
+                std::lock_guard<std::mutex> lock(m_mutex);
+                const auto                  last = m_hashes.find(path);
+                if (last == m_hashes.end() || last->second == hash) {
+                    continue;
                 }
+                last->second = hash;
+                changed.push_back(path);
+            }
 
-                ptr += sizeof(inotify_event) + event->len;
+            // Outside the lock, so the callback may call setFiles()
+            for (const auto& path : changed) {
+                m_onChange(path);
             }
-        } else if (numRead == -1 && errno != EAGAIN) {
-            // An error occurred during read
-            sendNotification("[Hyprlua] read error: " + std::string(std::strerror(errno)), CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
         }
-
-        // Sleep to reduce CPU usage
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
     }
-
-    // Cleanup: Remove the watch and close the inotify file descriptor
-    inotify_rm_watch(inotifyFd, watchDesc);
-    close(inotifyFd);
 }
@@ -3,24 +3,39 @@
 #include <string>
 #include <thread>
 #include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 #include "globals.hpp"
 
 /**
  * @class FileWatcher
- * @brief Monitors filesystem changes in a directory using inotify
+ * @brief Monitors a set of files for changes using inotify
  *
- * This class watches a specified directory for changes to a target file,
- * providing notifications through the application's UI system. It uses
- * Linux's inotify API internally and runs monitoring in a separate thread.
+ * This class watches the directories holding a set of files, which may be
+ * spread over nested directories, and reports changes to those files only.
+ * A file that is a symlink is also watched under its target, so editing the
+ * target counts as a change. A change is reported once the writer closed the
+ * file or renamed a new version into place, and only if the content differs
+ * from the last version seen, so atomic saves are reported once and rewrites
+ * that change nothing not at all. It uses Linux's inotify API internally and runs
+ * monitoring in a separate thread that blocks in epoll until either a file
+ * changes or stop() is called.
  */
 class FileWatcher {
   public:
+    /// @brief Invoked from the watcher thread with the path of the changed file
+    using Callback = std::function<void(const std::string&)>;
+
     /**
      * @brief Construct a new FileWatcher instance
-     * @param filepath Full path to the target file to monitor
-     * @param directory Parent directory to watch for changes
+     * @param filepath Full path to the first file to monitor; see setFiles()
+     * @param onChange Called on every detected change; defaults to a UI notification
      */
-    FileWatcher(const std::string& filepath, const std::string& directory);
+    FileWatcher(const std::string& filepath, Callback onChange = {});
 
     /**
      * @brief Destructor that ensures clean thread termination
@@ -28,32 +43,78 @@ class FileWatcher {
     ~FileWatcher();
 
     /**
-     * @brief Start the file watching thread
+     * @brief Arm the inotify watch and start the file watching thread
+     * @return false if inotify or epoll could not be set up
+     * @note The watch is active once this returns, not when the thread gets scheduled
      */
-    void start();
+    bool start();
 
     /**
-     * @brief Stop the file watching thread
+     * @brief Wake the file watching thread and wait for it to exit
+     * @note Returns as soon as the thread observes the shutdown eventfd
      */
     void stop();
 
+    /**
+     * @brief Replace the set of watched files
+     * @details Directories no longer holding a watched file stop being watched.
+     *          Files that do not exist yet are watched through their directory.
+     *          Files new to the set are hashed now; later changes are compared against that.
+     * @param files Paths as they should be reported to the callback
+     * @note Thread-safe; may be called before or after start()
+     */
+    void setFiles(const std::vector<std::string>& files);
+
+    /**
+     * @brief Number of times the watcher thread returned from epoll_wait
+     * @details Used to verify the thread stays asleep while nothing changes
+     */
+    uint64_t wakeups() const;
+
   private:
     /**
      * @brief Main monitoring loop using inotify
-     * @details This method contains the core logic for setting up inotify watches,
-     *          processing filesystem events, and handling errors.
+     * @details This method contains the core logic for processing filesystem
+     *          events and handling errors.
      */
     void watch();
 
-    /// @brief Full path to the target file being monitored
-    std::string m_filepath;
+    /// @brief Release the inotify, eventfd and epoll descriptors
+    void closeDescriptors();
+
+    /// @brief Bring the inotify watches in line with m_files; m_mutex must be held
+    void applyFiles();
 
-    /// @brief Directory path being watched for changes
-    std::string m_directory;
+    /// @brief Reported path of a file named @p name in the directory of @p wd, or nullptr
+    const std::string* lookup(int wd, const std::string& name) const;
+
+    /// @brief Guards m_files, m_watches and m_hashes
+    mutable std::mutex m_mutex;
+
+    /// @brief Files to watch, as reported to the callback
+    std::vector<std::string> m_files;
+
+    /// @brief Watch descriptor to file name in that directory to reported path
+    std::unordered_map<int, std::unordered_map<std::string, std::string>> m_watches;
+
+    /// @brief Content hash of each watched file when it was last reported or first watched; nullopt if unreadable
+    std::unordered_map<std::string, std::optional<uint64_t>> m_hashes;
+
+    /// @brief Change handler run on the watcher thread
+    Callback m_onChange;
 
     /// @brief Thread handle for the monitoring thread
     std::thread m_thread;
 
-    /// @brief Atomic flag to control the monitoring loop
-    std::atomic<bool> m_keepWatching;
+    /// @brief inotify instance holding one watch per directory in m_watches
+    int m_inotifyFd = -1;
+
+    /// @brief eventfd written by stop() to wake the thread
+    int m_stopFd = -1;
+
+    /// @brief epoll instance multiplexing m_inotifyFd and m_stopFd
+    int m_epollFd = -1;
+
+    /// @brief Count of epoll_wait returns, see wakeups()
+    std::atomic<uint64_t> m_wakeups = 0;
 };
@@ -0,0 +1,83 @@
+// bind_spec_test.cpp
+// Checks the keybind parser against Hyprland's bind syntax.
+#include "lua/bind_spec.hpp"
+#include "expect.hpp"
+
+#include <cstdio>
+#include <format>
+
+using hyprlua::BindSpec;
+namespace mod = hyprlua::mod;
+
+/// @brief Parse @p line, expecting success, and check it survives a round trip through to_string()
+static BindSpec parse_ok(const char* line) {
+    auto spec = hyprlua::parse_bind_line(line);
+    EXPECT(spec.has_value(), "'%s' failed: %s", line, spec ? "" : spec.error().c_str());
+    if (!spec) {
+        return {};
+    }
+
+    const auto text  = hyprlua::to_string(*spec);
+    auto       again = hyprlua::parse_bind_line(text);
+    EXPECT(again && *again == *spec, "'%s' did not round-trip through '%s'", line, text.c_str());
+    EXPECT(std::format("{}", *spec) == text, "'%s' formats differently from to_string()", line);
+    return *spec;
+}
+
+static void parse_fails(const char* line, const char* fragment) {
+    auto spec = hyprlua::parse_bind_line(line);
+    EXPECT(!spec.has_value(), "'%s' should not parse", line);
+    if (!spec) {
+        EXPECT(spec.error().find(fragment) != std::string::npos, "'%s': error '%s' does not mention '%s'", line, spec.error().c_str(), fragment);
+    }
+}
+
+int main() {
+    auto spec = parse_ok("binde = SUPER SHIFT, h, resizeactive, -50 0");
+    EXPECT(spec.mods == (mod::SUPER | mod::SHIFT), "mods %u", spec.mods);
+    EXPECT(spec.key == "h" && spec.dispatcher == "resizeactive" && spec.arg == "-50 0", "key %s dispatcher %s arg %s", spec.key.c_str(), spec.dispatcher.c_str(), spec.arg.c_str());
+    EXPECT(spec.repeat && !spec.locked, "flags");
+
+    // The argument keeps its commas
+    spec = parse_ok("bind = SUPER, Return, exec, foot -e sh -c 'a, b'");
+    EXPECT(spec.arg == "foot -e sh -c 'a, b'", "arg %s", spec.arg.c_str());
+
+    spec = parse_ok("bind = , XF86AudioMute, exec, wpctl set-mute @DEFAULT_SINK@ toggle");
+    EXPECT(spec.mods == 0, "no mods");
+
+    spec = parse_ok("bind = SUPER, q, killactive,");
+    EXPECT(spec.arg.empty(), "empty arg");
+    spec = parse_ok("bind = SUPER, q, killactive");
+    EXPECT(spec.dispatcher == "killactive", "dispatcher without arg");
+
+    spec = parse_ok("bindd = SUPER, q, Close the window, killactive,");
+    EXPECT(spec.description == "Close the window" && spec.dispatcher == "killactive", "description %s", spec.description.c_str());
+
+    spec = parse_ok("bindm = SUPER, mouse:272, movewindow");
+    EXPECT(spec.mouse && spec.key == "mouse:272", "mouse bind");
+
+    spec = parse_ok("bindlr = ctrl+alt, code:10, workspace, 1");
+    EXPECT(spec.mods == (mod::CTRL | mod::ALT) && spec.keycode == 10 && spec.key.empty(), "keycode %u", spec.keycode);
+    EXPECT(spec.locked && spec.release, "flags");
+
+    EXPECT(*hyprlua::parse_mods("WIN_MOD1") == (mod::SUPER | mod::ALT), "mod aliases");
+    EXPECT(*hyprlua::parse_mods("") == 0, "empty mods");
+
+    // Binds on the same keys share a trigger whatever their flags, so they are replaced together
+    EXPECT(hyprlua::trigger(parse_ok("bind = SUPER, h, movefocus, l")) == hyprlua::trigger(parse_ok("bindr = SUPER, h, exec, true")), "same trigger");
+    EXPECT(hyprlua::trigger(parse_ok("bind = SUPER, h, movefocus, l")) != hyprlua::trigger(parse_ok("bind = SUPER SHIFT, h, movefocus, l")), "different trigger");
+
+    parse_fails("bind = HYPER, h, exec, true", "unknown modifier");
+    parse_fails("bindx = SUPER, h, exec, true", "unknown bind flag");
+    parse_fails("binds = SUPER, a&b, exec, true", "not supported");
+    parse_fails("bind = SUPER, code:abc, exec, true", "invalid key");
+    parse_fails("bind = SUPER, , exec, true", "without a key");
+    parse_fails("bind = SUPER, h", "expected MODS");
+    parse_fails("bind = SUPER, h, , true", "without a dispatcher");
+    parse_fails("bindm = SUPER, mouse:272, exec", "mouse binds");
+    parse_fails("bind = , catchall, exec, true", "inside a submap");
+    parse_fails("unbind = SUPER, h", "invalid bind keyword");
+    parse_fails("SUPER, h, exec", "expected bind");
+
+    return failures == 0 ? 0 : 1;
+}
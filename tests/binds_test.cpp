@@ -0,0 +1,60 @@
+// binds_test.cpp
+// Reloads a config with a changed, an unchanged and a dropped bind, and checks that only the changed and
+// dropped ones are touched, that a hyprland.conf bind on the same trigger as a Hyprlua bind survives, and
+// that the binds come back after Hyprland reloads its own config.
+#include "lua/binds.hpp"
+#include "runtime_harness.hpp"
+#include "expect.hpp"
+
+#include <algorithm>
+
+static bool has_bind(const std::string& key, const std::string& handler, const std::string& arg) {
+    const auto binds = standin::keybinds();
+    return std::ranges::any_of(binds, [&](const SKeybind& kb) { return kb.key == key && kb.handler == handler && kb.arg == arg; });
+}
+
+int main() {
+    harness::Runtime runtime("binds");
+    // As if from hyprland.conf
+    g_pKeybindManager->addKeybind(SKeybind{.key = "q", .modmask = hyprlua::mod::SUPER, .handler = "killactive"});
+
+    runtime.write("hyprland.lua", "hypr.binds.set(\"SUPER\", \"q\", \"exec\", \"one\")\n"
+                                  "hypr.binds.set(\"SUPER\", \"w\", \"exec\", \"two\")\n"
+                                  "hypr.binds.set(\"SUPER\", \"e\", \"exec\", \"three\")\n");
+    EXPECT(runtime.start(), "config not applied");
+    EXPECT(standin::keybinds().size() == 4, "%zu binds", standin::keybinds().size());
+
+    // Nothing changed: Hyprland's bind list is not touched
+    const auto calls  = standin::keybindCalls();
+    auto       before = hyprlua::modules::bind_stats();
+    EXPECT(runtime.reload(), "unchanged reload not applied");
+    auto stats = hyprlua::modules::bind_stats();
+    EXPECT(standin::keybindCalls() == calls, "%llu keybind calls", static_cast<unsigned long long>(standin::keybindCalls() - calls));
+    EXPECT(stats.unchanged - before.unchanged == 3, "%llu unchanged", static_cast<unsigned long long>(stats.unchanged - before.unchanged));
+
+    // q changes, w stays, e goes
+    runtime.write("hyprland.lua", "hypr.binds.set(\"SUPER\", \"q\", \"exec\", \"four\")\n"
+                                  "hypr.binds.set(\"SUPER\", \"w\", \"exec\", \"two\")\n");
+    before = hyprlua::modules::bind_stats();
+    EXPECT(runtime.reload(), "edited reload not applied");
+    stats = hyprlua::modules::bind_stats();
+    EXPECT(stats.added - before.added == 1, "%llu added", static_cast<unsigned long long>(stats.added - before.added));
+    EXPECT(stats.removed - before.removed == 2, "%llu removed", static_cast<unsigned long long>(stats.removed - before.removed));
+    EXPECT(stats.unchanged - before.unchanged == 1, "%llu unchanged", static_cast<unsigned long long>(stats.unchanged - before.unchanged));
+
+    EXPECT(has_bind("q", "killactive", ""), "hyprland.conf bind on SUPER, q removed");
+    EXPECT(has_bind("q", "exec", "four"), "changed bind not added");
+    EXPECT(!has_bind("q", "exec", "one"), "old bind not removed");
+    EXPECT(has_bind("w", "exec", "two"), "unchanged bind removed");
+    EXPECT(!has_bind("e", "exec", "three"), "dropped bind not removed");
+    EXPECT(standin::keybinds().size() == 3, "%zu binds", standin::keybinds().size());
+
+    // Hyprland reloading hyprland.conf drops every bind; the hook adds Hyprlua's back
+    g_pKeybindManager->m_keybinds.clear();
+    g_pKeybindManager->addKeybind(SKeybind{.key = "q", .modmask = hyprlua::mod::SUPER, .handler = "killactive"});
+    standin::emit("configReloaded", {});
+    EXPECT(has_bind("q", "exec", "four") && has_bind("w", "exec", "two"), "binds not restored after a Hyprland reload");
+    EXPECT(standin::keybinds().size() == 3, "%zu binds after a Hyprland reload", standin::keybinds().size());
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+// conf_writer_test.cpp
+// Writes recorded ChangeSets as hyprland.conf and checks the order and that every line parses back.
+#include "lua/conf_writer.hpp"
+#include "expect.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace hyprlua;
+
+static void add_monitor(ChangeSet& changes, const char* line, std::vector<std::string> workspaces = {}) {
+    auto spec = parse_monitor_line(line);
+    EXPECT(spec.has_value(), "'%s' should parse", line);
+    if (spec) {
+        spec->workspaces = std::move(workspaces);
+        changes.monitors.push_back(std::make_shared<MonitorSpec>(std::move(*spec)));
+    }
+}
+
+static void add_bind(ChangeSet& changes, const char* line, const char* submap = "") {
+    auto spec = parse_bind_line(line, submap);
+    EXPECT(spec.has_value(), "'%s' should parse", line);
+    if (spec) {
+        changes.binds.push_back(std::move(*spec));
+    }
+}
+
+/// @brief The lines after the header comment, blank lines dropped
+static std::vector<std::string> body(const std::string& text) {
+    std::vector<std::string> lines;
+    std::istringstream       in(text);
+    for (std::string line; std::getline(in, line);) {
+        if (!line.empty() && !line.starts_with("# Generated")) {
+            lines.push_back(line);
+        }
+    }
+    return lines;
+}
+
+static std::string join(const std::vector<std::string>& lines) {
+    std::string out;
+    for (const auto& line : lines) {
+        out += line + "\n";
+    }
+    return out;
+}
+
+int main() {
+    ChangeSet changes;
+    add_monitor(changes, "DP-1, 1920x1080@60, 0x0, 1", {"1", "2"});
+    add_monitor(changes, "HDMI-A-1, preferred, auto, 1", {"3"});
+    // The last call for an output wins but keeps the output's place
+    add_monitor(changes, "DP-1, 2560x1440@144, 0x0, 1.5", {"1", "2"});
+    add_monitor(changes, "eDP-1, disable", {"9"});
+
+    add_bind(changes, "bind = SUPER, Return, exec, foot");
+    add_bind(changes, "binde = , l, resizeactive, 10 0", "resize");
+    add_bind(changes, "bind = , escape, submap, reset", "resize");
+    add_bind(changes, "bindm = SUPER, mouse:272, movewindow");
+    add_bind(changes, "bind = SUPER, x, hyprlua, 0");
+
+    std::ostringstream out;
+    const auto         stats = write_conf(changes, out, "hyprland.lua");
+    const auto         lines = body(out.str());
+
+    EXPECT(out.str().starts_with("# Generated by hyprlua-compile from hyprland.lua"), "header: %s", out.str().c_str());
+    EXPECT(stats.monitors == 3 && stats.workspaces == 3 && stats.binds == 4 && stats.luaBinds == 1, "stats %u %u %u %u", stats.monitors, stats.workspaces, stats.binds, stats.luaBinds);
+
+    const std::vector<std::string> expected = {
+        "monitor = DP-1,2560x1440@144,0x0,1.5",
+        "monitor = HDMI-A-1,preferred,auto,1",
+        "monitor = eDP-1,disable",
+        "workspace = 1,monitor:DP-1,default:true",
+        "workspace = 2,monitor:DP-1",
+        "workspace = 3,monitor:HDMI-A-1,default:true",
+        "bind = SUPER, Return, exec, foot",
+        "bindm = SUPER, mouse:272, movewindow, ",
+        "# SUPER, x: bound to a Lua function, which needs the plugin",
+        "submap = resize",
+        "binde = , l, resizeactive, 10 0",
+        "bind = , escape, submap, reset",
+        "submap = reset",
+    };
+    EXPECT(lines == expected, "got:\n%s", join(lines).c_str());
+
+    // Every written line reads back to the spec it came from
+    for (const auto& line : lines) {
+        if (line.starts_with("monitor = ")) {
+            EXPECT(parse_monitor_line(line.substr(10)).has_value(), "'%s' does not parse", line.c_str());
+        } else if (line.starts_with("bind")) {
+            EXPECT(parse_bind_line(line).has_value(), "'%s' does not parse", line.c_str());
+        }
+    }
+
+    // Writing is deterministic
+    std::ostringstream again;
+    write_conf(changes, again, "hyprland.lua");
+    EXPECT(again.str() == out.str(), "second write differs");
+
+    // Options come first, collapsed per key like monitors
+    ChangeSet options;
+    options.options = {{"general:gaps_in", int64_t{5}}, {"general:col.active_border", std::string("rgba(33ccffee) 45deg")}, {"decoration:active_opacity", 0.9}, {"general:gaps_in", int64_t{8}}};
+    add_monitor(options, "DP-1, preferred, auto, 1");
+    std::ostringstream             withOptions;
+    const auto                     optionStats     = write_conf(options, withOptions);
+    const std::vector<std::string> expectedOptions = {
+        "general:gaps_in = 8",
+        "general:col.active_border = rgba(33ccffee) 45deg",
+        "decoration:active_opacity = 0.9",
+        "monitor = DP-1,preferred,auto,1",
+    };
+    EXPECT(body(withOptions.str()) == expectedOptions, "got:\n%s", join(body(withOptions.str())).c_str());
+    EXPECT(optionStats.options == 3 && optionStats.monitors == 1, "stats %u %u", optionStats.options, optionStats.monitors);
+
+    // Window rules come last, one windowrulev2 line per action; rules with a when function are comments
+    ChangeSet      rules;
+    WindowRuleSpec firefox;
+    firefox.fields[static_cast<size_t>(RuleField::Class)] = *Matcher::compile("^firefox$");
+    firefox.fields[static_cast<size_t>(RuleField::Title)] = *Matcher::compile("Picture-in-Picture");
+    firefox.actions = {*parse_rule_action("float"), *parse_rule_action("pin")};
+    WindowRuleSpec steam;
+    steam.fields[static_cast<size_t>(RuleField::InitialClass)] = *Matcher::compile("^steam$");
+    steam.actions   = {*parse_rule_action("workspace 5 silent")};
+    steam.predicate = 0;
+    rules.rules     = {firefox, steam};
+    std::ostringstream             withRules;
+    const auto                     ruleStats     = write_conf(rules, withRules);
+    const std::vector<std::string> expectedRules = {
+        "windowrulev2 = float, class:^firefox$, title:Picture-in-Picture",
+        "windowrulev2 = pin, class:^firefox$, title:Picture-in-Picture",
+        "# windowrulev2 = workspace 5 silent, initialClass:^steam$: also has a Lua when function, which needs the plugin",
+    };
+    EXPECT(body(withRules.str()) == expectedRules, "got:\n%s", join(body(withRules.str())).c_str());
+    EXPECT(ruleStats.rules == 1 && ruleStats.luaRules == 1, "stats %u %u", ruleStats.rules, ruleStats.luaRules);
+
+    // An empty config is just the header
+    std::ostringstream empty;
+    const auto         none = write_conf(ChangeSet{}, empty);
+    EXPECT(body(empty.str()).empty() && none.monitors == 0 && none.binds == 0, "empty config wrote:\n%s", empty.str().c_str());
+
+    return failures == 0 ? 0 : 1;
+}
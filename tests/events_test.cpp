@@ -0,0 +1,42 @@
+// events_test.cpp
+// Emits bursts of workspace events at a config with an immediate and a debounced hypr.on handler, and checks
+// that the immediate one gets each burst as one batch per event loop iteration and the debounced one gets
+// every event of both bursts in a single call once they stopped.
+#include "runtime_harness.hpp"
+#include "expect.hpp"
+
+#include <chrono>
+
+int main() {
+    harness::Runtime runtime("events");
+    const auto       monitor   = standin::addMonitor("DP-1");
+    const auto       workspace = standin::addWorkspace(1, "1", monitor);
+
+    // Each handler appends the size of every batch it gets; the next run publishes both lists through a bind
+    runtime.write("hyprland.lua", "hypr.binds.set(\"SUPER\", \"l\", \"exec\", hypr.store.get(\"immediate\", \"\") .. \"|\" .. hypr.store.get(\"debounced\", \"\"))\n"
+                                  "hypr.on(\"workspace\", function(events)\n"
+                                  "  hypr.store.set(\"immediate\", hypr.store.get(\"immediate\", \"\") .. #events .. \",\")\n"
+                                  "end)\n"
+                                  "hypr.on(\"workspace\", function(events)\n"
+                                  "  hypr.store.set(\"debounced\", hypr.store.get(\"debounced\", \"\") .. #events .. \",\")\n"
+                                  "end, { debounce_ms = 100 })\n");
+    EXPECT(runtime.start(), "config not applied");
+
+    for (int i = 0; i < 3; ++i) {
+        standin::emit("workspace", workspace);
+    }
+    runtime.dispatch();
+    for (int i = 0; i < 2; ++i) {
+        standin::emit("workspace", workspace);
+    }
+    const auto quiet = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+    while (std::chrono::steady_clock::now() < quiet) {
+        runtime.dispatch();
+    }
+
+    EXPECT(runtime.reload(), "reload not applied");
+    const auto published = harness::bind_arg("l");
+    EXPECT(published == "3,2,|5,", "batches '%s'", published ? published->c_str() : "(no bind)");
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,25 @@
+// expect.hpp
+#pragma once
+
+#include <cstdio>
+
+/**
+ * @file expect.hpp
+ * @brief The check every headless test uses
+ * @details A failed EXPECT prints the condition and a printf-style message and
+ *          counts the failure; main() returns failures == 0 ? 0 : 1, so one run
+ *          reports every failed check instead of stopping at the first.
+ */
+
+/// @brief Failed checks so far in this test binary
+inline int failures = 0;
+
+#define EXPECT(cond, ...)                                                                                                                                                          \
+    do {                                                                                                                                                                           \
+        if (!(cond)) {                                                                                                                                                             \
+            std::fprintf(stderr, "FAIL %s:%d: %s: ", __FILE__, __LINE__, #cond);                                                                                                   \
+            std::fprintf(stderr, __VA_ARGS__);                                                                                                                                     \
+            std::fputc('\n', stderr);                                                                                                                                              \
+            ++failures;                                                                                                                                                            \
+        }                                                                                                                                                                          \
+    } while (0)
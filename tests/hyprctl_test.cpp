@@ -0,0 +1,76 @@
+// hyprctl_test.cpp
+// Runs `hyprctl hyprlua stats` against a loaded config and checks that the reply is JSON with every section filled in.
+#include "eventloop.hpp"
+#include "globals.hpp"
+#include "hyprctl.hpp"
+#include "logger.hpp"
+#include "utils.hpp"
+#include "lua/runtime.hpp"
+#include "standin.hpp"
+#include "expect.hpp"
+#include "json_parse.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <wayland-server-core.h>
+
+namespace fs = std::filesystem;
+
+int main() {
+    const auto root = fs::temp_directory_path() / ("hyprlua-hyprctl-test-" + std::to_string(getpid()));
+    fs::create_directories(root);
+    setenv("XDG_CACHE_HOME", (root / "cache").c_str(), 1);
+    setenv("HYPRLUA_STORE_PATH", (root / "store.bin").c_str(), 1);
+
+    hyprlua::log::setLevel(hyprlua::log::Level::Off);
+    standin::reset();
+    standin::addMonitor("DP-1");
+    auto* loop                   = wl_event_loop_create();
+    g_pCompositor->m_wlEventLoop = loop;
+    hyprlua::eventloop::init(loop);
+    PHANDLE = reinterpret_cast<HANDLE>(1);
+
+    // A quote in the source path has to come out escaped in "callbacks"
+    const auto config = root / "hypr \"land\".lua";
+    std::ofstream(config) << "hypr.monitors.add(\"DP-1\", \"1920x1080@60\", \"0x0\", 1)\n"
+                             "hypr.binds.set(\"SUPER\", \"x\", function() end)\n"
+                             "hypr.store.set(\"loaded\", true)\n";
+    hyprlua::init_lua_runtime(HYPRLUA_RUNTIME_MODULES, config.string());
+    while (!hyprlua::config_loaded()) {
+        wl_event_loop_dispatch(loop, 10);
+    }
+    hyprlua::hyprctl::registerCommands();
+
+    const auto reply = standin::hyprctl("hyprlua stats");
+    const auto doc   = parse_json(reply);
+    EXPECT(doc.has_value(), "reply is not JSON: %s", reply.c_str());
+    if (doc) {
+        for (const char* section : {"phases", "monitors", "binds", "options", "rules", "timers", "store", "memory", "modules", "watchdog", "log"}) {
+            EXPECT(doc->get(section) && doc->get(section)->type == JsonValue::Type::Object, "%s missing", section);
+        }
+        EXPECT(doc->get("monitors") && doc->get("monitors")->get("applied") && doc->get("monitors")->get("applied")->number == 1, "monitor not counted");
+        EXPECT(doc->get("store") && doc->get("store")->get("keys") && doc->get("store")->get("keys")->number == 1, "store key not counted");
+        EXPECT(doc->get("store") && doc->get("store")->get("persist") && doc->get("store")->get("persist")->type == JsonValue::Type::Bool, "persist not a boolean");
+        EXPECT(doc->get("memory") && doc->get("memory")->get("bytes") && doc->get("memory")->get("bytes")->number > 0, "memory not reported");
+
+        const auto* callbacks = doc->get("callbacks");
+        EXPECT(callbacks && callbacks->type == JsonValue::Type::Array && callbacks->array.size() == 1, "bind callback missing");
+        if (callbacks && callbacks->array.size() == 1) {
+            const auto* source = callbacks->array[0].get("source");
+            EXPECT(source && source->string.find("hypr \"land\".lua") != std::string::npos, "source %s", source ? source->string.c_str() : "missing");
+        }
+    }
+    EXPECT(standin::hyprctl("hyprlua bogus").starts_with("usage:"), "unknown subcommand not answered with the usage");
+
+    hyprlua::hyprctl::unregisterCommands();
+    hyprlua::shutdown_lua_runtime();
+    hyprlua::eventloop::shutdown();
+    shutdownNotifications();
+    wl_event_loop_destroy(loop);
+    std::error_code ec;
+    fs::remove_all(root, ec);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,225 @@
+// json_parse.hpp
+#pragma once
+
+#include <cctype>
+#include <charconv>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @file json_parse.hpp
+ * @brief A strict JSON reader for checking the plugin's JSON output in tests
+ * @details Accepts exactly RFC 8259 documents; anything else, trailing text
+ *          included, is refused. \\u escapes outside ASCII are kept as '?'.
+ */
+
+struct JsonValue {
+    enum class Type {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object,
+    };
+
+    Type                             type    = Type::Null;
+    bool                             boolean = false;
+    double                           number  = 0;
+    std::string                      string{};
+    std::vector<JsonValue>           array{};
+    std::map<std::string, JsonValue> object{};
+
+    /// @brief Member @p key of an object, or nullptr
+    const JsonValue* get(const std::string& key) const {
+        const auto it = object.find(key);
+        return type == Type::Object && it != object.end() ? &it->second : nullptr;
+    }
+};
+
+namespace json_parse_detail {
+
+    struct Reader {
+        std::string_view text;
+        size_t           pos = 0;
+
+        void             skip() {
+            while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+                ++pos;
+            }
+        }
+
+        bool take(std::string_view word) {
+            if (text.substr(pos, word.size()) != word) {
+                return false;
+            }
+            pos += word.size();
+            return true;
+        }
+
+        std::optional<std::string> string() {
+            if (!take("\"")) {
+                return std::nullopt;
+            }
+            std::string out;
+            while (pos < text.size()) {
+                const char c = text[pos++];
+                if (c == '"') {
+                    return out;
+                }
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    return std::nullopt;
+                }
+                if (c != '\\') {
+                    out += c;
+                    continue;
+                }
+                if (pos >= text.size()) {
+                    return std::nullopt;
+                }
+                switch (const char e = text[pos++]; e) {
+                    case '"':
+                    case '\\':
+                    case '/': out += e; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'n': out += '\n'; break;
+                    case 'r': out += '\r'; break;
+                    case 't': out += '\t'; break;
+                    case 'u': {
+                        unsigned code = 0;
+                        const auto digits = text.substr(pos, 4);
+                        if (digits.size() != 4 || std::from_chars(digits.data(), digits.data() + 4, code, 16).ptr != digits.data() + 4) {
+                            return std::nullopt;
+                        }
+                        pos += 4;
+                        out += code < 0x80 ? static_cast<char>(code) : '?';
+                        break;
+                    }
+                    default: return std::nullopt;
+                }
+            }
+            return std::nullopt;
+        }
+
+        std::optional<double> number() {
+            const auto digits = [&] {
+                const size_t first = pos;
+                while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) {
+                    ++pos;
+                }
+                return pos > first;
+            };
+            const size_t start = pos;
+            take("-");
+            // No leading zeros: "0" stands alone, "01" leaves the "1" as trailing text
+            if (!take("0") && !digits()) {
+                return std::nullopt;
+            }
+            if (take(".") && !digits()) {
+                return std::nullopt;
+            }
+            if (take("e") || take("E")) {
+                if (!take("+")) {
+                    take("-");
+                }
+                if (!digits()) {
+                    return std::nullopt;
+                }
+            }
+            double value = 0;
+            std::from_chars(text.data() + start, text.data() + pos, value);
+            return value;
+        }
+
+        std::optional<JsonValue> value(int depth) {
+            skip();
+            if (depth > 64 || pos >= text.size()) {
+                return std::nullopt;
+            }
+            JsonValue out;
+            if (take("null")) {
+                return out;
+            }
+            if (take("true")) {
+                out.type    = JsonValue::Type::Bool;
+                out.boolean = true;
+                return out;
+            }
+            if (take("false")) {
+                out.type = JsonValue::Type::Bool;
+                return out;
+            }
+            if (text[pos] == '"') {
+                auto s = string();
+                if (!s) {
+                    return std::nullopt;
+                }
+                out.type   = JsonValue::Type::String;
+                out.string = std::move(*s);
+                return out;
+            }
+            if (take("[")) {
+                out.type = JsonValue::Type::Array;
+                skip();
+                if (take("]")) {
+                    return out;
+                }
+                do {
+                    auto element = value(depth + 1);
+                    if (!element) {
+                        return std::nullopt;
+                    }
+                    out.array.push_back(std::move(*element));
+                    skip();
+                } while (take(","));
+                return take("]") ? std::optional(std::move(out)) : std::nullopt;
+            }
+            if (take("{")) {
+                out.type = JsonValue::Type::Object;
+                skip();
+                if (take("}")) {
+                    return out;
+                }
+                do {
+                    skip();
+                    auto key = string();
+                    skip();
+                    if (!key || !take(":")) {
+                        return std::nullopt;
+                    }
+                    auto member = value(depth + 1);
+                    if (!member || out.object.contains(*key)) {
+                        return std::nullopt;
+                    }
+                    out.object.emplace(std::move(*key), std::move(*member));
+                    skip();
+                } while (take(","));
+                return take("}") ? std::optional(std::move(out)) : std::nullopt;
+            }
+            auto n = number();
+            if (!n) {
+                return std::nullopt;
+            }
+            out.type   = JsonValue::Type::Number;
+            out.number = *n;
+            return out;
+        }
+    };
+
+}
+
+/// @brief The document in @p text, or std::nullopt if it is not valid JSON; duplicate keys are refused too
+inline std::optional<JsonValue> parse_json(std::string_view text) {
+    json_parse_detail::Reader reader{text};
+    auto                      value = reader.value(0);
+    reader.skip();
+    if (!value || reader.pos != text.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
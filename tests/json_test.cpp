@@ -0,0 +1,64 @@
+// json_test.cpp
+// Checks that json::Writer places commas and quotes so its output parses back to what was written.
+#include "json.hpp"
+#include "expect.hpp"
+#include "json_parse.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+using namespace hyprlua;
+
+static void test_writer() {
+    json::Writer w;
+    w.beginObject().field("count", uint64_t{18446744073709551615u}).field("offset", -3).field("on", true).field("ratio", 0.25);
+    w.field("name", "DP-1 \"main\"\n\x01").field("empty", std::string_view{});
+    w.beginObject("nested").field("inner", false).end();
+    w.beginObject("none").end();
+    w.beginArray("list").field("ignored", 1).field("", "two").beginObject().field("three", 3).end().end();
+    w.beginArray("nothing").end();
+    w.raw("phases", "{\"load\": {\"count\": 1}}");
+    w.field("nan", std::numeric_limits<double>::quiet_NaN());
+    w.end();
+
+    const auto doc = parse_json(w.str());
+    EXPECT(doc.has_value(), "not JSON: %s", w.str().c_str());
+    if (!doc) {
+        return;
+    }
+    EXPECT(doc->object.size() == 12, "members %zu", doc->object.size());
+    EXPECT(doc->get("count")->number == 18446744073709551615.0, "count %f", doc->get("count")->number);
+    EXPECT(doc->get("offset")->number == -3, "offset %f", doc->get("offset")->number);
+    EXPECT(doc->get("on")->type == JsonValue::Type::Bool && doc->get("on")->boolean, "on not true");
+    EXPECT(doc->get("ratio")->number == 0.25, "ratio %f", doc->get("ratio")->number);
+    EXPECT(doc->get("name")->string == "DP-1 \"main\"\n\x01", "name %s", doc->get("name")->string.c_str());
+    EXPECT(doc->get("empty")->type == JsonValue::Type::String && doc->get("empty")->string.empty(), "empty string lost");
+    EXPECT(doc->get("nested")->get("inner")->type == JsonValue::Type::Bool && !doc->get("nested")->get("inner")->boolean, "nested lost");
+    EXPECT(doc->get("none")->type == JsonValue::Type::Object && doc->get("none")->object.empty(), "empty object lost");
+
+    const auto& list = doc->get("list")->array;
+    EXPECT(list.size() == 3, "list %zu", list.size());
+    EXPECT(list.size() == 3 && list[0].number == 1 && list[1].string == "two" && list[2].get("three")->number == 3, "list elements wrong");
+    EXPECT(doc->get("nothing")->type == JsonValue::Type::Array && doc->get("nothing")->array.empty(), "empty array lost");
+    EXPECT(doc->get("phases")->get("load")->get("count")->number == 1, "raw member lost");
+    EXPECT(doc->get("nan")->type == JsonValue::Type::Null, "NaN not written as null");
+}
+
+/// @brief The reader used by the other tests refuses what is not JSON
+static void test_parser() {
+    EXPECT(parse_json("{\"a\": [1, 2.5e3, -0.5, null]}").has_value(), "valid document refused");
+    EXPECT(!parse_json("{\"a\": 1,}"), "trailing comma accepted");
+    EXPECT(!parse_json("{\"a\": 1 \"b\": 2}"), "missing comma accepted");
+    EXPECT(!parse_json("{\"a\": 1, \"a\": 2}"), "duplicate key accepted");
+    EXPECT(!parse_json("{\"a\": nan}"), "nan accepted");
+    EXPECT(!parse_json("{\"a\": \"\n\"}"), "raw newline in a string accepted");
+    EXPECT(!parse_json("{} {}"), "trailing text accepted");
+    EXPECT(!parse_json("01"), "leading zero accepted");
+}
+
+int main() {
+    test_writer();
+    test_parser();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+// lua_allocator_test.cpp
+// Drives the Lua allocator the way lua_Alloc is called and checks its accounting.
+#include "lua/allocator.hpp"
+#include "expect.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using hyprlua::LuaAllocator;
+
+/// @brief Small blocks are reused from the free lists and resizes keep their contents
+static void test_pools() {
+    LuaAllocator alloc;
+
+    // Lua passes the object type as osize for new blocks
+    void* a = LuaAllocator::lua_alloc(&alloc, nullptr, 5, 24);
+    EXPECT(a != nullptr, "small allocation");
+    EXPECT(alloc.stats().bytes == 24 && alloc.stats().poolBytes == LuaAllocator::CHUNK, "bytes %llu", (unsigned long long)alloc.stats().bytes);
+    std::memset(a, 0x5a, 24);
+
+    // Within the same size class the block stays where it is
+    void* same = alloc.reallocate(a, 24, 30);
+    EXPECT(same == a && alloc.stats().bytes == 30, "resize in place");
+
+    // Across classes it moves and keeps its contents
+    void* grown = alloc.reallocate(same, 30, 200);
+    EXPECT(grown != nullptr && grown != a, "resize across classes");
+    EXPECT(static_cast<unsigned char*>(grown)[23] == 0x5a, "contents kept");
+
+    alloc.reallocate(grown, 200, 0);
+    EXPECT(alloc.stats().bytes == 0, "everything freed, %llu left", (unsigned long long)alloc.stats().bytes);
+
+    // A freed block of a class is the next one handed out for it
+    void* b = alloc.reallocate(nullptr, 0, 200);
+    EXPECT(b == grown, "free list reuse");
+    alloc.reallocate(b, 200, 0);
+
+    // Many small blocks fit in one chunk
+    std::vector<void*> blocks;
+    for (int i = 0; i < 1000; ++i) {
+        blocks.push_back(alloc.reallocate(nullptr, 0, 32));
+    }
+    EXPECT(alloc.stats().poolBytes == LuaAllocator::CHUNK, "one chunk for 1000 blocks, %llu bytes", (unsigned long long)alloc.stats().poolBytes);
+    for (void* block : blocks) {
+        alloc.reallocate(block, 32, 0);
+    }
+    EXPECT(alloc.stats().allocations == alloc.stats().frees, "%llu allocations, %llu frees", (unsigned long long)alloc.stats().allocations, (unsigned long long)alloc.stats().frees);
+}
+
+/// @brief Blocks larger than the pools go to malloc and are accounted separately
+static void test_large() {
+    LuaAllocator alloc;
+
+    void*        big = alloc.reallocate(nullptr, 0, 4096);
+    EXPECT(big != nullptr && alloc.stats().largeBytes == 4096 && alloc.stats().poolBytes == 0, "large allocation");
+    std::memset(big, 1, 4096);
+
+    big = alloc.reallocate(big, 4096, 100000);
+    EXPECT(big != nullptr && alloc.stats().largeBytes == 100000, "large resize");
+
+    // Shrinking into the pools moves the block
+    void* small = alloc.reallocate(big, 100000, 64);
+    EXPECT(small != nullptr && alloc.stats().largeBytes == 0 && static_cast<unsigned char*>(small)[63] == 1, "shrink into pools");
+    alloc.reallocate(small, 64, 0);
+    EXPECT(alloc.stats().peakBytes == 100000, "peak %llu", (unsigned long long)alloc.stats().peakBytes);
+}
+
+/// @brief The limit refuses growth, never shrinking or freeing
+static void test_limit() {
+    LuaAllocator alloc(10000);
+
+    void*        a = alloc.reallocate(nullptr, 0, 8000);
+    EXPECT(a != nullptr, "within the limit");
+    EXPECT(alloc.reallocate(nullptr, 0, 4000) == nullptr, "over the limit");
+    EXPECT(alloc.reallocate(a, 8000, 12000) == nullptr, "growth over the limit");
+    EXPECT(alloc.stats().limitHits == 2 && alloc.stats().bytes == 8000, "hits %llu", (unsigned long long)alloc.stats().limitHits);
+
+    // A refused growth leaves the old block valid
+    a = alloc.reallocate(a, 8000, 1000);
+    EXPECT(a != nullptr && alloc.stats().bytes == 1000, "shrink");
+    EXPECT(alloc.reallocate(nullptr, 0, 4000) != nullptr, "room again after shrinking");
+}
+
+/// @brief The memory limit comes from the environment, in MiB
+static void test_default_limit() {
+    setenv("HYPRLUA_LUA_MEMORY_MB", "64", 1);
+    EXPECT(LuaAllocator::defaultLimit() == 64u * 1024 * 1024, "64 MiB");
+    setenv("HYPRLUA_LUA_MEMORY_MB", "0", 1);
+    EXPECT(LuaAllocator::defaultLimit() == 0, "0 disables the limit");
+    setenv("HYPRLUA_LUA_MEMORY_MB", "lots", 1);
+    EXPECT(LuaAllocator::defaultLimit() == 256u * 1024 * 1024, "garbage falls back to the default");
+    unsetenv("HYPRLUA_LUA_MEMORY_MB");
+}
+
+int main() {
+    test_pools();
+    test_large();
+    test_limit();
+    test_default_limit();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+// module_graph_test.cpp
+// Reloads a config split into modules and checks which of them run again: unchanged modules without side
+// effects are replayed, an edited or invalidated dependency runs again together with the module that
+// required it, and a module that reads a config global, registers a function or changes shared values always runs.
+#include "lua/runtime.hpp"
+#include "runtime_harness.hpp"
+#include "expect.hpp"
+
+static void expect_stats(uint32_t executed, uint32_t replayed, const char* when) {
+    const auto stats = hyprlua::module_stats();
+    EXPECT(stats.executed == executed && stats.replayed == replayed, "%s: executed %u, replayed %u", when, stats.executed, stats.replayed);
+}
+
+int main() {
+    harness::Runtime runtime("module-graph");
+
+    runtime.write("data.lua", "return { gap = 5 }\n");
+    const auto child = runtime.write("child.lua", "return { value = 1 }\n");
+    runtime.write("parent.lua", "local child = require(\"child\")\n"
+                                "return { value = child.value + 1 }\n");
+    runtime.write("reads.lua", "return { value = CONFIG_VALUE }\n");
+    runtime.write("registers.lua", "hypr.binds.set(\"SUPER\", \"r\", function() end)\n");
+    runtime.write("extends.lua", "function string.hyprlua_echo(s) return s end\n");
+    runtime.write("mutates.lua", "require(\"data\").mutated = true\n");
+    runtime.write("hyprland.lua", "CONFIG_VALUE = 7\n"
+                                  "local data = require(\"data\")\n"
+                                  "assert(data.gap == 5)\n"
+                                  "assert(require(\"parent\").value == require(\"child\").value + 1, \"parent is stale\")\n"
+                                  "assert(require(\"reads\").value == 7, \"reads is stale\")\n"
+                                  "require(\"registers\")\n"
+                                  "require(\"extends\")\n"
+                                  "assert(string.hyprlua_echo(\"x\") == \"x\", \"extends did not run\")\n"
+                                  "require(\"mutates\")\n"
+                                  "assert(data.mutated, \"mutates did not run\")\n");
+    EXPECT(runtime.start(), "config not applied");
+    expect_stats(7, 0, "first load");
+
+    // data and parent, which brings child along, are rebuilt; the other four have side effects and run
+    EXPECT(runtime.reload(), "unchanged reload not applied");
+    expect_stats(4, 2, "unchanged");
+
+    // An edited dependency runs again, and so does the module that required it
+    runtime.write("child.lua", "return { value = 2 }\n");
+    EXPECT(runtime.reload(), "reload after editing child.lua not applied");
+    expect_stats(6, 1, "child edited");
+
+    // Reported by the watcher without an edit: invalidate() reaches parent through child
+    EXPECT(runtime.reload(child), "reload after invalidating child.lua not applied");
+    expect_stats(6, 1, "child invalidated");
+
+    EXPECT(runtime.reload(), "settled reload not applied");
+    expect_stats(4, 2, "settled");
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,66 @@
+// monitor_index_test.cpp
+// Resolves monitor rule names against an index of outputs: names, prefixes, desc: and serial:.
+#include "lua/monitor_index.hpp"
+#include "expect.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using hyprlua::MonitorIndex;
+
+static std::string show(const std::vector<size_t>& found) {
+    std::string out;
+    for (const auto i : found) {
+        out += (out.empty() ? "" : ",") + std::to_string(i);
+    }
+    return "[" + out + "]";
+}
+
+static void expect_match(const MonitorIndex& index, const char* selector, const std::vector<size_t>& expected) {
+    const auto found = index.match(selector);
+    EXPECT(found == expected, "'%s' matched %s, expected %s", selector, show(found).c_str(), show(expected).c_str());
+}
+
+int main() {
+    EXPECT(MonitorIndex::serial_of("Dell Inc. DELL U2720Q 1234ABCD") == "1234ABCD", "serial %s", MonitorIndex::serial_of("Dell Inc. DELL U2720Q 1234ABCD").c_str());
+    EXPECT(MonitorIndex::serial_of("LG Electronics 27GL850 0x0001 ") == "0x0001", "trailing space");
+    EXPECT(MonitorIndex::serial_of("Unknown").empty(), "one word has no serial");
+
+    MonitorIndex index;
+    index.rebuild({
+        {"eDP-1", "BOE 0x0BCA 0x0000", "0x0000"},
+        {"DP-2", "Dell Inc. DELL U2720Q 1234ABCD", "1234ABCD"},
+        {"DP-1", "Dell Inc. DELL U2720Q 5678EFGH", "5678EFGH"},
+        {"HDMI-A-1", "LG Electronics 27GL850 0x0001", "0x0001"},
+    });
+
+    // Names are exact
+    expect_match(index, "DP-1", {2});
+    expect_match(index, "DP", {});
+    expect_match(index, "DP-3", {});
+
+    // A trailing '*' selects every output whose name starts with the rest, in output order
+    expect_match(index, "DP-*", {1, 2});
+    expect_match(index, "*", {0, 1, 2, 3});
+    expect_match(index, "VGA-*", {});
+
+    // desc: is a prefix of the description and selects the first output in output order, as in Hyprland
+    expect_match(index, "desc:Dell Inc. DELL U2720Q", {1});
+    expect_match(index, "desc:Dell Inc. DELL U2720Q 5678", {2});
+    expect_match(index, "desc:LG Electronics 27GL850 0x0001", {3});
+    expect_match(index, "desc:Samsung", {});
+
+    // serial: is exact
+    expect_match(index, "serial:5678EFGH", {2});
+    expect_match(index, "serial:5678", {});
+
+    // A rebuild replaces the outputs entirely, as after a hotplug
+    index.rebuild({{"DP-1", "Dell Inc. DELL U2720Q 5678EFGH", "5678EFGH"}});
+    expect_match(index, "DP-1", {0});
+    expect_match(index, "DP-2", {});
+    expect_match(index, "serial:1234ABCD", {});
+    EXPECT(index.outputs().size() == 1 && index.outputs()[0].name == "DP-1", "outputs after rebuild");
+
+    return failures == 0 ? 0 : 1;
+}
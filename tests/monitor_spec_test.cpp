@@ -0,0 +1,74 @@
+// monitor_spec_test.cpp
+// Checks the monitor rule parser against Hyprland's monitor syntax.
+#include "lua/monitor_spec.hpp"
+#include "expect.hpp"
+
+#include <cstdio>
+#include <format>
+
+using hyprlua::MonitorSpec;
+
+/// @brief Parse @p line, expecting success, and check it survives a round trip through to_string()
+static MonitorSpec parse_ok(const char* line) {
+    auto spec = hyprlua::parse_monitor_line(line);
+    EXPECT(spec.has_value(), "'%s' failed: %s", line, spec ? "" : spec.error().c_str());
+    if (!spec) {
+        return {};
+    }
+
+    const auto text  = hyprlua::to_string(*spec);
+    auto       again = hyprlua::parse_monitor_line(text);
+    EXPECT(again && *again == *spec, "'%s' did not round-trip through '%s'", line, text.c_str());
+    EXPECT(std::format("{}", *spec) == text, "'%s' formats differently from to_string()", line);
+    return *spec;
+}
+
+static void parse_fails(const char* line, const char* fragment) {
+    auto spec = hyprlua::parse_monitor_line(line);
+    EXPECT(!spec.has_value(), "'%s' should not parse", line);
+    if (!spec) {
+        EXPECT(spec.error().find(fragment) != std::string::npos, "'%s': error '%s' does not mention '%s'", line, spec.error().c_str(), fragment);
+    }
+}
+
+int main() {
+    auto spec = parse_ok("DP-1, 2560x1440@143.97, 1920x0, 1.25");
+    EXPECT(spec.name == "DP-1", "name %s", spec.name.c_str());
+    EXPECT(spec.mode == MonitorSpec::Mode::Explicit && spec.width == 2560 && spec.height == 1440, "resolution %dx%d", spec.width, spec.height);
+    EXPECT(spec.refresh == 143.97, "refresh %f", spec.refresh);
+    EXPECT(spec.placement == MonitorSpec::Placement::Explicit && spec.x == 1920 && spec.y == 0, "position %dx%d", spec.x, spec.y);
+    EXPECT(spec.scale && *spec.scale == 1.25, "scale");
+
+    spec = parse_ok("desc:LG Electronics 0x1234,preferred,auto,auto");
+    EXPECT(spec.name == "desc:LG Electronics 0x1234", "name %s", spec.name.c_str());
+    EXPECT(spec.mode == MonitorSpec::Mode::Preferred, "preferred");
+    EXPECT(spec.placement == MonitorSpec::Placement::AutoRight, "auto");
+    EXPECT(!spec.scale, "auto scale");
+
+    spec = parse_ok("eDP-1,highrr,auto-center-left,2,transform,3,mirror,DP-1,bitdepth,10,vrr,2");
+    EXPECT(spec.mode == MonitorSpec::Mode::HighRR, "highrr");
+    EXPECT(spec.placement == MonitorSpec::Placement::AutoCenterLeft, "auto-center-left");
+    EXPECT(spec.transform == 3 && spec.mirror == "DP-1" && spec.bitdepth == 10 && spec.vrr == 2, "options");
+
+    parse_ok("HDMI-A-1,1920x1080@60Hz,-1920x-200,1");
+    parse_ok("HDMI-A-1,maxwidth,auto-down,1");
+
+    spec = parse_ok("DP-2, disable");
+    EXPECT(spec.disabled, "disable");
+
+    // Anything not understood is an error, never a default
+    parse_fails("DP-1,1920x,0x0,1", "invalid resolution");
+    parse_fails("DP-1,1920x1080@fast,0x0,1", "invalid resolution");
+    parse_fails("DP-1,prefered,0x0,1", "invalid resolution");
+    parse_fails("DP-1,preferred,0x0x0,1", "invalid position");
+    parse_fails("DP-1,preferred,auto-sideways,1", "invalid position");
+    parse_fails("DP-1,preferred,auto,0", "invalid scale");
+    parse_fails("DP-1,preferred,auto,1,transform,8", "invalid transform");
+    parse_fails("DP-1,preferred,auto,1,bitdepth,12", "invalid bitdepth");
+    parse_fails("DP-1,preferred,auto,1,vrr", "has no value");
+    parse_fails("DP-1,preferred,auto,1,hdr,1", "unknown monitor option");
+    parse_fails("DP-1,preferred", "expected NAME");
+    parse_fails(",preferred,auto,1", "without an output name");
+
+    return failures == 0 ? 0 : 1;
+}
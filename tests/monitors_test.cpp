@@ -0,0 +1,45 @@
+// monitors_test.cpp
+// Applies a monitor rule through the runtime and checks that an unchanged reload leaves the output and its
+// workspace rules alone, that a workspace dropped from the rule is released, and that the rule and its
+// workspaces are applied again after Hyprland reloads its own config.
+#include "runtime_harness.hpp"
+#include "expect.hpp"
+
+#include <string>
+#include <vector>
+
+/// @brief Check the keywords set so far, workspace rules being the only ones this config sets
+static void expect_keywords(const std::vector<std::string>& expected, const char* when) {
+    const auto keywords = standin::parsedKeywords();
+    EXPECT(keywords == expected, "%s: %zu keywords, last '%s'", when, keywords.size(), keywords.empty() ? "" : keywords.back().c_str());
+}
+
+int main() {
+    harness::Runtime runtime("monitors");
+    standin::addMonitor("DP-1");
+
+    runtime.write("hyprland.lua", "hypr.monitors.add(\"DP-1\", \"1920x1080@60\", \"0x0\", 1, { 1, 2 })\n");
+    EXPECT(runtime.start(), "config not applied");
+    EXPECT(standin::rulesApplied() == 1, "%llu rules applied", static_cast<unsigned long long>(standin::rulesApplied()));
+    expect_keywords({"workspace 1,monitor:DP-1,default:true", "workspace 2,monitor:DP-1"}, "first load");
+
+    EXPECT(runtime.reload(), "unchanged reload not applied");
+    EXPECT(standin::rulesApplied() == 1, "%llu rules applied after an unchanged reload", static_cast<unsigned long long>(standin::rulesApplied()));
+    expect_keywords({"workspace 1,monitor:DP-1,default:true", "workspace 2,monitor:DP-1"}, "unchanged reload");
+
+    // Workspace 1 keeps its rule, 2 is released
+    runtime.write("hyprland.lua", "hypr.monitors.add(\"DP-1\", \"1920x1080@60\", \"0x0\", 1, { 1 })\n");
+    EXPECT(runtime.reload(), "edited reload not applied");
+    EXPECT(standin::rulesApplied() == 2, "%llu rules applied after an edited reload", static_cast<unsigned long long>(standin::rulesApplied()));
+    expect_keywords({"workspace 1,monitor:DP-1,default:true", "workspace 2,monitor:DP-1", "workspace 2,default:false"}, "workspace dropped");
+
+    // Hyprland put DP-1 back on its hyprland.conf rule; the hook applies ours once the reload is done
+    standin::emit("configReloaded", {});
+    for (int i = 0; i < 20 && standin::rulesApplied() == 2; ++i) {
+        runtime.dispatch();
+    }
+    EXPECT(standin::rulesApplied() == 3, "%llu rules applied after a Hyprland reload", static_cast<unsigned long long>(standin::rulesApplied()));
+    expect_keywords({"workspace 1,monitor:DP-1,default:true", "workspace 2,monitor:DP-1", "workspace 2,default:false", "workspace 1,monitor:DP-1,default:true"}, "Hyprland reload");
+
+    return failures == 0 ? 0 : 1;
+}
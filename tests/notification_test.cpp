@@ -0,0 +1,91 @@
+// notification_test.cpp
+// Checks that notifications are merged, rate limited and shown on the event loop thread.
+#include "eventloop.hpp"
+#include "globals.hpp"
+#include "utils.hpp"
+#include "standin.hpp"
+#include "expect.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <wayland-server-core.h>
+
+using Clock = std::chrono::steady_clock;
+
+static const CHyprColor COLOR{1.0, 1.0, 1.0, 1.0};
+
+/// @brief Run the event loop until @p count notifications were shown or @p timeout passed
+static void dispatch_until(wl_event_loop* loop, size_t count, std::chrono::milliseconds timeout) {
+    const auto deadline = Clock::now() + timeout;
+    while (standin::notifications().size() < count && Clock::now() < deadline) {
+        wl_event_loop_dispatch(loop, 10);
+    }
+}
+
+int main() {
+    wl_event_loop* loop = wl_event_loop_create();
+    if (!loop || !hyprlua::eventloop::init(loop)) {
+        std::fprintf(stderr, "could not set up the event loop\n");
+        return 1;
+    }
+    PHANDLE = reinterpret_cast<HANDLE>(1);
+
+    // Repeats merge, summaries count, and only the burst is shown right away
+    setNotificationRateLimit(2, 200);
+    std::thread producer([] {
+        for (int i = 0; i < 20; ++i) {
+            sendNotification("[Hyprlua] read error", COLOR, 5000);
+        }
+        for (int i = 0; i < 12; ++i) {
+            sendSummaryNotification("applied", "monitor rule", COLOR, 3000);
+        }
+        sendNotification("[Hyprlua] Config reloaded", COLOR, 3000);
+    });
+    producer.join();
+
+    EXPECT(standin::notifications().empty(), "nothing may be shown from the producer thread");
+
+    const auto start = Clock::now();
+    dispatch_until(loop, 2, std::chrono::milliseconds(500));
+    auto shown = standin::notifications();
+    EXPECT(shown.size() == 2, "expected the burst of 2, got %zu", shown.size());
+    if (shown.size() == 2) {
+        EXPECT(shown[0].text == "[Hyprlua] read error (x20)", "got '%s'", shown[0].text.c_str());
+        EXPECT(shown[1].text == "[Hyprlua] applied 12 monitor rules", "got '%s'", shown[1].text.c_str());
+    }
+
+    dispatch_until(loop, 3, std::chrono::milliseconds(1000));
+    const auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+    shown             = standin::notifications();
+    EXPECT(shown.size() == 3, "expected the third toast after the interval, got %zu", shown.size());
+    EXPECT(waited >= 150, "third toast came after %lld ms, before the rate limit allowed it", static_cast<long long>(waited));
+    for (const auto& n : shown) {
+        EXPECT(n.thread == std::this_thread::get_id(), "'%s' was shown off the event loop thread", n.text.c_str());
+    }
+
+    // Without a limit everything queued is shown in one go
+    standin::reset();
+    setNotificationRateLimit(1, 0);
+    for (int i = 0; i < 5; ++i) {
+        sendNotification("[Hyprlua] message " + std::to_string(i), COLOR, 3000);
+    }
+    dispatch_until(loop, 5, std::chrono::milliseconds(100));
+    EXPECT(standin::notifications().size() == 5, "unlimited: got %zu", standin::notifications().size());
+
+    // Shutdown shows what is still waiting, later calls are shown directly
+    standin::reset();
+    setNotificationRateLimit(1, 10000);
+    sendNotification("[Hyprlua] first", COLOR, 3000);
+    sendNotification("[Hyprlua] second", COLOR, 3000);
+    dispatch_until(loop, 2, std::chrono::milliseconds(100));
+    EXPECT(standin::notifications().size() == 1, "limit of 1: got %zu", standin::notifications().size());
+    hyprlua::eventloop::shutdown();
+    shutdownNotifications();
+    EXPECT(standin::notifications().size() == 2, "shutdown did not flush: got %zu", standin::notifications().size());
+    sendNotification("[Hyprlua] exiting", COLOR, 3000);
+    EXPECT(standin::notifications().size() == 3, "after shutdown: got %zu", standin::notifications().size());
+
+    wl_event_loop_destroy(loop);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+// option_store_test.cpp
+// Writes option batches against the stand-in: one lookup per key, unchanged values skipped, one refresh per batch.
+#include "lua/option_store.hpp"
+#include "logger.hpp"
+#include "standin.hpp"
+#include "expect.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace hyprlua;
+
+static Hyprlang::INT int_of(Hyprlang::CConfigValue* value) {
+    return *static_cast<Hyprlang::INT*>(*value->getDataStaticPtr());
+}
+
+static Hyprlang::FLOAT float_of(Hyprlang::CConfigValue* value) {
+    return *static_cast<Hyprlang::FLOAT*>(*value->getDataStaticPtr());
+}
+
+/// @brief Nested tables join with ':' except under col, and values print like hyprland.conf
+static void test_spec() {
+    EXPECT(option_key("general", "gaps_in") == "general:gaps_in", "%s", option_key("general", "gaps_in").c_str());
+    EXPECT(option_key("general:col", "active_border") == "general:col.active_border", "%s", option_key("general:col", "active_border").c_str());
+    EXPECT(option_key("decoration:blur", "size") == "decoration:blur:size", "%s", option_key("decoration:blur", "size").c_str());
+    EXPECT(option_key("decoration", "col") == "decoration:col", "%s", option_key("decoration", "col").c_str());
+
+    EXPECT(option_text(OptionValue{int64_t{3}}) == "3", "%s", option_text(OptionValue{int64_t{3}}).c_str());
+    EXPECT(option_text(OptionValue{0.5}) == "0.5", "%s", option_text(OptionValue{0.5}).c_str());
+    EXPECT(option_text(OptionValue{std::string("rgba(33ccffee)")}) == "rgba(33ccffee)", "string");
+}
+
+static void test_store() {
+    standin::reset();
+    standin::addMonitor("DP-1");
+    standin::addMonitor("HDMI-A-1");
+    auto* border  = standin::addOption("general:border_size", Hyprlang::INT{1});
+    auto* opacity = standin::addOption("decoration:active_opacity", Hyprlang::FLOAT{1.0f});
+    auto* layout  = standin::addOption("general:layout", Hyprlang::STRING{"dwindle"});
+    auto* active  = standin::addOption("general:col.active_border", Hyprlang::SCustomType{"0xffffffff"});
+
+    OptionStore                      store;
+    const std::vector<OptionSetting> config = {
+        {"general:border_size", int64_t{2}},
+        {"decoration:active_opacity", 0.9},
+        {"general:layout", std::string("master")},
+        {"general:col.active_border", std::string("rgba(33ccffee) rgba(00ff99ee) 45deg")},
+        {"general:border_size", int64_t{3}}, // the last value wins
+    };
+
+    auto errors = store.apply(config);
+    EXPECT(errors.empty(), "%zu errors, first: %s", errors.size(), errors.empty() ? "" : errors[0].c_str());
+    EXPECT(int_of(border) == 3, "border_size %lld", static_cast<long long>(int_of(border)));
+    EXPECT(float_of(opacity) == 0.9f, "active_opacity %f", float_of(opacity));
+    EXPECT(std::string(std::any_cast<Hyprlang::STRING>(layout->getValue())) == "master", "layout");
+    EXPECT(std::any_cast<void*>(active->getValue()) != nullptr, "custom value");
+
+    // Numbers are written in place; only the string and the gradient went through the parser
+    const auto parsed = standin::parsedKeywords();
+    EXPECT(parsed.size() == 2, "%zu keywords parsed", parsed.size());
+    EXPECT(standin::configLookups() == 4, "%llu lookups", static_cast<unsigned long long>(standin::configLookups()));
+
+    // One refresh for the whole batch, whatever the number of options
+    auto refreshes = standin::refreshes();
+    EXPECT(refreshes.layouts == 2 && refreshes.damage == 2 && refreshes.decorations == 1, "layouts %llu damage %llu decorations %llu",
+           static_cast<unsigned long long>(refreshes.layouts), static_cast<unsigned long long>(refreshes.damage), static_cast<unsigned long long>(refreshes.decorations));
+
+    // The same batch again: nothing written, no refresh, no new lookups
+    errors = store.apply(config);
+    EXPECT(errors.empty(), "second apply failed");
+    EXPECT(store.stats().written == 4 && store.stats().skipped == 4, "written %llu skipped %llu", static_cast<unsigned long long>(store.stats().written),
+           static_cast<unsigned long long>(store.stats().skipped));
+    EXPECT(standin::parsedKeywords().size() == 2, "unchanged options were parsed again");
+    EXPECT(standin::configLookups() == 4, "handles were looked up again");
+    EXPECT(standin::refreshes().layouts == 2 && store.stats().refreshes == 1, "unchanged batch refreshed");
+
+    // A value set elsewhere, e.g. by hyprctl keyword, is noticed for numbers; the gradient needs invalidate()
+    *static_cast<Hyprlang::INT*>(*border->getDataStaticPtr()) = 7;
+    store.apply(config);
+    EXPECT(int_of(border) == 3, "border_size not restored");
+    EXPECT(standin::parsedKeywords().size() == 2, "only border_size should be written");
+    store.invalidate();
+    store.apply(config);
+    EXPECT(standin::parsedKeywords().size() == 3 && standin::parsedKeywords().back().starts_with("general:col.active_border"), "gradient not rewritten after invalidate()");
+
+    // Unknown options and rejected values are reported; the rest of the batch still applies
+    errors = store.apply({{"general:no_such_option", int64_t{1}}, {"general:border_size", std::string("thick")}, {"decoration:active_opacity", 0.5}});
+    EXPECT(errors.size() == 2, "%zu errors", errors.size());
+    EXPECT(float_of(opacity) == 0.5f, "active_opacity %f", float_of(opacity));
+    EXPECT(store.stats().failed == 2, "failed %llu", static_cast<unsigned long long>(store.stats().failed));
+}
+
+/// @brief Options a later batch no longer sets go back to the value they had before the first
+static void test_restore() {
+    standin::reset();
+    standin::addMonitor("DP-1");
+    auto* border = standin::addOption("general:border_size", Hyprlang::INT{1});
+    auto* layout = standin::addOption("general:layout", Hyprlang::STRING{"dwindle"});
+    auto* active = standin::addOption("general:col.active_border", Hyprlang::SCustomType{"0xffffffff"});
+
+    OptionStore store;
+    auto        errors = store.apply({{"general:border_size", int64_t{2}}, {"general:layout", std::string("master")}, {"general:col.active_border", std::string("0xff33ccff")}});
+    EXPECT(errors.empty(), "first batch failed");
+    errors = store.apply({{"general:border_size", int64_t{4}}});
+    EXPECT(errors.empty(), "%zu errors, first: %s", errors.size(), errors.empty() ? "" : errors[0].c_str());
+    EXPECT(int_of(border) == 4, "border_size %lld", static_cast<long long>(int_of(border)));
+    EXPECT(std::string(std::any_cast<Hyprlang::STRING>(layout->getValue())) == "dwindle", "layout not restored");
+    EXPECT(static_cast<Hyprlang::SCustomType*>(std::any_cast<void*>(active->getValue()))->text == "0xffffffff", "gradient not restored");
+
+    // Restored options are no longer tracked, and an empty batch puts back the rest
+    const auto parsed = standin::parsedKeywords().size();
+    store.apply({{"general:border_size", int64_t{4}}});
+    EXPECT(standin::parsedKeywords().size() == parsed, "restored options were written again");
+    store.apply({});
+    EXPECT(int_of(border) == 1, "border_size %lld", static_cast<long long>(int_of(border)));
+}
+
+int main() {
+    log::setLevel(log::Level::Off);
+    test_spec();
+    test_store();
+    test_restore();
+    return failures == 0 ? 0 : 1;
+}
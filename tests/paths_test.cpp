@@ -0,0 +1,94 @@
+// paths_test.cpp
+// Checks how the config file, the runtime module directory and the store snapshot are resolved from the environment.
+#include "paths.hpp"
+#include "expect.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+namespace fs = std::filesystem;
+
+static void clear_env() {
+    for (const char* name : {"HYPRLUA_CONFIG_PATH", "HYPRLUA_MODULES_PATH", "HYPRLUA_STORE_PATH", "XDG_CONFIG_HOME", "XDG_DATA_HOME", "XDG_DATA_DIRS", "XDG_STATE_HOME"}) {
+        unsetenv(name);
+    }
+}
+
+/// @brief HYPRLUA_CONFIG_PATH wins, then XDG_CONFIG_HOME, then ~/.config
+static void test_config_file() {
+    clear_env();
+    setenv("HOME", "/home/user", 1);
+    EXPECT(hyprlua::paths::config_file() == "/home/user/.config/hypr/hyprland.lua", "default: %s", hyprlua::paths::config_file().c_str());
+
+    setenv("XDG_CONFIG_HOME", "/xdg/config", 1);
+    EXPECT(hyprlua::paths::config_file() == "/xdg/config/hypr/hyprland.lua", "XDG_CONFIG_HOME: %s", hyprlua::paths::config_file().c_str());
+
+    // Relative XDG paths are invalid and ignored
+    setenv("XDG_CONFIG_HOME", "relative/config", 1);
+    EXPECT(hyprlua::paths::config_file() == "/home/user/.config/hypr/hyprland.lua", "relative XDG_CONFIG_HOME: %s", hyprlua::paths::config_file().c_str());
+
+    setenv("HYPRLUA_CONFIG_PATH", "~/dotfiles/hyprland.lua", 1);
+    EXPECT(hyprlua::paths::config_file() == "/home/user/dotfiles/hyprland.lua", "HYPRLUA_CONFIG_PATH: %s", hyprlua::paths::config_file().c_str());
+}
+
+/// @brief Module directories follow the XDG data dirs, and the first existing one is used
+static void test_modules_dir(const std::string& root) {
+    clear_env();
+    setenv("HOME", root.c_str(), 1);
+    setenv("XDG_DATA_DIRS", ("relative:" + root + "/a:" + root + "/b").c_str(), 1);
+
+    const auto dirs = hyprlua::paths::module_dirs();
+    EXPECT(dirs.size() >= 3, "expected at least 3 candidates, got %zu", dirs.size());
+    if (dirs.size() >= 3) {
+        EXPECT(dirs[0] == root + "/.local/share/hyprlua/modules", "data home: %s", dirs[0].c_str());
+        EXPECT(dirs[1] == root + "/a/hyprlua/modules", "first data dir: %s", dirs[1].c_str());
+        EXPECT(dirs[2] == root + "/b/hyprlua/modules", "second data dir: %s", dirs[2].c_str());
+    }
+
+    // Only the second data dir exists
+    fs::create_directories(root + "/b/hyprlua/modules");
+    EXPECT(hyprlua::paths::modules_dir() == root + "/b/hyprlua/modules", "existing dir: %s", hyprlua::paths::modules_dir().c_str());
+
+    // The data home takes precedence once it exists
+    setenv("XDG_DATA_HOME", (root + "/share").c_str(), 1);
+    fs::create_directories(root + "/share/hyprlua/modules");
+    EXPECT(hyprlua::paths::modules_dir() == root + "/share/hyprlua/modules", "data home: %s", hyprlua::paths::modules_dir().c_str());
+
+    // HYPRLUA_MODULES_PATH is the only candidate when set, existing or not
+    setenv("HYPRLUA_MODULES_PATH", "/nonexistent/modules", 1);
+    EXPECT(hyprlua::paths::module_dirs().size() == 1, "HYPRLUA_MODULES_PATH adds other candidates");
+    EXPECT(hyprlua::paths::modules_dir() == "/nonexistent/modules", "HYPRLUA_MODULES_PATH: %s", hyprlua::paths::modules_dir().c_str());
+}
+
+/// @brief HYPRLUA_STORE_PATH wins, then XDG_STATE_HOME, then ~/.local/state
+static void test_store_file() {
+    clear_env();
+    setenv("HOME", "/home/user", 1);
+    EXPECT(hyprlua::paths::store_file() == "/home/user/.local/state/hyprlua/store.bin", "default: %s", hyprlua::paths::store_file().c_str());
+
+    setenv("XDG_STATE_HOME", "/xdg/state", 1);
+    EXPECT(hyprlua::paths::store_file() == "/xdg/state/hyprlua/store.bin", "XDG_STATE_HOME: %s", hyprlua::paths::store_file().c_str());
+
+    setenv("XDG_STATE_HOME", "relative/state", 1);
+    EXPECT(hyprlua::paths::store_file() == "/home/user/.local/state/hyprlua/store.bin", "relative XDG_STATE_HOME: %s", hyprlua::paths::store_file().c_str());
+
+    setenv("HYPRLUA_STORE_PATH", "~/store.bin", 1);
+    EXPECT(hyprlua::paths::store_file() == "/home/user/store.bin", "HYPRLUA_STORE_PATH: %s", hyprlua::paths::store_file().c_str());
+}
+
+int main() {
+    char tmpl[] = "/tmp/hyprlua-paths-XXXXXX";
+    if (!mkdtemp(tmpl)) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+
+    test_config_file();
+    test_modules_dir(tmpl);
+    test_store_file();
+
+    fs::remove_all(tmpl);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+// profile_table_test.cpp
+// Checks stack merging, the folded output, hotspot counting and that a full table drops samples.
+#include "lua/profile_table.hpp"
+#include "expect.hpp"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace hyprlua;
+
+static std::string folded(const ProfileTable& table) {
+    std::ostringstream out;
+    table.write_folded(out);
+    return out.str();
+}
+
+static void test_folded() {
+    const ProfileFrame main{"main chunk", "hyprland.lua", 20, 0};
+    const ProfileFrame setup{"setup", "hyprland.lua", 12, 10};
+    const ProfileFrame setupLater{"setup", "hyprland.lua", 14, 10};
+    const ProfileFrame format{"format", "[C]", -1, -1};
+
+    ProfileTable       table;
+    // Innermost frame first
+    for (int i = 0; i < 3; ++i) {
+        EXPECT(table.record(std::vector{setup, main}), "sample %d dropped", i);
+    }
+    EXPECT(table.record(std::vector{format, setupLater, main}), "sample dropped");
+    EXPECT(table.record(std::vector{main}), "sample dropped");
+
+    const std::string expected = "main chunk (hyprland.lua:20) 1\n"
+                                 "main chunk (hyprland.lua:20);setup (hyprland.lua:12) 3\n"
+                                 "main chunk (hyprland.lua:20);setup (hyprland.lua:14);format ([C]) 1\n";
+    EXPECT(folded(table) == expected, "got:\n%s", folded(table).c_str());
+    EXPECT(table.samples() == 5 && table.dropped() == 0, "samples %llu dropped %llu", static_cast<unsigned long long>(table.samples()),
+           static_cast<unsigned long long>(table.dropped()));
+
+    const auto lines = table.hottest_lines(10);
+    EXPECT(!lines.empty() && lines[0].label == "hyprland.lua:12" && lines[0].self == 3 && lines[0].total == 3, "hottest line %s",
+           lines.empty() ? "none" : lines[0].label.c_str());
+    const auto functions = table.hottest_functions(10);
+    EXPECT(!functions.empty() && functions[0].label == "setup (hyprland.lua:10)" && functions[0].self == 3 && functions[0].total == 4, "hottest function %s",
+           functions.empty() ? "none" : functions[0].label.c_str());
+    bool mainSeen = false;
+    for (const auto& f : functions) {
+        if (f.label == "main chunk (hyprland.lua:0)") {
+            mainSeen = f.self == 1 && f.total == 5;
+        }
+    }
+    EXPECT(mainSeen, "main chunk should be on every stack and innermost once");
+
+    table.clear();
+    EXPECT(folded(table).empty() && table.samples() == 0, "clear kept samples");
+}
+
+static void test_recursion_and_separators() {
+    const ProfileFrame fib{"fib", "a;b.lua", 3, 1};
+    ProfileTable       table;
+    table.record(std::vector{fib, fib, fib});
+
+    // A recursive function is on the stack once as far as totals go
+    const auto functions = table.hottest_functions(1);
+    EXPECT(functions.size() == 1 && functions[0].total == 1 && functions[0].self == 1, "recursion counted %llu times",
+           functions.empty() ? 0ULL : static_cast<unsigned long long>(functions[0].total));
+    EXPECT(folded(table) == "fib (a:b.lua:3);fib (a:b.lua:3);fib (a:b.lua:3) 1\n", "';' kept in a frame: %s", folded(table).c_str());
+}
+
+static void test_limits() {
+    ProfileTable             table(4, 64);
+    std::vector<std::string> names;
+    for (int i = 0; i < 8; ++i) {
+        names.push_back("f" + std::to_string(i));
+    }
+    uint64_t kept = 0;
+    for (const auto& name : names) {
+        kept += table.record(std::vector{ProfileFrame{name, "x.lua", 1, 1}});
+    }
+    EXPECT(kept == 4 && table.samples() == 4 && table.dropped() == 4, "kept %llu dropped %llu", static_cast<unsigned long long>(kept),
+           static_cast<unsigned long long>(table.dropped()));
+
+    // Stacks deeper than MAX_DEPTH keep their innermost frames
+    ProfileTable              deep;
+    std::vector<ProfileFrame> frames(ProfileTable::MAX_DEPTH + 10, ProfileFrame{"outer", "x.lua", 1, 1});
+    frames[0] = {"leaf", "x.lua", 2, 2};
+    EXPECT(deep.record(frames), "deep stack dropped");
+    const auto out = folded(deep);
+    EXPECT(out.ends_with("leaf (x.lua:2) 1\n"), "leaf lost: %s", out.c_str());
+
+    EXPECT(!deep.record({}), "empty stack recorded");
+}
+
+int main() {
+    test_folded();
+    test_recursion_and_separators();
+    test_limits();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+// runtime_harness.hpp
+#pragma once
+
+#include "eventloop.hpp"
+#include "globals.hpp"
+#include "logger.hpp"
+#include "trace.hpp"
+#include "utils.hpp"
+#include "lua/runtime.hpp"
+#include "standin.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <wayland-server-core.h>
+
+/**
+ * @file runtime_harness.hpp
+ * @brief Runs a config through the Lua runtime against the stand-in, reload after reload
+ * @details Each Runtime gets its own directory for the config, the bytecode cache and
+ *          the store snapshot. A reload is waited for through the trace sites of the
+ *          build and the apply, which count every run whether it succeeded or not.
+ */
+
+namespace harness {
+
+    namespace fs = std::filesystem;
+
+    /// @brief Times the trace site @p name was hit so far
+    inline uint64_t hits(std::string_view name) {
+        for (const auto& summary : hyprlua::trace::summaries()) {
+            if (summary.name == name)
+                return summary.count;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Argument of the bind on @p key, or std::nullopt without one
+     * @details Configs under test publish values such as hypr.store contents through
+     *          a bind's argument, the one thing of theirs a test can read back.
+     */
+    inline std::optional<std::string> bind_arg(const std::string& key) {
+        for (const auto& bind : standin::keybinds()) {
+            if (bind.key == key)
+                return bind.arg;
+        }
+        return std::nullopt;
+    }
+
+    class Runtime {
+      public:
+        /// @brief Reset the stand-in and set up the event loop; add monitors and the like, then start()
+        explicit Runtime(const std::string& name) : m_root(fs::temp_directory_path() / ("hyprlua-" + name + "-test-" + std::to_string(getpid()))) {
+            fs::create_directories(m_root);
+            setenv("XDG_CACHE_HOME", (m_root / "cache").c_str(), 1);
+            setenv("HYPRLUA_STORE_PATH", (m_root / "store.bin").c_str(), 1);
+
+            hyprlua::log::setLevel(hyprlua::log::Level::Off);
+            hyprlua::trace::setEnabled(true);
+            standin::reset();
+            m_loop                       = wl_event_loop_create();
+            g_pCompositor->m_wlEventLoop = m_loop;
+            hyprlua::eventloop::init(m_loop);
+            PHANDLE = reinterpret_cast<HANDLE>(1);
+            setNotificationRateLimit(1, 0);
+        }
+
+        ~Runtime() {
+            hyprlua::shutdown_lua_runtime();
+            hyprlua::eventloop::shutdown();
+            shutdownNotifications();
+            wl_event_loop_destroy(m_loop);
+            std::error_code ec;
+            fs::remove_all(m_root, ec);
+        }
+
+        Runtime(const Runtime&)            = delete;
+        Runtime& operator=(const Runtime&) = delete;
+
+        /// @brief Write @p text to @p file in the config directory; returns its path
+        std::string write(const std::string& file, const std::string& text) {
+            const auto path = m_root / file;
+            std::ofstream(path, std::ios::trunc) << text;
+            return path.string();
+        }
+
+        /// @brief Run hyprland.lua; false if no config was applied within five seconds
+        bool start() {
+            hyprlua::init_lua_runtime(HYPRLUA_RUNTIME_MODULES, (m_root / "hyprland.lua").string());
+            for (int i = 0; i < 500 && !hyprlua::config_loaded(); ++i) {
+                dispatch();
+            }
+            return hyprlua::config_loaded();
+        }
+
+        /**
+         * @brief Reload and wait until the new config was applied or refused
+         * @param changed A file to report as changed first, as the watcher does; empty to just reload
+         * @return Whether the new config was applied; false if the previous one was kept
+         */
+        bool reload(const std::string& changed = {}) {
+            const auto built   = hits("config.build");
+            const auto applied = hits("config.apply");
+            if (changed.empty())
+                hyprlua::request_reload();
+            else
+                hyprlua::file_changed(changed);
+            for (int i = 0; i < 500 && hits("config.build") == built; ++i) {
+                dispatch();
+            }
+            // A build that succeeded posts its apply to the main thread right away
+            for (int i = 0; i < 20 && hits("config.apply") == applied; ++i) {
+                dispatch();
+            }
+            return hits("config.apply") > applied;
+        }
+
+        /// @brief Run the event loop once, waiting up to @p ms for something to do
+        void dispatch(int ms = 10) {
+            wl_event_loop_dispatch(m_loop, ms);
+        }
+
+        const fs::path& root() const {
+            return m_root;
+        }
+
+      private:
+        fs::path         m_root;
+        wl_event_loop*   m_loop = nullptr;
+    };
+
+} // namespace harness
@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * @file Compositor.hpp
+ * @brief Stand-in for the parts of Hyprland's CCompositor used by Hyprlua
+ * @details Outputs, workspaces and windows are created through standin.hpp; lookups behave
+ *          like Hyprland's, without any rendering behind them
+ */
+
+#include "desktop/Window.hpp"
+#include "desktop/Workspace.hpp"
+#include "helpers/Monitor.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+struct wl_event_loop;
+
+class CCompositor {
+  public:
+    wl_event_loop*            m_wlEventLoop = nullptr;
+    std::vector<PHLMONITOR>   m_monitors;
+    std::vector<PHLMONITOR>   m_realMonitors;
+    std::vector<PHLWORKSPACE> m_workspaces;
+    std::vector<PHLWINDOW>    m_windows;
+
+    PHLMONITOR                getMonitorFromName(const std::string& name);
+    PHLMONITOR                getMonitorFromDesc(const std::string& desc);
+    PHLWORKSPACE              getWorkspaceByID(const WORKSPACEID& id);
+    PHLWORKSPACE              getWorkspaceByName(const std::string& name);
+    void                      moveWorkspaceToMonitor(PHLWORKSPACE workspace, PHLMONITOR monitor, bool noWarpCursor = false);
+    void                      updateAllWindowsAnimatedDecorationValues();
+};
+
+inline std::unique_ptr<CCompositor> g_pCompositor;
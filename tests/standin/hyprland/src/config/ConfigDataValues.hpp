@@ -0,0 +1,16 @@
+#pragma once
+
+/**
+ * @file ConfigDataValues.hpp
+ * @brief Stand-in for the base of Hyprland's custom option types, like gradients and gaps
+ */
+
+#include <string>
+
+class ICustomConfigValueData {
+  public:
+    virtual ~ICustomConfigValueData() = default;
+
+    /// @brief The value as hyprctl getoption prints it
+    virtual std::string toString() = 0;
+};
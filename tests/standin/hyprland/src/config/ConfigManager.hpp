@@ -0,0 +1,20 @@
+#pragma once
+
+/**
+ * @file ConfigManager.hpp
+ * @brief Stand-in for the parts of Hyprland's CConfigManager used by Hyprlua
+ * @details Keywords are parsed into the values registered with standin::addOption()
+ *          and recorded, see standin.hpp for the inspection helpers. Workspace rules
+ *          are recorded only.
+ */
+
+#include <memory>
+#include <string>
+
+class CConfigManager {
+  public:
+    /// @brief Set one keyword like a `keyword` request would; returns the parse error, or an empty string
+    std::string parseKeyword(const std::string& command, const std::string& value);
+};
+
+inline std::unique_ptr<CConfigManager> g_pConfigManager;
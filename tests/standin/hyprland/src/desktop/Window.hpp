@@ -0,0 +1,22 @@
+#pragma once
+
+/**
+ * @file Window.hpp
+ * @brief Stand-in for Hyprland's CWindow
+ */
+
+#include "Workspace.hpp"
+#include <memory>
+#include <string>
+
+class CWindow {
+  public:
+    std::string  m_title;
+    std::string  m_class;
+    std::string  m_initialTitle;
+    std::string  m_initialClass;
+    PHLWORKSPACE m_workspace;
+};
+
+using PHLWINDOW    = std::shared_ptr<CWindow>;
+using PHLWINDOWREF = std::weak_ptr<CWindow>;
@@ -0,0 +1,22 @@
+#pragma once
+
+/**
+ * @file Workspace.hpp
+ * @brief Stand-in for Hyprland's CWorkspace
+ */
+
+#include "../helpers/Monitor.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+using WORKSPACEID = int64_t;
+
+class CWorkspace {
+  public:
+    WORKSPACEID   m_id = 0;
+    std::string   m_name;
+    PHLMONITORREF m_monitor;
+};
+
+using PHLWORKSPACE = std::shared_ptr<CWorkspace>;
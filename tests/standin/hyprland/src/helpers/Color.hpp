@@ -0,0 +1,14 @@
+#pragma once
+
+/**
+ * @file Color.hpp
+ * @brief Stand-in for Hyprland's CHyprColor used by headless tests
+ */
+
+class CHyprColor {
+  public:
+    CHyprColor() = default;
+    CHyprColor(float r_, float g_, float b_, float a_) : r(r_), g(g_), b(b_), a(a_) {}
+
+    double r = 0, g = 0, b = 0, a = 0;
+};
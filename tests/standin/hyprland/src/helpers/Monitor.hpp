@@ -0,0 +1,79 @@
+#pragma once
+
+/**
+ * @file Monitor.hpp
+ * @brief Stand-in for the parts of Hyprland's CMonitor and SMonitorRule used by Hyprlua
+ * @details Applying a rule records it on the monitor and counts the call instead of
+ *          doing a modeset, see standin.hpp for the inspection helpers
+ */
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#ifndef WL_OUTPUT_TRANSFORM_ENUM
+#define WL_OUTPUT_TRANSFORM_ENUM
+enum wl_output_transform {
+    WL_OUTPUT_TRANSFORM_NORMAL      = 0,
+    WL_OUTPUT_TRANSFORM_90          = 1,
+    WL_OUTPUT_TRANSFORM_180         = 2,
+    WL_OUTPUT_TRANSFORM_270         = 3,
+    WL_OUTPUT_TRANSFORM_FLIPPED     = 4,
+    WL_OUTPUT_TRANSFORM_FLIPPED_90  = 5,
+    WL_OUTPUT_TRANSFORM_FLIPPED_180 = 6,
+    WL_OUTPUT_TRANSFORM_FLIPPED_270 = 7,
+};
+#endif
+
+typedef int64_t MONITORID;
+
+class Vector2D {
+  public:
+    Vector2D() = default;
+    Vector2D(double x_, double y_) : x(x_), y(y_) {}
+
+    bool   operator==(const Vector2D&) const = default;
+
+    double x = 0, y = 0;
+};
+
+enum eAutoDirs : uint8_t {
+    DIR_AUTO_NONE = 0,
+    DIR_AUTO_UP,
+    DIR_AUTO_DOWN,
+    DIR_AUTO_LEFT,
+    DIR_AUTO_RIGHT,
+    DIR_AUTO_CENTER_UP,
+    DIR_AUTO_CENTER_DOWN,
+    DIR_AUTO_CENTER_LEFT,
+    DIR_AUTO_CENTER_RIGHT,
+};
+
+struct SMonitorRule {
+    eAutoDirs           autoDir     = DIR_AUTO_NONE;
+    std::string         name        = "";
+    Vector2D            resolution  = Vector2D(1280, 720);
+    Vector2D            offset      = Vector2D(0, 0);
+    float               scale       = 1;
+    float               refreshRate = 60;
+    bool                disabled    = false;
+    wl_output_transform transform   = WL_OUTPUT_TRANSFORM_NORMAL;
+    std::string         mirrorOf    = "";
+    bool                enable10bit = false;
+    std::optional<int>  vrr;
+};
+
+class CMonitor {
+  public:
+    MONITORID    m_id = 0;
+    std::string  m_name;
+    std::string  m_description;
+    SMonitorRule m_activeMonitorRule;
+    uint64_t     m_rulesApplied = 0;
+
+    bool         applyMonitorRule(SMonitorRule* rule, bool force = false);
+};
+
+using PHLMONITOR    = std::shared_ptr<CMonitor>;
+using PHLMONITORREF = std::weak_ptr<CMonitor>;
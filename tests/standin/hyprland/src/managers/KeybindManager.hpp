@@ -0,0 +1,59 @@
+#pragma once
+
+/**
+ * @file KeybindManager.hpp
+ * @brief Stand-in for the parts of Hyprland's CKeybindManager used by Hyprlua
+ * @details Keeps the bind list like Hyprland does; dispatchers are registered by
+ *          name only and do nothing when looked up
+ */
+
+#include "../plugins/PluginAPI.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct SParsedKey {
+    std::string key      = "";
+    uint32_t    keycode  = 0;
+    bool        catchAll = false;
+};
+
+struct SKeybind {
+    std::string key            = "";
+    uint32_t    keycode        = 0;
+    bool        catchAll       = false;
+    uint32_t    modmask        = 0;
+    std::string handler        = "";
+    std::string arg            = "";
+    bool        locked         = false;
+    std::string submap         = "";
+    std::string description    = "";
+    bool        release        = false;
+    bool        repeat         = false;
+    bool        longPress      = false;
+    bool        mouse          = false;
+    bool        nonConsuming   = false;
+    bool        transparent    = false;
+    bool        ignoreMods     = false;
+    bool        multiKey       = false;
+    bool        hasDescription = false;
+    bool        dontInhibit    = false;
+    bool        click          = false;
+    bool        drag           = false;
+};
+
+class CKeybindManager {
+  public:
+    CKeybindManager();
+
+    void                                                                          addKeybind(SKeybind kb);
+    void                                                                          removeKeybind(uint32_t mod, const SParsedKey& key);
+
+    std::unordered_map<std::string, std::function<SDispatchResult(std::string)>> m_dispatchers;
+    std::vector<SP<SKeybind>>                                                     m_keybinds;
+};
+
+inline std::unique_ptr<CKeybindManager> g_pKeybindManager;
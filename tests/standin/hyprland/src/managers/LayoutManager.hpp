@@ -0,0 +1,27 @@
+#pragma once
+
+/**
+ * @file LayoutManager.hpp
+ * @brief Stand-in for the parts of Hyprland's CLayoutManager and IHyprLayout used by Hyprlua
+ * @details Recalculating a monitor only counts the call, see standin.hpp
+ */
+
+#include "../helpers/Monitor.hpp"
+#include <memory>
+
+class IHyprLayout {
+  public:
+    void recalculateMonitor(const MONITORID& id);
+};
+
+class CLayoutManager {
+  public:
+    IHyprLayout* getCurrentLayout() {
+        return &m_layout;
+    }
+
+  private:
+    IHyprLayout m_layout;
+};
+
+inline std::unique_ptr<CLayoutManager> g_pLayoutManager;
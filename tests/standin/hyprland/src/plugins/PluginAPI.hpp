@@ -0,0 +1,69 @@
+#pragma once
+
+/**
+ * @file PluginAPI.hpp
+ * @brief Stand-in for the subset of Hyprland's plugin API used by Hyprlua
+ * @details Calls are recorded by the stand-in instead of reaching a compositor,
+ *          see standin.hpp for the inspection helpers
+ */
+
+#include "../helpers/Color.hpp"
+#include <hyprlang.hpp>
+#include <any>
+#include <functional>
+#include <memory>
+#include <string>
+
+#define APICALL
+#define EXPORT
+#define HYPRLAND_API_VERSION "0.1"
+
+typedef void* HANDLE;
+
+template <typename T>
+using SP = std::shared_ptr<T>;
+template <typename T>
+using WP = std::weak_ptr<T>;
+
+enum eHyprCtlOutputFormat {
+    FORMAT_NORMAL = 0,
+    FORMAT_JSON,
+};
+
+struct SDispatchResult {
+    bool        passEvent = false;
+    bool        success   = true;
+    std::string error;
+};
+
+struct SCallbackInfo {
+    bool cancelled = false;
+};
+
+typedef std::function<void(void*, SCallbackInfo&, std::any)> HOOK_CALLBACK_FN;
+
+struct SHyprCtlCommand {
+    std::string                                                   name  = "";
+    bool                                                          exact = true;
+    std::function<std::string(eHyprCtlOutputFormat, std::string)> fn;
+};
+
+struct PLUGIN_DESCRIPTION_INFO {
+    std::string name        = "";
+    std::string description = "";
+    std::string author      = "";
+    std::string version     = "";
+};
+
+namespace HyprlandAPI {
+    bool                    addNotification(HANDLE handle, const std::string& text, const CHyprColor& color, const float timeMs);
+    SP<SHyprCtlCommand>     registerHyprCtlCommand(HANDLE handle, SHyprCtlCommand cmd);
+    bool                    unregisterHyprCtlCommand(HANDLE handle, SP<SHyprCtlCommand> cmd);
+    std::string             invokeHyprctlCommand(const std::string& call, const std::string& args, const std::string& format = "");
+    bool                    addDispatcherV2(HANDLE handle, const std::string& name, std::function<SDispatchResult(std::string)> handler);
+    bool                    removeDispatcher(HANDLE handle, const std::string& name);
+    SP<HOOK_CALLBACK_FN>    registerCallbackDynamic(HANDLE handle, const std::string& event, HOOK_CALLBACK_FN fn);
+    Hyprlang::CConfigValue* getConfigValue(HANDLE handle, const std::string& name);
+}
+
+const char* __hyprland_api_get_hash();
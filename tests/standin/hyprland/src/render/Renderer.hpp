@@ -0,0 +1,17 @@
+#pragma once
+
+/**
+ * @file Renderer.hpp
+ * @brief Stand-in for the parts of Hyprland's CHyprRenderer used by Hyprlua
+ * @details Damage is counted per monitor instead of scheduling a frame, see standin.hpp
+ */
+
+#include "../helpers/Monitor.hpp"
+#include <memory>
+
+class CHyprRenderer {
+  public:
+    void damageMonitor(PHLMONITOR monitor);
+};
+
+inline std::unique_ptr<CHyprRenderer> g_pHyprRenderer;
@@ -0,0 +1,82 @@
+#pragma once
+
+/**
+ * @file hyprlang.hpp
+ * @brief Stand-in for the parts of hyprlang's CConfigValue used by Hyprlua
+ * @details A value owns its data like hyprlang's does: getDataStaticPtr() points at
+ *          the pointer Hyprland reads the live value through
+ */
+
+#include <hyprland/src/config/ConfigDataValues.hpp>
+#include <any>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace Hyprlang {
+
+    typedef int64_t     INT;
+    typedef float       FLOAT;
+    typedef const char* STRING;
+
+    /// @brief Handled by a custom parser in Hyprland, like gaps and gradients; getValue() is the data pointer
+    struct SCustomType : ICustomConfigValueData {
+        explicit SCustomType(std::string text = {}) : text(std::move(text)) {}
+
+        std::string toString() override {
+            return text;
+        }
+
+        std::string text;
+    };
+
+    class CConfigValue {
+      public:
+        explicit CConfigValue(INT value) : m_int(value), m_data(&m_int) {}
+        explicit CConfigValue(FLOAT value) : m_float(value), m_data(&m_float) {}
+        explicit CConfigValue(STRING value) : m_string(value), m_data(m_string.data()) {}
+        explicit CConfigValue(SCustomType value) : m_custom(std::move(value)), m_data(static_cast<ICustomConfigValueData*>(&m_custom)) {}
+
+        CConfigValue(const CConfigValue&)            = delete;
+        CConfigValue& operator=(const CConfigValue&) = delete;
+
+        std::any      getValue() const {
+            if (m_data == &m_int) {
+                return m_int;
+            }
+            if (m_data == &m_float) {
+                return m_float;
+            }
+            if (m_data == &m_custom) {
+                return m_data;
+            }
+            return static_cast<STRING>(m_data);
+        }
+
+        void* const* getDataStaticPtr() const {
+            return &m_data;
+        }
+
+        /// @brief Stand-in only: what the config manager's parser does to this value
+        void setFromText(const std::string& text) {
+            if (m_data == &m_int) {
+                m_int = std::stoll(text);
+            } else if (m_data == &m_float) {
+                m_float = std::stof(text);
+            } else if (m_data == &m_custom) {
+                m_custom.text = text;
+            } else {
+                m_string = text;
+                m_data   = m_string.data();
+            }
+        }
+
+      private:
+        INT         m_int   = 0;
+        FLOAT       m_float = 0;
+        std::string m_string;
+        SCustomType m_custom;
+        void*       m_data = nullptr;
+    };
+
+} // namespace Hyprlang
@@ -0,0 +1,342 @@
+#include "standin.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+    std::mutex                                                               g_mutex;
+    std::vector<standin::Notification>                                       g_notifications;
+    std::vector<std::string>                                                 g_hyprctlCalls;
+    std::vector<SP<SHyprCtlCommand>>                                         g_commands;
+    std::unordered_map<std::string, std::vector<WP<HOOK_CALLBACK_FN>>>       g_hooks;
+    std::atomic<uint64_t>                                                    g_rulesApplied = 0;
+    std::atomic<uint64_t>                                                    g_keybindCalls = 0;
+    std::unordered_map<std::string, std::unique_ptr<Hyprlang::CConfigValue>> g_options;
+    std::vector<std::string>                                                 g_parsedKeywords;
+    uint64_t                                                                 g_configLookups = 0;
+    standin::Refreshes                                                       g_refreshes;
+    MONITORID                                                                g_nextMonitorId = 0;
+    std::vector<std::string>                                                 g_dispatches;
+
+    /// @brief Create the config manager and what it refreshes, if not there yet
+    void                                                                     config_managers() {
+        if (!g_pConfigManager) {
+            g_pConfigManager = std::make_unique<CConfigManager>();
+            g_pLayoutManager = std::make_unique<CLayoutManager>();
+            g_pHyprRenderer  = std::make_unique<CHyprRenderer>();
+        }
+    }
+
+    CCompositor&                                                             compositor() {
+        if (!g_pCompositor) {
+            g_pCompositor = std::make_unique<CCompositor>();
+        }
+        return *g_pCompositor;
+    }
+}
+
+bool HyprlandAPI::addNotification(HANDLE, const std::string& text, const CHyprColor& color, const float timeMs) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_notifications.push_back({text, color, timeMs, std::this_thread::get_id()});
+    return true;
+}
+
+SP<SHyprCtlCommand> HyprlandAPI::registerHyprCtlCommand(HANDLE, SHyprCtlCommand cmd) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_commands.push_back(std::make_shared<SHyprCtlCommand>(std::move(cmd)));
+    return g_commands.back();
+}
+
+bool HyprlandAPI::unregisterHyprCtlCommand(HANDLE, SP<SHyprCtlCommand> cmd) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    return std::erase(g_commands, cmd) > 0;
+}
+
+std::string HyprlandAPI::invokeHyprctlCommand(const std::string& call, const std::string& args, const std::string&) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_hyprctlCalls.push_back(call + " " + args);
+    return "ok";
+}
+
+bool HyprlandAPI::addDispatcherV2(HANDLE, const std::string& name, std::function<SDispatchResult(std::string)> handler) {
+    if (!g_pKeybindManager) {
+        g_pKeybindManager = std::make_unique<CKeybindManager>();
+        g_options.clear();
+        g_parsedKeywords.clear();
+        g_configLookups = 0;
+        g_refreshes     = {};
+        g_nextMonitorId = 0;
+    }
+    return g_pKeybindManager->m_dispatchers.emplace(name, std::move(handler)).second;
+}
+
+bool HyprlandAPI::removeDispatcher(HANDLE, const std::string& name) {
+    return g_pKeybindManager && g_pKeybindManager->m_dispatchers.erase(name) > 0;
+}
+
+SP<HOOK_CALLBACK_FN> HyprlandAPI::registerCallbackDynamic(HANDLE, const std::string& event, HOOK_CALLBACK_FN fn) {
+    // Like Hyprland, only weak references are kept: dropping the returned pointer unregisters
+    auto hook = std::make_shared<HOOK_CALLBACK_FN>(std::move(fn));
+    g_hooks[event].push_back(hook);
+    return hook;
+}
+
+Hyprlang::CConfigValue* HyprlandAPI::getConfigValue(HANDLE, const std::string& name) {
+    ++g_configLookups;
+    auto it = g_options.find(name);
+    return it == g_options.end() ? nullptr : it->second.get();
+}
+
+const char* __hyprland_api_get_hash() {
+    return "standin";
+}
+
+bool CMonitor::applyMonitorRule(SMonitorRule* rule, bool) {
+    m_activeMonitorRule = *rule;
+    ++m_rulesApplied;
+    g_rulesApplied.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+std::string CConfigManager::parseKeyword(const std::string& command, const std::string& value) {
+    g_parsedKeywords.push_back(command + " " + value);
+    // Workspace rules are only recorded
+    if (command == "workspace") {
+        return "";
+    }
+    auto it = g_options.find(command);
+    if (it == g_options.end()) {
+        return "Invalid keyword " + command;
+    }
+    try {
+        it->second->setFromText(value);
+    } catch (const std::exception&) {
+        return "Invalid value " + value + " for " + command;
+    }
+    return "";
+}
+
+void IHyprLayout::recalculateMonitor(const MONITORID&) {
+    ++g_refreshes.layouts;
+}
+
+void CHyprRenderer::damageMonitor(PHLMONITOR) {
+    ++g_refreshes.damage;
+}
+
+CKeybindManager::CKeybindManager() {
+    for (const auto* name : {"exec", "killactive", "workspace", "movetoworkspace", "movetoworkspacesilent", "movefocus", "movewindow", "resizeactive", "togglefloating",
+                             "setfloating", "settiled", "pin", "resizewindowpixel", "movewindowpixel", "setprop", "fullscreen", "submap", "pass", "mouse"}) {
+        m_dispatchers[name] = [name](std::string arg) {
+            g_dispatches.push_back(std::string(name) + " " + arg);
+            return SDispatchResult{};
+        };
+    }
+}
+
+void CKeybindManager::addKeybind(SKeybind kb) {
+    m_keybinds.push_back(std::make_shared<SKeybind>(std::move(kb)));
+    g_keybindCalls.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CKeybindManager::removeKeybind(uint32_t mod, const SParsedKey& key) {
+    std::erase_if(m_keybinds, [&](const SP<SKeybind>& kb) { return kb->modmask == mod && kb->key == key.key && kb->keycode == key.keycode && kb->catchAll == key.catchAll; });
+    g_keybindCalls.fetch_add(1, std::memory_order_relaxed);
+}
+
+PHLMONITOR CCompositor::getMonitorFromName(const std::string& name) {
+    for (const auto& m : m_realMonitors) {
+        if (m->m_name == name) {
+            return m;
+        }
+    }
+    return nullptr;
+}
+
+PHLMONITOR CCompositor::getMonitorFromDesc(const std::string& desc) {
+    for (const auto& m : m_realMonitors) {
+        if (m->m_description.starts_with(desc)) {
+            return m;
+        }
+    }
+    return nullptr;
+}
+
+PHLWORKSPACE CCompositor::getWorkspaceByID(const WORKSPACEID& id) {
+    for (const auto& w : m_workspaces) {
+        if (w->m_id == id) {
+            return w;
+        }
+    }
+    return nullptr;
+}
+
+PHLWORKSPACE CCompositor::getWorkspaceByName(const std::string& name) {
+    for (const auto& w : m_workspaces) {
+        if (w->m_name == name) {
+            return w;
+        }
+    }
+    return nullptr;
+}
+
+void CCompositor::moveWorkspaceToMonitor(PHLWORKSPACE workspace, PHLMONITOR monitor, bool) {
+    workspace->m_monitor = monitor;
+}
+
+void CCompositor::updateAllWindowsAnimatedDecorationValues() {
+    ++g_refreshes.decorations;
+}
+
+namespace standin {
+
+    std::vector<Notification> notifications() {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        return g_notifications;
+    }
+
+    PHLMONITOR addMonitor(const std::string& name, const std::string& description) {
+        auto monitor           = std::make_shared<CMonitor>();
+        monitor->m_id          = g_nextMonitorId++;
+        monitor->m_name        = name;
+        monitor->m_description = description;
+        compositor().m_monitors.push_back(monitor);
+        compositor().m_realMonitors.push_back(monitor);
+        return monitor;
+    }
+
+    PHLWORKSPACE addWorkspace(WORKSPACEID id, const std::string& name, const PHLMONITOR& monitor) {
+        auto workspace       = std::make_shared<CWorkspace>();
+        workspace->m_id      = id;
+        workspace->m_name    = name;
+        workspace->m_monitor = monitor;
+        compositor().m_workspaces.push_back(workspace);
+        return workspace;
+    }
+
+    PHLWINDOW addWindow(const std::string& cls, const std::string& title) {
+        auto window            = std::make_shared<CWindow>();
+        window->m_class        = cls;
+        window->m_title        = title;
+        window->m_initialClass = cls;
+        window->m_initialTitle = title;
+        compositor().m_windows.push_back(window);
+        return window;
+    }
+
+    std::vector<std::string> hyprctlCalls() {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        return g_hyprctlCalls;
+    }
+
+    uint64_t rulesApplied() {
+        return g_rulesApplied.load(std::memory_order_relaxed);
+    }
+
+    std::vector<SKeybind> keybinds() {
+        std::vector<SKeybind> out;
+        if (g_pKeybindManager) {
+            for (const auto& kb : g_pKeybindManager->m_keybinds) {
+                out.push_back(*kb);
+            }
+        }
+        return out;
+    }
+
+    uint64_t keybindCalls() {
+        return g_keybindCalls.load(std::memory_order_relaxed);
+    }
+
+    std::vector<std::string> dispatches() {
+        return g_dispatches;
+    }
+
+    SDispatchResult dispatch(const std::string& dispatcher, const std::string& arg) {
+        auto it = g_pKeybindManager->m_dispatchers.find(dispatcher);
+        if (it == g_pKeybindManager->m_dispatchers.end()) {
+            return {.success = false, .error = "Invalid dispatcher"};
+        }
+        return it->second(arg);
+    }
+
+    void emit(const std::string& event, std::any data) {
+        auto it = g_hooks.find(event);
+        if (it == g_hooks.end()) {
+            return;
+        }
+        std::erase_if(it->second, [](const WP<HOOK_CALLBACK_FN>& hook) { return hook.expired(); });
+        for (const auto& weak : it->second) {
+            if (auto hook = weak.lock()) {
+                SCallbackInfo info;
+                (*hook)(nullptr, info, data);
+            }
+        }
+    }
+
+    size_t hooks(const std::string& event) {
+        auto it = g_hooks.find(event);
+        return it == g_hooks.end() ? 0 : std::ranges::count_if(it->second, [](const WP<HOOK_CALLBACK_FN>& hook) { return !hook.expired(); });
+    }
+
+    std::string hyprctl(const std::string& request) {
+        SP<SHyprCtlCommand> match;
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            for (const auto& cmd : g_commands) {
+                if (cmd->exact ? request == cmd->name : request.starts_with(cmd->name)) {
+                    match = cmd;
+                    break;
+                }
+            }
+        }
+        return match ? match->fn(FORMAT_NORMAL, request) : "";
+    }
+
+    Hyprlang::CConfigValue* addOption(const std::string& name, std::unique_ptr<Hyprlang::CConfigValue> value) {
+        config_managers();
+        auto& slot = g_options[name];
+        slot       = std::move(value);
+        return slot.get();
+    }
+
+    uint64_t configLookups() {
+        return g_configLookups;
+    }
+
+    std::vector<std::string> parsedKeywords() {
+        return g_parsedKeywords;
+    }
+
+    Refreshes refreshes() {
+        return g_refreshes;
+    }
+
+    void reset() {
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            g_notifications.clear();
+            g_hyprctlCalls.clear();
+            g_commands.clear();
+        }
+        g_hooks.clear();
+        g_rulesApplied    = 0;
+        g_keybindCalls    = 0;
+        g_pKeybindManager = std::make_unique<CKeybindManager>();
+        g_options.clear();
+        g_parsedKeywords.clear();
+        g_configLookups = 0;
+        g_refreshes     = {};
+        g_nextMonitorId = 0;
+        g_dispatches.clear();
+        config_managers();
+
+        auto& c = compositor();
+        c.m_monitors.clear();
+        c.m_realMonitors.clear();
+        c.m_workspaces.clear();
+        c.m_windows.clear();
+    }
+
+} // namespace standin
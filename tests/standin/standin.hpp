@@ -0,0 +1,110 @@
+#pragma once
+
+#include <hyprland/src/Compositor.hpp>
+#include <hyprland/src/config/ConfigManager.hpp>
+#include <hyprland/src/desktop/Window.hpp>
+#include <hyprland/src/managers/KeybindManager.hpp>
+#include <hyprland/src/managers/LayoutManager.hpp>
+#include <hyprland/src/plugins/PluginAPI.hpp>
+#include <hyprland/src/render/Renderer.hpp>
+#include <any>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file standin.hpp
+ * @brief Inspection helpers for the headless compositor stand-in
+ * @details The stand-in implements the Hyprland calls Hyprlua makes and records
+ *          them, so the plugin's C++ code can be tested and benchmarked without a
+ *          running compositor. It is not thread-safe beyond what Hyprland itself
+ *          guarantees: compositor objects are only touched from one thread.
+ */
+
+namespace standin {
+
+    /// @brief A notification as it would have been shown by Hyprland
+    struct Notification {
+        std::string     text;
+        CHyprColor      color;
+        float           timeMs = 0;
+        std::thread::id thread;
+    };
+
+    /// @brief Snapshot of every notification recorded so far
+    std::vector<Notification> notifications();
+
+    /**
+     * @brief Add an output to g_pCompositor, creating the compositor if needed
+     * @param name Connector name, e.g. "DP-1"
+     * @param description What desc: rules match against
+     */
+    PHLMONITOR addMonitor(const std::string& name, const std::string& description = "");
+
+    /// @brief Add a workspace on @p monitor
+    PHLWORKSPACE addWorkspace(WORKSPACEID id, const std::string& name, const PHLMONITOR& monitor);
+
+    /**
+     * @brief Add a mapped window to g_pCompositor; its initial class and title are @p cls and @p title
+     * @note Only adds it; emit "openWindow" to have it reported like Hyprland would
+     */
+    PHLWINDOW addWindow(const std::string& cls, const std::string& title);
+
+    /// @brief Every HyprlandAPI::invokeHyprctlCommand call as "call args"
+    std::vector<std::string> hyprctlCalls();
+
+    /// @brief Monitor rules applied over all outputs
+    uint64_t rulesApplied();
+
+    /// @brief Snapshot of g_pKeybindManager's binds, in the order they were added
+    std::vector<SKeybind> keybinds();
+
+    /// @brief addKeybind plus removeKeybind calls
+    uint64_t keybindCalls();
+
+    /// @brief Dispatcher calls made by the plugin, as "dispatcher arg"; key presses through dispatch() included
+    std::vector<std::string> dispatches();
+
+    /// @brief Run a dispatcher the way a key press on one of its binds would
+    SDispatchResult dispatch(const std::string& dispatcher, const std::string& arg);
+
+    /// @brief Fire a compositor event at the callbacks registered for it, like Hyprland's event manager
+    void emit(const std::string& event, std::any data);
+
+    /// @brief Callbacks currently registered for @p event
+    size_t hooks(const std::string& event);
+
+    /**
+     * @brief Run a request against the registered hyprctl commands, like `hyprctl <request>` would
+     * @return The command's output, or an empty string if no command matched
+     */
+    std::string hyprctl(const std::string& request);
+
+    /// @brief Register a config option for HyprlandAPI::getConfigValue to find, like Hyprland's defaults
+    Hyprlang::CConfigValue* addOption(const std::string& name, std::unique_ptr<Hyprlang::CConfigValue> value);
+
+    template <typename T>
+    Hyprlang::CConfigValue* addOption(const std::string& name, T value) {
+        return addOption(name, std::make_unique<Hyprlang::CConfigValue>(std::move(value)));
+    }
+
+    /// @brief HyprlandAPI::getConfigValue calls, found or not
+    uint64_t configLookups();
+
+    /// @brief Every CConfigManager::parseKeyword call as "keyword value"
+    std::vector<std::string> parsedKeywords();
+
+    /// @brief Layout and render refreshes requested by the plugin
+    struct Refreshes {
+        uint64_t layouts     = 0; ///< IHyprLayout::recalculateMonitor calls
+        uint64_t damage      = 0; ///< CHyprRenderer::damageMonitor calls
+        uint64_t decorations = 0; ///< CCompositor::updateAllWindowsAnimatedDecorationValues calls
+    };
+    Refreshes refreshes();
+
+    /// @brief Forget all recorded calls, outputs, workspaces, binds, windows, registered commands, event callbacks and options
+    void reset();
+
+} // namespace standin
@@ -0,0 +1,105 @@
+#include "wayland-server-core.h"
+
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+struct wl_event_loop {
+    int epollFd = -1;
+};
+
+struct wl_event_source {
+    wl_event_loop*             loop = nullptr;
+    int                        fd   = -1;
+    wl_event_loop_fd_func_t    onFd    = nullptr;
+    wl_event_loop_timer_func_t onTimer = nullptr;
+    void*                      data    = nullptr;
+};
+
+namespace {
+    wl_event_source* add_source(wl_event_loop* loop, wl_event_source* source, uint32_t events) {
+        epoll_event ev{};
+        ev.events   = events;
+        ev.data.ptr = source;
+        if (source->fd < 0 || epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, source->fd, &ev) < 0) {
+            if (source->onTimer && source->fd >= 0) {
+                close(source->fd);
+            }
+            delete source;
+            return nullptr;
+        }
+        return source;
+    }
+}
+
+extern "C" {
+
+wl_event_loop* wl_event_loop_create(void) {
+    int fd = epoll_create1(EPOLL_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    return new wl_event_loop{fd};
+}
+
+void wl_event_loop_destroy(wl_event_loop* loop) {
+    close(loop->epollFd);
+    delete loop;
+}
+
+wl_event_source* wl_event_loop_add_fd(wl_event_loop* loop, int fd, uint32_t mask, wl_event_loop_fd_func_t func, void* data) {
+    uint32_t events = 0;
+    if (mask & WL_EVENT_READABLE) {
+        events |= EPOLLIN;
+    }
+    if (mask & WL_EVENT_WRITABLE) {
+        events |= EPOLLOUT;
+    }
+    return add_source(loop, new wl_event_source{loop, fd, func, nullptr, data}, events);
+}
+
+wl_event_source* wl_event_loop_add_timer(wl_event_loop* loop, wl_event_loop_timer_func_t func, void* data) {
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    return add_source(loop, new wl_event_source{loop, fd, nullptr, func, data}, EPOLLIN);
+}
+
+int wl_event_source_timer_update(wl_event_source* source, int ms_delay) {
+    itimerspec its{};
+    its.it_value.tv_sec  = ms_delay / 1000;
+    its.it_value.tv_nsec = static_cast<long>(ms_delay % 1000) * 1000000L;
+    return timerfd_settime(source->fd, 0, &its, nullptr);
+}
+
+int wl_event_source_remove(wl_event_source* source) {
+    epoll_ctl(source->loop->epollFd, EPOLL_CTL_DEL, source->fd, nullptr);
+    if (source->onTimer) {
+        close(source->fd);
+    }
+    delete source;
+    return 0;
+}
+
+int wl_event_loop_dispatch(wl_event_loop* loop, int timeout) {
+    epoll_event events[16];
+    int         count = epoll_wait(loop->epollFd, events, 16, timeout);
+    for (int i = 0; i < count; ++i) {
+        auto* source = static_cast<wl_event_source*>(events[i].data.ptr);
+        if (source->onTimer) {
+            uint64_t expirations = 0;
+            if (read(source->fd, &expirations, sizeof(expirations)) == sizeof(expirations)) {
+                source->onTimer(source->data);
+            }
+        } else {
+            uint32_t mask = 0;
+            if (events[i].events & EPOLLIN) {
+                mask |= WL_EVENT_READABLE;
+            }
+            if (events[i].events & EPOLLOUT) {
+                mask |= WL_EVENT_WRITABLE;
+            }
+            source->onFd(source->fd, mask, source->data);
+        }
+    }
+    return count < 0 ? -1 : 0;
+}
+}
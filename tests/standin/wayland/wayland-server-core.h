@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * @file wayland-server-core.h
+ * @brief Stand-in for the wl_event_loop subset used by Hyprlua
+ * @details Only used when libwayland-server is not installed. Sources are driven
+ *          by epoll and timerfd like the real implementation; signals, idle
+ *          sources and the rest of the display API are not provided.
+ */
+
+#include <cstdint>
+
+extern "C" {
+
+struct wl_event_loop;
+struct wl_event_source;
+
+enum {
+    WL_EVENT_READABLE = 0x01,
+    WL_EVENT_WRITABLE = 0x02,
+    WL_EVENT_HANGUP   = 0x04,
+    WL_EVENT_ERROR    = 0x08,
+};
+
+typedef int (*wl_event_loop_fd_func_t)(int fd, uint32_t mask, void* data);
+typedef int (*wl_event_loop_timer_func_t)(void* data);
+
+wl_event_loop*   wl_event_loop_create(void);
+void             wl_event_loop_destroy(wl_event_loop* loop);
+wl_event_source* wl_event_loop_add_fd(wl_event_loop* loop, int fd, uint32_t mask, wl_event_loop_fd_func_t func, void* data);
+wl_event_source* wl_event_loop_add_timer(wl_event_loop* loop, wl_event_loop_timer_func_t func, void* data);
+int              wl_event_source_timer_update(wl_event_source* source, int ms_delay);
+int              wl_event_source_remove(wl_event_source* source);
+int              wl_event_loop_dispatch(wl_event_loop* loop, int timeout);
+}
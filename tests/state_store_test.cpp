@@ -0,0 +1,173 @@
+// state_store_test.cpp
+// Checks values in the store, snapshot round trips, and that damaged or outdated snapshots are refused.
+#include "lua/state_store.hpp"
+#include "expect.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+using namespace hyprlua;
+
+namespace fs = std::filesystem;
+
+/// @brief { 1, 2, name = "main", nested = { on = true } }
+static std::shared_ptr<const StoreTable> sample_table() {
+    auto nested = std::make_shared<StoreTable>();
+    nested->entries.emplace_back(std::string("on"), true);
+    auto table = std::make_shared<StoreTable>();
+    table->entries.emplace_back(int64_t{1}, int64_t{1});
+    table->entries.emplace_back(int64_t{2}, int64_t{2});
+    table->entries.emplace_back(std::string("name"), std::string("main"));
+    table->entries.emplace_back(std::string("nested"), std::shared_ptr<const StoreTable>(nested));
+    return table;
+}
+
+static bool same(const StoreValue& a, const StoreValue& b);
+
+static bool same_table(const StoreTable& a, const StoreTable& b) {
+    if (a.entries.size() != b.entries.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.entries.size(); ++i) {
+        if (!same(a.entries[i].first, b.entries[i].first) || !same(a.entries[i].second, b.entries[i].second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief Deep equality; StoreValue's own == compares tables by identity
+static bool same(const StoreValue& a, const StoreValue& b) {
+    const auto* ta = std::get_if<std::shared_ptr<const StoreTable>>(&a);
+    const auto* tb = std::get_if<std::shared_ptr<const StoreTable>>(&b);
+    if (ta && tb) {
+        return same_table(**ta, **tb);
+    }
+    return a == b;
+}
+
+static void test_values() {
+    StateStore store;
+    EXPECT(std::holds_alternative<std::monostate>(store.get("missing")), "missing key has a value");
+
+    EXPECT(store.set("count", int64_t{3}), "new key not a change");
+    EXPECT(store.set("ratio", 0.5), "new key not a change");
+    EXPECT(store.set("name", std::string("DP-1")), "new key not a change");
+    EXPECT(store.set("enabled", false), "new key not a change");
+    EXPECT(store.size() == 4, "size %zu", store.size());
+
+    // Same value again leaves the generation alone, a different one bumps it
+    const uint64_t generation = store.generation();
+    EXPECT(!store.set("count", int64_t{3}), "unchanged value counted as a change");
+    EXPECT(store.generation() == generation, "generation moved on an unchanged value");
+    // An integer and a float with the same value are different Lua values
+    EXPECT(store.set("count", 3.0), "integer to float not a change");
+    EXPECT(store.generation() == generation + 1, "generation did not move");
+
+    EXPECT(std::get<double>(store.get("count")) == 3.0, "count not replaced");
+    EXPECT(std::get<std::string>(store.get("name")) == "DP-1", "name lost");
+    EXPECT(std::get<bool>(store.get("enabled")) == false, "enabled lost");
+
+    // Reads share the frozen table instead of copying it
+    const auto table = sample_table();
+    store.set("layout", table);
+    EXPECT(std::get<std::shared_ptr<const StoreTable>>(store.get("layout")) == table, "table copied on read");
+
+    // Storing nil removes the key
+    EXPECT(store.set("enabled", StoreValue{}), "removal not a change");
+    EXPECT(!store.set("enabled", StoreValue{}), "removing a missing key counted as a change");
+    const auto keys = store.keys();
+    EXPECT(keys == (std::vector<std::string>{"count", "layout", "name", "ratio"}), "keys %zu", keys.size());
+}
+
+static void test_round_trip(const std::string& dir) {
+    StateStore store;
+    store.set("count", int64_t{-42});
+    store.set("ratio", 1.25);
+    store.set("name", std::string("with\0nul", 8));
+    store.set("enabled", true);
+    store.set("layout", sample_table());
+
+    const std::string path  = dir + "/state/store.bin";
+    const auto        saved = store.save(path);
+    EXPECT(saved && *saved == store.generation(), "save failed");
+    EXPECT(!fs::exists(path + ".tmp." + std::to_string(getpid())), "temporary file left behind");
+
+    StateStore loaded;
+    EXPECT(loaded.load(path) == StateStore::LoadResult::Loaded, "snapshot not loaded");
+    EXPECT(loaded.keys() == store.keys(), "keys differ");
+    for (const auto& key : store.keys()) {
+        EXPECT(same(loaded.get(key), store.get(key)), "value of %s differs", key.c_str());
+    }
+
+    StateStore empty;
+    EXPECT(empty.load(dir + "/none.bin") == StateStore::LoadResult::Missing, "missing snapshot not reported");
+}
+
+static void test_damaged(const std::string& dir) {
+    StateStore store;
+    store.set("count", int64_t{1});
+    store.set("layout", sample_table());
+    const std::string good = store.serialize();
+
+    StateStore target;
+    target.set("kept", true);
+    const auto refused = [&](std::string data, StateStore::LoadResult expected, const char* what) {
+        EXPECT(target.deserialize(data) == expected, "%s not refused", what);
+        EXPECT(target.keys() == std::vector<std::string>{"kept"}, "%s changed the store", what);
+    };
+
+    refused(good.substr(0, good.size() - 1), StateStore::LoadResult::Corrupt, "truncated snapshot");
+    refused(good.substr(0, 10), StateStore::LoadResult::Corrupt, "truncated header");
+    refused("not a snapshot at all, just some text", StateStore::LoadResult::Corrupt, "foreign file");
+
+    std::string flipped = good;
+    flipped.back() ^= 0x5a;
+    refused(flipped, StateStore::LoadResult::Corrupt, "flipped payload byte");
+
+    // The version follows the 8-byte magic
+    std::string outdated = good;
+    outdated[8] = static_cast<char>(StateStore::FORMAT_VERSION + 1);
+    refused(outdated, StateStore::LoadResult::Outdated, "other format version");
+
+    const std::string path = dir + "/empty.bin";
+    std::ofstream(path).close();
+    EXPECT(target.load(path) == StateStore::LoadResult::Corrupt, "empty file not refused");
+
+    EXPECT(target.deserialize(good) == StateStore::LoadResult::Loaded, "good snapshot refused");
+    EXPECT(target.keys() == store.keys(), "good snapshot did not replace the contents");
+}
+
+/// @brief Tables nested deeper than MAX_DEPTH are refused when read back
+static void test_depth() {
+    auto value = StoreValue{int64_t{0}};
+    for (size_t i = 0; i <= StateStore::MAX_DEPTH; ++i) {
+        auto table = std::make_shared<StoreTable>();
+        table->entries.emplace_back(int64_t{1}, value);
+        value = std::shared_ptr<const StoreTable>(table);
+    }
+    StateStore store;
+    store.set("deep", value);
+    StateStore loaded;
+    EXPECT(loaded.deserialize(store.serialize()) == StateStore::LoadResult::Corrupt, "over-deep table read back");
+}
+
+int main() {
+    char tmpl[] = "/tmp/hyprlua-store-XXXXXX";
+    if (!mkdtemp(tmpl)) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+
+    test_values();
+    test_round_trip(tmpl);
+    test_damaged(tmpl);
+    test_depth();
+
+    fs::remove_all(tmpl);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,39 @@
+// store_test.cpp
+// Counts config runs in hypr.store and checks that the count survives each reload, that a config failing
+// after its write leaves the store alone, and that a table read back can be changed without changing the store.
+#include "runtime_harness.hpp"
+#include "expect.hpp"
+
+static void expect_published(const char* expected, const char* when) {
+    const auto published = harness::bind_arg("n");
+    EXPECT(published == expected, "%s: '%s'", when, published ? published->c_str() : "(no bind)");
+}
+
+int main() {
+    harness::Runtime runtime("store");
+
+    const std::string counting = "local runs = hypr.store.get(\"runs\", 0) + 1\n"
+                                 "hypr.store.set(\"runs\", runs)\n"
+                                 "local list = hypr.store.get(\"list\", { 0 })\n"
+                                 "list[1] = list[1] + 1\n"
+                                 "hypr.store.set(\"list\", { list[1] })\n"
+                                 "local copy = hypr.store.get(\"list\")\n"
+                                 "copy[1] = -1\n"
+                                 "hypr.binds.set(\"SUPER\", \"n\", \"exec\", runs .. \",\" .. hypr.store.get(\"list\")[1])\n";
+    runtime.write("hyprland.lua", counting);
+    EXPECT(runtime.start(), "config not applied");
+    expect_published("1,1", "first load");
+
+    EXPECT(runtime.reload(), "reload not applied");
+    expect_published("2,2", "reload");
+
+    runtime.write("hyprland.lua", "hypr.store.set(\"runs\", 100)\n"
+                                  "error(\"broken config\")\n");
+    EXPECT(!runtime.reload(), "broken config applied");
+
+    runtime.write("hyprland.lua", counting);
+    EXPECT(runtime.reload(), "reload after the broken config not applied");
+    expect_published("3,3", "after the broken config");
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+// timer_queue_test.cpp
+// Checks that the TimerQueue runs timers in deadline order on the event loop, and that cancelling works from inside a timer.
+#include "eventloop.hpp"
+#include "expect.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <wayland-server-core.h>
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+/// @brief Run the event loop until @p done or @p timeout passed
+template <typename F>
+static void dispatch_until(wl_event_loop* loop, F done, std::chrono::milliseconds timeout) {
+    const auto deadline = Clock::now() + timeout;
+    while (!done() && Clock::now() < deadline) {
+        wl_event_loop_dispatch(loop, 5);
+    }
+}
+
+static std::string join(const std::vector<std::string>& parts) {
+    std::string out;
+    for (const auto& part : parts) {
+        out += (out.empty() ? "" : " ") + part;
+    }
+    return out;
+}
+
+static void test_order(wl_event_loop* loop) {
+    hyprlua::eventloop::TimerQueue queue;
+    std::vector<std::string>       ran;
+    const auto                     start = Clock::now();
+
+    queue.schedule(60, [&] { ran.push_back("60"); });
+    queue.schedule(20, [&] { ran.push_back("20"); });
+    queue.schedule(0, [&] { ran.push_back("0a"); });
+    queue.schedule(0, [&] { ran.push_back("0b"); });
+    const auto dropped = queue.schedule(40, [&] { ran.push_back("40"); });
+    EXPECT(queue.size() == 5, "%zu pending", queue.size());
+    EXPECT(queue.cancel(dropped) && !queue.cancel(dropped), "cancel twice");
+
+    dispatch_until(loop, [&] { return ran.size() == 4; }, 1000ms);
+    const auto elapsed = Clock::now() - start;
+    EXPECT(join(ran) == "0a 0b 20 60", "ran: %s", join(ran).c_str());
+    EXPECT(elapsed >= 60ms, "the 60 ms timer ran after %lld ms", static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()));
+    EXPECT(queue.size() == 0, "%zu still pending", queue.size());
+}
+
+static void test_reentrancy(wl_event_loop* loop) {
+    hyprlua::eventloop::TimerQueue queue;
+    std::vector<std::string>       ran;
+
+    // Both are due in the same batch: the first cancels the second, which must not run
+    hyprlua::eventloop::TimerQueue::Id second = 0;
+    queue.schedule(10, [&] {
+        ran.push_back("first");
+        queue.cancel(second);
+        queue.schedule(10, [&] { ran.push_back("rescheduled"); });
+    });
+    second = queue.schedule(10, [&] { ran.push_back("second"); });
+
+    dispatch_until(loop, [&] { return ran.size() == 2; }, 1000ms);
+    EXPECT(join(ran) == "first rescheduled", "ran: %s", join(ran).c_str());
+
+    // clear() drops everything, including an armed earliest deadline
+    bool late = false;
+    queue.schedule(5, [&] { late = true; });
+    queue.clear();
+    dispatch_until(loop, [] { return false; }, 50ms);
+    EXPECT(!late && queue.size() == 0, "a cleared timer ran");
+}
+
+static void test_many(wl_event_loop* loop) {
+    hyprlua::eventloop::TimerQueue queue;
+    int                            ran = 0;
+    for (int i = 0; i < 1000; ++i) {
+        const auto id = queue.schedule(i % 20, [&] { ++ran; });
+        if (i % 2 == 0) {
+            queue.cancel(id);
+        }
+    }
+    dispatch_until(loop, [&] { return ran == 500; }, 2000ms);
+    EXPECT(ran == 500, "ran %d of 500", ran);
+}
+
+int main() {
+    wl_event_loop* loop = wl_event_loop_create();
+    if (!loop || !hyprlua::eventloop::init(loop)) {
+        std::fprintf(stderr, "could not set up the event loop\n");
+        return 1;
+    }
+
+    test_order(loop);
+    test_reentrancy(loop);
+    test_many(loop);
+
+    hyprlua::eventloop::shutdown();
+    wl_event_loop_destroy(loop);
+    return failures == 0 ? 0 : 1;
+}
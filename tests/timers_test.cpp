@@ -0,0 +1,75 @@
+// timers_test.cpp
+// Runs a config whose hypr.async coroutine sleeps through the stand-in's event loop, and checks that
+// it is resumed on every wake and that a bind added after the config was applied is refused.
+#include "eventloop.hpp"
+#include "globals.hpp"
+#include "logger.hpp"
+#include "utils.hpp"
+#include "lua/runtime.hpp"
+#include "lua/timers.hpp"
+#include "standin.hpp"
+#include "expect.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <wayland-server-core.h>
+
+namespace fs = std::filesystem;
+
+int main() {
+    const auto root = fs::temp_directory_path() / ("hyprlua-timers-test-" + std::to_string(getpid()));
+    fs::create_directories(root);
+    setenv("XDG_CACHE_HOME", (root / "cache").c_str(), 1);
+    setenv("HYPRLUA_STORE_PATH", (root / "store.bin").c_str(), 1);
+
+    hyprlua::log::setLevel(hyprlua::log::Level::Off);
+    standin::reset();
+    auto* loop                   = wl_event_loop_create();
+    g_pCompositor->m_wlEventLoop = loop;
+    hyprlua::eventloop::init(loop);
+    PHANDLE = reinterpret_cast<HANDLE>(1);
+    setNotificationRateLimit(1, 0);
+
+    // Each wake runs from a timer on the main thread, long after the coroutine that created it yielded
+    const auto config = root / "hyprland.lua";
+    std::ofstream(config) << "hypr.async(function()\n"
+                             "  hypr.sleep(0)\n"
+                             "  hypr.sleep(0)\n"
+                             "  hypr.binds.set(\"SUPER\", \"y\", \"exec\", \"true\")\n"
+                             "end)\n";
+    hyprlua::init_lua_runtime(HYPRLUA_RUNTIME_MODULES, config.string());
+    while (!hyprlua::config_loaded()) {
+        wl_event_loop_dispatch(loop, 10);
+    }
+    const auto before = hyprlua::modules::timer_stats();
+    for (int i = 0; i < 100 && hyprlua::modules::timer_stats().failed == before.failed; ++i) {
+        wl_event_loop_dispatch(loop, 10);
+    }
+    // Let the failure toast through
+    wl_event_loop_dispatch(loop, 10);
+
+    const auto stats = hyprlua::modules::timer_stats();
+    EXPECT(stats.fired - before.fired == 2, "fired %llu", static_cast<unsigned long long>(stats.fired - before.fired));
+    EXPECT(stats.failed - before.failed == 1, "failed %llu", static_cast<unsigned long long>(stats.failed - before.failed));
+    EXPECT(stats.pending == 0, "pending %llu", static_cast<unsigned long long>(stats.pending));
+
+    bool refused = false;
+    for (const auto& n : standin::notifications()) {
+        refused = refused || n.text.find("hypr.binds.set can only be called while the config loads") != std::string::npos;
+    }
+    EXPECT(refused, "late bind not reported");
+    for (const auto& bind : standin::keybinds()) {
+        EXPECT(bind.key != "y", "late bind added");
+    }
+
+    hyprlua::shutdown_lua_runtime();
+    hyprlua::eventloop::shutdown();
+    shutdownNotifications();
+    wl_event_loop_destroy(loop);
+    std::error_code ec;
+    fs::remove_all(root, ec);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+// trace_test.cpp
+// Checks histogram percentiles, the run-time switch and the Chrome trace capture.
+#include "trace.hpp"
+#include "expect.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+
+static hyprlua::trace::Site histogramSite("test.histogram");
+static hyprlua::trace::Site idleSite("test.idle");
+
+static void traced_work() {
+    HYPRLUA_TRACE_SCOPE("test.scope");
+    std::this_thread::sleep_for(1ms);
+}
+
+int main() {
+    // 98 fast samples and 2 slow ones: p50 is fast, p99 is slow
+    for (int i = 0; i < 98; ++i) {
+        histogramSite.record(100us);
+    }
+    histogramSite.record(10ms);
+    histogramSite.record(20ms);
+
+    auto s = histogramSite.summary();
+    EXPECT(s.count == 100, "count %llu", static_cast<unsigned long long>(s.count));
+    EXPECT(s.lastUs == 20000, "last %f", s.lastUs);
+    EXPECT(s.maxUs == 20000, "max %f", s.maxUs);
+    EXPECT(s.totalUs == 98 * 100 + 10000 + 20000, "total %f", s.totalUs);
+    EXPECT(s.p50Us > 88 && s.p50Us < 113, "p50 %f", s.p50Us);
+    EXPECT(s.p99Us > 8800 && s.p99Us < 11300, "p99 %f", s.p99Us);
+
+    // Sites that were never hit are left out
+    bool idleListed = false;
+    for (const auto& summary : hyprlua::trace::summaries()) {
+        idleListed |= summary.name == idleSite.name();
+    }
+    EXPECT(!idleListed, "unused site listed");
+
+    // Switched off, scopes record nothing
+    hyprlua::trace::setEnabled(false);
+    traced_work();
+    EXPECT(hyprlua::trace::statsJson().find("test.scope") == std::string::npos, "scope recorded while off");
+    hyprlua::trace::setEnabled(true);
+    traced_work();
+    EXPECT(hyprlua::trace::statsJson().find("\"test.scope\": {\"count\": 1") != std::string::npos, "json: %s", hyprlua::trace::statsJson().c_str());
+
+    // Nothing is captured until requested, then one event per scope until finished
+    EXPECT(hyprlua::trace::finishCapture().empty(), "capture without a request");
+    const std::string path = "/tmp/hyprlua-trace-test-" + std::to_string(getpid()) + ".json";
+    hyprlua::trace::requestCapture(path);
+    hyprlua::trace::startCaptureIfRequested();
+    traced_work();
+    std::thread([] { traced_work(); }).join();
+    EXPECT(hyprlua::trace::finishCapture() == path, "capture not written");
+    traced_work();
+
+    std::ifstream      in(path);
+    std::ostringstream json;
+    json << in.rdbuf();
+    const auto text   = json.str();
+    size_t     events = 0;
+    for (size_t at = text.find("\"ph\": \"X\""); at != std::string::npos; at = text.find("\"ph\": \"X\"", at + 1)) {
+        ++events;
+    }
+    EXPECT(text.starts_with("{\"traceEvents\": ["), "trace: %s", text.c_str());
+    EXPECT(events == 2, "expected 2 events, got %zu", events);
+    std::remove(path.c_str());
+
+    return failures == 0 ? 0 : 1;
+}
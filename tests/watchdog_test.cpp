@@ -0,0 +1,39 @@
+// watchdog_test.cpp
+// Reloads into a config that loops forever and checks that the watchdog aborts it within the reload budget,
+// that the previous config's binds and Lua state stay in place, and that a fixed config is applied after.
+#include "lua/watchdog.hpp"
+#include "runtime_harness.hpp"
+#include "expect.hpp"
+
+#include <algorithm>
+
+int main() {
+    harness::Runtime runtime("watchdog");
+
+    runtime.write("hyprland.lua", "hypr.watchdog.configure({ reload_ms = 200 })\n"
+                                  "hypr.binds.set(\"SUPER\", \"a\", \"exec\", \"first\")\n"
+                                  "hypr.binds.set(\"SUPER\", \"b\", function() end)\n");
+    EXPECT(runtime.start(), "config not applied");
+
+    // Records its binds, then never returns
+    runtime.write("hyprland.lua", "hypr.watchdog.configure({ reload_ms = 200 })\n"
+                                  "hypr.binds.set(\"SUPER\", \"a\", \"exec\", \"second\")\n"
+                                  "while true do end\n");
+    const auto aborts = hyprlua::modules::watchdog_aborts();
+    EXPECT(!runtime.reload(), "looping config applied");
+    EXPECT(hyprlua::modules::watchdog_aborts() == aborts + 1, "%llu aborts", static_cast<unsigned long long>(hyprlua::modules::watchdog_aborts() - aborts));
+    runtime.dispatch();
+    const auto notifications = standin::notifications();
+    EXPECT(std::ranges::any_of(notifications, [](const auto& n) { return n.text.find("exceeded its 200 ms budget") != std::string::npos; }), "abort not reported");
+
+    // The previous config is still the one applied, its Lua function bind included
+    EXPECT(harness::bind_arg("a") == "first", "bind of the aborted config applied");
+    const auto callback = harness::bind_arg("b");
+    EXPECT(callback && standin::dispatch(hyprlua::LUA_DISPATCHER, *callback).success, "Lua function bind of the previous config no longer runs");
+
+    runtime.write("hyprland.lua", "hypr.binds.set(\"SUPER\", \"a\", \"exec\", \"third\")\n");
+    EXPECT(runtime.reload(), "fixed config not applied");
+    EXPECT(harness::bind_arg("a") == "third", "fixed config's bind not applied");
+
+    return failures == 0 ? 0 : 1;
+}
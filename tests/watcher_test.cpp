@@ -0,0 +1,144 @@
+// watcher_test.cpp
+// Measures FileWatcher idle wakeups, change latency and shutdown time, and checks
+// that nested and symlinked files are watched while unrelated ones are not, that
+// saves which change nothing are dropped and that quick or atomic saves are each
+// reported once.
+#include "watcher.hpp"
+#include "standin.hpp"
+#include "expect.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+using Clock  = std::chrono::steady_clock;
+
+int main() {
+    char tmpl[] = "/tmp/hyprlua-watcher-XXXXXX";
+    if (!mkdtemp(tmpl)) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+    const std::string directory = std::string(tmpl) + "/";
+    const std::string filepath  = directory + "hyprland.lua";
+    std::ofstream(filepath) << "-- initial\n";
+
+    std::mutex               mtx;
+    std::condition_variable  cv;
+    int                      events = 0;
+    std::vector<std::string> paths;
+    Clock::time_point        eventTime;
+
+    FileWatcher              watcher(filepath, [&](const std::string& path) {
+        std::lock_guard<std::mutex> lock(mtx);
+        paths.push_back(path);
+        eventTime = Clock::now();
+        ++events;
+        cv.notify_all();
+    });
+    EXPECT(watcher.start(), "watcher failed to start");
+
+    // Idle: the thread must stay blocked in epoll_wait
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    const auto idleWakeups = watcher.wakeups();
+    std::printf("idle wakeups over 1s: %llu\n", static_cast<unsigned long long>(idleWakeups));
+    EXPECT(idleWakeups == 0, "watcher woke up %llu times while idle", static_cast<unsigned long long>(idleWakeups));
+
+    // Latency: time from the write to the callback
+    const auto writeTime = Clock::now();
+    std::ofstream(filepath, std::ios::app) << "-- changed\n";
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait_for(lock, std::chrono::seconds(2), [&] { return events > 0; });
+        EXPECT(events == 1, "expected one change event, got %d", events);
+        EXPECT(events == 0 || paths.back() == filepath, "unexpected path %s", paths.back().c_str());
+        if (events > 0) {
+            const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(eventTime - writeTime).count();
+            std::printf("write to event latency: %lld us\n", static_cast<long long>(latency));
+            EXPECT(latency < 10000, "change took %lld us to be reported", static_cast<long long>(latency));
+        }
+    }
+
+    // Required files in nested directories and behind symlinks
+    const std::string nested = directory + "lua/keys/binds.lua";
+    const std::string linked = directory + "linked.lua";
+    const std::string target = directory + "dotfiles/real.lua";
+    fs::create_directories(directory + "lua/keys");
+    fs::create_directories(directory + "dotfiles");
+    std::ofstream(nested) << "-- binds\n";
+    std::ofstream(target) << "-- real\n";
+    fs::create_symlink(target, linked);
+    watcher.setFiles({filepath, nested, linked});
+
+    auto change = [&](const std::string& path, const std::string& expected) {
+        const int before = events;
+        std::ofstream(path, std::ios::app) << "-- changed\n";
+        std::unique_lock<std::mutex> lock(mtx);
+        const bool                   seen = cv.wait_for(lock, std::chrono::milliseconds(expected.empty() ? 200 : 2000), [&] { return events > before; });
+        if (expected.empty()) {
+            EXPECT(!seen, "change to %s was reported as %s", path.c_str(), paths.back().c_str());
+        } else {
+            EXPECT(seen && paths.back() == expected, "change to %s reported as %s", path.c_str(), seen ? paths.back().c_str() : "nothing");
+        }
+    };
+    change(nested, nested);
+    change(target, linked);
+    change(directory + "unrelated.lua", "");
+
+    // Count the events that arrive within @p window of now
+    auto eventsWithin = [&](int before, std::chrono::milliseconds window) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait_for(lock, window, [] { return false; });
+        return events - before;
+    };
+
+    // Saving identical content is not a change
+    {
+        const int before = events;
+        std::ofstream(nested, std::ios::trunc) << "-- binds\n-- changed\n";
+        const int seen = eventsWithin(before, std::chrono::milliseconds(300));
+        EXPECT(seen == 0, "identical save reported %d times", seen);
+    }
+
+    // Two real edits 100 ms apart are both reported
+    {
+        const int before = events;
+        std::ofstream(filepath, std::ios::app) << "-- first\n";
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::ofstream(filepath, std::ios::app) << "-- second\n";
+        const int seen = eventsWithin(before, std::chrono::milliseconds(500));
+        EXPECT(seen == 2, "two edits 100 ms apart reported %d times", seen);
+    }
+
+    // An atomic save (write a temporary file, rename it over the original) is reported once
+    {
+        const int before = events;
+        std::ofstream(nested + ".tmp") << "-- binds\n-- saved atomically\n";
+        fs::rename(nested + ".tmp", nested);
+        const int seen = eventsWithin(before, std::chrono::milliseconds(500));
+        EXPECT(seen == 1, "atomic save reported %d times", seen);
+        EXPECT(seen == 0 || paths.back() == nested, "atomic save reported as %s", paths.back().c_str());
+    }
+
+    // Files dropped from the set are no longer reported
+    watcher.setFiles({filepath});
+    change(nested, "");
+
+    // Shutdown must not wait for a poll interval
+    const auto stopStart = Clock::now();
+    watcher.stop();
+    const auto stopTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - stopStart).count();
+    std::printf("stop latency: %lld us\n", static_cast<long long>(stopTime));
+    EXPECT(stopTime < 50000, "stop took %lld us", static_cast<long long>(stopTime));
+
+    fs::remove_all(tmpl);
+    return failures == 0 ? 0 : 1;
+}
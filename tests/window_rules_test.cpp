@@ -0,0 +1,138 @@
+// window_rules_test.cpp
+// Checks pattern compilation, rule actions and that the class index finds the same rules a full scan does.
+#include "lua/window_rules.hpp"
+#include "expect.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace hyprlua;
+
+static Matcher compile(const std::string& pattern) {
+    auto matcher = Matcher::compile(pattern);
+    EXPECT(matcher.has_value(), "'%s' should compile: %s", pattern.c_str(), matcher ? "" : matcher.error().c_str());
+    return matcher.value_or(Matcher{});
+}
+
+static void test_matchers() {
+    EXPECT(compile("").any() && compile("").matches("anything"), "empty pattern");
+
+    // Plain text is found anywhere; anchors pin it, with or without Hyprland's parentheses
+    EXPECT(compile("fox").matches("firefox") && !compile("fox").matches("chromium"), "contains");
+    EXPECT(compile("^fire").matches("firefox") && !compile("^fire").matches("campfire"), "prefix");
+    EXPECT(compile("fox$").matches("firefox") && !compile("fox$").matches("foxes"), "suffix");
+    EXPECT(compile("^firefox$").exact() == "firefox", "exact: '%s'", std::string(compile("^firefox$").exact()).c_str());
+    EXPECT(compile("^(firefox)$").exact() == "firefox", "parenthesized exact");
+    EXPECT(!compile("^firefox$").matches("firefox-esr"), "exact matches a longer name");
+
+    // Anything else is a regex
+    EXPECT(compile("^(firefox|chromium)$").exact().empty(), "alternation is not exact");
+    EXPECT(compile("^(firefox|chromium)$").matches("chromium") && !compile("^(firefox|chromium)$").matches("chromium-browser"), "alternation");
+    EXPECT(compile("Picture.in.Picture").matches("Picture-in-Picture"), "regex dot");
+    EXPECT(compile("price\\$").matches("price$") && !compile("price\\$").matches("price"), "escaped dollar is literal");
+
+    // Regexes are only run on text holding the literal part every match needs; that must not lose matches
+    EXPECT(compile(".* - Project 3$").matches("notes.txt - Project 3") && !compile(".* - Project 3$").matches("notes.txt - Project 4"), "required literal");
+    EXPECT(compile("^(Dialog|Settings) 3").matches("Settings 3") && !compile("^(Dialog|Settings) 3").matches("Settings 4"), "literal after a group");
+    EXPECT(compile("Dialog|Settings").matches("Settings"), "top-level alternative");
+    EXPECT(compile("ab?c").matches("ac") && compile("ab*c").matches("ac"), "optional characters are not required");
+    EXPECT(compile("x{2}yz").matches("xxyz") && compile("a[.]b\\.c").matches("a.b.c"), "repeat counts and classes");
+    EXPECT(compile("v\\d+ beta").matches("v12 beta") && !compile("v\\d+ beta").matches("v12 alpha"), "escaped class");
+
+    auto bad = Matcher::compile("^(unclosed");
+    EXPECT(!bad.has_value(), "invalid regex accepted");
+}
+
+static void test_actions() {
+    auto check = [](const char* text, const char* dispatcher, const char* argument) {
+        auto action = parse_rule_action(text);
+        EXPECT(action.has_value(), "'%s' should parse: %s", text, action ? "" : action.error().c_str());
+        if (action) {
+            EXPECT(action->dispatcher == dispatcher, "'%s' dispatcher %s", text, action->dispatcher.c_str());
+            EXPECT(action->argument("0x10") == argument, "'%s' argument %s", text, action->argument("0x10").c_str());
+        }
+    };
+    check("float", "setfloating", "address:0x10");
+    check("tile", "settiled", "address:0x10");
+    check("pin", "pin", "address:0x10");
+    check("workspace 3", "movetoworkspace", "3,address:0x10");
+    check("workspace name:web silent", "movetoworkspacesilent", "name:web,address:0x10");
+    check("size 800 600", "resizewindowpixel", "exact 800 600,address:0x10");
+    check("move 50% 10", "movewindowpixel", "exact 50% 10,address:0x10");
+    check("opacity 0.9", "setprop", "address:0x10 alpha 0.9");
+
+    for (const char* bad : {"", "explode", "float now", "workspace", "workspace 3 loud", "size 800", "size wide 600", "opacity 50%"}) {
+        EXPECT(!parse_rule_action(bad).has_value(), "'%s' should be rejected", bad);
+    }
+}
+
+static WindowRuleSpec rule(const std::string& cls, const std::string& title = "", const std::string& initialClass = "") {
+    WindowRuleSpec spec;
+    spec.fields[static_cast<size_t>(RuleField::Class)]        = compile(cls);
+    spec.fields[static_cast<size_t>(RuleField::Title)]        = compile(title);
+    spec.fields[static_cast<size_t>(RuleField::InitialClass)] = compile(initialClass);
+    return spec;
+}
+
+static std::vector<uint32_t> scan(const std::vector<WindowRuleSpec>& rules, const WindowFields& window) {
+    std::vector<uint32_t> out;
+    for (uint32_t i = 0; i < rules.size(); ++i) {
+        bool match = true;
+        for (size_t f = 0; f < RULE_FIELD_COUNT; ++f) {
+            match = match && rules[i].fields[f].matches(window.values[f]);
+        }
+        if (match) {
+            out.push_back(i);
+        }
+    }
+    return out;
+}
+
+static void test_rule_set() {
+    const std::vector<WindowRuleSpec> rules = {
+        rule("^firefox$"),
+        rule("", "Picture-in-Picture"),
+        rule("^kitty$", "^vim"),
+        rule("", "", "^steam$"),
+        rule("^(firefox|chromium)$"),
+        rule("^firefox$", "Private Browsing$"),
+        rule("^kitty$"),
+    };
+    const RuleSet set(rules);
+
+    const std::vector<WindowFields> windows = {
+        {{"firefox", "Mozilla Firefox", "firefox", "Mozilla Firefox"}},
+        {{"firefox", "Picture-in-Picture", "firefox", "Picture-in-Picture"}},
+        {{"firefox", "GitHub - Private Browsing", "firefox", ""}},
+        {{"kitty", "vim notes.txt", "kitty", "kitty"}},
+        {{"kitty", "zsh", "kitty", "kitty"}},
+        {{"steam_app_1", "Game", "steam", "Steam"}},
+        {{"chromium", "New Tab", "chromium", "New Tab"}},
+        {{"foot", "foot", "foot", "foot"}},
+    };
+
+    std::vector<uint32_t> matched;
+    for (const auto& window : windows) {
+        set.match(window, matched);
+        const auto expected = scan(rules, window);
+        EXPECT(matched == expected, "window %.*s / %.*s: index found %zu rules, scan %zu", static_cast<int>(window.values[0].size()), window.values[0].data(),
+               static_cast<int>(window.values[1].size()), window.values[1].data(), matched.size(), expected.size());
+    }
+
+    set.match(windows[2], matched);
+    EXPECT((matched == std::vector<uint32_t>{0, 4, 5}), "private window matched %zu rules", matched.size());
+
+    // A window of a class no rule names only meets the unindexed rules: 1 and 4
+    const uint64_t before = set.checked();
+    set.match(windows[7], matched);
+    EXPECT(set.checked() - before == 2, "checked %llu rules", static_cast<unsigned long long>(set.checked() - before));
+    EXPECT(matched.empty(), "foot matched %zu rules", matched.size());
+}
+
+int main() {
+    test_matchers();
+    test_actions();
+    test_rule_set();
+    return failures == 0 ? 0 : 1;
+}